@@ -0,0 +1,81 @@
+#include "benchmark.h"
+
+#include <algorithm>
+
+#include "log.h"
+
+using namespace std::chrono;
+
+#define LOG(logger) logger.Log() << "[bench] "
+
+namespace
+{
+    // Initial measurements to find out number of iterations are shorter than MinTime
+    const size_t CALIBRATION_DIVIDER = 10;
+
+    nanoseconds Measure(const TBenchmarkFn& fn, size_t iterations)
+    {
+        auto start = steady_clock::now();
+        fn(iterations);
+        return duration_cast<nanoseconds>(steady_clock::now() - start);
+    }
+
+    size_t Calibrate(const TBenchmarkFn& fn, milliseconds minTime)
+    {
+        const nanoseconds calibrationTime = minTime / CALIBRATION_DIVIDER;
+        size_t iterations = 1;
+        auto time = Measure(fn, iterations);
+        while (time < calibrationTime) {
+            iterations *= 2;
+            time = Measure(fn, iterations);
+        }
+        auto res = static_cast<double>(iterations) * nanoseconds(minTime).count() / std::max<int64_t>(time.count(), 1);
+        return std::max<size_t>(static_cast<size_t>(res), 1);
+    }
+}
+
+void TBenchmarks::Add(const std::string& name, TBenchmarkFn fn)
+{
+    Benchmarks.emplace_back(name, fn);
+}
+
+std::vector<TBenchmarkResult> TBenchmarks::Run(const TBenchmarkSettings& settings) const
+{
+    std::vector<TBenchmarkResult> res;
+    for (const auto& benchmark: Benchmarks) {
+        if (benchmark.first.find(settings.Filter) == std::string::npos) {
+            continue;
+        }
+        LOG(Info) << "running " << benchmark.first;
+
+        TBenchmarkResult result;
+        result.Name = benchmark.first;
+        result.Iterations = Calibrate(benchmark.second, settings.MinTime);
+
+        std::vector<double> times;
+        for (size_t i = 0; i < std::max<size_t>(settings.Repetitions, 1); ++i) {
+            auto time = Measure(benchmark.second, result.Iterations);
+            times.push_back(static_cast<double>(time.count()) / result.Iterations);
+        }
+        std::sort(times.begin(), times.end());
+        result.NsPerOp = times[times.size() / 2];
+        result.MinNsPerOp = times.front();
+        res.push_back(result);
+    }
+    return res;
+}
+
+Json::Value BenchmarkResultsToJson(const std::vector<TBenchmarkResult>& results)
+{
+    Json::Value res(Json::arrayValue);
+    for (const auto& result: results) {
+        Json::Value item;
+        item["name"] = result.Name;
+        item["iterations"] = Json::UInt64(result.Iterations);
+        item["ns_per_op"] = result.NsPerOp;
+        item["min_ns_per_op"] = result.MinNsPerOp;
+        item["ops_per_second"] = (result.NsPerOp > 0) ? 1e9 / result.NsPerOp : 0.0;
+        res.append(item);
+    }
+    return res;
+}
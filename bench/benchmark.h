@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <wblib/json/json.h>
+
+namespace WBMQTT
+{
+    struct TMosquittoMqttConfig;
+}
+
+/**
+ * @brief Benchmark body. It must perform measured operation given number of times.
+ *        Preparation of data must be done outside of the function.
+ */
+typedef std::function<void(size_t iterations)> TBenchmarkFn;
+
+struct TBenchmarkResult
+{
+    std::string Name;
+
+    //! Number of iterations in every measurement
+    size_t Iterations = 0;
+
+    //! Median time of one iteration over all measurements
+    double NsPerOp = 0;
+
+    //! Minimal time of one iteration over all measurements
+    double MinNsPerOp = 0;
+};
+
+struct TBenchmarkSettings
+{
+    //! Minimal duration of one measurement, number of iterations is adjusted to fit it
+    std::chrono::milliseconds MinTime = std::chrono::milliseconds(200);
+
+    //! Number of measurements of every benchmark
+    size_t Repetitions = 5;
+
+    //! Run only benchmarks which names contain the string
+    std::string Filter;
+};
+
+class TBenchmarks
+{
+public:
+    void Add(const std::string& name, TBenchmarkFn fn);
+
+    std::vector<TBenchmarkResult> Run(const TBenchmarkSettings& settings) const;
+
+private:
+    std::vector<std::pair<std::string, TBenchmarkFn>> Benchmarks;
+};
+
+Json::Value BenchmarkResultsToJson(const std::vector<TBenchmarkResult>& results);
+
+//! Prevents compiler from optimizing away calculation of the value
+template<class T> inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+void RegisterCodecBenchmarks(TBenchmarks& benchmarks);
+void RegisterModbusBenchmarks(TBenchmarks& benchmarks, const std::string& dataDir);
+void RegisterSchedulerBenchmarks(TBenchmarks& benchmarks);
+void RegisterExpressionsBenchmarks(TBenchmarks& benchmarks);
+void RegisterConfigBenchmarks(TBenchmarks& benchmarks, const std::string& dataDir);
+void RegisterValueSnapshotBenchmarks(TBenchmarks& benchmarks);
+void RegisterWriteQueueBenchmarks(TBenchmarks& benchmarks);
+
+//! Requires MQTT broker, so is registered only if the broker is specified
+void RegisterMqttBenchmarks(TBenchmarks& benchmarks, const WBMQTT::TMosquittoMqttConfig& mqttConfig);
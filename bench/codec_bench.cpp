@@ -0,0 +1,100 @@
+#include "benchmark.h"
+
+#include <numeric>
+
+#include "crc16.h"
+#include "modbus_common.h"
+#include "register.h"
+
+namespace
+{
+    const size_t CRC_BUFFER_SIZE = 256;
+
+    struct TFormatSample
+    {
+        RegisterFormat Format;
+        const char* Value;
+    };
+
+    const std::vector<TFormatSample> FORMAT_SAMPLES = {{U8, "200"},
+                                                       {S8, "-100"},
+                                                       {U16, "60000"},
+                                                       {S16, "-30000"},
+                                                       {S24, "-8000000"},
+                                                       {U24, "16000000"},
+                                                       {U32, "4000000000"},
+                                                       {S32, "-2000000000"},
+                                                       {S64, "-9000000000000000000"},
+                                                       {U64, "18000000000000000000"},
+                                                       {BCD8, "42"},
+                                                       {BCD16, "1234"},
+                                                       {BCD24, "123456"},
+                                                       {BCD32, "12345678"},
+                                                       {Float, "1234.5"},
+                                                       {Double, "-12345.678"},
+                                                       {Char8, "A"},
+                                                       {String, "wb-mqtt-serial"},
+                                                       {String8, "wb-mqtt-serial"}};
+
+    PRegisterConfig MakeRegisterConfig(RegisterFormat format, double scale)
+    {
+        uint32_t bitWidth = (format == String || format == String8) ? 16 * 8 : 0;
+        return TRegisterConfig::Create(Modbus::REG_HOLDING,
+                                       0,
+                                       format,
+                                       scale,
+                                       0,
+                                       0,
+                                       TRegisterConfig::TSporadicMode::DISABLED,
+                                       false,
+                                       "holding",
+                                       EWordOrder::BigEndian,
+                                       EByteOrder::BigEndian,
+                                       0,
+                                       bitWidth);
+    }
+
+    void AddConversionBenchmarks(TBenchmarks& benchmarks, const TFormatSample& sample, double scale)
+    {
+        auto config = MakeRegisterConfig(sample.Format, scale);
+        std::string suffix = RegisterFormatName(sample.Format);
+        if (scale != 1) {
+            suffix += "/scaled";
+        }
+        std::string text = sample.Value;
+        auto rawValue = ConvertToRawValue(*config, text);
+
+        benchmarks.Add("ConvertToRawValue/" + suffix, [config, text](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                auto value = ConvertToRawValue(*config, text);
+                DoNotOptimize(value);
+            }
+        });
+        benchmarks.Add("ConvertFromRawValue/" + suffix, [config, rawValue](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                auto value = ConvertFromRawValue(*config, rawValue);
+                DoNotOptimize(value);
+            }
+        });
+    }
+}
+
+void RegisterCodecBenchmarks(TBenchmarks& benchmarks)
+{
+    benchmarks.Add("CRC16/" + std::to_string(CRC_BUFFER_SIZE), [](size_t iterations) {
+        std::vector<uint8_t> buf(CRC_BUFFER_SIZE);
+        std::iota(buf.begin(), buf.end(), 0);
+        for (size_t i = 0; i < iterations; ++i) {
+            auto crc = CRC16::CalculateCRC16(buf.data(), buf.size());
+            DoNotOptimize(crc);
+        }
+    });
+
+    for (const auto& sample: FORMAT_SAMPLES) {
+        AddConversionBenchmarks(benchmarks, sample, 1);
+    }
+    // Scaled values are converted through double
+    for (auto format: {S16, U32}) {
+        AddConversionBenchmarks(benchmarks, {format, "123.4"}, 0.1);
+    }
+}
@@ -0,0 +1,97 @@
+#include "benchmark.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include <wblib/json_utils.h>
+
+#include "confed_protocol_schemas_map.h"
+#include "rpc/rpc_config.h"
+#include "serial_config.h"
+
+namespace
+{
+    const size_t GENERATED_CONFIG_PORTS = 8;
+    const size_t GENERATED_CONFIG_DEVICES_PER_PORT = 32;
+    const std::vector<std::string> GENERATED_CONFIG_DEVICE_TYPES = {"WB-MCM16", "WB-MDM2", "WB-M1W2"};
+
+    Json::Value GenerateConfig()
+    {
+        Json::Value config;
+        config["debug"] = false;
+        auto& ports = config["ports"];
+        for (size_t portIndex = 0; portIndex < GENERATED_CONFIG_PORTS; ++portIndex) {
+            Json::Value port;
+            port["path"] = "/dev/ttyBENCH" + std::to_string(portIndex);
+            port["baud_rate"] = 115200;
+            port["parity"] = "N";
+            port["data_bits"] = 8;
+            port["stop_bits"] = 2;
+            for (size_t i = 0; i < GENERATED_CONFIG_DEVICES_PER_PORT; ++i) {
+                Json::Value device;
+                device["device_type"] = GENERATED_CONFIG_DEVICE_TYPES[i % GENERATED_CONFIG_DEVICE_TYPES.size()];
+                device["slave_id"] = std::to_string(i + 1);
+                port["devices"].append(device);
+            }
+            ports.append(port);
+        }
+        return config;
+    }
+}
+
+void RegisterConfigBenchmarks(TBenchmarks& benchmarks, const std::string& dataDir)
+{
+    auto commonDeviceSchema =
+        std::make_shared<Json::Value>(WBMQTT::JSON::Parse(dataDir + "/wb-mqtt-serial-confed-common.schema.json"));
+    auto templatesSchema = std::make_shared<Json::Value>(
+        LoadConfigTemplatesSchema(dataDir + "/wb-mqtt-serial-device-template.schema.json", *commonDeviceSchema));
+    auto templatesDir = dataDir + "/templates";
+
+    benchmarks.Add("TTemplateMap::AddTemplatesDir", [templatesSchema, templatesDir](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            TTemplateMap templates(*templatesSchema);
+            templates.AddTemplatesDir(templatesDir);
+            DoNotOptimize(templates);
+        }
+    });
+
+    // Templates are parsed and validated on first access
+    benchmarks.Add("TTemplateMap::GetTemplates/parse_all", [templatesSchema, templatesDir](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            TTemplateMap templates(*templatesSchema);
+            templates.AddTemplatesDir(templatesDir);
+            for (const auto& deviceTemplate: templates.GetTemplates()) {
+                DoNotOptimize(deviceTemplate->GetTemplate());
+            }
+        }
+    });
+
+    // Serial ports are not opened by LoadConfig, so the generated config doesn't need real ports
+    auto configFile = (std::filesystem::temp_directory_path() / "wb-mqtt-serial-bench.conf").string();
+    {
+        std::ofstream f(configFile);
+        f << GenerateConfig();
+    }
+    auto portsSchema = std::make_shared<Json::Value>(WBMQTT::JSON::Parse(dataDir + "/wb-mqtt-serial-ports.schema.json"));
+    auto protocolSchemas = std::make_shared<TProtocolConfedSchemasMap>(dataDir + "/protocols", *commonDeviceSchema);
+    auto name = "LoadConfig/" + std::to_string(GENERATED_CONFIG_PORTS) + "_ports_x_" +
+                std::to_string(GENERATED_CONFIG_DEVICES_PER_PORT) + "_devices";
+    benchmarks.Add(name,
+                   [configFile, commonDeviceSchema, templatesSchema, templatesDir, portsSchema, protocolSchemas](
+                       size_t iterations) {
+                       TSerialDeviceFactory deviceFactory;
+                       RegisterProtocols(deviceFactory);
+                       TTemplateMap templates(*templatesSchema);
+                       templates.AddTemplatesDir(templatesDir);
+                       for (size_t i = 0; i < iterations; ++i) {
+                           auto config = LoadConfig(configFile,
+                                                    deviceFactory,
+                                                    *commonDeviceSchema,
+                                                    templates,
+                                                    std::make_shared<TRPCConfig>(),
+                                                    *portsSchema,
+                                                    *protocolSchemas);
+                           DoNotOptimize(config);
+                       }
+                   });
+}
@@ -0,0 +1,46 @@
+#include "benchmark.h"
+
+#include <unordered_map>
+
+#include "expression_evaluator.h"
+
+namespace
+{
+    const std::string EXPRESSION = "(in1_mode==2||in1_mode==3)&&isDefined(in2_mode)&&in2_mode!=1&&counter>=-10";
+
+    class TParams: public Expressions::IParams
+    {
+    public:
+        std::optional<int32_t> Get(const std::string& name) const override
+        {
+            auto it = Values.find(name);
+            if (it == Values.end()) {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+        std::unordered_map<std::string, int32_t> Values = {{"in1_mode", 3}, {"in2_mode", 2}, {"counter", 0}};
+    };
+}
+
+void RegisterExpressionsBenchmarks(TBenchmarks& benchmarks)
+{
+    benchmarks.Add("Expressions::TParser::Parse", [](size_t iterations) {
+        Expressions::TParser parser;
+        for (size_t i = 0; i < iterations; ++i) {
+            auto ast = parser.Parse(EXPRESSION);
+            DoNotOptimize(ast);
+        }
+    });
+
+    benchmarks.Add("Expressions::Eval", [](size_t iterations) {
+        Expressions::TParser parser;
+        auto ast = parser.Parse(EXPRESSION);
+        TParams params;
+        for (size_t i = 0; i < iterations; ++i) {
+            auto res = Expressions::Eval(ast.get(), params);
+            DoNotOptimize(res);
+        }
+    });
+}
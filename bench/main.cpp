@@ -0,0 +1,163 @@
+#include "benchmark.h"
+#include "log.h"
+
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+#include <wblib/json_utils.h>
+#include <wblib/wbmqtt.h>
+
+#define STR(x) #x
+#define XSTR(x) STR(x)
+
+using namespace std;
+
+namespace
+{
+    const auto APP_NAME = "wb-mqtt-serial-bench";
+
+    void PrintUsage()
+    {
+        cout << "Usage:" << endl
+             << " " << APP_NAME << " [options]" << endl
+             << "Options:" << endl
+             << "  -o       file      write results in JSON format to the file" << endl
+             << "  -b       file      compare results with previously saved JSON file" << endl
+             << "  -f       filter    run only benchmarks which names contain the filter" << endl
+             << "  -t       ms        minimal duration of one measurement (default: 200)" << endl
+             << "  -r       count     number of measurements of every benchmark (default: 5)" << endl
+             << "  -D       dir       directory with schemas, templates and protocols (default: .)" << endl
+             << "  -H       IP        MQTT broker IP, enables MQTT benchmarks for comparison with shared memory access"
+             << endl
+             << "  -p       port      MQTT broker port (default: 1883)" << endl
+             << "  -d       level     1 - enable debug messages, -1 - silent mode" << endl;
+    }
+
+    map<string, double> LoadBaseline(const string& fileName)
+    {
+        map<string, double> res;
+        auto baseline = WBMQTT::JSON::Parse(fileName);
+        for (const auto& item: baseline["benchmarks"]) {
+            res[item["name"].asString()] = item["ns_per_op"].asDouble();
+        }
+        return res;
+    }
+
+    void PrintResults(const vector<TBenchmarkResult>& results, const map<string, double>& baseline)
+    {
+        for (const auto& result: results) {
+            cout << left << setw(64) << result.Name << right << setw(16) << fixed << setprecision(1) << result.NsPerOp
+                 << " ns/op";
+            auto it = baseline.find(result.Name);
+            if (it != baseline.end() && it->second > 0) {
+                cout << setw(10) << showpos << setprecision(1) << (result.NsPerOp / it->second - 1) * 100 << "%"
+                     << noshowpos;
+            }
+            cout << endl;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TBenchmarkSettings settings;
+    string outputFile;
+    string baselineFile;
+    string dataDir = ".";
+    WBMQTT::TMosquittoMqttConfig mqttConfig;
+    bool useMqtt = false;
+
+    int c;
+    try {
+        while ((c = getopt(argc, argv, "o:b:f:t:r:D:H:p:d:")) != -1) {
+            switch (c) {
+                case 'o':
+                    outputFile = optarg;
+                    break;
+                case 'b':
+                    baselineFile = optarg;
+                    break;
+                case 'f':
+                    settings.Filter = optarg;
+                    break;
+                case 't':
+                    settings.MinTime = chrono::milliseconds(stoul(optarg));
+                    break;
+                case 'r':
+                    settings.Repetitions = stoul(optarg);
+                    break;
+                case 'D':
+                    dataDir = optarg;
+                    break;
+                case 'H':
+                    mqttConfig.Host = optarg;
+                    useMqtt = true;
+                    break;
+                case 'p':
+                    mqttConfig.Port = stoi(optarg);
+                    break;
+                case 'd':
+                    if (stoi(optarg) < 0) {
+                        Info.SetEnabled(false);
+                        Warn.SetEnabled(false);
+                    } else if (stoi(optarg) > 0) {
+                        Debug.SetEnabled(true);
+                    }
+                    break;
+                default:
+                    PrintUsage();
+                    return 2;
+            }
+        }
+    } catch (const exception& e) {
+        cerr << "Invalid option value: " << e.what() << endl;
+        PrintUsage();
+        return 2;
+    }
+
+    try {
+        map<string, double> baseline;
+        if (!baselineFile.empty()) {
+            baseline = LoadBaseline(baselineFile);
+        }
+
+        TBenchmarks benchmarks;
+        RegisterCodecBenchmarks(benchmarks);
+        RegisterModbusBenchmarks(benchmarks, dataDir);
+        RegisterSchedulerBenchmarks(benchmarks);
+        RegisterExpressionsBenchmarks(benchmarks);
+        RegisterConfigBenchmarks(benchmarks, dataDir);
+        RegisterValueSnapshotBenchmarks(benchmarks);
+        RegisterWriteQueueBenchmarks(benchmarks);
+        if (useMqtt) {
+            RegisterMqttBenchmarks(benchmarks, mqttConfig);
+        }
+
+        auto results = benchmarks.Run(settings);
+        PrintResults(results, baseline);
+
+        if (!outputFile.empty()) {
+            Json::Value report;
+            report["version"] = XSTR(WBMQTT_VERSION);
+            report["commit"] = XSTR(WBMQTT_COMMIT);
+            report["min_time_ms"] = Json::Int64(settings.MinTime.count());
+            report["repetitions"] = Json::UInt64(settings.Repetitions);
+            report["benchmarks"] = BenchmarkResultsToJson(results);
+
+            Json::StreamWriterBuilder builder;
+            builder["indentation"] = "  ";
+            builder["precision"] = 15;
+            unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+            ofstream f(outputFile);
+            writer->write(report, &f);
+            f << endl;
+        }
+    } catch (const exception& e) {
+        cerr << "Benchmark failed: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "benchmark.h"
+
+#include "devices/modbus_device.h"
+#include "modbus_common.h"
+#include "modbus_read_planner.h"
+#include "port/serial_port.h"
+#include "serial_config.h"
+
+#include <algorithm>
+#include <wblib/json_utils.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    std::shared_ptr<TModbusDevice> MakeDevice(TSerialDeviceFactory& deviceFactory)
+    {
+        TModbusDeviceConfig config;
+        config.CommonConfig = std::make_shared<TDeviceConfig>("bench", "1", "modbus");
+        config.CommonConfig->MaxReadRegisters = Modbus::MAX_READ_REGISTERS;
+        config.CommonConfig->MaxRegHole = Modbus::MAX_HOLE_CONTINUOUS_16_BIT_REGISTERS;
+        config.CommonConfig->MaxBitHole = Modbus::MAX_HOLE_CONTINUOUS_1_BIT_REGISTERS;
+        return std::make_shared<TModbusDevice>(std::make_unique<Modbus::TModbusRTUTraits>(),
+                                               config,
+                                               deviceFactory.GetProtocol("modbus"));
+    }
+
+    void AddRangeBenchmark(TBenchmarks& benchmarks,
+                           const std::string& name,
+                           Modbus::RegisterType type,
+                           size_t count,
+                           size_t step)
+    {
+        auto deviceFactory = std::make_shared<TSerialDeviceFactory>();
+        TModbusDevice::Register(*deviceFactory);
+        auto device = MakeDevice(*deviceFactory);
+        std::vector<PRegister> registers;
+        for (size_t i = 0; i < count; ++i) {
+            auto reg = device->AddRegister(TRegisterConfig::Create(type, i * step));
+            // Registers with unknown availability are read one by one, so make them available as after first poll
+            reg->SetAvailable(TRegisterAvailability::AVAILABLE);
+            registers.push_back(reg);
+        }
+        auto port = std::make_shared<TSerialPort>(TSerialPortSettings("bench", TSerialPortConnectionSettings(115200)));
+
+        benchmarks.Add("TModbusRegisterRange::Add/" + name, [deviceFactory, device, registers, port](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                auto range = device->CreateRegisterRange();
+                for (const auto& reg: registers) {
+                    if (!range->Add(*port, reg, std::chrono::milliseconds::max())) {
+                        break;
+                    }
+                }
+                DoNotOptimize(range);
+            }
+        });
+    }
+
+    void AddDecodeBenchmark(TBenchmarks& benchmarks, const std::string& name, RegisterFormat format)
+    {
+        std::vector<uint8_t> data(Modbus::MAX_READ_REGISTERS * 2);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<uint8_t>(i);
+        }
+        auto config = TRegisterConfig::Create(Modbus::REG_INPUT, 0, format);
+        auto width = config->Get16BitWidth();
+
+        benchmarks.Add("TReadResponseWords/" + name, [data, config, width](size_t iterations) {
+            Modbus::TRegisterCache cache;
+            for (size_t i = 0; i < iterations; ++i) {
+                Modbus::TReadResponseWords words(data);
+                for (uint32_t index = 0; index + width <= Modbus::MAX_READ_REGISTERS; index += width) {
+                    auto value = words.GetRegisterValue(*config, index, cache);
+                    DoNotOptimize(value);
+                }
+            }
+        });
+    }
+
+    void AddReadPlanBenchmark(TBenchmarks& benchmarks,
+                              const std::string& name,
+                              const std::vector<Modbus::TReadPlanItem>& items)
+    {
+        // 9600 baud, 1 ms response time
+        Modbus::TReadCostModel model;
+        model.ByteTime = 11 * 1000000.0 / 9600;
+        model.RequestOverhead = std::chrono::microseconds(static_cast<int>(16.5 * model.ByteTime)) + 1ms;
+        model.MaxRegisters = Modbus::MAX_READ_REGISTERS;
+        model.MaxHole = Modbus::MAX_HOLE_CONTINUOUS_16_BIT_REGISTERS;
+
+        benchmarks.Add("PlanReadRequests/" + name, [items, model](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                auto plan = Modbus::PlanReadRequests(items, model);
+                DoNotOptimize(plan);
+            }
+        });
+    }
+
+    //! Registers of the type from a device template, sorted by address
+    std::vector<Modbus::TReadPlanItem> LoadTemplateReadPlanItems(const std::string& fileName,
+                                                                 const std::string& registerType)
+    {
+        auto templateJson = WBMQTT::JSON::Parse(fileName);
+        std::vector<Modbus::TReadPlanItem> items;
+        for (const auto& channel: templateJson["device"]["channels"]) {
+            if (!channel.isMember("address") || channel.get("reg_type", "").asString() != registerType) {
+                continue;
+            }
+            auto format = channel.get("format", "u16").asString();
+            uint32_t width = 1;
+            if (format == "s32" || format == "u32" || format == "float") {
+                width = 2;
+            } else if (format == "s64" || format == "u64" || format == "double") {
+                width = 4;
+            }
+            items.push_back({static_cast<uint32_t>(std::stoul(channel["address"].asString(), nullptr, 0)), width});
+        }
+        std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) { return a.Address < b.Address; });
+        // Channels reading parts of the same register are read once
+        items.erase(std::unique(items.begin(),
+                                items.end(),
+                                [](const auto& a, const auto& b) { return a.Address == b.Address; }),
+                    items.end());
+        return items;
+    }
+}
+
+void RegisterModbusBenchmarks(TBenchmarks& benchmarks, const std::string& dataDir)
+{
+    AddRangeBenchmark(benchmarks, "holding_x125", Modbus::REG_HOLDING, Modbus::MAX_READ_REGISTERS, 1);
+    AddRangeBenchmark(benchmarks, "holding_x60_with_holes", Modbus::REG_HOLDING, 60, 2);
+    AddRangeBenchmark(benchmarks, "coil_x256", Modbus::REG_COIL, 256, 1);
+    AddDecodeBenchmark(benchmarks, "u16_x125", U16);
+    AddDecodeBenchmark(benchmarks, "float_x62", Float);
+
+    // Registers of every third address, so every hole can be either read or skipped
+    std::vector<Modbus::TReadPlanItem> sparseItems;
+    for (uint32_t i = 0; i < 500; ++i) {
+        sparseItems.push_back({i * 3, 1});
+    }
+    AddReadPlanBenchmark(benchmarks, "sparse_x500", sparseItems);
+    AddReadPlanBenchmark(benchmarks,
+                         "map3e_input",
+                         LoadTemplateReadPlanItems(dataDir + "/templates/config-map3e.json", "input"));
+}
@@ -0,0 +1,35 @@
+#include "benchmark.h"
+
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+#include <wblib/wbmqtt.h>
+
+void RegisterMqttBenchmarks(TBenchmarks& benchmarks, const WBMQTT::TMosquittoMqttConfig& mqttConfig)
+{
+    auto config = mqttConfig;
+    config.Id = "wb-mqtt-serial-bench-" + std::to_string(getpid());
+    auto mqtt = WBMQTT::NewMosquittoMqttClient(config);
+    mqtt->Start();
+
+    // Same path as value delivery from the driver to a subscriber of /devices/+/controls/+
+    auto topic = "/tmp/" + config.Id + "/value";
+    auto received = std::make_shared<std::atomic<size_t>>(0);
+    mqtt->Subscribe([received](const WBMQTT::TMqttMessage& message) { received->store(std::stoul(message.Payload)); },
+                    topic);
+
+    benchmarks.Add("MQTT/publish_to_subscribe_round_trip", [mqtt, topic, received](size_t iterations) {
+        for (size_t i = 1; i <= iterations; ++i) {
+            mqtt->Publish(WBMQTT::TMqttMessage(topic, std::to_string(i), 0, false));
+            while (received->load() != i) {
+                std::this_thread::yield();
+            }
+        }
+        // Start next measurement from the beginning
+        mqtt->Publish(WBMQTT::TMqttMessage(topic, "0", 0, false));
+        while (received->load() != 0) {
+            std::this_thread::yield();
+        }
+    });
+}
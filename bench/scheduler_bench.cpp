@@ -0,0 +1,62 @@
+#include "benchmark.h"
+
+#include "poll_plan.h"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace
+{
+    struct TAccumulator
+    {
+        std::vector<int> Entries;
+        size_t MaxEntries = 1;
+
+        bool operator()(int entry, TItemAccumulationPolicy policy, milliseconds pollLimit)
+        {
+            if (Entries.size() >= MaxEntries) {
+                return false;
+            }
+            Entries.push_back(entry);
+            return true;
+        }
+    };
+
+    /**
+     * @brief Every iteration selects ready entries and schedules them again,
+     *        as the register poller does on every polling cycle
+     */
+    void AddSchedulerBenchmark(TBenchmarks& benchmarks, size_t entriesCount, size_t entriesPerCycle)
+    {
+        auto name = "TScheduler::AccumulateNext/" + std::to_string(entriesCount) + "_entries/" +
+                    std::to_string(entriesPerCycle) + "_per_cycle";
+        benchmarks.Add(name, [entriesCount, entriesPerCycle](size_t iterations) {
+            TScheduler<int> scheduler(100ms);
+            steady_clock::time_point now;
+            for (size_t i = 0; i < entriesCount; ++i) {
+                auto priority = (i % 2) ? TPriority::Low : TPriority::High;
+                scheduler.AddEntry(i, now + microseconds(i * 100), priority);
+            }
+            TAccumulator accumulator;
+            accumulator.MaxEntries = entriesPerCycle;
+            for (size_t i = 0; i < iterations; ++i) {
+                now = std::max(now + 1ms, scheduler.GetDeadline());
+                accumulator.Entries.clear();
+                scheduler.AccumulateNext(now, accumulator, TItemSelectionPolicy::All);
+                for (auto entry: accumulator.Entries) {
+                    auto priority = (entry % 2) ? TPriority::Low : TPriority::High;
+                    scheduler.UpdateSelectionTime(1ms, priority);
+                    scheduler.AddEntry(entry, now + milliseconds(entriesCount / 10 + entry % 100), priority);
+                }
+            }
+            DoNotOptimize(accumulator.Entries);
+        });
+    }
+}
+
+void RegisterSchedulerBenchmarks(TBenchmarks& benchmarks)
+{
+    AddSchedulerBenchmark(benchmarks, 100, 1);
+    AddSchedulerBenchmark(benchmarks, 10000, 1);
+    AddSchedulerBenchmark(benchmarks, 10000, 20);
+}
@@ -0,0 +1,77 @@
+#include "benchmark.h"
+
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+#include "value_snapshot.h"
+
+namespace
+{
+    const size_t SNAPSHOT_SLOTS = 1000;
+
+    std::shared_ptr<TValueSnapshotWriter> MakeWriter(const std::string& path)
+    {
+        auto writer = std::make_shared<TValueSnapshotWriter>(path, SNAPSHOT_SLOTS);
+        for (size_t i = 0; i < SNAPSHOT_SLOTS; ++i) {
+            writer->AllocateSlot("wb-mr6c_" + std::to_string(i / 10 + 1) + "/K" + std::to_string(i % 10 + 1));
+        }
+        return writer;
+    }
+}
+
+void RegisterValueSnapshotBenchmarks(TBenchmarks& benchmarks)
+{
+    auto path = (std::filesystem::temp_directory_path() / "wb-mqtt-serial-bench.snapshot").string();
+    auto writer = MakeWriter(path);
+    auto reader = std::make_shared<TValueSnapshotReader>(path);
+
+    benchmarks.Add("TValueSnapshotWriter::Update", [writer](size_t iterations) {
+        std::string value = "1234.5";
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            writer->Update(i % SNAPSHOT_SLOTS, value, 0, now);
+        }
+    });
+
+    benchmarks.Add("TValueSnapshotReader::Read", [writer, reader](size_t iterations) {
+        for (size_t i = 0; i < SNAPSHOT_SLOTS; ++i) {
+            writer->Update(i, "1234.5", 0, std::chrono::steady_clock::now());
+        }
+        for (size_t i = 0; i < iterations; ++i) {
+            auto value = reader->Read(i % SNAPSHOT_SLOTS);
+            DoNotOptimize(value);
+        }
+    });
+
+    benchmarks.Add("TValueSnapshotReader::FindSlot/" + std::to_string(SNAPSHOT_SLOTS) + "_slots",
+                   [writer, reader](size_t iterations) {
+                       for (size_t i = 0; i < iterations; ++i) {
+                           auto slot = reader->FindSlot("wb-mr6c_100/K10");
+                           DoNotOptimize(slot);
+                       }
+                   });
+
+    // Time from the value update by a port thread to its observation by a polling consumer and back.
+    // Compare with the same path through MQTT, which is measured by "mqtt" benchmark if a broker is available.
+    benchmarks.Add("ValueSnapshot/update_to_read_round_trip", [writer, reader](size_t iterations) {
+        std::atomic<size_t> ack = 0;
+        std::thread consumer([reader, iterations, &ack]() {
+            for (size_t i = 1; i <= iterations; ++i) {
+                auto expected = std::to_string(i);
+                while (reader->Read(0).Value != expected) {
+                    std::this_thread::yield();
+                }
+                ack.store(i, std::memory_order_release);
+            }
+        });
+        for (size_t i = 1; i <= iterations; ++i) {
+            writer->Update(0, std::to_string(i), 0, std::chrono::steady_clock::now());
+            while (ack.load(std::memory_order_acquire) != i) {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+        writer->Update(0, "0", 0, std::chrono::steady_clock::now());
+    });
+}
@@ -0,0 +1,65 @@
+#include "benchmark.h"
+
+#include <atomic>
+#include <thread>
+
+#include "serial_client_task_queue.h"
+#include "write_channel_serial_client_task.h"
+
+namespace
+{
+    std::vector<PRegisterHandler> MakeHandlers(size_t count)
+    {
+        std::vector<PRegisterHandler> handlers;
+        for (size_t i = 0; i < count; ++i) {
+            auto config = TRegisterConfig::Create(0, i);
+            handlers.push_back(std::make_shared<TRegisterHandler>(std::make_shared<TRegister>(nullptr, config)));
+        }
+        return handlers;
+    }
+
+    // Producers enqueue writes concurrently as MQTT and local API threads do,
+    // the consumer takes tasks as a port thread does, but doesn't run them
+    void AddStressBenchmark(TBenchmarks& benchmarks, size_t producers, size_t registers)
+    {
+        auto handlers = MakeHandlers(registers);
+        benchmarks.Add("TSerialClientTaskQueue::AddWrite/" + std::to_string(producers) + "_producers_" +
+                           std::to_string(registers) + "_registers",
+                       [handlers, producers](size_t iterations) {
+                           TSerialClientTaskQueue queue;
+                           std::atomic_bool done = false;
+                           std::thread consumer([&queue, &done]() {
+                               while (!done) {
+                                   auto tasks = queue.WaitAndTake(std::chrono::steady_clock::now() +
+                                                                  std::chrono::milliseconds(1));
+                                   DoNotOptimize(tasks);
+                               }
+                           });
+                           std::vector<std::thread> threads;
+                           for (size_t p = 0; p < producers; ++p) {
+                               threads.emplace_back([&queue, &handlers, p, producers, iterations]() {
+                                   for (size_t i = p; i < iterations; i += producers) {
+                                       auto& handler = handlers[i % handlers.size()];
+                                       handler->SetTextValue(std::to_string(i % 100));
+                                       queue.AddWrite(std::make_shared<TWriteChannelSerialClientTask>(handler,
+                                                                                                      nullptr,
+                                                                                                      nullptr));
+                                   }
+                               });
+                           }
+                           for (auto& thread: threads) {
+                               thread.join();
+                           }
+                           done = true;
+                           consumer.join();
+                       });
+    }
+}
+
+void RegisterWriteQueueBenchmarks(TBenchmarks& benchmarks)
+{
+    AddStressBenchmark(benchmarks, 1, 1);
+    AddStressBenchmark(benchmarks, 4, 1);
+    AddStressBenchmark(benchmarks, 4, 64);
+    AddStressBenchmark(benchmarks, 16, 64);
+}
@@ -0,0 +1,345 @@
+#include "bus_simulator.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <wblib/json_utils.h>
+
+#include "devices/modbus_device.h"
+#include "modbus_base.h"
+#include "port/feature_port.h"
+#include "serial_client.h"
+#include "serial_config.h"
+#include "simulated_bus.h"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+using namespace WBMQTT::JSON;
+
+#define LOG(logger) logger.Log() << "[sim] "
+
+namespace
+{
+    const size_t MAX_SLAVE_ID = 247;
+
+    // Minimal virtual time step if the scheduler has nothing to do at the moment
+    const auto MIN_CYCLE_TIME = 1ms;
+
+    struct TRegisterStats
+    {
+        steady_clock::time_point LastReadTime;
+        microseconds TotalInterval = microseconds::zero();
+        microseconds MaxInterval = microseconds::zero();
+        size_t Intervals = 0;
+        size_t Reads = 0;
+        size_t Errors = 0;
+    };
+
+    struct TGroupStats
+    {
+        microseconds TotalInterval = microseconds::zero();
+        microseconds MaxInterval = microseconds::zero();
+        size_t Intervals = 0;
+        size_t Reads = 0;
+        size_t Errors = 0;
+
+        void Add(const TRegisterStats& stats)
+        {
+            TotalInterval += stats.TotalInterval;
+            MaxInterval = std::max(MaxInterval, stats.MaxInterval);
+            Intervals += stats.Intervals;
+            Reads += stats.Reads;
+            Errors += stats.Errors;
+        }
+    };
+
+    double ToMs(microseconds value)
+    {
+        return value.count() / 1000.0;
+    }
+
+    TSimulatedDeviceGroup LoadDeviceGroup(const Json::Value& data)
+    {
+        TSimulatedDeviceGroup group;
+        Get(data, "name", group.Name);
+        Get(data, "count", group.Count);
+        Get(data, "registers", group.Registers);
+        Get(data, "max_read_registers", group.MaxReadRegisters);
+        if (data.isMember("read_period_ms")) {
+            group.ReadPeriod = milliseconds(data["read_period_ms"].asInt());
+        }
+        Get(data, "response_latency_us", group.ResponseLatency);
+        Get(data, "response_timeout_ms", group.ResponseTimeout);
+        Get(data, "disconnected", group.Disconnected);
+        Get(data, "event_period_ms", group.EventPeriod);
+        if (group.Registers == 0) {
+            throw std::runtime_error("device group \"" + group.Name + "\" has no registers");
+        }
+        return group;
+    }
+
+    TSimulatedPortConfig LoadPortConfig(const Json::Value& data)
+    {
+        TSimulatedPortConfig port;
+        Get(data, "count", port.Count);
+        Get(data, "baud_rate", port.ConnectionSettings.BaudRate);
+        if (data.isMember("parity")) {
+            port.ConnectionSettings.Parity = data["parity"].asCString()[0];
+        }
+        Get(data, "data_bits", port.ConnectionSettings.DataBits);
+        Get(data, "stop_bits", port.ConnectionSettings.StopBits);
+        Get(data, "disconnected_poll_backoff", port.DisconnectedPollSettings.Backoff);
+        Get(data, "disconnected_poll_max_delay_ms", port.DisconnectedPollSettings.MaxDelay);
+        if (data.isMember("disconnected_poll_max_bus_share")) {
+            port.DisconnectedPollSettings.MaxBusShare = data["disconnected_poll_max_bus_share"].asDouble() / 100.0;
+        }
+        for (const auto& groupData: data["devices"]) {
+            port.Groups.push_back(LoadDeviceGroup(groupData));
+        }
+        return port;
+    }
+
+    class TPortSimulation
+    {
+    public:
+        TPortSimulation(const std::string& name,
+                        const TSimulatedPortConfig& config,
+                        TSerialDeviceFactory& deviceFactory,
+                        std::minstd_rand& random)
+            : Config(config)
+        {
+            Bus = std::make_shared<TSimulatedBus>(Clock, TSerialPortSettings(name, config.ConnectionSettings));
+            Port = std::make_shared<TFeaturePort>(Bus, false);
+            Port->Open();
+
+            size_t slaveId = 1;
+            for (size_t groupIndex = 0; groupIndex < config.Groups.size(); ++groupIndex) {
+                const auto& group = config.Groups[groupIndex];
+                for (size_t i = 0; i < group.Count; ++i, ++slaveId) {
+                    if (slaveId > MAX_SLAVE_ID) {
+                        throw std::runtime_error("too many devices on port " + name);
+                    }
+                    auto device = MakeDevice(group, slaveId, deviceFactory);
+                    DeviceGroups[device.get()] = groupIndex;
+                    Devices.push_back(device);
+
+                    TSimulatedSlaveSettings slave;
+                    slave.SlaveId = slaveId;
+                    slave.ResponseLatency = group.ResponseLatency;
+                    slave.Disconnected = group.Disconnected;
+                    if (group.EventPeriod.count() > 0) {
+                        slave.EventPeriod = group.EventPeriod;
+                        std::uniform_int_distribution<microseconds::rep> phase(
+                            0,
+                            duration_cast<microseconds>(group.EventPeriod).count() - 1);
+                        slave.EventPhase = microseconds(phase(random));
+                    }
+                    Bus->AddSlave(slave);
+                }
+            }
+
+            Quarantine = std::make_shared<TDisconnectedPollQuarantine>(config.DisconnectedPollSettings);
+            Reader = std::make_unique<TSerialClientRegisterAndEventsReader>(Devices,
+                                                                            GetReadEventsPeriod(*Port),
+                                                                            Clock.GetNowFn(),
+                                                                            std::numeric_limits<size_t>::max(),
+                                                                            Quarantine);
+            LastAccessedDevice = std::make_unique<TSerialClientDeviceAccessHandler>(Reader->GetEventsReader());
+        }
+
+        void Run(microseconds duration)
+        {
+            auto start = Clock.Now();
+            auto end = start + duration;
+            while (Clock.Now() < end) {
+                auto cycleStart = Clock.Now();
+                Reader->OpenPortCycle(*Port, [this](PRegister reg) { ProcessRegister(reg); }, *LastAccessedDevice);
+                auto deadline = std::min(Reader->GetDeadline(Clock.Now()), end);
+                if (Clock.Now() == cycleStart && deadline <= cycleStart) {
+                    deadline = cycleStart + MIN_CYCLE_TIME;
+                }
+                Clock.AdvanceTo(deadline);
+            }
+            Duration = duration_cast<microseconds>(Clock.Now() - start);
+        }
+
+        Json::Value GetReport() const
+        {
+            std::vector<TGroupStats> groups(Config.Groups.size());
+            for (const auto& item: Registers) {
+                auto device = item.first->Device();
+                auto it = DeviceGroups.find(device.get());
+                if (it != DeviceGroups.end()) {
+                    groups[it->second].Add(item.second);
+                }
+            }
+
+            const auto& busStats = Bus->GetStats();
+            Json::Value res;
+            res["port"] = Bus->GetDescription(false);
+            res["bus_utilization"] = Duration.count() ? double(busStats.BusyTime.count()) / Duration.count() : 0.0;
+            res["requests"] = Json::UInt64(busStats.Requests);
+            res["timeouts"] = Json::UInt64(busStats.Timeouts);
+            res["events"] = Json::UInt64(busStats.Events);
+            if (busStats.Events) {
+                res["avg_event_latency_ms"] = ToMs(busStats.TotalEventLatency / busStats.Events);
+                res["max_event_latency_ms"] = ToMs(busStats.MaxEventLatency);
+            }
+            res["disconnected_devices_poll_time_ms"] = ToMs(Quarantine->GetDisconnectedDevicesPollTime());
+
+            auto& groupsReport = res["devices"];
+            groupsReport = Json::Value(Json::arrayValue);
+            for (size_t i = 0; i < groups.size(); ++i) {
+                Json::Value groupReport;
+                groupReport["name"] = Config.Groups[i].Name;
+                if (Config.Groups[i].ReadPeriod) {
+                    groupReport["requested_read_period_ms"] = Json::Int64(Config.Groups[i].ReadPeriod->count());
+                }
+                groupReport["reads"] = Json::UInt64(groups[i].Reads);
+                groupReport["read_errors"] = Json::UInt64(groups[i].Errors);
+                if (groups[i].Intervals) {
+                    groupReport["avg_read_period_ms"] = ToMs(groups[i].TotalInterval / groups[i].Intervals);
+                    groupReport["max_read_period_ms"] = ToMs(groups[i].MaxInterval);
+                }
+                groupsReport.append(groupReport);
+            }
+            return res;
+        }
+
+        const TSimulatedBusStats& GetBusStats() const
+        {
+            return Bus->GetStats();
+        }
+
+        microseconds GetDuration() const
+        {
+            return Duration;
+        }
+
+    private:
+        PSerialDevice MakeDevice(const TSimulatedDeviceGroup& group,
+                                 size_t slaveId,
+                                 TSerialDeviceFactory& deviceFactory)
+        {
+            TModbusDeviceConfig config;
+            config.CommonConfig =
+                std::make_shared<TDeviceConfig>(group.Name + std::to_string(slaveId), std::to_string(slaveId), "modbus");
+            config.CommonConfig->FrameTimeout = 0ms;
+            config.CommonConfig->ResponseTimeout = group.ResponseTimeout;
+            config.CommonConfig->MaxReadRegisters = group.MaxReadRegisters;
+            // Disconnection is detected by failed cycles only, because real time doesn't go in the simulation
+            config.CommonConfig->DeviceTimeout = 0ms;
+
+            auto device = std::make_shared<TModbusDevice>(std::make_unique<Modbus::TModbusRTUTraits>(),
+                                                          config,
+                                                          deviceFactory.GetProtocol("modbus"));
+            for (size_t addr = 0; addr < group.Registers; ++addr) {
+                auto registerConfig = TRegisterConfig::Create(Modbus::REG_HOLDING, addr);
+                if (addr == 0 && group.EventPeriod.count() > 0) {
+                    registerConfig->SporadicMode = TRegisterConfig::TSporadicMode::ONLY_EVENTS;
+                } else {
+                    registerConfig->ReadPeriod = group.ReadPeriod;
+                    device->SetSporadicOnly(false);
+                }
+                device->AddRegister(registerConfig);
+            }
+            return device;
+        }
+
+        void ProcessRegister(PRegister reg)
+        {
+            if (reg->GetConfig()->SporadicMode != TRegisterConfig::TSporadicMode::DISABLED) {
+                return;
+            }
+            auto& stats = Registers[reg];
+            if (reg->GetErrorState().test(TRegister::ReadError)) {
+                ++stats.Errors;
+                return;
+            }
+            auto now = Clock.Now();
+            if (stats.Reads) {
+                auto interval = duration_cast<microseconds>(now - stats.LastReadTime);
+                stats.TotalInterval += interval;
+                stats.MaxInterval = std::max(stats.MaxInterval, interval);
+                ++stats.Intervals;
+            }
+            ++stats.Reads;
+            stats.LastReadTime = now;
+        }
+
+        const TSimulatedPortConfig& Config;
+        TVirtualClock Clock;
+        PSimulatedBus Bus;
+        PFeaturePort Port;
+        std::list<PSerialDevice> Devices;
+        std::unordered_map<const TSerialDevice*, size_t> DeviceGroups;
+        PDisconnectedPollQuarantine Quarantine;
+        std::unique_ptr<TSerialClientRegisterAndEventsReader> Reader;
+        std::unique_ptr<TSerialClientDeviceAccessHandler> LastAccessedDevice;
+        std::unordered_map<PRegister, TRegisterStats> Registers;
+        microseconds Duration = microseconds::zero();
+    };
+}
+
+TSimulationConfig LoadSimulationConfig(const Json::Value& data)
+{
+    TSimulationConfig config;
+    Get(data, "duration_s", config.Duration);
+    Get(data, "seed", config.Seed);
+    for (const auto& portData: data["ports"]) {
+        config.Ports.push_back(LoadPortConfig(portData));
+    }
+    if (config.Ports.empty()) {
+        throw std::runtime_error("no ports in simulation config");
+    }
+    return config;
+}
+
+Json::Value RunSimulation(const TSimulationConfig& config)
+{
+    TSerialDeviceFactory deviceFactory;
+    TModbusDevice::Register(deviceFactory);
+    std::minstd_rand random(config.Seed);
+
+    Json::Value res;
+    auto& portsReport = res["ports"];
+    portsReport = Json::Value(Json::arrayValue);
+
+    TSimulatedBusStats total;
+    microseconds totalDuration = microseconds::zero();
+    size_t portIndex = 0;
+    for (const auto& portConfig: config.Ports) {
+        for (size_t i = 0; i < portConfig.Count; ++i, ++portIndex) {
+            // Ports are independent, so they are simulated one after another
+            TPortSimulation port("sim" + std::to_string(portIndex), portConfig, deviceFactory, random);
+            LOG(Info) << "simulating port sim" << portIndex;
+            port.Run(config.Duration);
+            portsReport.append(port.GetReport());
+
+            const auto& busStats = port.GetBusStats();
+            total.BusyTime += busStats.BusyTime;
+            total.Requests += busStats.Requests;
+            total.Timeouts += busStats.Timeouts;
+            total.Events += busStats.Events;
+            total.TotalEventLatency += busStats.TotalEventLatency;
+            total.MaxEventLatency = std::max(total.MaxEventLatency, busStats.MaxEventLatency);
+            totalDuration += port.GetDuration();
+        }
+    }
+
+    auto& totalReport = res["total"];
+    totalReport["ports"] = Json::UInt64(portIndex);
+    totalReport["duration_s"] = Json::Int64(config.Duration.count());
+    totalReport["avg_bus_utilization"] =
+        totalDuration.count() ? double(total.BusyTime.count()) / totalDuration.count() : 0.0;
+    totalReport["requests"] = Json::UInt64(total.Requests);
+    totalReport["timeouts"] = Json::UInt64(total.Timeouts);
+    totalReport["events"] = Json::UInt64(total.Events);
+    if (total.Events) {
+        totalReport["avg_event_latency_ms"] = ToMs(total.TotalEventLatency / total.Events);
+        totalReport["max_event_latency_ms"] = ToMs(total.MaxEventLatency);
+    }
+    return res;
+}
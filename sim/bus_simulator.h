@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <wblib/json/json.h>
+
+#include "disconnected_poll_quarantine.h"
+#include "port/serial_port_settings.h"
+
+//! Devices of the same kind connected to a simulated port
+struct TSimulatedDeviceGroup
+{
+    std::string Name;
+    size_t Count = 1;
+
+    //! Number of holding registers polled by the driver
+    size_t Registers = 1;
+
+    //! Maximum number of registers in one read request
+    int MaxReadRegisters = 1;
+
+    //! Read period of registers, registers are polled as fast as possible if not set
+    std::optional<std::chrono::milliseconds> ReadPeriod;
+
+    std::chrono::microseconds ResponseLatency = std::chrono::microseconds(1000);
+    std::chrono::milliseconds ResponseTimeout = std::chrono::milliseconds(500);
+
+    //! Devices don't answer any request
+    bool Disconnected = false;
+
+    //! Period of Fast Modbus events from every device, zero disables events
+    std::chrono::milliseconds EventPeriod = std::chrono::milliseconds::zero();
+};
+
+struct TSimulatedPortConfig
+{
+    //! Number of identical ports
+    size_t Count = 1;
+
+    TSerialPortConnectionSettings ConnectionSettings;
+    TDisconnectedPollSettings DisconnectedPollSettings;
+    std::vector<TSimulatedDeviceGroup> Groups;
+};
+
+struct TSimulationConfig
+{
+    //! Virtual time of the simulation
+    std::chrono::seconds Duration = std::chrono::seconds(60);
+
+    //! Seed for random phases of device events
+    uint32_t Seed = 1;
+
+    std::vector<TSimulatedPortConfig> Ports;
+};
+
+TSimulationConfig LoadSimulationConfig(const Json::Value& data);
+
+/**
+ * @brief Runs the driver's polling scheduler against simulated buses in virtual time.
+ *        Every port has its own virtual clock, so results don't depend on the host speed
+ *        and are the same for the same config.
+ *
+ * @return report with achieved read periods, event latencies and bus utilization
+ */
+Json::Value RunSimulation(const TSimulationConfig& config);
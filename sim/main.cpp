@@ -0,0 +1,80 @@
+#include "bus_simulator.h"
+#include "log.h"
+
+#include <getopt.h>
+#include <iostream>
+
+#include <wblib/json_utils.h>
+
+using namespace std;
+
+namespace
+{
+    const auto APP_NAME = "wb-mqtt-serial-sim";
+
+    void PrintUsage()
+    {
+        cout << "Usage:" << endl
+             << " " << APP_NAME << " [options] scenario.json" << endl
+             << "Runs polling scheduler of wb-mqtt-serial against simulated RS-485 buses in virtual time" << endl
+             << "and prints JSON report to stdout" << endl
+             << "Options:" << endl
+             << "  -d       level     debugging output:" << endl
+             << "                       1 - enable debug messages;" << endl
+             << "                       -1 - silent mode" << endl;
+    }
+
+    void SetDebugLevel(const char* optarg)
+    {
+        try {
+            switch (stoi(optarg)) {
+                case 0:
+                    return;
+                case -1:
+                    Info.SetEnabled(false);
+                    Warn.SetEnabled(false);
+                    return;
+                case 1:
+                    Debug.SetEnabled(true);
+                    return;
+            }
+        } catch (...) {
+        }
+        cerr << "Invalid -d parameter value " << optarg << endl;
+        PrintUsage();
+        exit(2);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int c;
+    while ((c = getopt(argc, argv, "d:")) != -1) {
+        switch (c) {
+            case 'd':
+                SetDebugLevel(optarg);
+                break;
+            default:
+                PrintUsage();
+                return 2;
+        }
+    }
+    if (optind + 1 != argc) {
+        PrintUsage();
+        return 2;
+    }
+
+    try {
+        auto report = RunSimulation(LoadSimulationConfig(WBMQTT::JSON::Parse(argv[optind])));
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "  ";
+        builder["precision"] = 15;
+        unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+        writer->write(report, &cout);
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Simulation failed: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,397 @@
+#include "simulated_bus.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "bin_utils.h"
+#include "crc16.h"
+#include "modbus_base.h"
+#include "serial_exc.h"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+using namespace BinUtils;
+
+namespace
+{
+    const uint8_t BROADCAST_ADDRESS = 0xFD;
+    const uint8_t FAST_MODBUS_COMMAND = 0x46;
+    const uint8_t EVENTS_REQUEST_COMMAND = 0x10;
+    const uint8_t HAS_EVENTS_RESPONSE_COMMAND = 0x11;
+    const uint8_t NO_EVENTS_RESPONSE_COMMAND = 0x12;
+    const uint8_t ENABLE_EVENTS_COMMAND = 0x18;
+    const uint8_t HOLDING_EVENT_TYPE = 3;
+
+    const size_t CRC_SIZE = 2;
+    const size_t RTU_HEADER_SIZE = 1;
+
+    // 0x46 0x10 StartingSlaveId MaxBytes ConfirmSlaveId ConfirmFlag
+    const size_t READ_EVENTS_REQUEST_PDU_SIZE = 6;
+
+    // Type AddrHi AddrLo Count
+    const size_t ENABLE_EVENTS_RECORD_HEADER_SIZE = 4;
+
+    std::vector<uint8_t> MakeExceptionPdu(uint8_t function, uint8_t code)
+    {
+        return {static_cast<uint8_t>(function | Modbus::EXCEPTION_BIT), code};
+    }
+}
+
+//==========================================================
+//              TVirtualClock
+//==========================================================
+
+steady_clock::time_point TVirtualClock::Now() const
+{
+    return Time;
+}
+
+void TVirtualClock::Advance(microseconds interval)
+{
+    if (interval.count() > 0) {
+        Time += interval;
+    }
+}
+
+void TVirtualClock::AdvanceTo(steady_clock::time_point time)
+{
+    Time = std::max(Time, time);
+}
+
+util::TGetNowFn TVirtualClock::GetNowFn()
+{
+    return [this]() { return Now(); };
+}
+
+//==========================================================
+//              TSimulatedBus
+//==========================================================
+
+TSimulatedBus::TSimulatedBus(TVirtualClock& clock, const TSerialPortSettings& settings)
+    : Clock(clock),
+      Settings(settings)
+{}
+
+void TSimulatedBus::AddSlave(const TSimulatedSlaveSettings& settings)
+{
+    TSlave slave;
+    slave.Settings = settings;
+    slave.NextEventTime = steady_clock::time_point() + settings.EventPhase;
+    Slaves[settings.SlaveId] = slave;
+}
+
+const TSimulatedBusStats& TSimulatedBus::GetStats() const
+{
+    return Stats;
+}
+
+void TSimulatedBus::Open()
+{
+    PortIsOpen = true;
+}
+
+void TSimulatedBus::Close()
+{
+    PortIsOpen = false;
+}
+
+bool TSimulatedBus::IsOpen() const
+{
+    return PortIsOpen;
+}
+
+void TSimulatedBus::CheckPortOpen() const
+{
+    if (!PortIsOpen) {
+        throw TSerialDeviceException("port not open");
+    }
+}
+
+void TSimulatedBus::WriteBytes(const uint8_t* buf, int count)
+{
+    CheckPortOpen();
+    auto sendTime = GetSendTimeBytes(count);
+    Clock.Advance(sendTime);
+    Stats.BusyTime += sendTime;
+    ++Stats.Requests;
+    LastInteraction = Clock.Now();
+
+    Response.clear();
+    EventSource = nullptr;
+    WaitingForResponse = true;
+    ProcessRequest(buf, count);
+}
+
+uint8_t TSimulatedBus::ReadByte(const microseconds& timeout)
+{
+    CheckPortOpen();
+    Clock.Advance(CalcResponseTimeout(timeout));
+    throw TResponseTimeoutException();
+}
+
+TReadFrameResult TSimulatedBus::ReadFrame(uint8_t* buf,
+                                          size_t count,
+                                          const microseconds& responseTimeout,
+                                          const microseconds& frameTimeout,
+                                          TFrameCompletePred frameComplete)
+{
+    CheckPortOpen();
+    auto timeout = CalcResponseTimeout(responseTimeout);
+    if (Response.empty() || ResponseLatency > timeout) {
+        Clock.Advance(timeout);
+        if (WaitingForResponse) {
+            ++Stats.Timeouts;
+        }
+        WaitingForResponse = false;
+        Response.clear();
+        EventSource = nullptr;
+        LastInteraction = Clock.Now();
+        throw TResponseTimeoutException();
+    }
+
+    TReadFrameResult res;
+    res.Count = std::min(count, Response.size());
+    res.ResponseTime = ResponseLatency;
+    std::copy_n(Response.begin(), res.Count, buf);
+
+    auto sendTime = GetSendTimeBytes(Response.size());
+    Clock.Advance(ResponseLatency + sendTime);
+    Stats.BusyTime += sendTime;
+
+    // Real port waits for silence on the line if the frame is not recognized as complete
+    if (!frameComplete || !frameComplete(buf, res.Count)) {
+        Clock.Advance(frameTimeout);
+    }
+
+    if (EventSource) {
+        auto latency = duration_cast<microseconds>(Clock.Now() - EventSource->NextEventTime);
+        ++Stats.Events;
+        Stats.TotalEventLatency += latency;
+        Stats.MaxEventLatency = std::max(Stats.MaxEventLatency, latency);
+        EventSource->NextEventTime = GetNextEventTime(*EventSource, EventSnapshotTime);
+        EventSource = nullptr;
+    }
+
+    WaitingForResponse = false;
+    Response.clear();
+    LastInteraction = Clock.Now();
+    return res;
+}
+
+void TSimulatedBus::SkipNoise()
+{}
+
+void TSimulatedBus::SleepSinceLastInteraction(const microseconds& us)
+{
+    Clock.AdvanceTo(LastInteraction + us);
+}
+
+microseconds TSimulatedBus::GetSendTimeBytes(double bytesNumber) const
+{
+    size_t bitsPerByte = 1 + Settings.DataBits + Settings.StopBits;
+    if (Settings.Parity != 'N') {
+        ++bitsPerByte;
+    }
+    return GetSendTimeBits(std::ceil(bitsPerByte * bytesNumber));
+}
+
+microseconds TSimulatedBus::GetSendTimeBits(size_t bitsNumber) const
+{
+    auto us = std::ceil(bitsNumber * 1000000.0 / double(Settings.BaudRate));
+    return microseconds(static_cast<microseconds::rep>(us));
+}
+
+std::string TSimulatedBus::GetDescription(bool verbose) const
+{
+    if (verbose) {
+        return Settings.ToString();
+    }
+    return Settings.Device;
+}
+
+void TSimulatedBus::ProcessRequest(const uint8_t* buf, size_t size)
+{
+    if (size < RTU_HEADER_SIZE + 1 + CRC_SIZE) {
+        return;
+    }
+    auto crc = GetBigEndian<uint16_t>(buf + size - CRC_SIZE, buf + size);
+    if (crc != CRC16::CalculateCRC16(buf, size - CRC_SIZE)) {
+        return;
+    }
+    auto slaveId = buf[0];
+    const uint8_t* pdu = buf + RTU_HEADER_SIZE;
+    size_t pduSize = size - RTU_HEADER_SIZE - CRC_SIZE;
+
+    if (slaveId == BROADCAST_ADDRESS && pduSize > 1 && pdu[0] == FAST_MODBUS_COMMAND &&
+        pdu[1] == EVENTS_REQUEST_COMMAND)
+    {
+        ProcessReadEventsRequest(pdu, pduSize);
+        return;
+    }
+
+    auto it = Slaves.find(slaveId);
+    if (it == Slaves.end() || it->second.Settings.Disconnected) {
+        return;
+    }
+    SetResponse(slaveId, ProcessModbusRequest(it->second, pdu, pduSize), it->second.Settings.ResponseLatency);
+}
+
+std::vector<uint8_t> TSimulatedBus::ProcessModbusRequest(TSlave& slave, const uint8_t* pdu, size_t size)
+{
+    auto function = pdu[0];
+    if (function == FAST_MODBUS_COMMAND && size > 1 && pdu[1] == ENABLE_EVENTS_COMMAND) {
+        return ProcessEnableEventsRequest(slave, pdu, size);
+    }
+    if (size < Modbus::READ_REQUEST_PDU_SIZE) {
+        return MakeExceptionPdu(function, Modbus::ILLEGAL_FUNCTION);
+    }
+    auto addr = GetFromBigEndian<uint16_t>(pdu + 1);
+    auto count = GetFromBigEndian<uint16_t>(pdu + 3);
+    switch (function) {
+        case Modbus::FN_READ_COILS:
+        case Modbus::FN_READ_DISCRETE: {
+            std::vector<uint8_t> res{function, static_cast<uint8_t>((count + 7) / 8)};
+            res.resize(res.size() + res[1]);
+            return res;
+        }
+        case Modbus::FN_READ_HOLDING:
+        case Modbus::FN_READ_INPUT: {
+            std::vector<uint8_t> res{function, static_cast<uint8_t>(count * 2)};
+            auto it = std::back_inserter(res);
+            for (uint16_t i = 0; i < count; ++i) {
+                uint16_t value = (function == Modbus::FN_READ_HOLDING) ? GetRegisterValue(slave, addr + i) : addr + i;
+                AppendBigEndian(it, value);
+            }
+            return res;
+        }
+        case Modbus::FN_WRITE_SINGLE_COIL:
+        case Modbus::FN_WRITE_SINGLE_REGISTER: {
+            return std::vector<uint8_t>(pdu, pdu + Modbus::WRITE_SINGLE_PDU_SIZE);
+        }
+        case Modbus::FN_WRITE_MULTIPLE_COILS:
+        case Modbus::FN_WRITE_MULTIPLE_REGISTERS: {
+            return std::vector<uint8_t>(pdu, pdu + Modbus::WRITE_RESPONSE_PDU_SIZE);
+        }
+        default: {
+            return MakeExceptionPdu(function, Modbus::ILLEGAL_FUNCTION);
+        }
+    }
+}
+
+std::vector<uint8_t> TSimulatedBus::ProcessEnableEventsRequest(TSlave& slave, const uint8_t* pdu, size_t size)
+{
+    // 0x46 0x18 DataSize (Type AddrHi AddrLo Count Priority[Count])...
+    std::vector<uint8_t> res{FAST_MODBUS_COMMAND, ENABLE_EVENTS_COMMAND, 0};
+    const uint8_t* record = pdu + 3;
+    const uint8_t* end = pdu + std::min(size, static_cast<size_t>(pdu[2]) + 3);
+    while (record + ENABLE_EVENTS_RECORD_HEADER_SIZE <= end) {
+        auto type = record[0];
+        auto addr = GetFromBigEndian<uint16_t>(record + 1);
+        size_t count = record[3];
+        const uint8_t* priorities = record + ENABLE_EVENTS_RECORD_HEADER_SIZE;
+        if (priorities + count > end) {
+            break;
+        }
+        // Every record starts a new byte in the response bit mask
+        size_t maskStart = res.size();
+        res.resize(maskStart + (count + 7) / 8);
+        for (size_t i = 0; i < count; ++i) {
+            if (type != HOLDING_EVENT_TYPE || addr + i != slave.Settings.EventRegister ||
+                slave.Settings.EventPeriod.count() == 0)
+            {
+                continue;
+            }
+            slave.EventsEnabled = (priorities[i] != 0);
+            if (slave.EventsEnabled) {
+                res[maskStart + i / 8] |= (1 << (i % 8));
+                // Current value is read by polling, so only next changes are reported
+                slave.NextEventTime = GetNextEventTime(slave, Clock.Now());
+            }
+        }
+        record = priorities + count;
+    }
+    res[2] = res.size() - 3;
+    return res;
+}
+
+void TSimulatedBus::ProcessReadEventsRequest(const uint8_t* pdu, size_t size)
+{
+    if (size < READ_EVENTS_REQUEST_PDU_SIZE) {
+        return;
+    }
+
+    // Arbitration starts from the slave requested by the client to share the bus between slaves
+    auto it = Slaves.lower_bound(pdu[2]);
+    TSlave* source = nullptr;
+    for (size_t i = 0; i < Slaves.size(); ++i, ++it) {
+        if (it == Slaves.end()) {
+            it = Slaves.begin();
+        }
+        if (HasPendingEvent(it->second)) {
+            source = &it->second;
+            break;
+        }
+    }
+
+    if (!source) {
+        SetResponse(BROADCAST_ADDRESS, {FAST_MODBUS_COMMAND, NO_EVENTS_RESPONSE_COMMAND}, GetArbitrationTime());
+        return;
+    }
+
+    auto addr = source->Settings.EventRegister;
+    // Flag, one event, event record: DataSize Type IdHi IdLo ValueHi ValueLo
+    std::vector<uint8_t> res{FAST_MODBUS_COMMAND, HAS_EVENTS_RESPONSE_COMMAND, 0, 1, 6, 2, HOLDING_EVENT_TYPE};
+    auto back = std::back_inserter(res);
+    AppendBigEndian(back, addr);
+    AppendBigEndian(back, GetRegisterValue(*source, addr));
+    SetResponse(source->Settings.SlaveId, res, GetArbitrationTime());
+    EventSource = source;
+    EventSnapshotTime = Clock.Now();
+}
+
+void TSimulatedBus::SetResponse(uint8_t slaveId, const std::vector<uint8_t>& pdu, microseconds latency)
+{
+    Response.clear();
+    Response.push_back(slaveId);
+    Response.insert(Response.end(), pdu.begin(), pdu.end());
+    Response.resize(Response.size() + CRC_SIZE);
+    WriteAs2Bytes(&Response[Response.size() - CRC_SIZE],
+                  CRC16::CalculateCRC16(Response.data(), Response.size() - CRC_SIZE));
+    ResponseLatency = latency;
+}
+
+bool TSimulatedBus::HasPendingEvent(const TSlave& slave) const
+{
+    return slave.EventsEnabled && !slave.Settings.Disconnected && slave.NextEventTime <= Clock.Now();
+}
+
+uint16_t TSimulatedBus::GetRegisterValue(const TSlave& slave, uint16_t addr) const
+{
+    if (addr != slave.Settings.EventRegister || slave.Settings.EventPeriod.count() == 0) {
+        return addr;
+    }
+    // The value is a count of changes since the simulation start
+    auto elapsed = duration_cast<microseconds>(Clock.Now().time_since_epoch()) - slave.Settings.EventPhase;
+    if (elapsed.count() < 0) {
+        return 0;
+    }
+    return static_cast<uint16_t>(elapsed / slave.Settings.EventPeriod + 1);
+}
+
+steady_clock::time_point TSimulatedBus::GetNextEventTime(const TSlave& slave, steady_clock::time_point time) const
+{
+    auto first = steady_clock::time_point() + slave.Settings.EventPhase;
+    if (time < first) {
+        return first;
+    }
+    auto changes = (time - first) / slave.Settings.EventPeriod + 1;
+    return first + changes * slave.Settings.EventPeriod;
+}
+
+microseconds TSimulatedBus::GetArbitrationTime() const
+{
+    // Same as events response timeout used by the driver: command processing time and 9 arbitration slots
+    const auto cmdTime =
+        std::max(GetSendTimeBytes(Modbus::STANDARD_FRAME_TIMEOUT_BYTES), GetSendTimeBits(20) + 800us);
+    return cmdTime + 9 * std::max(GetSendTimeBits(13), GetSendTimeBits(12) + 50us);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include "port/port.h"
+#include "port/serial_port_settings.h"
+
+//! Virtual time source of the simulation. Time changes only when the simulation advances it.
+class TVirtualClock
+{
+public:
+    std::chrono::steady_clock::time_point Now() const;
+
+    void Advance(std::chrono::microseconds interval);
+    void AdvanceTo(std::chrono::steady_clock::time_point time);
+
+    util::TGetNowFn GetNowFn();
+
+private:
+    std::chrono::steady_clock::time_point Time;
+};
+
+struct TSimulatedSlaveSettings
+{
+    uint8_t SlaveId = 1;
+
+    //! Time between the end of a request and the start of a response
+    std::chrono::microseconds ResponseLatency = std::chrono::microseconds(1000);
+
+    //! The slave doesn't answer any request
+    bool Disconnected = false;
+
+    //! Holding register producing Fast Modbus events
+    uint16_t EventRegister = 0;
+
+    //! Period of the event register value change, zero disables events
+    std::chrono::microseconds EventPeriod = std::chrono::microseconds::zero();
+
+    //! Time of the first event register value change since the simulation start
+    std::chrono::microseconds EventPhase = std::chrono::microseconds::zero();
+};
+
+struct TSimulatedBusStats
+{
+    //! Time when request or response bytes were transmitted
+    std::chrono::microseconds BusyTime = std::chrono::microseconds::zero();
+
+    size_t Requests = 0;
+    size_t Timeouts = 0;
+
+    //! Count of delivered Fast Modbus events
+    size_t Events = 0;
+
+    //! Time between the event register value change and the end of the event delivery
+    std::chrono::microseconds TotalEventLatency = std::chrono::microseconds::zero();
+    std::chrono::microseconds MaxEventLatency = std::chrono::microseconds::zero();
+};
+
+/**
+ * @brief RS-485 bus with simulated Modbus RTU slaves.
+ *        The bus doesn't sleep, it advances virtual clock by the time which real transmission would take.
+ *        Byte transmission time is calculated from port settings.
+ *        Slaves answer Modbus read and write requests, Fast Modbus enable events and read events requests.
+ */
+class TSimulatedBus: public TPort
+{
+public:
+    TSimulatedBus(TVirtualClock& clock, const TSerialPortSettings& settings);
+
+    void AddSlave(const TSimulatedSlaveSettings& settings);
+
+    const TSimulatedBusStats& GetStats() const;
+
+    void Open() override;
+    void Close() override;
+    bool IsOpen() const override;
+    void CheckPortOpen() const override;
+
+    void WriteBytes(const uint8_t* buf, int count) override;
+    uint8_t ReadByte(const std::chrono::microseconds& timeout) override;
+    TReadFrameResult ReadFrame(uint8_t* buf,
+                               size_t count,
+                               const std::chrono::microseconds& responseTimeout,
+                               const std::chrono::microseconds& frameTimeout,
+                               TFrameCompletePred frameComplete = 0) override;
+    void SkipNoise() override;
+    void SleepSinceLastInteraction(const std::chrono::microseconds& us) override;
+
+    std::chrono::microseconds GetSendTimeBytes(double bytesNumber) const override;
+    std::chrono::microseconds GetSendTimeBits(size_t bitsNumber) const override;
+
+    std::string GetDescription(bool verbose = true) const override;
+
+private:
+    struct TSlave
+    {
+        TSimulatedSlaveSettings Settings;
+        bool EventsEnabled = false;
+
+        //! Time of the first event register value change not delivered yet
+        std::chrono::steady_clock::time_point NextEventTime;
+    };
+
+    void ProcessRequest(const uint8_t* buf, size_t size);
+    std::vector<uint8_t> ProcessModbusRequest(TSlave& slave, const uint8_t* pdu, size_t size);
+    std::vector<uint8_t> ProcessEnableEventsRequest(TSlave& slave, const uint8_t* pdu, size_t size);
+    void ProcessReadEventsRequest(const uint8_t* pdu, size_t size);
+    void SetResponse(uint8_t slaveId, const std::vector<uint8_t>& pdu, std::chrono::microseconds latency);
+    bool HasPendingEvent(const TSlave& slave) const;
+    uint16_t GetRegisterValue(const TSlave& slave, uint16_t addr) const;
+    std::chrono::steady_clock::time_point GetNextEventTime(const TSlave& slave,
+                                                           std::chrono::steady_clock::time_point time) const;
+    std::chrono::microseconds GetArbitrationTime() const;
+
+    TVirtualClock& Clock;
+    TSerialPortSettings Settings;
+    bool PortIsOpen = false;
+    std::map<uint8_t, TSlave> Slaves;
+    std::chrono::steady_clock::time_point LastInteraction;
+
+    bool WaitingForResponse = false;
+    std::vector<uint8_t> Response;
+    std::chrono::microseconds ResponseLatency = std::chrono::microseconds::zero();
+
+    //! Slave which events are delivered by the pending response
+    TSlave* EventSource = nullptr;
+    std::chrono::steady_clock::time_point EventSnapshotTime;
+
+    TSimulatedBusStats Stats;
+};
+
+typedef std::shared_ptr<TSimulatedBus> PSimulatedBus;
@@ -0,0 +1,65 @@
+#include "batch_reader.h"
+
+#include "log.h"
+#include <algorithm>
+
+#define LOG(logger) logger.Log() << "[batch read] "
+
+bool IBatchReader::ReadBefore(const TRegisterConfig& reg, const TRegisterConfig& other) const
+{
+    return false;
+}
+
+TBatchRegisterRange::TBatchRegisterRange(const IBatchReader& reader): Reader(reader)
+{}
+
+bool TBatchRegisterRange::Add(TPort& port, PRegister reg, std::chrono::milliseconds pollLimit)
+{
+    if (!RegisterList().empty()) {
+        if (RegisterList().front()->Device() != reg->Device()) {
+            return false;
+        }
+        if (!Reader.CanReadInBatch(port, RegisterList(), *reg->GetConfig(), pollLimit)) {
+            return false;
+        }
+    }
+    // Keep order of registers in a request, equal registers are read in order of adding
+    auto it = std::find_if(RegisterList().begin(), RegisterList().end(), [this, &reg](const auto& r) {
+        return Reader.ReadBefore(*reg->GetConfig(), *r->GetConfig());
+    });
+    RegisterList().insert(it, reg);
+    return true;
+}
+
+void ReadBatchRegisterRange(TSerialDevice& device,
+                            IBatchReader& reader,
+                            TPort& port,
+                            PRegisterRange range,
+                            bool breakOnError)
+{
+    std::list<PRegister> regs;
+    std::copy_if(range->RegisterList().begin(),
+                 range->RegisterList().end(),
+                 std::back_inserter(regs),
+                 [](const auto& reg) { return reg->GetAvailable() != TRegisterAvailability::UNAVAILABLE; });
+    if (regs.empty()) {
+        return;
+    }
+
+    try {
+        port.SleepSinceLastInteraction(device.DeviceConfig()->RequestDelay);
+        reader.ReadBatch(port, regs);
+        device.SetTransferResult(true);
+    } catch (const TSerialDeviceException& e) {
+        for (auto& reg: regs) {
+            reg->SetError(TRegister::TError::ReadError);
+        }
+        auto& logger = (device.GetConnectionState() == TDeviceConnectionState::DISCONNECTED) ? Debug : Warn;
+        LOG(logger) << e.what() << " [slave_id is " << device.ToString() + "]";
+        device.SetTransferResult(false);
+        if (breakOnError) {
+            throw;
+        }
+    }
+    device.InvalidateReadCache();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "serial_device.h"
+
+/**
+ * @brief Protocol specific part of reading several registers by one request.
+ *        A device implementing the interface creates TBatchRegisterRange
+ *        and reads it with ReadBatchRegisterRange.
+ */
+class IBatchReader
+{
+public:
+    virtual ~IBatchReader() = default;
+
+    /**
+     * @brief Checks if the register can be read by one request with registers of the batch
+     *
+     * @param batch registers of the batch, not empty
+     * @param reg register to add
+     * @param pollLimit estimated time of the request must not exceed the limit
+     */
+    virtual bool CanReadInBatch(TPort& port,
+                                const std::list<PRegister>& batch,
+                                const TRegisterConfig& reg,
+                                std::chrono::milliseconds pollLimit) const = 0;
+
+    //! Checks if the register must precede the other one in a request
+    virtual bool ReadBefore(const TRegisterConfig& reg, const TRegisterConfig& other) const;
+
+    /**
+     * @brief Reads registers by one request and sets their values or errors.
+     *        Throws TSerialDeviceException if the request has failed.
+     */
+    virtual void ReadBatch(TPort& port, const std::list<PRegister>& regs) = 0;
+};
+
+class TBatchRegisterRange: public TRegisterRange
+{
+public:
+    explicit TBatchRegisterRange(const IBatchReader& reader);
+
+    bool Add(TPort& port, PRegister reg, std::chrono::milliseconds pollLimit) override;
+
+private:
+    const IBatchReader& Reader;
+};
+
+/**
+ * @brief Reads available registers of the range by one request.
+ *        All registers get read error if the request fails.
+ */
+void ReadBatchRegisterRange(TSerialDevice& device,
+                            IBatchReader& reader,
+                            TPort& port,
+                            PRegisterRange range,
+                            bool breakOnError);
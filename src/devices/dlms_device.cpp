@@ -2,9 +2,11 @@
 #include "common_utils.h"
 #include "log.h"
 
+#include <cmath>
 #include <fstream>
 
 #include "GXDLMSConverter.h"
+#include "GXDLMSData.h"
 #include "GXDLMSObject.h"
 #include "GXDLMSObjectFactory.h"
 #include "GXDLMSSapAssignment.h"
@@ -16,6 +18,27 @@ namespace
 {
     const size_t MAX_PACKET_SIZE = 200;
 
+    // Gurux client sends at most 10 attributes in one Get-Request-With-List,
+    // so a range of this size is usually read by one request
+    const size_t MAX_READ_LIST_SIZE = 10;
+
+    // HDLC frames with Get-Request-With-List and Get-Response-With-List headers without attributes
+    const size_t READ_LIST_SERVICE_BYTES = 2 * 19;
+
+    // Class id, logical name, attribute index and access selector of an attribute in a request
+    const size_t READ_LIST_ATTRIBUTE_REQUEST_BYTES = 10;
+
+    // Data access result and data type tag of an attribute value in a response
+    const size_t READ_LIST_ATTRIBUTE_RESPONSE_BYTES = 2;
+
+    const int REGISTER_VALUE_ATTRIBUTE_INDEX = 2;
+    const int REGISTER_SCALER_UNIT_ATTRIBUTE_INDEX = 3;
+    const int DATA_VALUE_ATTRIBUTE_INDEX = 2;
+
+    // Objects identifying the meter for the persistent objects cache
+    const auto SERIAL_NUMBER_LOGICAL_NAME = "0.0.96.1.0.255";
+    const auto FIRMWARE_LOGICAL_NAME = "1.0.0.2.0.255";
+
     const auto OBIS_CODE_HINTS_FULL_FILE_PATH = "/usr/share/wb-mqtt-serial/obis-hints.json";
 
     const std::chrono::milliseconds DLMS_DEFAULT_RESPONSE_TIMEOUT(1000);
@@ -102,6 +125,33 @@ namespace
         }
     };
 
+    class TDlmsRegisterRange: public TRegisterRange
+    {
+    public:
+        bool Add(TPort& port, PRegister reg, std::chrono::milliseconds pollLimit) override
+        {
+            if (RegisterList().size() >= MAX_READ_LIST_SIZE || HasOtherDeviceAndType(reg)) {
+                return false;
+            }
+            // Scalers are read only once, so the estimation counts value attributes only
+            auto bytes = Bytes + READ_LIST_ATTRIBUTE_REQUEST_BYTES + READ_LIST_ATTRIBUTE_RESPONSE_BYTES +
+                         reg->GetConfig()->GetByteWidth();
+            if (!RegisterList().empty()) {
+                auto pollTime = port.GetSendTimeBytes(READ_LIST_SERVICE_BYTES + bytes) +
+                                reg->Device()->DeviceConfig()->RequestDelay + reg->Device()->GetFrameTimeout(port);
+                if (std::chrono::ceil<std::chrono::milliseconds>(pollTime) > pollLimit) {
+                    return false;
+                }
+            }
+            Bytes = bytes;
+            RegisterList().push_back(reg);
+            return true;
+        }
+
+    private:
+        size_t Bytes = 0;
+    };
+
     class TDlmsDeviceFactory: public IDeviceFactory
     {
     public:
@@ -368,7 +418,8 @@ void TDlmsDevice::Register(TSerialDeviceFactory& factory)
 TDlmsDevice::TDlmsDevice(const TDlmsDeviceConfig& config, PProtocol protocol)
     : TSerialDevice(config.DeviceConfig, protocol),
       TUInt32SlaveId(config.DeviceConfig->SlaveId),
-      DisconnectRetryTimeout(config.DisconnectRetryTimeout)
+      DisconnectRetryTimeout(config.DisconnectRetryTimeout),
+      LogicalDeviceAddress(config.LogicalDeviceAddress)
 {
     auto pwd = config.DeviceConfig->Password;
     if (pwd.empty() || pwd.back() != 0) {
@@ -431,9 +482,8 @@ void TDlmsDevice::ReadAttribute(TPort& port, const std::string& addr, int attrib
         "Getting " + addr + ":" + std::to_string(attribute) + " failed");
 }
 
-TRegisterValue TDlmsDevice::ReadRegisterImpl(TPort& port, const TRegisterConfig& reg)
+CGXDLMSObject* TDlmsDevice::GetRegisterObject(const std::string& addr)
 {
-    auto addr = ToTObisRegisterAddress(reg).GetLogicalName();
     auto obj = Client->GetObjects().FindByLN(DLMS_OBJECT_TYPE_REGISTER, addr);
     if (!obj) {
         obj = CGXDLMSObjectFactory::CreateObject(DLMS_OBJECT_TYPE_REGISTER, addr);
@@ -442,23 +492,23 @@ TRegisterValue TDlmsDevice::ReadRegisterImpl(TPort& port, const TRegisterConfig&
         }
         Client->GetObjects().push_back(obj);
     }
+    return obj;
+}
 
-    bool forceValueRead = true;
+TRegisterValue TDlmsDevice::ReadRegisterImpl(TPort& port, const TRegisterConfig& reg)
+{
+    auto addr = ToTObisRegisterAddress(reg).GetLogicalName();
+    auto obj = GetRegisterObject(addr);
 
-    const auto REGISTER_VALUE_ATTRIBUTE_INDEX = 2;
-    std::vector<int> attributes;
-    obj->GetAttributeIndexToRead(false, attributes);
-    for (auto pos: attributes) {
-        ReadAttribute(port, addr, pos, *obj);
-        if (pos == REGISTER_VALUE_ATTRIBUTE_INDEX) {
-            forceValueRead = false;
-        }
+    // Scaler and unit are static, so they are read once while device is connected
+    if (!ScalerUnitRead.count(addr)) {
+        ReadAttribute(port, addr, REGISTER_SCALER_UNIT_ATTRIBUTE_INDEX, *obj);
+        ScalerUnitRead.insert(addr);
+        CacheScalerUnit(addr, obj);
     }
 
-    // Some devices doesn't set read access, let's force read value
-    if (forceValueRead) {
-        ReadAttribute(port, addr, REGISTER_VALUE_ATTRIBUTE_INDEX, *obj);
-    }
+    // Some devices doesn't set read access, so value is always read
+    ReadAttribute(port, addr, REGISTER_VALUE_ATTRIBUTE_INDEX, *obj);
 
     auto r = static_cast<CGXDLMSRegister*>(obj);
 
@@ -469,8 +519,225 @@ TRegisterValue TDlmsDevice::ReadRegisterImpl(TPort& port, const TRegisterConfig&
     return TRegisterValue{CopyDoubleToUint64(r->GetValue().ToDouble())};
 }
 
+bool TDlmsDevice::ReadList(TPort& port, std::vector<std::pair<CGXDLMSObject*, unsigned char>>& list)
+{
+    std::vector<CGXByteBuffer> data;
+    auto res = Client->ReadList(list, data);
+    if (res != DLMS_ERROR_CODE_OK) {
+        throw TSerialDeviceTransientErrorException("Get-Request-With-List failed. Can't generate request: " +
+                                                   GetErrorMessage(res));
+    }
+    std::vector<CGXDLMSVariant> values;
+    for (auto& buf: data) {
+        CGXReplyData reply;
+        try {
+            ReadDataBlock(port, buf.GetData(), buf.GetSize(), reply);
+        } catch (const TSerialDeviceException& e) {
+            throw TSerialDeviceTransientErrorException(std::string("Get-Request-With-List failed. ") + e.what());
+        } catch (const std::exception& e) {
+            // The meter has answered, but declined the request, although it declares multiple references support
+            LOG(Warn) << "Get-Request-With-List is rejected, registers will be read one by one: " << e.what();
+            ReadListRejected = true;
+            return false;
+        }
+        if (reply.GetValue().vt == DLMS_DATA_TYPE_ARRAY) {
+            values.insert(values.end(), reply.GetValue().Arr.begin(), reply.GetValue().Arr.end());
+        }
+    }
+    if (values.size() != list.size()) {
+        LOG(Debug) << "Get-Request-With-List: " << values.size() << " values received, " << list.size()
+                   << " expected";
+        return false;
+    }
+    res = Client->UpdateValues(list, values);
+    if (res != DLMS_ERROR_CODE_OK) {
+        LOG(Debug) << "Get-Request-With-List: bad response: " << GetErrorMessage(res);
+        return false;
+    }
+    return true;
+}
+
+PRegisterRange TDlmsDevice::CreateRegisterRange() const
+{
+    return std::make_shared<TDlmsRegisterRange>();
+}
+
+void TDlmsDevice::ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError)
+{
+    if ((Client->GetNegotiatedConformance() & DLMS_CONFORMANCE_MULTIPLE_REFERENCES) == 0 || ReadListRejected ||
+        range->RegisterList().size() < 2 || !ReadRegisterList(port, range, breakOnError))
+    {
+        TSerialDevice::ReadRegisterRange(port, range, breakOnError);
+    }
+    SaveCachedObjects();
+}
+
+bool TDlmsDevice::ReadRegisterList(TPort& port, PRegisterRange range, bool breakOnError)
+{
+    std::vector<std::pair<PRegister, CGXDLMSObject*>> regs;
+    std::vector<std::pair<CGXDLMSObject*, unsigned char>> list;
+    std::vector<std::string> newScalerUnits;
+    for (const auto& reg: range->RegisterList()) {
+        if (reg->GetAvailable() == TRegisterAvailability::UNAVAILABLE) {
+            continue;
+        }
+        auto addr = ToTObisRegisterAddress(*reg->GetConfig()).GetLogicalName();
+        auto obj = GetRegisterObject(addr);
+        // Scaler must be read before value, because it is applied to the value by Gurux object
+        if (!ScalerUnitRead.count(addr)) {
+            list.emplace_back(obj, REGISTER_SCALER_UNIT_ATTRIBUTE_INDEX);
+            newScalerUnits.push_back(addr);
+        }
+        list.emplace_back(obj, REGISTER_VALUE_ATTRIBUTE_INDEX);
+        regs.emplace_back(reg, obj);
+    }
+    if (regs.empty()) {
+        return true;
+    }
+
+    try {
+        port.SleepSinceLastInteraction(DeviceConfig()->RequestDelay);
+        if (!ReadList(port, list)) {
+            // Some attributes can't be read, read registers one by one to find them
+            SetTransferResult(true);
+            return false;
+        }
+        SetTransferResult(true);
+    } catch (const TSerialDeviceException& e) {
+        for (const auto& reg: regs) {
+            reg.first->SetError(TRegister::TError::ReadError);
+        }
+        if (GetConnectionState() == TDeviceConnectionState::DISCONNECTED) {
+            LOG(Debug) << e.what();
+        } else {
+            LOG(Warn) << e.what();
+        }
+        SetTransferResult(false);
+        if (breakOnError) {
+            throw;
+        }
+        return true;
+    }
+
+    for (const auto& addr: newScalerUnits) {
+        ScalerUnitRead.insert(addr);
+        CacheScalerUnit(addr, GetRegisterObject(addr));
+    }
+    for (const auto& reg: regs) {
+        auto value = static_cast<CGXDLMSRegister*>(reg.second)->GetValue();
+        if (!value.IsNumber()) {
+            reg.first->SetAvailable(TRegisterAvailability::UNAVAILABLE);
+            reg.first->SetError(TRegister::TError::ReadError);
+            LOG(Warn) << reg.first->ToString() << " value is not a number, register is now marked as unsupported";
+            continue;
+        }
+        reg.first->SetValue(TRegisterValue{CopyDoubleToUint64(value.ToDouble())});
+    }
+    InvalidateReadCache();
+    return true;
+}
+
+std::optional<std::string> TDlmsDevice::ReadIdentity(TPort& port, const std::string& addr)
+{
+    auto obj = Client->GetObjects().FindByLN(DLMS_OBJECT_TYPE_DATA, addr);
+    if (!obj) {
+        obj = CGXDLMSObjectFactory::CreateObject(DLMS_OBJECT_TYPE_DATA, addr);
+        if (!obj) {
+            throw TSerialDeviceTransientErrorException("Can't create data object");
+        }
+        Client->GetObjects().push_back(obj);
+    }
+    std::vector<CGXByteBuffer> data;
+    auto res = Client->Read(obj, DATA_VALUE_ATTRIBUTE_INDEX, data);
+    if (res != DLMS_ERROR_CODE_OK) {
+        throw TSerialDeviceTransientErrorException("Getting " + addr + " failed. Can't generate request: " +
+                                                   GetErrorMessage(res));
+    }
+    CGXReplyData reply;
+    for (auto& buf: data) {
+        try {
+            ReadDataBlock(port, buf.GetData(), buf.GetSize(), reply);
+        } catch (const TSerialDeviceException& e) {
+            throw TSerialDeviceTransientErrorException("Getting " + addr + " failed. " + e.what());
+        } catch (const std::exception& e) {
+            LOG(Debug) << "Getting " << addr << " failed: " << e.what();
+            return std::nullopt;
+        }
+    }
+    res = Client->UpdateValue(*obj, DATA_VALUE_ATTRIBUTE_INDEX, reply.GetValue());
+    if (res != DLMS_ERROR_CODE_OK) {
+        LOG(Debug) << "Getting " << addr << " failed: " << GetErrorMessage(res);
+        return std::nullopt;
+    }
+    return static_cast<CGXDLMSData*>(obj)->GetValue().ToString();
+}
+
+void TDlmsDevice::LoadCachedObjects(TPort& port)
+{
+    CachedObjects.reset();
+    CachedObjectsChanged = false;
+    if (!ObjectsCache) {
+        return;
+    }
+    auto serialNumber = ReadIdentity(port, SERIAL_NUMBER_LOGICAL_NAME);
+    if (!serialNumber) {
+        LOG(Debug) << "Serial number is not available, objects are not cached";
+        return;
+    }
+    auto firmware = ReadIdentity(port, FIRMWARE_LOGICAL_NAME);
+    if (!firmware) {
+        LOG(Debug) << "Firmware identifier is not available, objects are not cached";
+        return;
+    }
+    DLMS::TMeterIdentity identity{*serialNumber, *firmware};
+    CachedObjects = ObjectsCache->Find(ObjectsCacheId, identity);
+    if (!CachedObjects) {
+        CachedObjects = DLMS::TObjectsCacheEntry{identity, {}};
+        return;
+    }
+    for (const auto& [addr, scalerUnit]: CachedObjects->ScalerUnits) {
+        auto reg = static_cast<CGXDLMSRegister*>(GetRegisterObject(addr));
+        reg->SetScaler(std::pow(10, scalerUnit.Scaler));
+        reg->SetUnit(scalerUnit.Unit);
+        ScalerUnitRead.insert(addr);
+    }
+    LOG(Debug) << "Scalers and units of " << CachedObjects->ScalerUnits.size() << " registers are loaded from cache";
+}
+
+void TDlmsDevice::CacheScalerUnit(const std::string& addr, CGXDLMSObject* obj)
+{
+    if (!CachedObjects) {
+        return;
+    }
+    auto reg = static_cast<CGXDLMSRegister*>(obj);
+    CachedObjects->ScalerUnits[addr] = DLMS::TScalerUnit{static_cast<int>(std::lround(std::log10(reg->GetScaler()))),
+                                                         reg->GetUnit()};
+    CachedObjectsChanged = true;
+}
+
+void TDlmsDevice::SaveCachedObjects()
+{
+    if (CachedObjectsChanged) {
+        ObjectsCache->Set(ObjectsCacheId, *CachedObjects);
+        CachedObjectsChanged = false;
+    }
+}
+
+void TDlmsDevice::SetObjectsCache(DLMS::TObjectsCacheStorage& storage, const std::string& portDescription)
+{
+    ObjectsCache = &storage;
+    ObjectsCacheId = portDescription + ":" + DeviceConfig()->SlaveId + ":" + std::to_string(LogicalDeviceAddress);
+}
+
 void TDlmsDevice::PrepareImpl(TPort& port)
 {
+    // Objects are kept between sessions, so static attributes are not read on every reconnect.
+    // The meter could be replaced while it was disconnected, so read them again in that case
+    bool reconnect = (GetConnectionState() != TDeviceConnectionState::CONNECTED);
+    if (reconnect) {
+        ScalerUnitRead.clear();
+        ReadListRejected = false;
+    }
     try {
         Disconnect(port);
     } catch (...) {
@@ -482,6 +749,10 @@ void TDlmsDevice::PrepareImpl(TPort& port)
         Disconnect(port);
     }
     InitializeConnection(port);
+    if (reconnect) {
+        // Identification of the meter is cheaper than reading scalers and units of all registers
+        LoadCachedObjects(port);
+    }
     SetTransferResult(true);
 }
 
@@ -684,6 +955,18 @@ const CGXDLMSObjectCollection& TDlmsDevice::ReadAllObjects(TPort& port, bool rea
     return objs;
 }
 
+void DLMS::RegisterObjectsCache(TObjectsCacheStorage& storage, PHandlerConfig handlerConfig)
+{
+    for (const auto& portConfig: handlerConfig->PortConfigs) {
+        for (const auto& device: portConfig->Devices) {
+            auto dlmsDevice = std::dynamic_pointer_cast<TDlmsDevice>(device->Device);
+            if (dlmsDevice) {
+                dlmsDevice->SetObjectsCache(storage, portConfig->Port->GetDescription(false));
+            }
+        }
+    }
+}
+
 void DLMS::PrintDeviceTemplateGenerationOptionsUsage()
 {
     std::cout << "dlms_hdlc protocol options:" << std::endl
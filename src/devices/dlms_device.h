@@ -1,11 +1,15 @@
 #pragma once
 
 #include "device_template_generator.h"
+#include "dlms_objects_cache.h"
 #include "serial_config.h"
 #include "serial_device.h"
 
 #include "GXDLMSSecureClient.h"
 
+#include <optional>
+#include <unordered_set>
+
 const int PUBLIC_CLIENT_ADDRESS = 16;
 
 struct TDlmsDeviceConfig
@@ -24,6 +28,21 @@ class TDlmsDevice: public TSerialDevice, public TUInt32SlaveId
 {
     std::unique_ptr<CGXDLMSSecureClient> Client;
     std::chrono::milliseconds DisconnectRetryTimeout;
+    int LogicalDeviceAddress;
+
+    //! Logical names of registers with scaler and unit read since device was connected
+    std::unordered_set<std::string> ScalerUnitRead;
+
+    //! The meter has rejected Get-Request-With-List since device was connected
+    bool ReadListRejected = false;
+
+    //! Persistent cache of objects metadata, it isn't used if not set
+    DLMS::TObjectsCacheStorage* ObjectsCache = nullptr;
+    std::string ObjectsCacheId;
+
+    //! Cached objects of the connected meter, it is empty if the meter can't be identified
+    std::optional<DLMS::TObjectsCacheEntry> CachedObjects;
+    bool CachedObjectsChanged = false;
 
     void InitializeConnection(TPort& port);
     void SendData(TPort& port, const uint8_t* data, size_t size);
@@ -33,6 +52,36 @@ class TDlmsDevice: public TSerialDevice, public TUInt32SlaveId
     void ReadDataBlock(TPort& port, const uint8_t* data, size_t size, CGXReplyData& reply);
     void ReadDLMSPacket(TPort& port, const uint8_t* data, size_t size, CGXReplyData& reply);
     void ReadAttribute(TPort& port, const std::string& addr, int attribute, CGXDLMSObject& obj);
+    CGXDLMSObject* GetRegisterObject(const std::string& addr);
+
+    /**
+     * @brief Reads attributes by Get-Request-With-List.
+     *        The list is split to several requests by Gurux client according to PDU size.
+     *
+     * @return false if the request is rejected by the meter or the response can't be applied to the objects
+     * @throws TSerialDeviceTransientErrorException on communication errors
+     */
+    bool ReadList(TPort& port, std::vector<std::pair<CGXDLMSObject*, unsigned char>>& list);
+
+    /**
+     * @brief Reads registers of the range by Get-Request-With-List.
+     *
+     * @return false if registers must be read one by one
+     */
+    bool ReadRegisterList(TPort& port, PRegisterRange range, bool breakOnError);
+
+    /**
+     * @brief Reads value attribute of a data object used to identify the meter
+     *
+     * @return std::nullopt if the meter doesn't provide the object
+     * @throws TSerialDeviceTransientErrorException on communication errors
+     */
+    std::optional<std::string> ReadIdentity(TPort& port, const std::string& addr);
+
+    //! Identifies the connected meter and restores its objects metadata from the cache
+    void LoadCachedObjects(TPort& port);
+    void CacheScalerUnit(const std::string& addr, CGXDLMSObject* obj);
+    void SaveCachedObjects();
     void GetAssociationView(TPort& port);
     void Disconnect(TPort& port);
 
@@ -46,6 +95,11 @@ public:
 
     void EndSession(TPort& port) override;
 
+    void SetObjectsCache(DLMS::TObjectsCacheStorage& storage, const std::string& portDescription);
+
+    PRegisterRange CreateRegisterRange() const override;
+    void ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError = false) override;
+
     static void Register(TSerialDeviceFactory& factory);
 
     const CGXDLMSObjectCollection& ReadAllObjects(TPort& port, bool readAttributes);
@@ -58,6 +112,9 @@ protected:
 
 namespace DLMS
 {
+    //! Sets the persistent objects cache to all DLMS devices
+    void RegisterObjectsCache(TObjectsCacheStorage& storage, PHandlerConfig handlerConfig);
+
     void PrintDeviceTemplateGenerationOptionsUsage();
     void GenerateDeviceTemplate(TDeviceTemplateGenerationMode mode,
                                 PPort port,
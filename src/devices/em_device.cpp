@@ -1,5 +1,43 @@
 #include "em_device.h"
 
+#include <algorithm>
+
+namespace
+{
+    // Typical request and response of electricity meter protocols: slave id, command, parameters, CRC, data
+    const size_t REQUEST_AND_RESPONSE_BYTES = 30;
+
+    class TEMRegisterRange: public TRegisterRange
+    {
+    public:
+        bool Add(TPort& port, PRegister reg, std::chrono::milliseconds pollLimit) override
+        {
+            if (!RegisterList().empty() && RegisterList().front()->Device() != reg->Device()) {
+                return false;
+            }
+            // Registers with the same type and address are read by one request
+            bool newRequest = std::none_of(RegisterList().begin(), RegisterList().end(), [&reg](const auto& r) {
+                return r->GetConfig()->Type == reg->GetConfig()->Type &&
+                       r->GetConfig()->GetAddress().Compare(reg->GetConfig()->GetAddress()) == 0;
+            });
+            auto pollTime = PollTime;
+            if (newRequest) {
+                pollTime += port.GetSendTimeBytes(REQUEST_AND_RESPONSE_BYTES) +
+                            reg->Device()->DeviceConfig()->RequestDelay + reg->Device()->GetFrameTimeout(port);
+            }
+            if (!RegisterList().empty() && std::chrono::ceil<std::chrono::milliseconds>(pollTime) > pollLimit) {
+                return false;
+            }
+            PollTime = pollTime;
+            RegisterList().push_back(reg);
+            return true;
+        }
+
+    private:
+        std::chrono::microseconds PollTime = std::chrono::microseconds::zero();
+    };
+}
+
 TEMDevice::TEMDevice(PDeviceConfig config, PProtocol protocol)
     : TSerialDevice(config, protocol),
       TUInt32SlaveId(config->SlaveId, true)
@@ -9,6 +47,11 @@ TEMDevice::TEMDevice(PDeviceConfig config, PProtocol protocol)
     }
 }
 
+PRegisterRange TEMDevice::CreateRegisterRange() const
+{
+    return PRegisterRange(new TEMRegisterRange());
+}
+
 void TEMDevice::WriteCommand(TPort& port, uint8_t cmd, uint8_t* payload, int len)
 {
     uint8_t buf[MAX_LEN], *p = buf;
@@ -17,6 +17,13 @@ class TEMDevice: public TSerialDevice, public TUInt32SlaveId
 public:
     TEMDevice(PDeviceConfig config, PProtocol protocol);
 
+    /**
+     * @brief Creates a range for all due registers of the meter.
+     *        Registers are read back to back in one session and
+     *        values cached by a device (e.g. value arrays) are requested once per range.
+     */
+    PRegisterRange CreateRegisterRange() const override;
+
 protected:
     enum ErrorType
     {
@@ -37,55 +37,25 @@ namespace
         return GetUint32RegisterAddress(reg.GetAddress()) & 0xFF;
     }
 
-    class TEnergomeraRegisterRange: public TRegisterRange
+    // Max number of registers in one GROUP request, longer requests don't fit in the request buffer
+    const size_t MAX_GROUP_SIZE = 11;
+
+    struct TGroupRequest
     {
-    public:
-        bool Add(TPort& port, PRegister reg, std::chrono::milliseconds pollLimit) override
-        {
-            // TODO: respect pollLimit
-            if (RegisterList().size() > 10) {
-                return false;
-            }
+        std::map<uint16_t, uint16_t> ParamMasks;
 
-            if (reg->GetAvailable() != TRegisterAvailability::UNAVAILABLE) {
-                if (HasOtherDeviceAndType(reg)) {
-                    return false;
-                }
-                RegisterList().push_back(reg);
-            }
-            return true;
-        }
+        // x[Param] -> Regs (sorted by bit number)
+        std::map<uint16_t, std::list<PRegister>> RegsByParam;
 
-        void UpdateMasks()
+        explicit TGroupRequest(const std::list<PRegister>& regs)
         {
-            std::list<PRegister> sortedRegList = RegisterList();
-            sortedRegList.sort([](const PRegister& a, const PRegister& b) -> bool {
-                if (GetParamId(*a->GetConfig()) < GetParamId(*b->GetConfig()))
-                    return true;
-                if (GetParamId(*a->GetConfig()) > GetParamId(*b->GetConfig()))
-                    return false;
-
-                if (GetValueNum(*a->GetConfig()) < GetValueNum(*b->GetConfig()))
-                    return true;
-                if (GetValueNum(*a->GetConfig()) > GetValueNum(*b->GetConfig()))
-                    return false;
-
-                return false;
-            });
-            RegisterList().swap(sortedRegList);
-            for (auto reg: RegisterList()) {
+            for (auto reg: regs) {
                 auto param_id = GetParamId(*reg->GetConfig());
                 auto value_num = GetValueNum(*reg->GetConfig());
                 ParamMasks[param_id] |= (1 << (value_num - 1));
                 RegsByParam[param_id].push_back(reg);
             };
         }
-
-    public:
-        std::map<uint16_t, uint16_t> ParamMasks;
-
-        // x[Param] -> Regs (sorted by bit number)
-        std::map<uint16_t, std::list<PRegister>> RegsByParam;
     };
 
     void CheckStripChecksum(uint8_t* resp, size_t len)
@@ -117,7 +87,7 @@ namespace
             LOG_PREFIX);
     }
 
-    void SendFastGroupReadRequest(TPort& port, TEnergomeraRegisterRange& range, const std::string& slaveId)
+    void SendFastGroupReadRequest(TPort& port, const TGroupRequest& request, const std::string& slaveId)
     {
         // request looks like this:
         //  Write [Energomera]:/?00000211!<SOH>R1<STX>GROUP(1001(1)1004(1)1008(1)4001(7))<ETX>
@@ -127,7 +97,7 @@ namespace
         char cmd_part[sizeof(buf) - 5] = {};
         // 11 bytes of header
         char query_part[sizeof(cmd_part) - 11] = {};
-        for (const auto& kv: range.ParamMasks) {
+        for (const auto& kv: request.ParamMasks) {
             snprintf(query_part + strlen(query_part),
                      sizeof(query_part) - strlen(query_part),
                      "%04hX(%hX)",
@@ -163,10 +133,10 @@ namespace
         return presp;
     }
 
-    void ProcessResponse(TEnergomeraRegisterRange& range, char* presp)
+    void ProcessResponse(const TGroupRequest& request, char* presp)
     {
         int nread;
-        for (const auto& kv: range.RegsByParam) {
+        for (const auto& kv: request.RegsByParam) {
             auto& regs = kv.second;
             auto param_id = kv.first;
 
@@ -224,42 +194,46 @@ TEnergomeraIecWithFastReadDevice::TEnergomeraIecWithFastReadDevice(PDeviceConfig
     : TIEC61107Device(config, protocol)
 {}
 
-void TEnergomeraIecWithFastReadDevice::ReadRegisterRange(TPort& port, PRegisterRange abstract_range, bool breakOnError)
+void TEnergomeraIecWithFastReadDevice::ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError)
 {
-    auto range = std::dynamic_pointer_cast<TEnergomeraRegisterRange>(abstract_range);
-    if (!range) {
-        throw std::runtime_error("TEnergomeraRegisterRange expected");
-    }
-
-    port.CheckPortOpen();
-    port.SkipNoise();
+    ReadBatchRegisterRange(*this, *this, port, range, breakOnError);
+}
 
-    try {
-        range->UpdateMasks();
-        SendFastGroupReadRequest(port, *range, SlaveId);
+PRegisterRange TEnergomeraIecWithFastReadDevice::CreateRegisterRange() const
+{
+    return std::make_shared<TBatchRegisterRange>(*this);
+}
 
-        uint8_t resp[RESPONSE_BUF_LEN] = {};
-        char* presp = ReadResponse(port, resp, RESPONSE_BUF_LEN, *DeviceConfig());
+bool TEnergomeraIecWithFastReadDevice::CanReadInBatch(TPort& port,
+                                                      const std::list<PRegister>& batch,
+                                                      const TRegisterConfig& reg,
+                                                      std::chrono::milliseconds pollLimit) const
+{
+    // TODO: respect pollLimit
+    // Values in a response are variable length text, so its size can't be estimated before the request.
+    // At 9600 baud even a response for a couple of parameters can exceed the limit, so a limit based on
+    // a guessed size would split a GROUP request into several ones. Each of them carries its own header
+    // and response timeout, so the whole poll takes longer than one request.
+    return batch.size() < MAX_GROUP_SIZE && batch.front()->GetConfig()->Type == reg.Type;
+}
 
-        SetTransferResult(true);
-        ProcessResponse(*range, presp);
-    } catch (const TSerialDeviceException& e) {
-        for (auto& r: range->RegisterList()) {
-            r->SetError(TRegister::TError::ReadError);
-        }
-        auto& logger = (GetConnectionState() == TDeviceConnectionState::DISCONNECTED) ? Debug : Warn;
-        LOG(logger) << "TEnergomeraIecWithFastReadDevice::ReadRegisterRange(): " << e.what() << " [slave_id is "
-                    << ToString() + "]";
-        SetTransferResult(false);
-        if (breakOnError) {
-            throw;
-        }
-    }
+bool TEnergomeraIecWithFastReadDevice::ReadBefore(const TRegisterConfig& reg, const TRegisterConfig& other) const
+{
+    return std::make_pair(GetParamId(reg), GetValueNum(reg)) < std::make_pair(GetParamId(other), GetValueNum(other));
 }
 
-PRegisterRange TEnergomeraIecWithFastReadDevice::CreateRegisterRange() const
+void TEnergomeraIecWithFastReadDevice::ReadBatch(TPort& port, const std::list<PRegister>& regs)
 {
-    return std::make_shared<TEnergomeraRegisterRange>();
+    port.CheckPortOpen();
+    port.SkipNoise();
+
+    TGroupRequest request(regs);
+    SendFastGroupReadRequest(port, request, SlaveId);
+
+    uint8_t resp[RESPONSE_BUF_LEN] = {};
+    char* presp = ReadResponse(port, resp, RESPONSE_BUF_LEN, *DeviceConfig());
+
+    ProcessResponse(request, presp);
 }
 
 void TEnergomeraIecWithFastReadDevice::PrepareImpl(TPort& port)
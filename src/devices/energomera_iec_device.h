@@ -1,9 +1,10 @@
 #pragma once
 
+#include "batch_reader.h"
 #include "iec_common.h"
 #include "serial_config.h"
 
-class TEnergomeraIecWithFastReadDevice: public TIEC61107Device
+class TEnergomeraIecWithFastReadDevice: public TIEC61107Device, public IBatchReader
 {
 public:
     TEnergomeraIecWithFastReadDevice(PDeviceConfig device_config, PProtocol protocol);
@@ -11,6 +12,13 @@ public:
     PRegisterRange CreateRegisterRange() const override;
     void ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError = false) override;
 
+    bool CanReadInBatch(TPort& port,
+                        const std::list<PRegister>& batch,
+                        const TRegisterConfig& reg,
+                        std::chrono::milliseconds pollLimit) const override;
+    bool ReadBefore(const TRegisterConfig& reg, const TRegisterConfig& other) const override;
+    void ReadBatch(TPort& port, const std::list<PRegister>& regs) override;
+
     static void Register(TSerialDeviceFactory& factory);
 
 protected:
@@ -30,20 +30,38 @@ namespace
         }
         return TRegisterValue{CopyDoubleToUint64(strtod(value.c_str() + startPos + 1, nullptr))};
     }
+
+    class TIecModeCDeviceFactory: public IDeviceFactory
+    {
+    public:
+        TIecModeCDeviceFactory()
+            : IDeviceFactory(std::make_unique<TStringRegisterAddressFactory>(),
+                             "#/definitions/iec_mode_c_data_readout_device",
+                             "#/definitions/channel_with_string_address")
+        {}
+
+        PSerialDevice CreateDevice(const Json::Value& data,
+                                   PDeviceConfig deviceConfig,
+                                   PProtocol protocol) const override
+        {
+            auto dev = std::make_shared<TIecModeCDevice>(deviceConfig, protocol);
+            bool dataReadout = false;
+            WBMQTT::JSON::Get(data, "data_readout", dataReadout);
+            dev->SetDataReadout(dataReadout);
+            return dev;
+        }
+    };
 }
 
 void TIecModeCDevice::Register(TSerialDeviceFactory& factory)
 {
-    factory.RegisterProtocol(new TIEC61107Protocol("iec_mode_c", RegisterTypes),
-                             new TBasicDeviceFactory<TIecModeCDevice, TStringRegisterAddressFactory>(
-                                 "#/definitions/iec_mode_c_device",
-                                 "#/definitions/channel_with_string_address"));
+    factory.RegisterProtocol(new TIEC61107Protocol("iec_mode_c", RegisterTypes), new TIecModeCDeviceFactory());
 }
 
 TIecModeCDevice::TIecModeCDevice(PDeviceConfig device_config, PProtocol protocol)
     : TIEC61107ModeCDevice(device_config, protocol, LOG_PREFIX, IEC::CalcXorCRC)
 {
-    SetDesiredBaudRate(9600);
+    SetDesiredBaudRate(19200);
     SetDefaultBaudRate(300);
     SetReadCommand(IEC::FormattedReadCommand);
 }
@@ -18,6 +18,10 @@ namespace
     };
     // clang-format on
 
+    // Values of an array read during previous register ranges are returned only within this period,
+    // so channels with different poll intervals don't get outdated values
+    const std::chrono::milliseconds VALUE_ARRAY_MAX_AGE(1000);
+
     class TMercury230DeviceRegisterAddressFactory: public TStringRegisterAddressFactory
     {
     public:
@@ -63,6 +67,8 @@ bool TMercury230Device::ConnectionSetup(TPort& port)
         std::copy(password.begin(), password.end(), setupCmd + 1);
     }
 
+    CachedValues.clear();
+
     uint8_t buf[1];
     WriteCommand(port, 0x01, setupCmd, 7);
     try {
@@ -102,12 +108,24 @@ TEMDevice::ErrorType TMercury230Device::CheckForException(uint8_t* frame, int le
     return TEMDevice::OTHER_ERROR;
 }
 
-const TMercury230Device::TValueArray& TMercury230Device::ReadValueArray(TPort& port, uint32_t address, int resp_len)
+uint32_t TMercury230Device::ReadValueArrayElement(TPort& port, uint32_t address, uint32_t index, int resp_len)
 {
+    index &= 0x03;
     int key = address;
     auto it = CachedValues.find(key);
-    if (it != CachedValues.end())
-        return it->second;
+    if (it != CachedValues.end()) {
+        // Channels of an array are often polled in different register ranges.
+        // The array is read again only when one of its elements is polled for the second time
+        // or if it is too old.
+        if (!it->second.FromPreviousRange ||
+            ((it->second.ReadElements & (1 << index)) == 0 &&
+             std::chrono::steady_clock::now() - it->second.ReadTime < VALUE_ARRAY_MAX_AGE))
+        {
+            it->second.ReadElements |= (1 << index);
+            return it->second.values[index];
+        }
+        CachedValues.erase(it);
+    }
 
     uint8_t cmdBuf[2];
     cmdBuf[0] = (uint8_t)(address & 0xff);        // high nibble = array number, lower nibble = month
@@ -118,8 +136,10 @@ const TMercury230Device::TValueArray& TMercury230Device::ReadValueArray(TPort& p
     for (int i = 0; i < resp_len; i++, p += 4) {
         a.values[i] = ((uint32_t)p[1] << 24) + ((uint32_t)p[0] << 16) + ((uint32_t)p[3] << 8) + (uint32_t)p[2];
     }
+    a.ReadElements = (1 << index);
+    a.ReadTime = std::chrono::steady_clock::now();
 
-    return CachedValues.insert(std::make_pair(key, a)).first->second;
+    return CachedValues.insert(std::make_pair(key, a)).first->second.values[index];
 }
 
 uint32_t TMercury230Device::ReadParam(TPort& port, uint32_t address, unsigned resp_payload_len, RegisterType reg_type)
@@ -167,9 +187,9 @@ TRegisterValue TMercury230Device::ReadRegisterImpl(TPort& port, const TRegisterC
     auto addr = GetUint32RegisterAddress(reg.GetAddress());
     switch (reg.Type) {
         case REG_VALUE_ARRAY:
-            return TRegisterValue{ReadValueArray(port, addr, 4).values[reg.GetDataOffset() & 0x03]};
+            return TRegisterValue{ReadValueArrayElement(port, addr, reg.GetDataOffset(), 4)};
         case REG_VALUE_ARRAY12:
-            return TRegisterValue{ReadValueArray(port, addr, 3).values[reg.GetDataOffset() & 0x03]};
+            return TRegisterValue{ReadValueArrayElement(port, addr, reg.GetDataOffset(), 3)};
         case REG_PARAM:
         case REG_PARAM_SIGN_ACT:
         case REG_PARAM_SIGN_REACT:
@@ -183,7 +203,9 @@ TRegisterValue TMercury230Device::ReadRegisterImpl(TPort& port, const TRegisterC
 
 void TMercury230Device::InvalidateReadCache()
 {
-    CachedValues.clear();
+    for (auto& value: CachedValues) {
+        value.second.FromPreviousRange = true;
+    }
     TSerialDevice::InvalidateReadCache();
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <exception>
 #include <list>
@@ -43,8 +44,14 @@ private:
     struct TValueArray
     {
         uint32_t values[4];
+        //! Bit mask of elements returned since the array was read from the meter
+        uint8_t ReadElements = 0;
+        //! The array was read during one of previous register ranges
+        bool FromPreviousRange = false;
+        //! Time of reading the array from the meter
+        std::chrono::steady_clock::time_point ReadTime;
     };
-    const TValueArray& ReadValueArray(TPort& port, uint32_t address, int resp_len = 4);
+    uint32_t ReadValueArrayElement(TPort& port, uint32_t address, uint32_t index, int resp_len = 4);
     uint32_t ReadParam(TPort& port, uint32_t address, unsigned resp_payload_len, RegisterType reg_type);
 
     std::unordered_map<int, TValueArray> CachedValues;
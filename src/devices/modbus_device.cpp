@@ -51,8 +51,19 @@ TModbusDevice::TModbusDevice(std::unique_ptr<Modbus::IModbusTraits> modbusTraits
       ModbusTraits(std::move(modbusTraits)),
       ResponseTime(std::chrono::milliseconds::zero()),
       EnableWbContinuousRead(config.EnableWbContinuousRead),
-      ContinuousReadEnabled(false)
-{}
+      ContinuousReadEnabled(false),
+      OptimizeReadRanges(config.OptimizeReadRanges),
+      AutoMaxReadHoles(false),
+      TunedMaxReadRegisters(0),
+      TunedSupportsHoles(true)
+{
+    if (config.AutoMaxReadRegisters) {
+        ReadBlockTuner = std::make_unique<Modbus::TReadBlockTuner>(DeviceConfig()->MaxReadRegisters,
+                                                                   Modbus::MAX_READ_REGISTERS);
+        AutoMaxReadHoles = config.AutoMaxReadHoles;
+        TunedMaxReadRegisters = ReadBlockTuner->GetMaxReadRegisters();
+    }
+}
 
 bool TModbusDevice::GetForceFrameTimeout()
 {
@@ -64,6 +75,104 @@ bool TModbusDevice::GetContinuousReadEnabled()
     return ContinuousReadEnabled;
 }
 
+bool TModbusDevice::IsReadRequestStart(int registerType, uint32_t address) const
+{
+    return OptimizeReadRanges && ReadRangePlan.IsRequestStart(registerType, address);
+}
+
+bool TModbusDevice::IsReadTuningEnabled() const
+{
+    return ReadBlockTuner != nullptr;
+}
+
+int TModbusDevice::GetMaxReadRegisters() const
+{
+    return ReadBlockTuner ? TunedMaxReadRegisters : DeviceConfig()->MaxReadRegisters;
+}
+
+int TModbusDevice::GetMaxReadHole(bool singleBit) const
+{
+    if (ReadBlockTuner && !TunedSupportsHoles) {
+        return 0;
+    }
+    if (AutoMaxReadHoles) {
+        return singleBit ? Modbus::MAX_HOLE_CONTINUOUS_1_BIT_REGISTERS : Modbus::MAX_HOLE_CONTINUOUS_16_BIT_REGISTERS;
+    }
+    return singleBit ? DeviceConfig()->MaxBitHole : DeviceConfig()->MaxRegHole;
+}
+
+Modbus::TReadTuning TModbusDevice::GetReadTuning() const
+{
+    std::unique_lock lock(ReadTuningMutex);
+    if (!ReadBlockTuner) {
+        return Modbus::TReadTuning();
+    }
+    return ReadBlockTuner->GetResult();
+}
+
+void TModbusDevice::RestoreReadTuning(const Modbus::TReadTuning& tuning)
+{
+    Modbus::TReadTuning res;
+    {
+        std::unique_lock lock(ReadTuningMutex);
+        if (!ReadBlockTuner) {
+            return;
+        }
+        ReadBlockTuner->Restore(tuning);
+        res = ReadBlockTuner->GetResult();
+        ApplyReadTuning(res);
+    }
+}
+
+void TModbusDevice::SetReadTuningChangedCallback(std::function<void(const Modbus::TReadTuning&)> callback)
+{
+    ReadTuningChangedCallback = callback;
+}
+
+void TModbusDevice::UpdateReadTuning(const Modbus::TModbusRegisterRange& range,
+                                     Modbus::TReadRangeResult result,
+                                     bool hasHoles,
+                                     bool wasConnected)
+{
+    // A disconnected device says nothing about supported request size,
+    // such failures must not shrink the learned limit
+    if (result != Modbus::TReadRangeResult::SUCCESS && !wasConnected) {
+        return;
+    }
+    Modbus::TReadTuning res;
+    {
+        std::unique_lock lock(ReadTuningMutex);
+        auto prev = ReadBlockTuner->GetResult();
+        if (result == Modbus::TReadRangeResult::SUCCESS) {
+            ReadBlockTuner->OnReadSuccess(range.GetCount(), hasHoles, GetRegisters().size());
+        } else if (result == Modbus::TReadRangeResult::ERROR && hasHoles && !GetSupportsHoles()) {
+            ReadBlockTuner->OnHolesNotSupported();
+        } else {
+            // Some devices silently drop too large requests, so timeouts are failures too.
+            // Failures of ranges not larger than the known good size are ignored by the tuner
+            ReadBlockTuner->OnReadFailure(range.GetCount());
+        }
+        res = ReadBlockTuner->GetResult();
+        TunedMaxReadRegisters = ReadBlockTuner->GetMaxReadRegisters();
+        if (res == prev) {
+            return;
+        }
+        ApplyReadTuning(res);
+    }
+    if (ReadTuningChangedCallback) {
+        ReadTuningChangedCallback(res);
+    }
+}
+
+void TModbusDevice::ApplyReadTuning(const Modbus::TReadTuning& tuning)
+{
+    TunedMaxReadRegisters = ReadBlockTuner->GetMaxReadRegisters();
+    TunedSupportsHoles = tuning.SupportsHoles;
+    LOG(Info) << ToString() << ": read tuning " << Modbus::ReadTuningStateToString(tuning.State)
+              << ", max read registers: " << tuning.MaxReadRegisters
+              << ", holes: " << (tuning.SupportsHoles ? "supported" : "not supported");
+}
+
 PRegisterRange TModbusDevice::CreateRegisterRange() const
 {
     return Modbus::CreateRegisterRange(ResponseTime.GetValue());
@@ -73,6 +182,7 @@ void TModbusDevice::PrepareImpl(TPort& port)
 {
     TSerialDevice::PrepareImpl(port);
     if (GetConnectionState() != TDeviceConnectionState::CONNECTED) {
+        InvalidateReadCache();
         if (EnableWbContinuousRead) {
             ContinuousReadEnabled =
                 Modbus::EnableWbContinuousRead(shared_from_this(), *ModbusTraits, port, SlaveId, ModbusCache);
@@ -102,6 +212,7 @@ void TModbusDevice::PrepareImpl(TPort& port)
 
 void TModbusDevice::WriteRegisterImpl(TPort& port, const TRegisterConfig& reg, const TRegisterValue& value)
 {
+    InvalidateReadCache();
     Modbus::WriteRegister(*ModbusTraits,
                           port,
                           SlaveId,
@@ -113,6 +224,20 @@ void TModbusDevice::WriteRegisterImpl(TPort& port, const TRegisterConfig& reg, c
                           GetFrameTimeout(port));
 }
 
+void TModbusDevice::WriteRegistersImpl(TPort& port, std::vector<TRegisterWriteRequest>& requests)
+{
+    InvalidateReadCache();
+    Modbus::WriteRegisters(*ModbusTraits,
+                           port,
+                           SlaveId,
+                           requests,
+                           DeviceConfig()->MaxWriteRegisters,
+                           ModbusCache,
+                           DeviceConfig()->RequestDelay,
+                           GetResponseTimeout(port),
+                           GetFrameTimeout(port));
+}
+
 void TModbusDevice::ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError)
 {
     auto modbus_range = std::dynamic_pointer_cast<Modbus::TModbusRegisterRange>(range);
@@ -120,8 +245,23 @@ void TModbusDevice::ReadRegisterRange(TPort& port, PRegisterRange range, bool br
         throw std::runtime_error("modbus range expected");
     }
     SyncMWACTime(port);
-    Modbus::ReadRegisterRange(*ModbusTraits, port, SlaveId, *modbus_range, ModbusCache, breakOnError);
+    auto hasHoles = modbus_range->HasHoles();
+    auto wasConnected = (GetConnectionState() == TDeviceConnectionState::CONNECTED);
+    auto result = Modbus::ReadRegisterRange(*ModbusTraits,
+                                            port,
+                                            SlaveId,
+                                            *modbus_range,
+                                            ModbusCache,
+                                            breakOnError,
+                                            0,
+                                            &SingleBitReadCache);
     ResponseTime.AddValue(modbus_range->GetResponseTime());
+    if (ReadBlockTuner) {
+        UpdateReadTuning(*modbus_range, result, hasHoles, wasConnected);
+    }
+    if (OptimizeReadRanges) {
+        ReadRangePlan.Update(port, *this, ResponseTime.GetValue(), GetForceFrameTimeout());
+    }
 }
 
 void TModbusDevice::WriteSetupRegisters(TPort& port, const TDeviceSetupItems& setupItems, bool breakOnError)
@@ -137,6 +277,11 @@ void TModbusDevice::WriteSetupRegisters(TPort& port, const TDeviceSetupItems& se
                                 breakOnError);
 }
 
+void TModbusDevice::InvalidateReadCache()
+{
+    SingleBitReadCache.clear();
+}
+
 std::chrono::milliseconds TModbusDevice::GetFrameTimeout(TPort& port) const
 {
     return std::max(
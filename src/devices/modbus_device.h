@@ -2,7 +2,9 @@
 
 #include <chrono>
 #include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <stdint.h>
 #include <string>
 
@@ -10,6 +12,8 @@
 #include "serial_device.h"
 
 #include "modbus_common.h"
+#include "modbus_read_planner.h"
+#include "modbus_read_tuner.h"
 #include "running_average.h"
 
 class TModbusDeviceConfig
@@ -23,6 +27,22 @@ public:
      *
      */
     bool EnableWbContinuousRead = false;
+
+    /**
+     * @brief Split register ranges according to estimated bus time of read requests
+     *        instead of greedy merging of neighbouring registers
+     */
+    bool OptimizeReadRanges = false;
+
+    /**
+     * @brief Search the largest supported read request size and holes support during polling
+     */
+    bool AutoMaxReadRegisters = false;
+
+    /**
+     * @brief max_reg_hole and max_bit_hole are not set, auto tuning checks holes support with default limits
+     */
+    bool AutoMaxReadHoles = false;
 };
 
 template<class Dev> class TModbusDeviceFactory: public IDeviceFactory
@@ -42,6 +62,9 @@ public:
         TModbusDeviceConfig config;
         config.CommonConfig = deviceConfig;
         WBMQTT::JSON::Get(data, "enable_wb_continuous_read", config.EnableWbContinuousRead);
+        WBMQTT::JSON::Get(data, "optimize_read_ranges", config.OptimizeReadRanges);
+        WBMQTT::JSON::Get(data, "auto_max_read_registers", config.AutoMaxReadRegisters);
+        config.AutoMaxReadHoles = !data.isMember("max_reg_hole") && !data.isMember("max_bit_hole");
         WBMQTT::JSON::Get(data,
                           "continue_polling_on_illegal_modbus_exception",
                           deviceConfig->ContinuePollingOnIllegalModbusException);
@@ -56,9 +79,21 @@ class TModbusDevice: public TSerialDevice, public TUInt32SlaveId
 {
     std::unique_ptr<Modbus::IModbusTraits> ModbusTraits;
     Modbus::TRegisterCache ModbusCache;
+    Modbus::TSingleBitReadCache SingleBitReadCache;
     TRunningAverage<std::chrono::microseconds, 10> ResponseTime;
     bool EnableWbContinuousRead;
     bool ContinuousReadEnabled;
+    bool OptimizeReadRanges;
+    Modbus::TReadRangePlan ReadRangePlan;
+    std::unique_ptr<Modbus::TReadBlockTuner> ReadBlockTuner;
+    mutable std::mutex ReadTuningMutex;
+    bool AutoMaxReadHoles;
+
+    //! Read limits learned by auto tuning, they are used instead of configured ones
+    int TunedMaxReadRegisters;
+    bool TunedSupportsHoles;
+
+    std::function<void(const Modbus::TReadTuning&)> ReadTuningChangedCallback;
     std::chrono::system_clock::time_point LastMWACTimeSync;
 
 public:
@@ -69,10 +104,33 @@ public:
     bool GetForceFrameTimeout();
     bool GetContinuousReadEnabled();
 
+    //! The register must start a new read request according to read ranges optimization plan
+    bool IsReadRequestStart(int registerType, uint32_t address) const;
+
+    bool IsReadTuningEnabled() const;
+
+    //! Max count of Modbus registers in one read request, configured or learned by auto tuning
+    int GetMaxReadRegisters() const;
+
+    //! Max count of unused registers or bits in one read request, configured or learned by auto tuning
+    int GetMaxReadHole(bool singleBit) const;
+
+    //! Current state of read block size auto tuning, the method is thread safe
+    Modbus::TReadTuning GetReadTuning() const;
+
+    //! Applies previously learned read parameters
+    void RestoreReadTuning(const Modbus::TReadTuning& tuning);
+
+    //! The callback is called from polling thread if learned read parameters have changed
+    void SetReadTuningChangedCallback(std::function<void(const Modbus::TReadTuning&)> callback);
+
     PRegisterRange CreateRegisterRange() const override;
     void ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError = false) override;
     void WriteSetupRegisters(TPort& port, const TDeviceSetupItems& setupItems, bool breakOnError = false) override;
 
+    //! Drops previous reads of coils and discrete inputs, so the next read updates all their registers
+    void InvalidateReadCache() override;
+
     std::chrono::milliseconds GetFrameTimeout(TPort& port) const override;
 
     static void Register(TSerialDeviceFactory& factory);
@@ -80,7 +138,14 @@ public:
 protected:
     void PrepareImpl(TPort& port) override;
     void WriteRegisterImpl(TPort& port, const TRegisterConfig& reg, const TRegisterValue& value) override;
+    void WriteRegistersImpl(TPort& port, std::vector<TRegisterWriteRequest>& requests) override;
 
 private:
     void SyncMWACTime(TPort& port);
+    void UpdateReadTuning(const Modbus::TModbusRegisterRange& range,
+                          Modbus::TReadRangeResult result,
+                          bool hasHoles,
+                          bool wasConnected);
+    //! Updates read limits from learned values, ReadTuningMutex must be locked
+    void ApplyReadTuning(const Modbus::TReadTuning& tuning);
 };
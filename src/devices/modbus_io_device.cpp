@@ -89,6 +89,20 @@ void TModbusIODevice::WriteRegisterImpl(TPort& port, const TRegisterConfig& reg,
                           Shift);
 }
 
+void TModbusIODevice::WriteRegistersImpl(TPort& port, std::vector<TRegisterWriteRequest>& requests)
+{
+    Modbus::WriteRegisters(*ModbusTraits,
+                           port,
+                           SlaveId,
+                           requests,
+                           DeviceConfig()->MaxWriteRegisters,
+                           ModbusCache,
+                           DeviceConfig()->RequestDelay,
+                           GetResponseTimeout(port),
+                           GetFrameTimeout(port),
+                           Shift);
+}
+
 void TModbusIODevice::ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError)
 {
     auto modbus_range = std::dynamic_pointer_cast<Modbus::TModbusRegisterRange>(range);
@@ -31,4 +31,5 @@ public:
 protected:
     void PrepareImpl(TPort& port) override;
     void WriteRegisterImpl(TPort& port, const TRegisterConfig& reg, const TRegisterValue& value) override;
+    void WriteRegistersImpl(TPort& port, std::vector<TRegisterWriteRequest>& requests) override;
 };
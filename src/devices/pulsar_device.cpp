@@ -1,12 +1,23 @@
 /* vim: set ts=4 sw=4: */
 
+#include <bit>
 #include <cstdlib>
 #include <cstring>
 
 #include "pulsar_device.h"
+#include "log.h"
+
+#define LOG(logger) logger.Log() << "[pulsar] "
 
 namespace
 {
+    // Channel mask is 32 bits wide
+    const uint32_t MAX_CHANNELS = 32;
+
+    // Address, function, length, request ID and CRC16
+    const size_t SERVICE_BYTES = 10;
+    const size_t DATA_REQUEST_SIZE = 14;
+
     const TRegisterTypes RegisterTypes{{TPulsarDevice::REG_DEFAULT, "default", "value", Double, true},
                                        {TPulsarDevice::REG_SYSTIME, "systime", "value", U64, true}};
 }
@@ -233,3 +244,92 @@ TRegisterValue TPulsarDevice::ReadRegisterImpl(TPort& port, const TRegisterConfi
             throw TSerialDeviceException("Pulsar protocol: wrong register type");
     }
 }
+
+PRegisterRange TPulsarDevice::CreateRegisterRange() const
+{
+    return std::make_shared<TBatchRegisterRange>(*this);
+}
+
+void TPulsarDevice::ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError)
+{
+    ReadBatchRegisterRange(*this, *this, port, range, breakOnError);
+}
+
+bool TPulsarDevice::CanReadInBatch(TPort& port,
+                                   const std::list<PRegister>& batch,
+                                   const TRegisterConfig& reg,
+                                   std::chrono::milliseconds pollLimit) const
+{
+    // Data registers are read by channel mask, response contains values of all channels of the mask
+    auto& first = *batch.front()->GetConfig();
+    if (first.Type != REG_DEFAULT || reg.Type != REG_DEFAULT || first.GetByteWidth() != reg.GetByteWidth() ||
+        GetUint32RegisterAddress(reg.GetAddress()) >= MAX_CHANNELS)
+    {
+        return false;
+    }
+    uint32_t mask = 1 << GetUint32RegisterAddress(reg.GetAddress());
+    for (const auto& r: batch) {
+        mask |= 1 << GetUint32RegisterAddress(r->GetConfig()->GetAddress());
+    }
+    auto responseSize = SERVICE_BYTES + std::popcount(mask) * reg.GetByteWidth();
+    auto time = port.GetSendTimeBytes(DATA_REQUEST_SIZE + responseSize) + GetFrameTimeout(port);
+    return std::chrono::ceil<std::chrono::milliseconds>(time) <= pollLimit;
+}
+
+void TPulsarDevice::ReadBatch(TPort& port, const std::list<PRegister>& regs)
+{
+    auto& first = *regs.front()->GetConfig();
+    if (regs.size() == 1) {
+        regs.front()->SetValue(ReadRegisterImpl(port, first));
+        return;
+    }
+
+    port.SkipNoise();
+
+    uint32_t mask = 0;
+    for (const auto& reg: regs) {
+        mask |= 1 << GetUint32RegisterAddress(reg->GetConfig()->GetAddress());
+    }
+    auto width = first.GetByteWidth();
+    std::vector<uint8_t> payload(std::popcount(mask) * width);
+
+    try {
+        WriteDataRequest(port, SlaveId, mask, RequestID);
+        ReadResponse(port, SlaveId, payload.data(), payload.size(), RequestID);
+    } catch (const TSerialDeviceException& e) {
+        // A late response must not be taken for a response to the next request
+        ++RequestID;
+        LOG(Debug) << "Failed to read channels by mask 0x" << std::hex << mask << ": " << e.what()
+                   << ", reading them one by one [slave_id is " << ToString() << "]";
+        ReadSeparately(port, regs);
+        return;
+    }
+
+    ++RequestID;
+
+    // values are placed in ascending order of channels
+    for (const auto& reg: regs) {
+        auto channel = GetUint32RegisterAddress(reg->GetConfig()->GetAddress());
+        auto index = std::popcount(mask & ((1u << channel) - 1));
+        reg->SetValue(TRegisterValue{ReadHex(payload.data() + index * width, width, false)});
+    }
+}
+
+void TPulsarDevice::ReadSeparately(TPort& port, const std::list<PRegister>& regs)
+{
+    bool readOk = false;
+    for (const auto& reg: regs) {
+        try {
+            reg->SetValue(ReadRegisterImpl(port, *reg->GetConfig()));
+            readOk = true;
+        } catch (const TSerialDeviceException& e) {
+            // The meter doesn't respond at all, don't wait for timeouts of other channels
+            if (!readOk) {
+                throw;
+            }
+            reg->SetError(TRegister::TError::ReadError);
+            LOG(Warn) << "Failed to read " << reg->ToString() << ": " << e.what() << " [slave_id is " << ToString()
+                      << "]";
+        }
+    }
+}
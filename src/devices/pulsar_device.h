@@ -2,12 +2,13 @@
 
 #pragma once
 
+#include "batch_reader.h"
 #include "serial_config.h"
 #include "serial_device.h"
 #include <memory>
 #include <stdint.h>
 
-class TPulsarDevice: public TSerialDevice, public TUInt32SlaveId
+class TPulsarDevice: public TSerialDevice, public TUInt32SlaveId, public IBatchReader
 {
 public:
     enum RegisterType
@@ -22,6 +23,15 @@ public:
 
     TRegisterValue ReadRegisterImpl(TPort& port, const TRegisterConfig& reg) override;
 
+    PRegisterRange CreateRegisterRange() const override;
+    void ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError = false) override;
+
+    bool CanReadInBatch(TPort& port,
+                        const std::list<PRegister>& batch,
+                        const TRegisterConfig& reg,
+                        std::chrono::milliseconds pollLimit) const override;
+    void ReadBatch(TPort& port, const std::list<PRegister>& regs) override;
+
 private:
     void WriteBCD(uint64_t data, uint8_t* buffer, size_t size, bool big_endian = true);
     void WriteHex(uint64_t data, uint8_t* buffer, size_t size, bool big_endian = true);
@@ -39,6 +49,9 @@ private:
     TRegisterValue ReadDataRegister(TPort& port, const TRegisterConfig& reg);
     TRegisterValue ReadSysTimeRegister(TPort& port, const TRegisterConfig& reg);
 
+    //! Reads registers by a request per register, used if the meter doesn't answer a request by channel mask
+    void ReadSeparately(TPort& port, const std::list<PRegister>& regs);
+
     uint16_t RequestID;
 };
 
@@ -0,0 +1,122 @@
+#include "disconnected_poll_quarantine.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace
+{
+    // Poll time of disconnected devices is accounted in sliding window of the size
+    const auto ACCOUNTING_WINDOW = 60s;
+
+    // Poll delay is randomly changed in range [delay * (1 - MAX_JITTER), delay * (1 + MAX_JITTER)]
+    const double MAX_JITTER = 0.25;
+
+    // Limit for exponent of poll delay to avoid overflow
+    const size_t MAX_BACKOFF_EXPONENT = 20;
+}
+
+TDisconnectedPollQuarantine::TDisconnectedPollQuarantine(const TDisconnectedPollSettings& settings,
+                                                         std::minstd_rand::result_type seed)
+    : Settings(settings),
+      Random(seed)
+{
+    Settings.MaxBusShare = std::clamp(Settings.MaxBusShare, 0.01, 1.0);
+}
+
+const TDisconnectedPollSettings& TDisconnectedPollQuarantine::GetSettings() const
+{
+    return Settings;
+}
+
+steady_clock::time_point TDisconnectedPollQuarantine::GetNextPollTime(const PSerialDevice& device,
+                                                                      steady_clock::time_point currentTime)
+{
+    auto& state = Devices[device];
+
+    // High and low priority registers of the device share the same schedule
+    if (state.NextPollTime > currentTime) {
+        return state.NextPollTime;
+    }
+
+    auto res = currentTime + GetDelay(state.FailedPolls);
+    ++state.FailedPolls;
+
+    // Wait until poll time share of disconnected devices goes under the limit
+    if (WindowTime.count() != 0) {
+        auto budgetTime = WindowStart + duration_cast<microseconds>(WindowTime / Settings.MaxBusShare);
+        res = std::max(res, time_point_cast<steady_clock::duration>(budgetTime));
+    }
+
+    // Don't let disconnected devices polls go one after another
+    auto spacing = GetSpacing();
+    if (spacing.count() != 0) {
+        std::vector<steady_clock::time_point> pollTimes;
+        for (const auto& item: Devices) {
+            if (item.first != device && item.second.NextPollTime >= currentTime) {
+                pollTimes.push_back(item.second.NextPollTime);
+            }
+        }
+        std::sort(pollTimes.begin(), pollTimes.end());
+        for (const auto& pollTime: pollTimes) {
+            if (res > pollTime - spacing && res < pollTime + spacing) {
+                res = pollTime + spacing;
+            }
+        }
+    }
+
+    state.NextPollTime = res;
+    return res;
+}
+
+void TDisconnectedPollQuarantine::Release(const PSerialDevice& device)
+{
+    Devices.erase(device);
+}
+
+void TDisconnectedPollQuarantine::AddPollTime(bool disconnected,
+                                              microseconds time,
+                                              steady_clock::time_point currentTime)
+{
+    if (WindowStart == steady_clock::time_point()) {
+        WindowStart = currentTime;
+    }
+    if (currentTime - WindowStart > ACCOUNTING_WINDOW) {
+        WindowStart = currentTime - ACCOUNTING_WINDOW / 2;
+        WindowTime /= 2;
+    }
+    if (!disconnected) {
+        return;
+    }
+    WindowTime += time;
+    TotalTimeUs += time.count();
+    AveragePollTime = AveragePollTime.count() ? (AveragePollTime * 3 + time) / 4 : time;
+}
+
+microseconds TDisconnectedPollQuarantine::GetDisconnectedDevicesPollTime() const
+{
+    return microseconds(TotalTimeUs.load());
+}
+
+double TDisconnectedPollQuarantine::GetDisconnectedDevicesPollShare(steady_clock::time_point currentTime) const
+{
+    auto elapsed = duration_cast<microseconds>(currentTime - WindowStart);
+    if (elapsed.count() <= 0) {
+        return 0;
+    }
+    return static_cast<double>(WindowTime.count()) / elapsed.count();
+}
+
+milliseconds TDisconnectedPollQuarantine::GetDelay(size_t failedPolls)
+{
+    auto delay = Settings.InitialDelay * (1 << std::min(failedPolls, MAX_BACKOFF_EXPONENT));
+    std::uniform_real_distribution<double> jitter(1 - MAX_JITTER, 1 + MAX_JITTER);
+    auto res = duration_cast<milliseconds>(std::min(delay, Settings.MaxDelay) * jitter(Random));
+    return std::min(res, Settings.MaxDelay);
+}
+
+microseconds TDisconnectedPollQuarantine::GetSpacing() const
+{
+    return duration_cast<microseconds>(AveragePollTime / Settings.MaxBusShare);
+}
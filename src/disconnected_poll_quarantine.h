@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+class TSerialDevice;
+typedef std::shared_ptr<TSerialDevice> PSerialDevice;
+
+struct TDisconnectedPollSettings
+{
+    //! Use exponential backoff and bus time budget instead of linear poll delay
+    bool Backoff = false;
+
+    //! Poll delay after the first failed poll of disconnected device
+    std::chrono::milliseconds InitialDelay = std::chrono::milliseconds(500);
+
+    //! Maximum poll delay of disconnected device
+    std::chrono::milliseconds MaxDelay = std::chrono::seconds(60);
+
+    //! Maximum share of port time spent on polling disconnected devices, 0 < MaxBusShare <= 1
+    double MaxBusShare = 0.2;
+};
+
+/**
+ * @brief Poll scheduling of disconnected devices.
+ *        Every disconnected device gets exponentially increasing poll delay with random jitter.
+ *        Polls of different disconnected devices are spaced so that their total bus time share
+ *        doesn't exceed the limit and they never go one after another.
+ *        The class also accounts time spent on polling disconnected devices.
+ */
+class TDisconnectedPollQuarantine
+{
+public:
+    TDisconnectedPollQuarantine(const TDisconnectedPollSettings& settings, std::minstd_rand::result_type seed = 1);
+
+    const TDisconnectedPollSettings& GetSettings() const;
+
+    /**
+     * @brief Calculates next poll time of disconnected device after failed poll
+     */
+    std::chrono::steady_clock::time_point GetNextPollTime(const PSerialDevice& device,
+                                                          std::chrono::steady_clock::time_point currentTime);
+
+    //! The device is connected again, its backoff is reset
+    void Release(const PSerialDevice& device);
+
+    /**
+     * @brief Accounts time spent on polling a device
+     *
+     * @param disconnected true if the device was disconnected before polling
+     * @param time poll duration
+     * @param currentTime poll start time
+     */
+    void AddPollTime(bool disconnected, std::chrono::microseconds time, std::chrono::steady_clock::time_point currentTime);
+
+    //! Total time spent on polling disconnected devices, the method is thread safe
+    std::chrono::microseconds GetDisconnectedDevicesPollTime() const;
+
+    //! Share of port time spent on polling disconnected devices in the last accounting window
+    //! The method must be called from polling thread
+    double GetDisconnectedDevicesPollShare(std::chrono::steady_clock::time_point currentTime) const;
+
+private:
+    struct TDeviceState
+    {
+        size_t FailedPolls = 0;
+        std::chrono::steady_clock::time_point NextPollTime;
+    };
+
+    TDisconnectedPollSettings Settings;
+    std::minstd_rand Random;
+    std::unordered_map<PSerialDevice, TDeviceState> Devices;
+
+    std::chrono::steady_clock::time_point WindowStart;
+    std::chrono::microseconds WindowTime = std::chrono::microseconds::zero();
+    std::chrono::microseconds AveragePollTime = std::chrono::microseconds::zero();
+    std::atomic<int64_t> TotalTimeUs = 0;
+
+    std::chrono::milliseconds GetDelay(size_t failedPolls);
+    std::chrono::microseconds GetSpacing() const;
+};
+
+typedef std::shared_ptr<TDisconnectedPollQuarantine> PDisconnectedPollQuarantine;
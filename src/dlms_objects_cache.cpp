@@ -0,0 +1,95 @@
+#include "dlms_objects_cache.h"
+
+#include <filesystem>
+#include <wblib/json_utils.h>
+
+#include "file_utils.h"
+#include "log.h"
+
+#define LOG(logger) logger.Log() << "[dlms] "
+
+namespace
+{
+    DLMS::TMeterIdentity GetIdentity(const Json::Value& item)
+    {
+        DLMS::TMeterIdentity res;
+        res.SerialNumber = item["serial_number"].asString();
+        res.Firmware = item["firmware"].asString();
+        return res;
+    }
+}
+
+namespace DLMS
+{
+    TObjectsCacheStorage::TObjectsCacheStorage(const std::string& filePath)
+        : FilePath(filePath),
+          Data(Json::objectValue)
+    {
+        if (!std::filesystem::exists(FilePath)) {
+            return;
+        }
+        try {
+            Data = WBMQTT::JSON::Parse(FilePath);
+            if (!Data.isObject()) {
+                Data = Json::Value(Json::objectValue);
+            }
+        } catch (const std::exception& e) {
+            LOG(Warn) << "Failed to load cached objects from " << FilePath << ": " << e.what();
+        }
+    }
+
+    std::optional<TObjectsCacheEntry> TObjectsCacheStorage::Find(const std::string& id,
+                                                                 const TMeterIdentity& identity)
+    {
+        std::unique_lock lock(Mutex);
+        if (!Data.isMember(id)) {
+            return std::nullopt;
+        }
+        const auto& item = Data[id];
+        if (!item.isObject() || !item["objects"].isObject()) {
+            return std::nullopt;
+        }
+        TObjectsCacheEntry res;
+        res.Identity = GetIdentity(item);
+        if (res.Identity != identity) {
+            LOG(Info) << id << ": meter or its firmware is changed, cached objects are dropped";
+            Data.removeMember(id);
+            Save();
+            return std::nullopt;
+        }
+        for (auto it = item["objects"].begin(); it != item["objects"].end(); ++it) {
+            res.ScalerUnits[it.name()] = TScalerUnit{(*it)["scaler"].asInt(), (*it)["unit"].asInt()};
+        }
+        return res;
+    }
+
+    void TObjectsCacheStorage::Set(const std::string& id, const TObjectsCacheEntry& entry)
+    {
+        std::unique_lock lock(Mutex);
+        Json::Value item(Json::objectValue);
+        item["serial_number"] = entry.Identity.SerialNumber;
+        item["firmware"] = entry.Identity.Firmware;
+        Json::Value objects(Json::objectValue);
+        for (const auto& [logicalName, scalerUnit]: entry.ScalerUnits) {
+            objects[logicalName]["scaler"] = scalerUnit.Scaler;
+            objects[logicalName]["unit"] = scalerUnit.Unit;
+        }
+        item["objects"] = objects;
+        Data[id] = item;
+        Save();
+    }
+
+    void TObjectsCacheStorage::Save()
+    {
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "  ";
+        try {
+            // Write to a temporary file first to keep the previous version on power loss
+            auto tmpFilePath = FilePath + ".tmp";
+            WriteToFile(tmpFilePath, Json::writeString(builder, Data));
+            std::filesystem::rename(tmpFilePath, FilePath);
+        } catch (const std::exception& e) {
+            LOG(Warn) << "Failed to save cached objects to " << FilePath << ": " << e.what();
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <wblib/json/json.h>
+
+namespace DLMS
+{
+    //! Scaler and unit of a register object (attribute 3)
+    struct TScalerUnit
+    {
+        //! Decimal exponent of the value
+        int Scaler = 0;
+        int Unit = 0;
+
+        bool operator==(const TScalerUnit& other) const = default;
+    };
+
+    //! Data identifying a meter and its firmware
+    struct TMeterIdentity
+    {
+        std::string SerialNumber;
+        std::string Firmware;
+
+        bool operator==(const TMeterIdentity& other) const = default;
+    };
+
+    //! Static metadata of objects read from a meter
+    struct TObjectsCacheEntry
+    {
+        TMeterIdentity Identity;
+
+        //! Scalers and units by logical names of register objects
+        std::map<std::string, TScalerUnit> ScalerUnits;
+
+        bool operator==(const TObjectsCacheEntry& other) const = default;
+    };
+
+    /**
+     * @brief Persistent storage of meters objects metadata.
+     *        It allows to skip reading of static attributes after reconnection or restart.
+     *        Entries are identified by port description, slave id and logical device address,
+     *        an entry is valid only for the same meter serial number and firmware.
+     */
+    class TObjectsCacheStorage
+    {
+    public:
+        TObjectsCacheStorage(const std::string& filePath);
+
+        /**
+         * @brief Finds cached objects of a meter.
+         *        An entry of another meter or firmware is stale, it is removed.
+         *
+         * @return cached objects or std::nullopt if they must be read from the meter
+         */
+        std::optional<TObjectsCacheEntry> Find(const std::string& id, const TMeterIdentity& identity);
+
+        void Set(const std::string& id, const TObjectsCacheEntry& entry);
+
+    private:
+        std::string FilePath;
+        std::mutex Mutex;
+        Json::Value Data;
+
+        void Save();
+    };
+}
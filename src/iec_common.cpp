@@ -1,8 +1,10 @@
 #include "iec_common.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include <string.h>
+#include <thread>
 
 #include "log.h"
 #include "port/serial_port.h"
@@ -11,6 +13,33 @@
 namespace IEC
 {
     const size_t RESPONSE_BUF_LEN = 1000;
+    const size_t DATA_READOUT_BUF_LEN = 16384;
+
+    const uint8_t DATA_READOUT_MODE = '0';
+    const uint8_t PROG_MODE = '1';
+
+    // Index is a baud rate code from identification message and mode select command
+    const std::vector<int> BAUD_RATES = {300, 600, 1200, 2400, 4800, 9600, 19200};
+
+    // Used if the baud rate code can't be found in identification message
+    const int FALLBACK_BAUD_RATE = 9600;
+
+    // Meters close a session after 60-120 s of inactivity, so a session is reopened a bit earlier
+    const std::chrono::seconds SESSION_INACTIVITY_TIMEOUT(55);
+
+    int GetBaudRate(uint8_t code)
+    {
+        return BAUD_RATES[code - '0'];
+    }
+
+    uint8_t GetBaudRateCode(int baudRate)
+    {
+        auto it = std::find(BAUD_RATES.begin(), BAUD_RATES.end(), baudRate);
+        if (it == BAUD_RATES.end()) {
+            throw TSerialDeviceException("Unsupported IEC61107 baud rate: " + std::to_string(baudRate));
+        }
+        return '0' + (it - BAUD_RATES.begin());
+    }
 
     TPort::TFrameCompletePred GetCRLFPacketPred()
     {
@@ -144,6 +173,96 @@ namespace IEC
         }
         return crc & 0x7F;
     }
+
+    TDataReadoutParser::TDataReadoutParser(TCrcFn crcFn)
+        : CrcFn(crcFn),
+          State(TState::WaitStart),
+          Pos(0),
+          StartPos(0),
+          ChecksumIsValid(false),
+          Value(nullptr)
+    {}
+
+    bool TDataReadoutParser::Parse(const uint8_t* buf, size_t size)
+    {
+        for (; Pos < size && State != TState::Complete; ++Pos) {
+            auto c = buf[Pos];
+            switch (State) {
+                case TState::WaitStart: {
+                    if (c == STX) {
+                        StartPos = Pos;
+                        State = TState::Address;
+                    }
+                    break;
+                }
+                case TState::Address: {
+                    if (c == ETX) {
+                        State = TState::WaitChecksum;
+                    } else if (c == '(') {
+                        // A value without address is the next value of previous data set
+                        if (!Address.empty() || !Value) {
+                            Value = &DataSets[Address];
+                            Value->clear();
+                            Address.clear();
+                        }
+                        Value->push_back(c);
+                        State = TState::Value;
+                    } else if (c != '\r' && c != '\n' && c != '!') {
+                        Address.push_back(c);
+                    }
+                    break;
+                }
+                case TState::Value: {
+                    if (c == ETX) {
+                        State = TState::WaitChecksum;
+                        break;
+                    }
+                    Value->push_back(c);
+                    if (c == ')') {
+                        State = TState::Address;
+                    }
+                    break;
+                }
+                case TState::WaitChecksum: {
+                    // BCC is calculated from the byte after STX up to and including ETX
+                    ChecksumIsValid = (c == CrcFn(buf + StartPos + 1, Pos - StartPos - 1));
+                    State = TState::Complete;
+                    break;
+                }
+                case TState::Complete:
+                    break;
+            }
+        }
+        return State == TState::Complete;
+    }
+
+    const std::unordered_map<std::string, std::string>& TDataReadoutParser::GetDataSets() const
+    {
+        if (State != TState::Complete) {
+            throw TSerialDeviceTransientErrorException("incomplete data readout");
+        }
+        if (!ChecksumIsValid) {
+            throw TSerialDeviceTransientErrorException("invalid data readout checksum");
+        }
+        return DataSets;
+    }
+}
+
+namespace
+{
+    //! All registers of a device are read by one data readout request, so the range is not limited
+    class TDataReadoutRegisterRange: public TRegisterRange
+    {
+    public:
+        bool Add(TPort& port, PRegister reg, std::chrono::milliseconds pollLimit) override
+        {
+            if (HasOtherDeviceAndType(reg)) {
+                return false;
+            }
+            RegisterList().push_back(reg);
+            return true;
+        }
+    };
 }
 
 TIEC61107Device::TIEC61107Device(PDeviceConfig device_config, PProtocol protocol)
@@ -188,7 +307,12 @@ TIEC61107ModeCDevice::TIEC61107ModeCDevice(PDeviceConfig device_config,
       LogPrefix(logPrefix),
       ReadCommand(IEC::UnformattedReadCommand),
       DefaultBaudRate(9600),
-      CurrentBaudRate(9600)
+      CurrentBaudRate(9600),
+      MeterBaudRateCode(IEC::GetBaudRateCode(IEC::FALLBACK_BAUD_RATE)),
+      BaudRateLimitCode(IEC::GetBaudRateCode(IEC::BAUD_RATES.back())),
+      BaudRateRaiseSessions(IEC::BAUD_RATE_RAISE_SESSIONS),
+      DataReadout(false),
+      ProgModeSessionIsOpen(false)
 {
     SetDesiredBaudRate(9600);
 }
@@ -196,12 +320,25 @@ TIEC61107ModeCDevice::TIEC61107ModeCDevice(PDeviceConfig device_config,
 void TIEC61107ModeCDevice::PrepareImpl(TPort& port)
 {
     TIEC61107Device::PrepareImpl(port);
+    // In data readout mode a session is started by every readout request
+    if (!DataReadout) {
+        OpenProgModeSession(port);
+    }
+}
+
+void TIEC61107ModeCDevice::OpenProgModeSession(TPort& port)
+{
     bool sessionIsOpen = false;
+    auto startTime = std::chrono::steady_clock::now();
     try {
         StartSession(port);
         sessionIsOpen = true;
         SwitchToProgMode(port);
         SendPassword(port);
+        ProgModeSessionIsOpen = true;
+        LastProgModeAccess = std::chrono::steady_clock::now();
+        AddSessionSetupTime(
+            std::chrono::duration_cast<std::chrono::microseconds>(LastProgModeAccess - startTime));
         SetTransferResult(true);
     } catch (const TSerialDeviceTransientErrorException& e) {
         Debug.Log() << LogPrefix << "Session start error: " << e.what() << " [slave_id is " << ToString() + "]";
@@ -214,17 +351,15 @@ void TIEC61107ModeCDevice::PrepareImpl(TPort& port)
 
 void TIEC61107ModeCDevice::StartSession(TPort& port)
 {
-    if (DefaultBaudRate != DesiredBaudRate) {
-        CurrentBaudRate = DefaultBaudRate;
-    }
+    CurrentBaudRate = DefaultBaudRate;
     TSerialPortConnectionSettings bf(CurrentBaudRate, 'E', 7, 1);
     port.ApplySerialPortSettings(bf);
     if (Probe(port)) {
         return;
     }
-    // Try desired baudrate, the device can remember it
-    if (DefaultBaudRate != DesiredBaudRate) {
-        bf.BaudRate = DesiredBaudRate;
+    // Try baudrate of previous session, the device can remember it
+    if (DefaultBaudRate != SessionBaudRate) {
+        bf.BaudRate = SessionBaudRate;
         port.ApplySerialPortSettings(bf);
         if (Probe(port)) {
             CurrentBaudRate = bf.BaudRate;
@@ -243,14 +378,21 @@ bool TIEC61107ModeCDevice::Probe(TPort& port)
             port.SkipNoise();
             // Send session start request
             WriteBytes(port, "/?" + SlaveId + "!\r\n");
-            // Pass identification response
-            IEC::ReadFrame(port,
-                           buf,
-                           sizeof(buf),
-                           GetResponseTimeout(port),
-                           GetFrameTimeout(port),
-                           IEC::GetCRLFPacketPred(),
-                           LogPrefix);
+            // Identification response: /XXXZIdentification<CR><LF>
+            // Z is the highest baud rate code supported by the meter
+            auto nread = IEC::ReadFrame(port,
+                                        buf,
+                                        sizeof(buf),
+                                        GetResponseTimeout(port),
+                                        GetFrameTimeout(port),
+                                        IEC::GetCRLFPacketPred(),
+                                        LogPrefix);
+            if (nread > 5 && buf[0] == '/' && buf[4] >= '0' && buf[4] <= IEC::GetBaudRateCode(IEC::BAUD_RATES.back()))
+            {
+                MeterBaudRateCode = buf[4];
+            } else {
+                MeterBaudRateCode = IEC::GetBaudRateCode(IEC::FALLBACK_BAUD_RATE);
+            }
             return true;
         } catch (const TSerialDeviceTransientErrorException& e) {
             --retryCount;
@@ -275,9 +417,132 @@ void TIEC61107ModeCDevice::InvalidateReadCache()
     TSerialDevice::InvalidateReadCache();
 }
 
+PRegisterRange TIEC61107ModeCDevice::CreateRegisterRange() const
+{
+    if (DataReadout) {
+        return std::make_shared<TDataReadoutRegisterRange>();
+    }
+    return TIEC61107Device::CreateRegisterRange();
+}
+
+void TIEC61107ModeCDevice::ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError)
+{
+    if (!DataReadout) {
+        TIEC61107Device::ReadRegisterRange(port, range, breakOnError);
+        return;
+    }
+
+    std::unordered_map<std::string, std::string> dataSets;
+    try {
+        dataSets = ReadDataReadout(port);
+        SetTransferResult(true);
+    } catch (const TSerialDeviceTransientErrorException& e) {
+        for (auto& reg: range->RegisterList()) {
+            reg->SetError(TRegister::TError::ReadError);
+        }
+        auto& logger = (GetConnectionState() == TDeviceConnectionState::DISCONNECTED) ? Debug : Warn;
+        logger.Log() << LogPrefix << "Data readout error: " << e.what() << " [slave_id is " << ToString() + "]";
+        SetTransferResult(false);
+        if (breakOnError) {
+            throw;
+        }
+        return;
+    }
+
+    auto missingRegs = std::make_shared<TDataReadoutRegisterRange>();
+    for (auto& reg: range->RegisterList()) {
+        if (reg->GetAvailable() == TRegisterAvailability::UNAVAILABLE) {
+            continue;
+        }
+        auto paramRequest = GetParameterRequest(*reg->GetConfig());
+        auto it = dataSets.find(paramRequest.substr(0, paramRequest.find('(')));
+        if (it == dataSets.end()) {
+            missingRegs->RegisterList().push_back(reg);
+            continue;
+        }
+        try {
+            reg->SetValue(GetRegisterValue(*reg->GetConfig(), it->second));
+        } catch (const TSerialDevicePermanentRegisterException& e) {
+            reg->SetAvailable(TRegisterAvailability::UNAVAILABLE);
+            reg->SetError(TRegister::TError::ReadError);
+            Warn.Log() << LogPrefix << e.what() << " [slave_id is " << ToString() + "] Register " << reg->ToString()
+                       << " is now marked as unsupported";
+        } catch (const TSerialDeviceException& e) {
+            reg->SetError(TRegister::TError::ReadError);
+            Warn.Log() << LogPrefix << e.what() << " [slave_id is " << ToString() + "] Register " << reg->ToString();
+        }
+    }
+
+    if (missingRegs->RegisterList().empty()) {
+        InvalidateReadCache();
+        return;
+    }
+
+    // Parameters missing in the readout are read one by one in programming mode
+    try {
+        OpenProgModeSession(port);
+    } catch (const TSerialDeviceTransientErrorException& e) {
+        for (auto& reg: missingRegs->RegisterList()) {
+            reg->SetError(TRegister::TError::ReadError);
+        }
+        SetTransferResult(false);
+        InvalidateReadCache();
+        if (breakOnError) {
+            throw;
+        }
+        return;
+    }
+    TIEC61107Device::ReadRegisterRange(port, missingRegs, breakOnError);
+}
+
+std::unordered_map<std::string, std::string> TIEC61107ModeCDevice::ReadDataReadout(TPort& port)
+{
+    port.CheckPortOpen();
+    if (ProgModeSessionIsOpen) {
+        SendEndSession(port);
+    }
+    auto startTime = std::chrono::steady_clock::now();
+    StartSession(port);
+    try {
+        SelectMode(port, IEC::DATA_READOUT_MODE);
+        AddSessionSetupTime(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime));
+        std::vector<uint8_t> buf(IEC::DATA_READOUT_BUF_LEN);
+        IEC::TDataReadoutParser parser(CrcFn);
+        try {
+            IEC::ReadFrame(
+                port,
+                buf.data(),
+                buf.size(),
+                GetResponseTimeout(port),
+                GetFrameTimeout(port),
+                [&parser](uint8_t* b, size_t s) { return parser.Parse(b, s); },
+                LogPrefix);
+        } catch (const TResponseTimeoutException& e) {
+            ProcessBaudRateFailure();
+            throw;
+        }
+        ProcessBaudRateSuccess();
+        // The meter closes the session after data readout
+        return parser.GetDataSets();
+    } catch (const TSerialDeviceTransientErrorException& e) {
+        SendEndSession(port);
+        throw;
+    }
+}
+
 TRegisterValue TIEC61107ModeCDevice::ReadRegisterImpl(TPort& port, const TRegisterConfig& reg)
 {
     port.CheckPortOpen();
+    // Reopen the session before the meter closes it because of inactivity
+    if (ProgModeSessionIsOpen &&
+        std::chrono::steady_clock::now() - LastProgModeAccess > IEC::SESSION_INACTIVITY_TIMEOUT)
+    {
+        SendEndSession(port);
+    }
+    if (!ProgModeSessionIsOpen) {
+        OpenProgModeSession(port);
+    }
     port.SkipNoise();
     return GetRegisterValue(reg, GetCachedResponse(port, GetParameterRequest(reg)));
 }
@@ -293,6 +558,7 @@ std::string TIEC61107ModeCDevice::GetCachedResponse(TPort& port, const std::stri
 
     uint8_t resp[IEC::RESPONSE_BUF_LEN] = {};
     auto len = ReadFrameProgMode(port, resp, sizeof(resp), IEC::STX);
+    LastProgModeAccess = std::chrono::steady_clock::now();
     // Proper response (inc. error) must start with STX, and end with ETX
     if ((resp[0] != IEC::STX) || (resp[len - 2] != IEC::ETX)) {
         throw TSerialDeviceTransientErrorException("malformed response");
@@ -322,20 +588,69 @@ std::string TIEC61107ModeCDevice::GetCachedResponse(TPort& port, const std::stri
     throw TSerialDeviceTransientErrorException(presp);
 }
 
-void TIEC61107ModeCDevice::SwitchToProgMode(TPort& port)
+void TIEC61107ModeCDevice::SelectMode(TPort& port, uint8_t mode)
 {
-    uint8_t buf[IEC::RESPONSE_BUF_LEN] = {};
-
-    WriteBytes(port, ToProgModeCommand);
-    if (CurrentBaudRate != DesiredBaudRate) {
+    auto baudRateCode = std::min({DesiredBaudRateCode, MeterBaudRateCode, BaudRateLimitCode});
+    auto baudRate = IEC::GetBaudRate(baudRateCode);
+    WriteBytes(port, std::vector<uint8_t>{IEC::ACK, '0', baudRateCode, mode, '\r', '\n'});
+    SessionBaudRate = baudRate;
+    if (CurrentBaudRate != baudRate) {
         // Time before response must be more than 20ms according to standard
         // Wait some time to transmit request
         port.SleepSinceLastInteraction(std::chrono::milliseconds(10));
-        TSerialPortConnectionSettings bf(DesiredBaudRate, 'E', 7, 1);
+        TSerialPortConnectionSettings bf(baudRate, 'E', 7, 1);
         port.ApplySerialPortSettings(bf);
-        CurrentBaudRate = DesiredBaudRate;
+        CurrentBaudRate = baudRate;
+    }
+}
+
+void TIEC61107ModeCDevice::ProcessBaudRateFailure()
+{
+    // The meter can declare a baud rate which doesn't work on the line, so use lower one in next sessions.
+    // A single timeout can be caused by noise on the bus, so the limit is lowered after several ones in a row
+    BaudRateSessions = 0;
+    if (CurrentBaudRate == DefaultBaudRate || ++BaudRateFailures < IEC::BAUD_RATE_FAILURES_THRESHOLD) {
+        return;
+    }
+    BaudRateFailures = 0;
+    BaudRateLimitCode = IEC::GetBaudRateCode(CurrentBaudRate) - 1;
+    if (BaudRateLimitRaised) {
+        // The line still doesn't allow the higher baud rate, try it less often
+        BaudRateRaiseSessions = std::min(BaudRateRaiseSessions * 2, IEC::MAX_BAUD_RATE_RAISE_SESSIONS);
+        BaudRateLimitRaised = false;
+    }
+    Warn.Log() << LogPrefix << "No response at " << CurrentBaudRate << " baud, "
+               << IEC::GetBaudRate(BaudRateLimitCode) << " baud will be used [slave_id is " << ToString() + "]";
+}
+
+void TIEC61107ModeCDevice::ProcessBaudRateSuccess()
+{
+    BaudRateFailures = 0;
+    // Line conditions can improve, so a higher baud rate is tried after some successful sessions
+    if (BaudRateLimitCode >= std::min(DesiredBaudRateCode, MeterBaudRateCode) ||
+        ++BaudRateSessions < BaudRateRaiseSessions)
+    {
+        return;
+    }
+    BaudRateSessions = 0;
+    ++BaudRateLimitCode;
+    BaudRateLimitRaised = true;
+    Debug.Log() << LogPrefix << IEC::GetBaudRate(BaudRateLimitCode) << " baud will be tried [slave_id is "
+                << ToString() + "]";
+}
+
+void TIEC61107ModeCDevice::SwitchToProgMode(TPort& port)
+{
+    uint8_t buf[IEC::RESPONSE_BUF_LEN] = {};
+
+    SelectMode(port, IEC::PROG_MODE);
+    try {
+        ReadFrameProgMode(port, buf, sizeof(buf), IEC::SOH);
+    } catch (const TResponseTimeoutException& e) {
+        ProcessBaudRateFailure();
+        throw;
     }
-    ReadFrameProgMode(port, buf, sizeof(buf), IEC::SOH);
+    ProcessBaudRateSuccess();
 
     // <SOH>P0<STX>(IDENTIFIER)<ETX>CRC
     if (buf[1] != 'P' || buf[2] != '0' || buf[3] != IEC::STX) {
@@ -367,6 +682,7 @@ void TIEC61107ModeCDevice::SendEndSession(TPort& port)
 {
     // We need to terminate the session so meter won't respond to the data meant for other devices
     WriteBytes(port, IEC::MakeRequest("B0", CrcFn));
+    ProgModeSessionIsOpen = false;
 
     // A device needs some time to process the command
     std::this_thread::sleep_for(GetFrameTimeout(port));
@@ -417,17 +733,8 @@ void TIEC61107ModeCDevice::SetReadCommand(const std::string& command)
 
 void TIEC61107ModeCDevice::SetDesiredBaudRate(int baudRate)
 {
-    const std::unordered_map<int, uint8_t> supportedBaudRates = {{300, '0'},
-                                                                 {2400, '3'},
-                                                                 {4800, '4'},
-                                                                 {9600, '5'},
-                                                                 {19200, '6'}};
-    auto baudRateCodeIt = supportedBaudRates.find(baudRate);
-    if (baudRateCodeIt == supportedBaudRates.end()) {
-        throw TSerialDeviceException("Unsupported IEC61107 baud rate: " + std::to_string(baudRate));
-    }
-    DesiredBaudRate = baudRate;
-    ToProgModeCommand = {IEC::ACK, '0', baudRateCodeIt->second, '1', '\r', '\n'};
+    DesiredBaudRateCode = IEC::GetBaudRateCode(baudRate);
+    SessionBaudRate = baudRate;
 }
 
 void TIEC61107ModeCDevice::SetDefaultBaudRate(int baudRate)
@@ -435,3 +742,8 @@ void TIEC61107ModeCDevice::SetDefaultBaudRate(int baudRate)
     DefaultBaudRate = baudRate;
     CurrentBaudRate = baudRate;
 }
+
+void TIEC61107ModeCDevice::SetDataReadout(bool enable)
+{
+    DataReadout = enable;
+}
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "serial_device.h"
@@ -18,6 +19,15 @@ namespace IEC
     const std::string UnformattedReadCommand = "R1";
     const std::string FormattedReadCommand = "R2";
 
+    //! Count of sessions failed in a row after switching to a baud rate required to stop using it
+    const size_t BAUD_RATE_FAILURES_THRESHOLD = 3;
+
+    //! Count of successful sessions at a lowered baud rate required to try a higher one
+    const size_t BAUD_RATE_RAISE_SESSIONS = 10;
+
+    //! The interval between tries of a higher baud rate is doubled after every failed try up to this count
+    const size_t MAX_BAUD_RATE_RAISE_SESSIONS = 1000;
+
     typedef std::function<uint8_t(const uint8_t* buf, size_t size)> TCrcFn;
 
     size_t ReadFrame(TPort& port,
@@ -39,6 +49,53 @@ namespace IEC
 
     //! A XOR of all bytes modulus 0x7F
     uint8_t CalcXorCRC(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Incremental parser of mode C data readout message.
+     *        <STX>1.8.0(019132.530*kWh)<CR><LF>0.9.1(12:00:00)(01)<CR><LF>!<CR><LF><ETX><BCC>
+     *        Data sets are parsed as bytes are received, so the parser can be used as a frame complete predicate.
+     */
+    class TDataReadoutParser
+    {
+    public:
+        explicit TDataReadoutParser(TCrcFn crcFn);
+
+        /**
+         * @brief Parse bytes received since previous call
+         *
+         * @param buf - the whole received message
+         * @param size - size of received message
+         * @return true if the message is complete
+         */
+        bool Parse(const uint8_t* buf, size_t size);
+
+        /**
+         * @brief Get parsed data sets
+         *        Values are stored with brackets, as in response to read command: 1.8.0 -> (019132.530*kWh)
+         *
+         * @throws TSerialDeviceTransientErrorException if the message is incomplete or has wrong checksum
+         */
+        const std::unordered_map<std::string, std::string>& GetDataSets() const;
+
+    private:
+        enum class TState
+        {
+            WaitStart,
+            Address,
+            Value,
+            WaitChecksum,
+            Complete
+        };
+
+        TCrcFn CrcFn;
+        TState State;
+        size_t Pos;
+        size_t StartPos;
+        bool ChecksumIsValid;
+        std::string Address;
+        std::string* Value;
+        std::unordered_map<std::string, std::string> DataSets;
+    };
 }
 
 /**
@@ -83,12 +140,28 @@ public:
     //! Set the read command. Default: "R1"
     void SetReadCommand(const std::string& command);
 
-    //! Set desired baud rate. Default: 9600
+    /**
+     * @brief Set desired baud rate. Default: 9600
+     *        It is the highest baud rate used in session.
+     *        Lower baud rate is used if the meter declares it in identification message
+     *        or doesn't respond after switching to desired one.
+     *        9600 is used if identification message doesn't contain baud rate code.
+     */
     void SetDesiredBaudRate(int baudRate);
 
     //! Set default baud rate on session start. Default: 9600
     void SetDefaultBaudRate(int baudRate);
 
+    /**
+     * @brief Read all values by one data readout request instead of a request per parameter.
+     *        Parameters missing in the readout are read in programming mode.
+     *        Default: false
+     */
+    void SetDataReadout(bool enable);
+
+    PRegisterRange CreateRegisterRange() const override;
+    void ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError = false) override;
+
 protected:
     /**
      * @brief Get string with parameter request for read command
@@ -116,13 +189,42 @@ private:
     std::string ReadCommand;
     int DefaultBaudRate;
     int CurrentBaudRate;
-    int DesiredBaudRate;
-    std::vector<uint8_t> ToProgModeCommand;
+    uint8_t DesiredBaudRateCode;
+
+    //! Baud rate code from meter's identification message
+    uint8_t MeterBaudRateCode;
+
+    //! Lowered if the meter doesn't respond after switching to a baud rate
+    uint8_t BaudRateLimitCode;
+
+    //! Count of failed sessions in a row after switching to a higher baud rate
+    size_t BaudRateFailures = 0;
+
+    //! Count of successful sessions since the limit was lowered or raised
+    size_t BaudRateSessions = 0;
+
+    //! Count of successful sessions required to try a higher baud rate
+    size_t BaudRateRaiseSessions;
+
+    //! The limit was raised and the meter hasn't failed at the new baud rate yet
+    bool BaudRateLimitRaised = false;
+
+    //! Baud rate of last session, the meter can remember it
+    int SessionBaudRate;
+
+    bool DataReadout;
+    bool ProgModeSessionIsOpen;
+    std::chrono::steady_clock::time_point LastProgModeAccess;
 
     std::string GetCachedResponse(TPort& port, const std::string& paramAddress);
     bool Probe(TPort& port);
     void StartSession(TPort& port);
+    void OpenProgModeSession(TPort& port);
+    void SelectMode(TPort& port, uint8_t mode);
+    void ProcessBaudRateFailure();
+    void ProcessBaudRateSuccess();
     void SwitchToProgMode(TPort& port);
+    std::unordered_map<std::string, std::string> ReadDataReadout(TPort& port);
     void SendPassword(TPort& port);
     void SendEndSession(TPort& port);
     size_t ReadFrameProgMode(TPort& port, uint8_t* buffer, size_t size, uint8_t startByte);
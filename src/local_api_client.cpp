@@ -0,0 +1,110 @@
+#include "local_api_client.h"
+#include "serial_exc.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace LocalApi;
+using namespace std::chrono;
+
+TLocalApiClient::TLocalApiClient(const std::string& socketPath, milliseconds responseTimeout)
+    : ResponseTimeout(responseTimeout),
+      NextRequestId(0)
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("local API socket path is too long: " + socketPath);
+    }
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    Fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (Fd < 0) {
+        throw std::runtime_error("can't create socket: " + FormatErrno(errno));
+    }
+    if (connect(Fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        auto err = errno;
+        close(Fd);
+        throw std::runtime_error("can't connect to " + socketPath + ": " + FormatErrno(err));
+    }
+}
+
+TLocalApiClient::~TLocalApiClient()
+{
+    close(Fd);
+}
+
+std::vector<TReadResult> TLocalApiClient::Read(const std::vector<std::string>& channels)
+{
+    auto requestId = NextRequestId++;
+    auto response = Request(EncodeReadRequest(requestId, channels), requestId, TMessageType::ReadResponse);
+    return DecodeReadResponse(response.Payload);
+}
+
+std::vector<TWriteResult> TLocalApiClient::Write(const std::vector<std::pair<std::string, std::string>>& values)
+{
+    auto requestId = NextRequestId++;
+    auto response = Request(EncodeWriteRequest(requestId, values), requestId, TMessageType::WriteResponse);
+    return DecodeWriteResponse(response.Payload);
+}
+
+TMessage TLocalApiClient::Request(const std::string& request, uint32_t requestId, TMessageType responseType)
+{
+    size_t sent = 0;
+    while (sent < request.size()) {
+        auto res = send(Fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("local API request failed: " + FormatErrno(errno));
+        }
+        sent += res;
+    }
+
+    auto deadline = steady_clock::now() + ResponseTimeout;
+    while (true) {
+        auto message = DecodeMessage(Input);
+        if (message) {
+            // Responses to previous timed out requests are skipped
+            if (message->RequestId != requestId) {
+                continue;
+            }
+            if (message->Type == TMessageType::ErrorResponse) {
+                throw std::runtime_error("local API error: " + DecodeErrorResponse(message->Payload));
+            }
+            if (message->Type != responseType) {
+                throw TProtocolError("unexpected response type");
+            }
+            return *message;
+        }
+
+        auto timeout = duration_cast<milliseconds>(deadline - steady_clock::now());
+        pollfd fd{Fd, POLLIN, 0};
+        auto res = poll(&fd, 1, std::max<int>(timeout.count(), 0));
+        if (res < 0 && errno != EINTR) {
+            throw std::runtime_error("local API response wait failed: " + FormatErrno(errno));
+        }
+        if (res == 0) {
+            throw std::runtime_error("local API response timeout");
+        }
+        if (res > 0) {
+            char buf[4096];
+            auto size = recv(Fd, buf, sizeof(buf), 0);
+            if (size < 0 && errno != EINTR) {
+                throw std::runtime_error("local API response read failed: " + FormatErrno(errno));
+            }
+            if (size == 0) {
+                throw std::runtime_error("local API connection is closed");
+            }
+            if (size > 0) {
+                Input.append(buf, size);
+            }
+        }
+    }
+}
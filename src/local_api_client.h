@@ -0,0 +1,34 @@
+#pragma once
+
+#include "local_api_protocol.h"
+
+#include <chrono>
+
+/**
+ * @brief Blocking client of local API for programs running on the same controller.
+ *        The client is not thread safe.
+ */
+class TLocalApiClient
+{
+public:
+    TLocalApiClient(const std::string& socketPath,
+                    std::chrono::milliseconds responseTimeout = std::chrono::milliseconds(5000));
+    ~TLocalApiClient();
+
+    TLocalApiClient(const TLocalApiClient&) = delete;
+    TLocalApiClient& operator=(const TLocalApiClient&) = delete;
+
+    //! Get last read values of channels ("device_id/control_id")
+    std::vector<LocalApi::TReadResult> Read(const std::vector<std::string>& channels);
+
+    //! Write channels and wait for completion of all writes
+    std::vector<LocalApi::TWriteResult> Write(const std::vector<std::pair<std::string, std::string>>& values);
+
+private:
+    LocalApi::TMessage Request(const std::string& request, uint32_t requestId, LocalApi::TMessageType responseType);
+
+    int Fd;
+    std::chrono::milliseconds ResponseTimeout;
+    uint32_t NextRequestId;
+    std::string Input;
+};
@@ -0,0 +1,261 @@
+#include "local_api_protocol.h"
+
+#include <limits>
+
+using namespace LocalApi;
+
+namespace
+{
+    class TEncoder
+    {
+    public:
+        TEncoder(TMessageType type, uint32_t requestId)
+        {
+            AppendUint32(0); // size placeholder
+            AppendUint8(static_cast<uint8_t>(type));
+            AppendUint32(requestId);
+        }
+
+        void AppendUint8(uint8_t value)
+        {
+            Data.push_back(static_cast<char>(value));
+        }
+
+        void AppendUint16(uint16_t value)
+        {
+            AppendUint8(value & 0xFF);
+            AppendUint8(value >> 8);
+        }
+
+        void AppendUint32(uint32_t value)
+        {
+            AppendUint16(value & 0xFFFF);
+            AppendUint16(value >> 16);
+        }
+
+        void AppendCount(size_t count)
+        {
+            if (count > std::numeric_limits<uint16_t>::max()) {
+                throw TProtocolError("too many items in message: " + std::to_string(count));
+            }
+            AppendUint16(count);
+        }
+
+        void AppendString(const std::string& value)
+        {
+            if (value.size() > std::numeric_limits<uint16_t>::max()) {
+                throw TProtocolError("too long string in message");
+            }
+            AppendUint16(value.size());
+            Data += value;
+        }
+
+        std::string Finish()
+        {
+            if (Data.size() > MAX_MESSAGE_SIZE) {
+                throw TProtocolError("message is too big: " + std::to_string(Data.size()));
+            }
+            uint32_t size = Data.size() - sizeof(uint32_t);
+            for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+                Data[i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+            }
+            return std::move(Data);
+        }
+
+    private:
+        std::string Data;
+    };
+
+    class TDecoder
+    {
+    public:
+        explicit TDecoder(const std::string& data): Data(data)
+        {}
+
+        uint8_t GetUint8()
+        {
+            if (Pos >= Data.size()) {
+                throw TProtocolError("unexpected end of message");
+            }
+            return static_cast<uint8_t>(Data[Pos++]);
+        }
+
+        uint16_t GetUint16()
+        {
+            uint16_t res = GetUint8();
+            return res | (static_cast<uint16_t>(GetUint8()) << 8);
+        }
+
+        uint32_t GetUint32()
+        {
+            uint32_t res = GetUint16();
+            return res | (static_cast<uint32_t>(GetUint16()) << 16);
+        }
+
+        std::string GetString()
+        {
+            size_t size = GetUint16();
+            if (Data.size() - Pos < size) {
+                throw TProtocolError("unexpected end of message");
+            }
+            auto res = Data.substr(Pos, size);
+            Pos += size;
+            return res;
+        }
+
+        TStatus GetStatus()
+        {
+            auto status = GetUint8();
+            if (status > static_cast<uint8_t>(TStatus::WriteError)) {
+                throw TProtocolError("unknown status: " + std::to_string(status));
+            }
+            return static_cast<TStatus>(status);
+        }
+
+        void CheckEnd() const
+        {
+            if (Pos != Data.size()) {
+                throw TProtocolError("unexpected data at the end of message");
+            }
+        }
+
+    private:
+        const std::string& Data;
+        size_t Pos = 0;
+    };
+}
+
+TProtocolError::TProtocolError(const std::string& message): std::runtime_error(message)
+{}
+
+std::string LocalApi::EncodeReadRequest(uint32_t requestId, const std::vector<std::string>& channels)
+{
+    TEncoder encoder(TMessageType::ReadRequest, requestId);
+    encoder.AppendCount(channels.size());
+    for (const auto& channel: channels) {
+        encoder.AppendString(channel);
+    }
+    return encoder.Finish();
+}
+
+std::string LocalApi::EncodeReadResponse(uint32_t requestId, const std::vector<TReadResult>& results)
+{
+    TEncoder encoder(TMessageType::ReadResponse, requestId);
+    encoder.AppendCount(results.size());
+    for (const auto& result: results) {
+        encoder.AppendUint8(static_cast<uint8_t>(result.Status));
+        encoder.AppendString(result.Value);
+        encoder.AppendString(result.Error);
+    }
+    return encoder.Finish();
+}
+
+std::string LocalApi::EncodeWriteRequest(uint32_t requestId,
+                                         const std::vector<std::pair<std::string, std::string>>& values)
+{
+    TEncoder encoder(TMessageType::WriteRequest, requestId);
+    encoder.AppendCount(values.size());
+    for (const auto& value: values) {
+        encoder.AppendString(value.first);
+        encoder.AppendString(value.second);
+    }
+    return encoder.Finish();
+}
+
+std::string LocalApi::EncodeWriteResponse(uint32_t requestId, const std::vector<TWriteResult>& results)
+{
+    TEncoder encoder(TMessageType::WriteResponse, requestId);
+    encoder.AppendCount(results.size());
+    for (const auto& result: results) {
+        encoder.AppendUint8(static_cast<uint8_t>(result.Status));
+        encoder.AppendString(result.Error);
+    }
+    return encoder.Finish();
+}
+
+std::string LocalApi::EncodeErrorResponse(uint32_t requestId, const std::string& message)
+{
+    TEncoder encoder(TMessageType::ErrorResponse, requestId);
+    encoder.AppendString(message);
+    return encoder.Finish();
+}
+
+std::optional<TMessage> LocalApi::DecodeMessage(std::string& buffer)
+{
+    if (buffer.size() < sizeof(uint32_t)) {
+        return std::nullopt;
+    }
+    TDecoder decoder(buffer);
+    size_t size = decoder.GetUint32();
+    if (size + sizeof(uint32_t) > MAX_MESSAGE_SIZE) {
+        throw TProtocolError("message is too big: " + std::to_string(size));
+    }
+    if (size + sizeof(uint32_t) < HEADER_SIZE) {
+        throw TProtocolError("message is too small: " + std::to_string(size));
+    }
+    if (buffer.size() < size + sizeof(uint32_t)) {
+        return std::nullopt;
+    }
+    TMessage message;
+    message.Type = static_cast<TMessageType>(decoder.GetUint8());
+    message.RequestId = decoder.GetUint32();
+    message.Payload = buffer.substr(HEADER_SIZE, size + sizeof(uint32_t) - HEADER_SIZE);
+    buffer.erase(0, size + sizeof(uint32_t));
+    return message;
+}
+
+std::vector<std::string> LocalApi::DecodeReadRequest(const std::string& payload)
+{
+    TDecoder decoder(payload);
+    std::vector<std::string> res(decoder.GetUint16());
+    for (auto& channel: res) {
+        channel = decoder.GetString();
+    }
+    decoder.CheckEnd();
+    return res;
+}
+
+std::vector<TReadResult> LocalApi::DecodeReadResponse(const std::string& payload)
+{
+    TDecoder decoder(payload);
+    std::vector<TReadResult> res(decoder.GetUint16());
+    for (auto& result: res) {
+        result.Status = decoder.GetStatus();
+        result.Value = decoder.GetString();
+        result.Error = decoder.GetString();
+    }
+    decoder.CheckEnd();
+    return res;
+}
+
+std::vector<std::pair<std::string, std::string>> LocalApi::DecodeWriteRequest(const std::string& payload)
+{
+    TDecoder decoder(payload);
+    std::vector<std::pair<std::string, std::string>> res(decoder.GetUint16());
+    for (auto& value: res) {
+        value.first = decoder.GetString();
+        value.second = decoder.GetString();
+    }
+    decoder.CheckEnd();
+    return res;
+}
+
+std::vector<TWriteResult> LocalApi::DecodeWriteResponse(const std::string& payload)
+{
+    TDecoder decoder(payload);
+    std::vector<TWriteResult> res(decoder.GetUint16());
+    for (auto& result: res) {
+        result.Status = decoder.GetStatus();
+        result.Error = decoder.GetString();
+    }
+    decoder.CheckEnd();
+    return res;
+}
+
+std::string LocalApi::DecodeErrorResponse(const std::string& payload)
+{
+    TDecoder decoder(payload);
+    auto res = decoder.GetString();
+    decoder.CheckEnd();
+    return res;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Binary protocol of local Unix socket API for fast channel reads and writes.
+ *
+ *        All numbers are little endian. Every message is
+ *            uint32 size of the rest of the message
+ *            uint8  message type (TMessageType)
+ *            uint32 request id, the response has the id of the request
+ *            payload
+ *        Strings are encoded as uint16 size followed by bytes.
+ *        Channels are identified by "device_id/control_id" as in MQTT.
+ *
+ *        ReadRequest:   uint16 count, count * (string channel)
+ *        ReadResponse:  uint16 count, count * (uint8 status, string value, string error)
+ *        WriteRequest:  uint16 count, count * (string channel, string value)
+ *        WriteResponse: uint16 count, count * (uint8 status, string error)
+ *        ErrorResponse: string message, is sent on malformed request
+ *
+ *        Read responses contain the last values read by the driver, the bus is not accessed.
+ *        Write response is sent when all writes of the request are completed or failed.
+ *        Value and error strings are the same as published to MQTT.
+ */
+namespace LocalApi
+{
+    const size_t MAX_MESSAGE_SIZE = 65536;
+    const size_t HEADER_SIZE = 9;
+
+    enum class TMessageType : uint8_t
+    {
+        ReadRequest = 0x01,
+        WriteRequest = 0x02,
+        ReadResponse = 0x81,
+        WriteResponse = 0x82,
+        ErrorResponse = 0xFF
+    };
+
+    enum class TStatus : uint8_t
+    {
+        Ok = 0,
+        NotFound = 1,
+        //! Channel's value is not read yet
+        NoValue = 2,
+        InvalidValue = 3,
+        WriteError = 4
+    };
+
+    struct TReadResult
+    {
+        TStatus Status = TStatus::Ok;
+        std::string Value;
+        std::string Error;
+    };
+
+    struct TWriteResult
+    {
+        TStatus Status = TStatus::Ok;
+        std::string Error;
+    };
+
+    struct TMessage
+    {
+        TMessageType Type;
+        uint32_t RequestId;
+        std::string Payload;
+    };
+
+    class TProtocolError: public std::runtime_error
+    {
+    public:
+        explicit TProtocolError(const std::string& message);
+    };
+
+    std::string EncodeReadRequest(uint32_t requestId, const std::vector<std::string>& channels);
+    std::string EncodeReadResponse(uint32_t requestId, const std::vector<TReadResult>& results);
+    std::string EncodeWriteRequest(uint32_t requestId, const std::vector<std::pair<std::string, std::string>>& values);
+    std::string EncodeWriteResponse(uint32_t requestId, const std::vector<TWriteResult>& results);
+    std::string EncodeErrorResponse(uint32_t requestId, const std::string& message);
+
+    /**
+     * @brief Extract a message from the beginning of the buffer
+     *
+     * @return the message and removes it from the buffer or nullopt if the buffer has no complete message
+     * @throw TProtocolError if the message is too big
+     */
+    std::optional<TMessage> DecodeMessage(std::string& buffer);
+
+    //! @throw TProtocolError on malformed payload
+    std::vector<std::string> DecodeReadRequest(const std::string& payload);
+    std::vector<TReadResult> DecodeReadResponse(const std::string& payload);
+    std::vector<std::pair<std::string, std::string>> DecodeWriteRequest(const std::string& payload);
+    std::vector<TWriteResult> DecodeWriteResponse(const std::string& payload);
+    std::string DecodeErrorResponse(const std::string& payload);
+}
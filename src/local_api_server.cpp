@@ -0,0 +1,364 @@
+#include "local_api_server.h"
+#include "log.h"
+#include "serial_exc.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace LocalApi;
+
+#define LOG(logger) logger.Log() << "[local api] "
+
+namespace
+{
+    const int LISTEN_BACKLOG = 16;
+    const size_t READ_BUFFER_SIZE = 4096;
+
+    struct TPendingWrite
+    {
+        std::mutex Mutex;
+        std::vector<TWriteResult> Results;
+        size_t Remaining;
+    };
+}
+
+/**
+ * @brief Responses of asynchronously completed writes.
+ *        It is shared with write callbacks, so it outlives the server if writes are completed after stop.
+ */
+class TLocalApiServer::TResponseQueue
+{
+public:
+    TResponseQueue()
+    {
+        Fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (Fd < 0) {
+            throw std::runtime_error("can't create eventfd: " + FormatErrno(errno));
+        }
+    }
+
+    ~TResponseQueue()
+    {
+        close(Fd);
+    }
+
+    void Push(uint64_t connectionId, std::string response)
+    {
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            Responses.emplace_back(connectionId, std::move(response));
+        }
+        Wakeup();
+    }
+
+    std::vector<std::pair<uint64_t, std::string>> Take()
+    {
+        uint64_t counter;
+        if (read(Fd, &counter, sizeof(counter)) < 0 && errno != EAGAIN) {
+            LOG(Warn) << "eventfd read failed: " << FormatErrno(errno);
+        }
+        std::vector<std::pair<uint64_t, std::string>> res;
+        std::unique_lock<std::mutex> lock(Mutex);
+        res.swap(Responses);
+        return res;
+    }
+
+    void Wakeup()
+    {
+        uint64_t one = 1;
+        if (write(Fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            LOG(Warn) << "eventfd write failed: " << FormatErrno(errno);
+        }
+    }
+
+    int GetFd() const
+    {
+        return Fd;
+    }
+
+private:
+    int Fd;
+    std::mutex Mutex;
+    std::vector<std::pair<uint64_t, std::string>> Responses;
+};
+
+TLocalApiServer::TLocalApiServer(const std::string& socketPath, PLocalApiBackend backend)
+    : SocketPath(socketPath),
+      Backend(backend),
+      ListenFd(-1),
+      Responses(std::make_shared<TResponseQueue>()),
+      NextConnectionId(0),
+      Active(false)
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (SocketPath.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("local API socket path is too long: " + SocketPath);
+    }
+    strncpy(addr.sun_path, SocketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    ListenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (ListenFd < 0) {
+        throw std::runtime_error("can't create local API socket: " + FormatErrno(errno));
+    }
+    // Remove socket file left after previous run
+    unlink(SocketPath.c_str());
+    if (bind(ListenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        chmod(SocketPath.c_str(), 0660) != 0 || listen(ListenFd, LISTEN_BACKLOG) != 0)
+    {
+        auto err = errno;
+        close(ListenFd);
+        throw std::runtime_error("can't listen local API socket " + SocketPath + ": " + FormatErrno(err));
+    }
+}
+
+TLocalApiServer::~TLocalApiServer()
+{
+    Stop();
+    for (auto& connection: Connections) {
+        close(connection.second.Fd);
+    }
+    close(ListenFd);
+    unlink(SocketPath.c_str());
+}
+
+void TLocalApiServer::Start()
+{
+    if (Active.exchange(true)) {
+        return;
+    }
+    Thread = std::thread([this]() { Loop(); });
+}
+
+void TLocalApiServer::Stop()
+{
+    if (!Active.exchange(false)) {
+        return;
+    }
+    Responses->Wakeup();
+    if (Thread.joinable()) {
+        Thread.join();
+    }
+}
+
+const std::string& TLocalApiServer::GetSocketPath() const
+{
+    return SocketPath;
+}
+
+void TLocalApiServer::Loop()
+{
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> connectionIds;
+    while (Active) {
+        fds.clear();
+        connectionIds.clear();
+        fds.push_back({ListenFd, POLLIN, 0});
+        fds.push_back({Responses->GetFd(), POLLIN, 0});
+        for (const auto& connection: Connections) {
+            short events = POLLIN;
+            if (!connection.second.Output.empty()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({connection.second.Fd, events, 0});
+            connectionIds.push_back(connection.first);
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(Error) << "poll failed: " << FormatErrno(errno);
+            break;
+        }
+        if (!Active) {
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            MoveResponsesToConnections();
+        }
+        for (size_t i = 0; i < connectionIds.size(); ++i) {
+            auto id = connectionIds[i];
+            auto it = Connections.find(id);
+            if (it == Connections.end()) {
+                continue;
+            }
+            auto revents = fds[i + 2].revents;
+            bool ok = !(revents & (POLLERR | POLLNVAL));
+            if (ok && (revents & (POLLIN | POLLHUP))) {
+                ok = ReadInput(it->second);
+                try {
+                    // Responses of remaining messages would exceed the buffer limit, the connection is closed below
+                    while (ok && it->second.Output.size() <= MAX_OUTPUT_BUFFER_SIZE) {
+                        auto message = DecodeMessage(it->second.Input);
+                        if (!message) {
+                            break;
+                        }
+                        HandleMessage(id, it->second, *message);
+                    }
+                } catch (const TProtocolError& e) {
+                    // Message boundaries are lost, so the connection can't be used anymore
+                    LOG(Debug) << "closing connection: " << e.what();
+                    ok = false;
+                }
+            }
+            if (ok && !it->second.Output.empty()) {
+                ok = WriteOutput(it->second);
+            }
+            if (ok && it->second.Output.size() > MAX_OUTPUT_BUFFER_SIZE) {
+                LOG(Warn) << "closing connection: client doesn't read responses, "
+                          << it->second.Output.size() << " bytes are pending";
+                ok = false;
+            }
+            if (!ok) {
+                CloseConnection(id);
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            Accept();
+        }
+    }
+}
+
+void TLocalApiServer::Accept()
+{
+    while (true) {
+        int fd = accept4(ListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG(Warn) << "accept failed: " << FormatErrno(errno);
+            }
+            return;
+        }
+        Connections.emplace(NextConnectionId++, TConnection{fd, {}, {}});
+    }
+}
+
+void TLocalApiServer::CloseConnection(uint64_t connectionId)
+{
+    auto it = Connections.find(connectionId);
+    if (it != Connections.end()) {
+        close(it->second.Fd);
+        Connections.erase(it);
+    }
+}
+
+bool TLocalApiServer::ReadInput(TConnection& connection)
+{
+    char buf[READ_BUFFER_SIZE];
+    while (true) {
+        auto res = recv(connection.Fd, buf, sizeof(buf), 0);
+        if (res > 0) {
+            connection.Input.append(buf, res);
+            // Don't let a client to allocate unlimited memory, DecodeMessage checks message size
+            if (connection.Input.size() >= MAX_MESSAGE_SIZE) {
+                return true;
+            }
+            continue;
+        }
+        if (res == 0) {
+            return false;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        }
+        if (errno != EINTR) {
+            LOG(Debug) << "recv failed: " << FormatErrno(errno);
+            return false;
+        }
+    }
+}
+
+bool TLocalApiServer::WriteOutput(TConnection& connection)
+{
+    while (!connection.Output.empty()) {
+        auto res = send(connection.Fd, connection.Output.data(), connection.Output.size(), MSG_NOSIGNAL);
+        if (res >= 0) {
+            connection.Output.erase(0, res);
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        }
+        if (errno != EINTR) {
+            LOG(Debug) << "send failed: " << FormatErrno(errno);
+            return false;
+        }
+    }
+    return true;
+}
+
+void TLocalApiServer::HandleMessage(uint64_t connectionId, TConnection& connection, const TMessage& message)
+{
+    try {
+        switch (message.Type) {
+            case TMessageType::ReadRequest: {
+                auto channels = DecodeReadRequest(message.Payload);
+                std::vector<TReadResult> results;
+                results.reserve(channels.size());
+                for (const auto& channel: channels) {
+                    results.push_back(Backend->Read(channel));
+                }
+                connection.Output += EncodeReadResponse(message.RequestId, results);
+                break;
+            }
+            case TMessageType::WriteRequest: {
+                HandleWriteRequest(connectionId, message);
+                break;
+            }
+            default: {
+                connection.Output += EncodeErrorResponse(
+                    message.RequestId,
+                    "unsupported message type: " + std::to_string(static_cast<int>(message.Type)));
+            }
+        }
+    } catch (const std::exception& e) {
+        connection.Output += EncodeErrorResponse(message.RequestId, e.what());
+    }
+}
+
+void TLocalApiServer::HandleWriteRequest(uint64_t connectionId, const TMessage& message)
+{
+    auto values = DecodeWriteRequest(message.Payload);
+    auto pending = std::make_shared<TPendingWrite>();
+    pending->Results.resize(values.size());
+    pending->Remaining = values.size();
+    if (values.empty()) {
+        Responses->Push(connectionId, EncodeWriteResponse(message.RequestId, pending->Results));
+        return;
+    }
+    auto requestId = message.RequestId;
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto callback = [pending, i, connectionId, requestId, responses = Responses](const TWriteResult& result) {
+            std::unique_lock<std::mutex> lock(pending->Mutex);
+            pending->Results[i] = result;
+            if (--pending->Remaining == 0) {
+                responses->Push(connectionId, EncodeWriteResponse(requestId, pending->Results));
+            }
+        };
+        try {
+            Backend->Write(values[i].first, values[i].second, callback);
+        } catch (const std::exception& e) {
+            callback(TWriteResult{TStatus::WriteError, e.what()});
+        }
+    }
+}
+
+void TLocalApiServer::MoveResponsesToConnections()
+{
+    for (auto& response: Responses->Take()) {
+        auto it = Connections.find(response.first);
+        // Connection could be closed before write completion
+        if (it != Connections.end()) {
+            it->second.Output += response.second;
+        }
+    }
+}
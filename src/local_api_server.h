@@ -0,0 +1,88 @@
+#pragma once
+
+#include "local_api_protocol.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace LocalApi
+{
+    //! Responses not read by a client are buffered up to the size, then the connection is closed
+    const size_t MAX_OUTPUT_BUFFER_SIZE = 16 * MAX_MESSAGE_SIZE;
+}
+
+/**
+ * @brief Access to channels for local API server
+ */
+class ILocalApiBackend
+{
+public:
+    typedef std::function<void(const LocalApi::TWriteResult& result)> TWriteCallback;
+
+    virtual ~ILocalApiBackend() = default;
+
+    //! Get the last read value of the channel without bus access. Called from the server thread
+    virtual LocalApi::TReadResult Read(const std::string& channel) = 0;
+
+    /**
+     * @brief Start writing the channel. The callback is called exactly once, it can be called from any thread
+     *        and even before the function returns
+     */
+    virtual void Write(const std::string& channel, const std::string& value, TWriteCallback callback) = 0;
+};
+
+typedef std::shared_ptr<ILocalApiBackend> PLocalApiBackend;
+
+/**
+ * @brief Unix socket server of local API. See local_api_protocol.h for protocol description.
+ *        All connections are served by one thread, writes are completed asynchronously,
+ *        so a client can send next requests without waiting for responses.
+ */
+class TLocalApiServer
+{
+public:
+    TLocalApiServer(const std::string& socketPath, PLocalApiBackend backend);
+    ~TLocalApiServer();
+
+    TLocalApiServer(const TLocalApiServer&) = delete;
+    TLocalApiServer& operator=(const TLocalApiServer&) = delete;
+
+    void Start();
+    void Stop();
+
+    const std::string& GetSocketPath() const;
+
+private:
+    struct TConnection
+    {
+        int Fd;
+        std::string Input;
+        std::string Output;
+    };
+
+    class TResponseQueue;
+
+    void Loop();
+    void Accept();
+    void CloseConnection(uint64_t connectionId);
+    bool ReadInput(TConnection& connection);
+    bool WriteOutput(TConnection& connection);
+    void HandleMessage(uint64_t connectionId, TConnection& connection, const LocalApi::TMessage& message);
+    void HandleWriteRequest(uint64_t connectionId, const LocalApi::TMessage& message);
+    void MoveResponsesToConnections();
+
+    std::string SocketPath;
+    PLocalApiBackend Backend;
+    int ListenFd;
+    std::shared_ptr<TResponseQueue> Responses;
+    std::unordered_map<uint64_t, TConnection> Connections;
+    uint64_t NextConnectionId;
+    std::atomic_bool Active;
+    std::thread Thread;
+};
+
+typedef std::shared_ptr<TLocalApiServer> PLocalApiServer;
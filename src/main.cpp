@@ -17,7 +17,9 @@
 #include "config_schema_generator.h"
 
 #include "device_template_generator.h"
+#include "devices/dlms_device.h"
 #include "files_watcher.h"
+#include "modbus_read_tuner.h"
 #include "port/serial_port.h"
 #include "rpc/rpc_config.h"
 #include "rpc/rpc_config_handler.h"
@@ -38,6 +40,9 @@ const auto driverName = "wb-modbus";
 const auto APP_NAME = "wb-mqtt-serial";
 
 const auto LIBWBMQTT_DB_FULL_FILE_PATH = "/var/lib/wb-mqtt-serial/libwbmqtt.db";
+const auto READ_TUNING_FULL_FILE_PATH = "/var/lib/wb-mqtt-serial/read-tuning.json";
+const auto DLMS_OBJECTS_CACHE_FULL_FILE_PATH = "/var/lib/wb-mqtt-serial/dlms-objects-cache.json";
+const auto FW_CACHE_DIR = "/var/lib/wb-mqtt-serial/firmware-cache";
 const auto CONFIG_FULL_FILE_PATH = "/etc/wb-mqtt-serial.conf";
 const auto TEMPLATES_DIR = "/usr/share/wb-mqtt-serial/templates";
 const auto USER_TEMPLATES_DIR = "/etc/wb-mqtt-serial.conf.d/templates";
@@ -60,6 +65,8 @@ const auto RPC_DEVICE_PROBE_REQUEST_SCHEMA_FULL_FILE_PATH =
     "/usr/share/wb-mqtt-serial/wb-mqtt-serial-rpc-device-probe-request.schema.json";
 const auto RPC_DEVICE_SET_POLL_REQUEST_SCHEMA_FULL_FILE_PATH =
     "/usr/share/wb-mqtt-serial/wb-mqtt-serial-rpc-device-set-poll-request.schema.json";
+const auto RPC_DEVICE_GET_READ_TUNING_REQUEST_SCHEMA_FULL_FILE_PATH =
+    "/usr/share/wb-mqtt-serial/wb-mqtt-serial-rpc-device-get-read-tuning-request.schema.json";
 const auto RPC_TEMPLATES_UPLOAD_REQUEST_SCHEMA_FULL_FILE_PATH =
     "/usr/share/wb-mqtt-serial/wb-mqtt-serial-rpc-templates-upload-request.schema.json";
 const auto RPC_TEMPLATES_DELETE_REQUEST_SCHEMA_FULL_FILE_PATH =
@@ -329,6 +336,8 @@ int main(int argc, char* argv[])
 
         PMQTTSerialDriver serialDriver;
         TRPCDeviceParametersCache parametersCache;
+        Modbus::TReadTuningStorage readTuningStorage(READ_TUNING_FULL_FILE_PATH);
+        DLMS::TObjectsCacheStorage dlmsObjectsCache(DLMS_OBJECTS_CACHE_FULL_FILE_PATH);
 
         if (handlerConfig) {
             if (handlerConfig->Debug) {
@@ -352,6 +361,8 @@ int main(int argc, char* argv[])
             driver->WaitForReady();
             serialDriver = make_shared<TMQTTSerialDriver>(driver, handlerConfig);
             parametersCache.RegisterCallbacks(handlerConfig);
+            readTuningStorage.RegisterDevices(handlerConfig);
+            DLMS::RegisterObjectsCache(dlmsObjectsCache, handlerConfig);
         }
 
         TSerialClientTaskRunner serialClientTaskRunner(serialDriver);
@@ -369,6 +380,7 @@ int main(int argc, char* argv[])
                                                 RPC_DEVICE_SET_REQUEST_SCHEMA_FULL_FILE_PATH,
                                                 RPC_DEVICE_PROBE_REQUEST_SCHEMA_FULL_FILE_PATH,
                                                 RPC_DEVICE_SET_POLL_REQUEST_SCHEMA_FULL_FILE_PATH,
+                                                RPC_DEVICE_GET_READ_TUNING_REQUEST_SCHEMA_FULL_FILE_PATH,
                                                 deviceFactory,
                                                 templates,
                                                 serialClientTaskRunner,
@@ -378,7 +390,7 @@ int main(int argc, char* argv[])
         // Register separate RPC server for non-blocking firmware update tasks
         auto fwUpdateRpcServer(WBMQTT::NewMqttRpcServer(mqtt, APP_NAME));
         auto rpcFwUpdateHandler =
-            std::make_shared<TRPCFwUpdateHandler>(serialClientTaskRunner, fwUpdateRpcServer, mqtt);
+            std::make_shared<TRPCFwUpdateHandler>(serialClientTaskRunner, fwUpdateRpcServer, mqtt, FW_CACHE_DIR);
 
         if (serialDriver) {
             serialDriver->Start();
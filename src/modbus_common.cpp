@@ -5,6 +5,9 @@
 #include "serial_device.h"
 #include "wb_registers.h"
 
+#include <algorithm>
+#include <bit>
+
 using namespace std;
 using namespace BinUtils;
 
@@ -18,7 +21,8 @@ namespace Modbus // modbus protocol declarations
     void ParseReadResponse(const std::vector<uint8_t>& data,
                            Modbus::EFunction function,
                            TModbusRegisterRange& range,
-                           TRegisterCache& cache);
+                           TRegisterCache& cache,
+                           TSingleBitReadCache* singleBitCache);
 }
 
 namespace // general utilities
@@ -109,12 +113,6 @@ namespace Modbus // modbus protocol common utilities
           ResponseTime(averageResponseTime)
     {}
 
-    TModbusRegisterRange::~TModbusRegisterRange()
-    {
-        if (Bits)
-            delete[] Bits;
-    }
-
     bool TModbusRegisterRange::Add(TPort& port, PRegister reg, std::chrono::milliseconds pollLimit)
     {
         if (reg->GetAvailable() == TRegisterAvailability::UNAVAILABLE) {
@@ -129,9 +127,13 @@ namespace Modbus // modbus protocol common utilities
         auto device = dynamic_cast<TModbusDevice*>(reg->Device().get());
         auto continuousReadEnabled = false;
         auto forceFrameTimeout = false;
+        auto maxReadRegisters = deviceConfig->MaxReadRegisters;
+        auto maxReadHole = isSingleBit ? deviceConfig->MaxBitHole : deviceConfig->MaxRegHole;
         if (device != nullptr) {
             continuousReadEnabled = device->GetContinuousReadEnabled();
             forceFrameTimeout = device->GetForceFrameTimeout();
+            maxReadRegisters = device->GetMaxReadRegisters();
+            maxReadHole = device->GetMaxReadHole(isSingleBit);
         }
 
         size_t extend;
@@ -147,10 +149,18 @@ namespace Modbus // modbus protocol common utilities
                 return false;
             }
 
+            // Start a new range if it is cheaper according to read ranges optimization plan.
+            // Registers inside the range (e.g. bit fields of one word) never start a new one
+            if (device != nullptr && addr >= Start + Count &&
+                device->IsReadRequestStart(reg->GetConfig()->Type, addr))
+            {
+                return false;
+            }
+
             // Can't add register separated from last in the range by more than maxHole registers
             int maxHole = 0;
             if (reg->Device()->GetSupportsHoles()) {
-                maxHole = isSingleBit ? deviceConfig->MaxBitHole : deviceConfig->MaxRegHole;
+                maxHole = maxReadHole;
             }
             if (Start + Count + maxHole < addr) {
                 return false;
@@ -171,9 +181,8 @@ namespace Modbus // modbus protocol common utilities
                     }
                     // Can read up to 16 UNKNOWN single bit registers at once
                     size_t maxRegs = 16;
-                    if ((deviceConfig->MaxReadRegisters > 0) && (deviceConfig->MaxReadRegisters <= MAX_READ_REGISTERS))
-                    {
-                        maxRegs = deviceConfig->MaxReadRegisters;
+                    if ((maxReadRegisters > 0) && (maxReadRegisters <= MAX_READ_REGISTERS)) {
+                        maxRegs = maxReadRegisters;
                     }
                     if (reg->GetAvailable() == TRegisterAvailability::UNKNOWN && (RegisterList().size() >= maxRegs)) {
                         return false;
@@ -190,8 +199,8 @@ namespace Modbus // modbus protocol common utilities
             extend = std::max(0, static_cast<int>(addr + widthInWords) - static_cast<int>(Start + Count));
 
             auto maxRegs = isSingleBit ? MAX_READ_BITS : MAX_READ_REGISTERS;
-            if ((deviceConfig->MaxReadRegisters > 0) && (deviceConfig->MaxReadRegisters <= maxRegs)) {
-                maxRegs = deviceConfig->MaxReadRegisters;
+            if ((maxReadRegisters > 0) && (maxReadRegisters <= maxRegs)) {
+                maxRegs = maxReadRegisters;
             }
             if (Count + extend > static_cast<size_t>(maxRegs)) {
                 return false;
@@ -229,15 +238,6 @@ namespace Modbus // modbus protocol common utilities
         return false;
     }
 
-    uint8_t* TModbusRegisterRange::GetBits()
-    {
-        if (!IsSingleBitType(Type()))
-            throw std::runtime_error("GetBits() for non-bit register");
-        if (!Bits)
-            Bits = new uint8_t[Count];
-        return Bits;
-    }
-
     uint32_t TModbusRegisterRange::GetStart() const
     {
         return Start;
@@ -284,7 +284,8 @@ namespace Modbus // modbus protocol common utilities
                                          TPort& port,
                                          uint8_t slaveId,
                                          int shift,
-                                         Modbus::TRegisterCache& cache)
+                                         Modbus::TRegisterCache& cache,
+                                         Modbus::TSingleBitReadCache* singleBitCache)
     {
         try {
             const auto& deviceConfig = *(Device()->DeviceConfig());
@@ -301,7 +302,7 @@ namespace Modbus // modbus protocol common utilities
                                           Device()->GetResponseTimeout(port),
                                           Device()->GetFrameTimeout(port));
             ResponseTime = res.ResponseTime;
-            ParseReadResponse(res.Pdu, function, *this, cache);
+            ParseReadResponse(res.Pdu, function, *this, cache, singleBitCache);
         } catch (const Modbus::TModbusExceptionError& err) {
             RethrowSerialDeviceException(err);
         } catch (const Modbus::TMalformedResponseError& err) {
@@ -543,36 +544,100 @@ namespace Modbus // modbus protocol common utilities
         }
     }
 
-    void ParseSingleBitReadResponse(const std::vector<uint8_t>& data, TModbusRegisterRange& range)
+    std::vector<uint64_t> UnpackBits(const std::vector<uint8_t>& data)
+    {
+        std::vector<uint64_t> words((data.size() + 7) / 8);
+        for (size_t i = 0; i < data.size(); ++i) {
+            words[i / 8] |= static_cast<uint64_t>(data[i]) << (i % 8) * 8;
+        }
+        return words;
+    }
+
+    // Drops snapshots of other ranges with the same registers, their registers are updated by the current range
+    void EraseOverlappingSnapshots(TSingleBitReadCache& cache, int type, uint32_t start, uint32_t count)
     {
-        auto start = data.begin();
-        auto destination = range.GetBits();
-        auto coil_count = range.GetCount();
-        while (start != data.end()) {
-            std::bitset<8> coils(*start++);
-            auto coils_in_byte = std::min(coil_count, size_t(8));
-            for (size_t i = 0; i < coils_in_byte; ++i) {
-                destination[i] = coils[i];
+        for (auto it = cache.begin(); it != cache.end();) {
+            auto otherStart = it->first.second;
+            if (it->first.first == type && otherStart != start && otherStart < start + count &&
+                start < otherStart + it->second.Count)
+            {
+                it = cache.erase(it);
+            } else {
+                ++it;
             }
+        }
+    }
 
-            coil_count -= coils_in_byte;
-            destination += coils_in_byte;
+    void ParseSingleBitReadResponse(const std::vector<uint8_t>& data,
+                                    TModbusRegisterRange& range,
+                                    TSingleBitReadCache* cache)
+    {
+        if (data.size() * 8 < range.GetCount()) {
+            throw TMalformedResponseError("response is too short: " + std::to_string(data.size()) + " bytes for " +
+                                          std::to_string(range.GetCount()) + " bits");
         }
-        for (auto reg: range.RegisterList()) {
-            auto addr = GetUint32RegisterAddress(reg->GetConfig()->GetAddress());
-            reg->SetValue(TRegisterValue{range.GetBits()[addr - range.GetStart()]});
+        auto words = UnpackBits(data);
+        const auto& registers = range.RegisterList();
+        TSingleBitReadSnapshot* snapshot = nullptr;
+        if (cache != nullptr) {
+            snapshot = &(*cache)[{range.Type(), range.GetStart()}];
+            if (snapshot->Count == range.GetCount() && snapshot->Words.size() == words.size() &&
+                std::equal(registers.begin(), registers.end(), snapshot->Registers.begin(), snapshot->Registers.end()))
+            {
+                // Only registers of changed bits are visited, unchanged words are skipped at once
+                for (size_t i = 0; i < words.size(); ++i) {
+                    for (auto changed = words[i] ^ snapshot->Words[i]; changed != 0; changed &= changed - 1) {
+                        auto bit = std::countr_zero(changed);
+                        uint32_t index = i * 64 + bit;
+                        auto it = std::lower_bound(
+                            snapshot->RegistersByBit.begin(),
+                            snapshot->RegistersByBit.end(),
+                            index,
+                            [](const auto& item, uint32_t bitIndex) { return item.first < bitIndex; });
+                        for (; it != snapshot->RegistersByBit.end() && it->first == index; ++it) {
+                            it->second->SetValue(TRegisterValue{(words[i] >> bit) & 1});
+                        }
+                    }
+                }
+                snapshot->Words = std::move(words);
+                return;
+            }
+        }
+        for (auto reg: registers) {
+            auto index = GetUint32RegisterAddress(reg->GetConfig()->GetAddress()) - range.GetStart();
+            reg->SetValue(TRegisterValue{(words[index / 64] >> (index % 64)) & 1});
+        }
+        if (snapshot != nullptr) {
+            EraseOverlappingSnapshots(*cache, range.Type(), range.GetStart(), range.GetCount());
+            snapshot->Count = range.GetCount();
+            snapshot->Registers.assign(registers.begin(), registers.end());
+            snapshot->RegistersByBit.clear();
+            for (auto reg: registers) {
+                auto index = GetUint32RegisterAddress(reg->GetConfig()->GetAddress()) - range.GetStart();
+                snapshot->RegistersByBit.emplace_back(index, reg);
+            }
+            std::stable_sort(snapshot->RegistersByBit.begin(),
+                             snapshot->RegistersByBit.end(),
+                             [](const auto& a, const auto& b) { return a.first < b.first; });
+            snapshot->Words = std::move(words);
         }
-        return;
     }
 
-    // Extracts numeric register data from data words array, ordered according
-    // to the register word order and byte order settings.
-    uint64_t GetNumberRegisterValue(const std::vector<uint16_t>& words, const TRegisterConfig& reg)
+    // Extracts numeric register data from data words,
+    // words are ordered according to the register byte order settings.
+    uint64_t GetNumberRegisterValue(const uint16_t* words, uint32_t width, const TRegisterConfig& reg)
     {
         uint64_t value = 0;
-        for (size_t i = 0; i < words.size(); ++i) {
-            value <<= 16;
-            value |= words[i];
+        if (reg.WordOrder == EWordOrder::LittleEndian) {
+            for (uint32_t i = width; i > 0; --i) {
+                value <<= 16;
+                value |= words[i - 1];
+            }
+        } else {
+            for (uint32_t i = 0; i < width; ++i) {
+                value <<= 16;
+                value |= words[i];
+            }
         }
         value >>= reg.GetDataOffset();
         value &= GetLSBMask(reg.GetDataWidth());
@@ -603,53 +668,74 @@ namespace Modbus // modbus protocol common utilities
         return str;
     }
 
-    // Orders read data buffer according to register word order and byte order settings.
-    // Fills register data cache for holding registers.
-    // Returns TRegister value.
-    TRegisterValue GetRegisterValue(const std::vector<uint8_t>& data,
-                                    const TRegisterConfig& reg,
-                                    Modbus::TRegisterCache& cache,
-                                    uint32_t index = 0)
+    TReadResponseWords::TReadResponseWords(const std::vector<uint8_t>& data): Data(data)
+    {}
+
+    const std::vector<uint16_t>& TReadResponseWords::GetWords(EByteOrder byteOrder)
     {
-        auto address = GetUint32RegisterAddress(reg.GetAddress());
-        auto width = GetModbusDataWidthIn16BitWords(reg);
-        auto start = data.data() + index * 2;
-        std::vector<uint16_t> words(width);
-        for (uint32_t i = 0; i < width; i++) {
-            if (reg.ByteOrder == EByteOrder::LittleEndian) {
-                words[i] = *(start + 1) << 8 | *start;
+        auto& words = (byteOrder == EByteOrder::LittleEndian) ? LittleEndianWords : BigEndianWords;
+        if (words.empty() && !Data.empty()) {
+            auto count = Data.size() / 2;
+            words.resize(count);
+            const auto* src = Data.data();
+            auto* dst = words.data();
+            if (byteOrder == EByteOrder::LittleEndian) {
+                for (size_t i = 0; i < count; ++i) {
+                    dst[i] = static_cast<uint16_t>(src[2 * i + 1] << 8 | src[2 * i]);
+                }
             } else {
-                words[i] = *start << 8 | *(start + 1);
+                for (size_t i = 0; i < count; ++i) {
+                    dst[i] = static_cast<uint16_t>(src[2 * i] << 8 | src[2 * i + 1]);
+                }
             }
-            if (IsHoldingType(reg.Type)) {
-                cache[address] = words[i];
-                ++address;
+        }
+        return words;
+    }
+
+    TRegisterValue TReadResponseWords::GetRegisterValue(const TRegisterConfig& reg,
+                                                        uint32_t index,
+                                                        TRegisterCache& cache)
+    {
+        const auto& words = GetWords(reg.ByteOrder);
+        auto width = GetModbusDataWidthIn16BitWords(reg);
+        if (index + width > words.size()) {
+            throw TMalformedResponseError("response is too short for " + reg.ToString());
+        }
+        const auto* regWords = words.data() + index;
+        if (IsHoldingType(reg.Type)) {
+            auto address = GetUint32RegisterAddress(reg.GetAddress());
+            for (uint32_t i = 0; i < width; ++i) {
+                cache[address + i] = regWords[i];
             }
-            start += 2;
         }
+        if (!reg.IsString()) {
+            return TRegisterValue{GetNumberRegisterValue(regWords, width, reg)};
+        }
+        std::vector<uint16_t> strWords(regWords, regWords + width);
         if (reg.WordOrder == EWordOrder::LittleEndian) {
-            std::reverse(words.begin(), words.end());
+            std::reverse(strWords.begin(), strWords.end());
         }
-        return reg.IsString() ? TRegisterValue{GetStringRegisterValue(words, reg)}
-                              : TRegisterValue{GetNumberRegisterValue(words, reg)};
+        return TRegisterValue{GetStringRegisterValue(strWords, reg)};
     }
 
     // Parses modbus response and stores result.
     void ParseReadResponse(const std::vector<uint8_t>& pdu,
                            Modbus::EFunction function,
                            TModbusRegisterRange& range,
-                           Modbus::TRegisterCache& cache)
+                           Modbus::TRegisterCache& cache,
+                           Modbus::TSingleBitReadCache* singleBitCache)
     {
         auto data = Modbus::ExtractResponseData(function, pdu);
         range.Device()->SetTransferResult(true);
         if (IsSingleBitType(range.Type())) {
-            ParseSingleBitReadResponse(data, range);
+            ParseSingleBitReadResponse(data, range, singleBitCache);
             return;
         }
+        TReadResponseWords words(data);
         for (auto reg: range.RegisterList()) {
             auto config = reg->GetConfig();
             auto index = GetUint32RegisterAddress(config->GetAddress()) - range.GetStart();
-            reg->SetValue(GetRegisterValue(data, *config, cache, index));
+            reg->SetValue(words.GetRegisterValue(*config, index, cache));
             if (reg->Device()->IsWbDevice() && config->Format == RegisterFormat::String) {
                 CheckWbStringRegister(reg);
             }
@@ -762,30 +848,178 @@ namespace Modbus // modbus protocol common utilities
         }
     }
 
-    void ProcessRangeException(TModbusRegisterRange& range, const char* msg)
+    // Checks if the register can be written by one request together with adjacent registers
+    bool CanCombineWrite(const TRegisterConfig& reg)
+    {
+        return (reg.Type == REG_HOLDING || reg.Type == REG_HOLDING_MULTI || reg.Type == REG_COIL) &&
+               !reg.IsPartial();
+    }
+
+    uint32_t GetWriteWidth(const TRegisterConfig& reg)
+    {
+        return (reg.Type == REG_COIL) ? 1 : GetModbusDataWidthIn16BitWords(reg);
+    }
+
+    // Writes requests from startIt by one FN_WRITE_MULTIPLE_REGISTERS or FN_WRITE_MULTIPLE_COILS request.
+    // Returns iterator to the first request not written or startIt if less than two requests can be combined.
+    std::vector<TRegisterWriteRequest>::iterator WriteMultipleRegisters(
+        IModbusTraits& traits,
+        TPort& port,
+        uint8_t slaveId,
+        std::vector<TRegisterWriteRequest>::iterator startIt,
+        std::vector<TRegisterWriteRequest>::iterator endIt,
+        size_t maxRegisters,
+        Modbus::TRegisterCache& cache,
+        std::chrono::microseconds requestDelay,
+        std::chrono::milliseconds responseTimeout,
+        std::chrono::milliseconds frameTimeout,
+        int shift)
+    {
+        const auto& first = *startIt->Register->GetConfig();
+        auto start = GetUint32RegisterAddress(first.GetWriteAddress());
+        auto maxCount = std::min(maxRegisters,
+                                 static_cast<size_t>((first.Type == REG_COIL) ? MAX_WRITE_BITS : MAX_WRITE_REGISTERS));
+        size_t count = 0;
+        auto it = startIt;
+        for (; it != endIt; ++it) {
+            const auto& reg = *it->Register->GetConfig();
+            if (!CanCombineWrite(reg) || reg.Type != first.Type ||
+                GetUint32RegisterAddress(reg.GetWriteAddress()) != start + count)
+            {
+                break;
+            }
+            auto width = GetWriteWidth(reg);
+            if (count + width > maxCount) {
+                break;
+            }
+            count += width;
+        }
+        if (std::distance(startIt, it) < 2) {
+            return startIt;
+        }
+
+        Modbus::TRegisterCache tmpCache;
+        std::vector<uint8_t> data;
+        EFunction fn;
+        if (first.Type == REG_COIL) {
+            fn = FN_WRITE_MULTIPLE_COILS;
+            data.resize(count / 8 + (count % 8 ? 1 : 0));
+            size_t bit = 0;
+            for (auto reqIt = startIt; reqIt != it; ++reqIt, ++bit) {
+                if (reqIt->Value.Get<uint64_t>()) {
+                    data[bit / 8] |= (1 << (bit % 8));
+                }
+            }
+        } else {
+            fn = FN_WRITE_MULTIPLE_REGISTERS;
+            for (auto reqIt = startIt; reqIt != it; ++reqIt) {
+                ComposeRawMultipleWriteRequestData(data, *reqIt->Register->GetConfig(), reqIt->Value, cache, tmpCache);
+            }
+        }
+
+        LOG(Debug) << port.GetDescription() << " modbus:" << std::to_string(slaveId) << " write " << count << " "
+                   << first.TypeName << "(s) @ " << start << " combined from " << std::distance(startIt, it)
+                   << " write requests";
+        try {
+            WriteTransaction(traits,
+                             port,
+                             slaveId,
+                             fn,
+                             Modbus::CalcResponsePDUSize(fn, count),
+                             Modbus::MakePDU(fn, start + shift, count, data),
+                             requestDelay,
+                             responseTimeout,
+                             frameTimeout);
+            for (const auto& item: tmpCache) {
+                cache.insert_or_assign(item.first, item.second);
+            }
+        } catch (const TSerialDeviceException& e) {
+            auto error = std::current_exception();
+            for (auto reqIt = startIt; reqIt != it; ++reqIt) {
+                reqIt->Error = error;
+            }
+        }
+        return it;
+    }
+
+    void WriteRegisters(IModbusTraits& traits,
+                        TPort& port,
+                        uint8_t slaveId,
+                        std::vector<TRegisterWriteRequest>& requests,
+                        size_t maxRegisters,
+                        TRegisterCache& cache,
+                        std::chrono::microseconds requestDelay,
+                        std::chrono::milliseconds responseTimeout,
+                        std::chrono::milliseconds frameTimeout,
+                        int shift)
+    {
+        auto it = requests.begin();
+        while (it != requests.end()) {
+            if (maxRegisters > 1 && CanCombineWrite(*it->Register->GetConfig())) {
+                auto end = WriteMultipleRegisters(traits,
+                                                  port,
+                                                  slaveId,
+                                                  it,
+                                                  requests.end(),
+                                                  maxRegisters,
+                                                  cache,
+                                                  requestDelay,
+                                                  responseTimeout,
+                                                  frameTimeout,
+                                                  shift);
+                if (end != it) {
+                    it = end;
+                    continue;
+                }
+            }
+            try {
+                WriteRegister(traits,
+                              port,
+                              slaveId,
+                              *it->Register->GetConfig(),
+                              it->Value,
+                              cache,
+                              requestDelay,
+                              responseTimeout,
+                              frameTimeout,
+                              shift);
+            } catch (const TSerialDeviceException& e) {
+                it->Error = std::current_exception();
+            }
+            ++it;
+        }
+    }
+
+    void ProcessRangeException(TModbusRegisterRange& range, const char* msg, TSingleBitReadCache* singleBitCache)
     {
         for (auto& reg: range.RegisterList()) {
             reg->SetError(TRegister::TError::ReadError);
         }
+        // Registers with errors must be updated by the next read even if their bits are not changed
+        if (singleBitCache != nullptr) {
+            singleBitCache->clear();
+        }
 
         auto& logger = (range.Device()->GetConnectionState() == TDeviceConnectionState::DISCONNECTED) ? Debug : Warn;
         LOG(logger) << "failed to read " << range << ": " << msg;
         range.Device()->SetTransferResult(false);
     }
 
-    void ReadRegisterRange(IModbusTraits& traits,
-                           TPort& port,
-                           uint8_t slaveId,
-                           TModbusRegisterRange& range,
-                           Modbus::TRegisterCache& cache,
-                           bool breakOnError,
-                           int shift)
+    TReadRangeResult ReadRegisterRange(IModbusTraits& traits,
+                                       TPort& port,
+                                       uint8_t slaveId,
+                                       TModbusRegisterRange& range,
+                                       Modbus::TRegisterCache& cache,
+                                       bool breakOnError,
+                                       int shift,
+                                       TSingleBitReadCache* singleBitCache)
     {
         if (range.RegisterList().empty()) {
-            return;
+            return TReadRangeResult::SUCCESS;
         }
         try {
-            range.ReadRange(traits, port, slaveId, shift, cache);
+            range.ReadRange(traits, port, slaveId, shift, cache, singleBitCache);
+            return TReadRangeResult::SUCCESS;
         } catch (const TSerialDevicePermanentRegisterException& e) {
             if (range.HasHoles()) {
                 range.Device()->SetSupportsHoles(false);
@@ -797,16 +1031,23 @@ namespace Modbus // modbus protocol common utilities
                     }
                 }
             }
-            ProcessRangeException(range, e.what());
+            ProcessRangeException(range, e.what(), singleBitCache);
+            if (breakOnError) {
+                throw;
+            }
+        } catch (const TResponseTimeoutException& e) {
+            ProcessRangeException(range, e.what(), singleBitCache);
             if (breakOnError) {
                 throw;
             }
+            return TReadRangeResult::TIMEOUT;
         } catch (const TSerialDeviceException& e) {
-            ProcessRangeException(range, e.what());
+            ProcessRangeException(range, e.what(), singleBitCache);
             if (breakOnError) {
                 throw;
             }
         }
+        return TReadRangeResult::ERROR;
     }
 
     bool FillSetupRegistersCache(Modbus::IModbusTraits& traits,
@@ -1078,7 +1319,7 @@ namespace Modbus // modbus protocol common utilities
         }
 
         Modbus::TRegisterCache cache;
-        return GetRegisterValue(data, reg, cache);
+        return TReadResponseWords(data).GetRegisterValue(reg, 0, cache);
     }
 
 } // modbus protocol utilities
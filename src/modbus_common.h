@@ -10,6 +10,7 @@ namespace Modbus // modbus protocol common utilities
     const int MAX_READ_BITS = 2000;
     const int MAX_READ_REGISTERS = 125;
     const int MAX_WRITE_REGISTERS = 123;
+    const int MAX_WRITE_BITS = 1968;
     const int MAX_HOLE_CONTINUOUS_16_BIT_REGISTERS = 10;
     const int MAX_HOLE_CONTINUOUS_1_BIT_REGISTERS = MAX_HOLE_CONTINUOUS_16_BIT_REGISTERS * 8;
 
@@ -31,11 +32,34 @@ namespace Modbus // modbus protocol common utilities
      */
     typedef std::map<uint16_t, uint16_t> TRegisterCache;
 
+    /**
+     * @brief Coils or discrete inputs received by the previous read of a range.
+     *        Only registers of bits changed since then are updated by the next read of the same range.
+     */
+    struct TSingleBitReadSnapshot
+    {
+        uint32_t Count = 0;
+
+        //! Registers in the range order, a range with other registers can't use the snapshot
+        std::vector<PRegister> Registers;
+
+        //! Registers sorted by bit index in the response
+        std::vector<std::pair<uint32_t, PRegister>> RegistersByBit;
+
+        std::vector<uint64_t> Words;
+    };
+
+    /**
+     * @brief Snapshots of single bit ranges keyed by register type and range start.
+     *        Must be cleared on any register change made not by a successful read:
+     *        writes, events and read errors.
+     */
+    typedef std::map<std::pair<int, uint32_t>, TSingleBitReadSnapshot> TSingleBitReadCache;
+
     class TModbusRegisterRange: public TRegisterRange
     {
     public:
         TModbusRegisterRange(std::chrono::microseconds averageResponseTime);
-        ~TModbusRegisterRange();
 
         bool Add(TPort& port, PRegister reg, std::chrono::milliseconds pollLimit) override;
 
@@ -45,7 +69,6 @@ namespace Modbus // modbus protocol common utilities
          * @return The count of Modbus registers in the range.
          */
         size_t GetCount() const;
-        uint8_t* GetBits();
         bool HasHoles() const;
         const std::string& TypeName() const;
         int Type() const;
@@ -59,7 +82,12 @@ namespace Modbus // modbus protocol common utilities
          *
          * All exceptions are inherited from TSerialDeviceException.
          */
-        void ReadRange(IModbusTraits& traits, TPort& port, uint8_t slaveId, int shift, Modbus::TRegisterCache& cache);
+        void ReadRange(IModbusTraits& traits,
+                       TPort& port,
+                       uint8_t slaveId,
+                       int shift,
+                       Modbus::TRegisterCache& cache,
+                       Modbus::TSingleBitReadCache* singleBitCache = nullptr);
 
         std::chrono::microseconds GetResponseTime() const;
 
@@ -67,7 +95,6 @@ namespace Modbus // modbus protocol common utilities
         bool HasHolesFlg = false;
         uint32_t Start;
         size_t Count = 0;
-        uint8_t* Bits = 0;
         std::chrono::microseconds AverageResponseTime;
         std::chrono::microseconds ResponseTime;
 
@@ -75,6 +102,40 @@ namespace Modbus // modbus protocol common utilities
         uint16_t GetQuantity() const;
     };
 
+    /**
+     * @brief Data of read response converted to 16-bit words.
+     *
+     * The whole response is converted at once for each byte order used by registers,
+     * so registers of a range are extracted without per-register copies and allocations.
+     * Conversion loops are kept simple to be vectorized by compiler.
+     */
+    class TReadResponseWords
+    {
+    public:
+        TReadResponseWords(const std::vector<uint8_t>& data);
+
+        /**
+         * @brief Returns register value and fills register data cache for holding registers.
+         *
+         * @param index position of the register's first word in the response
+         * @throws TMalformedResponseError if the response is too short for the register
+         */
+        TRegisterValue GetRegisterValue(const TRegisterConfig& reg, uint32_t index, TRegisterCache& cache);
+
+    private:
+        const std::vector<uint8_t>& Data;
+        std::vector<uint16_t> BigEndianWords;
+        std::vector<uint16_t> LittleEndianWords;
+
+        const std::vector<uint16_t>& GetWords(EByteOrder byteOrder);
+    };
+
+    /**
+     * @brief Unpacks coils or discrete inputs from read response data to 64-bit words.
+     *        Bit i of the response is bit (i % 64) of word (i / 64).
+     */
+    std::vector<uint64_t> UnpackBits(const std::vector<uint8_t>& data);
+
     PRegisterRange CreateRegisterRange(std::chrono::microseconds averageResponseTime);
 
     void WriteRegister(IModbusTraits& traits,
@@ -88,13 +149,50 @@ namespace Modbus // modbus protocol common utilities
                        std::chrono::milliseconds frameTimeout,
                        int shift = 0);
 
-    void ReadRegisterRange(IModbusTraits& traits,
-                           TPort& port,
-                           uint8_t slaveId,
-                           TModbusRegisterRange& range,
-                           TRegisterCache& cache,
-                           bool breakOnError,
-                           int shift = 0);
+    /**
+     * @brief Writes registers. Neighbouring requests for adjacent holding registers or coils
+     *        are combined into FN_WRITE_MULTIPLE_REGISTERS or FN_WRITE_MULTIPLE_COILS requests.
+     *        Requests are written in the given order. Errors are stored in requests,
+     *        all registers of a failed combined request get the same error.
+     *
+     * @param maxRegisters maximum number of 16-bit registers or coils in one request, 1 disables combining
+     */
+    void WriteRegisters(IModbusTraits& traits,
+                        TPort& port,
+                        uint8_t slaveId,
+                        std::vector<TRegisterWriteRequest>& requests,
+                        size_t maxRegisters,
+                        TRegisterCache& cache,
+                        std::chrono::microseconds requestDelay,
+                        std::chrono::milliseconds responseTimeout,
+                        std::chrono::milliseconds frameTimeout,
+                        int shift = 0);
+
+    enum class TReadRangeResult
+    {
+        SUCCESS,
+
+        //! The device hasn't answered
+        TIMEOUT,
+
+        //! The device has answered with an error or with a malformed response
+        ERROR
+    };
+
+    /**
+     * @brief Reads register range and sets registers values or errors
+     *
+     * @param singleBitCache previous reads of coils and discrete inputs,
+     *                       registers of unchanged bits are not updated, nullptr updates all registers
+     */
+    TReadRangeResult ReadRegisterRange(IModbusTraits& traits,
+                                       TPort& port,
+                                       uint8_t slaveId,
+                                       TModbusRegisterRange& range,
+                                       TRegisterCache& cache,
+                                       bool breakOnError,
+                                       int shift = 0,
+                                       TSingleBitReadCache* singleBitCache = nullptr);
 
     /**
      * @brief Reads a register value from a Modbus device.
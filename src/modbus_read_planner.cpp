@@ -0,0 +1,218 @@
+#include "modbus_read_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "devices/modbus_device.h"
+#include "modbus_common.h"
+
+namespace
+{
+    // Request 8 bytes: SlaveID, Operation, Addr, Count, CRC
+    const double READ_REQUEST_ADU_SIZE = 8;
+
+    // Response 5 bytes except data: SlaveID, Operation, Size, CRC
+    const double READ_RESPONSE_ADU_OVERHEAD = 5;
+
+    // Byte count used to calculate precise byte time from rounded microseconds
+    const size_t BYTE_TIME_MEASURE_BYTES = 100;
+
+    // Replan if measured response time differs from planned one more than by 1/RESPONSE_TIME_CHANGE_DIVIDER
+    const int RESPONSE_TIME_CHANGE_DIVIDER = 4;
+    const auto MIN_RESPONSE_TIME_CHANGE = std::chrono::microseconds(100);
+
+    bool IsSingleBitType(int type)
+    {
+        return (type == Modbus::REG_COIL) || (type == Modbus::REG_DISCRETE);
+    }
+
+    bool IsPlannedRegister(const TRegister& reg)
+    {
+        return reg.GetConfig()->AccessType != TRegisterConfig::EAccessType::WRITE_ONLY &&
+               reg.GetAvailable() != TRegisterAvailability::UNAVAILABLE && !reg.IsExcludedFromPolling();
+    }
+
+    size_t GetPlannedRegisterCount(const TSerialDevice& device)
+    {
+        return std::count_if(device.GetRegisters().begin(), device.GetRegisters().end(), [](const PRegister& reg) {
+            return IsPlannedRegister(*reg);
+        });
+    }
+
+    // Sorts items and joins overlapping ones, e.g. bit fields of the same register
+    void Normalize(std::vector<Modbus::TReadPlanItem>& items)
+    {
+        std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) { return a.Address < b.Address; });
+        std::vector<Modbus::TReadPlanItem> res;
+        for (const auto& item: items) {
+            if (!res.empty() && item.Address < res.back().Address + res.back().Width) {
+                auto end = std::max(res.back().Address + res.back().Width, item.Address + item.Width);
+                res.back().Width = end - res.back().Address;
+                continue;
+            }
+            res.push_back(item);
+        }
+        items.swap(res);
+    }
+}
+
+namespace Modbus
+{
+    TReadCostModel MakeReadCostModel(TPort& port,
+                                     const TModbusDevice& device,
+                                     int registerType,
+                                     std::chrono::microseconds averageResponseTime,
+                                     bool forceFrameTimeout)
+    {
+        const auto& config = *device.DeviceConfig();
+        TReadCostModel model;
+        model.IsSingleBit = IsSingleBitType(registerType);
+
+        int maxRegs = model.IsSingleBit ? MAX_READ_BITS : MAX_READ_REGISTERS;
+        auto maxReadRegisters = device.GetMaxReadRegisters();
+        if ((maxReadRegisters > 0) && (maxReadRegisters <= maxRegs)) {
+            maxRegs = maxReadRegisters;
+        }
+        model.MaxRegisters = maxRegs;
+
+        if (device.GetSupportsHoles()) {
+            model.MaxHole = std::max(0, device.GetMaxReadHole(model.IsSingleBit));
+        }
+
+        model.ByteTime = port.GetSendTimeBytes(BYTE_TIME_MEASURE_BYTES).count() /
+                         static_cast<double>(BYTE_TIME_MEASURE_BYTES);
+
+        model.RequestOverhead =
+            port.GetSendTimeBytes(READ_REQUEST_ADU_SIZE + READ_RESPONSE_ADU_OVERHEAD + STANDARD_FRAME_TIMEOUT_BYTES) +
+            averageResponseTime + config.RequestDelay;
+        if (forceFrameTimeout) {
+            model.RequestOverhead += config.FrameTimeout;
+        }
+        return model;
+    }
+
+    double EstimateReadRequestTime(const TReadCostModel& model, size_t count)
+    {
+        double dataBytes = model.IsSingleBit ? std::ceil(count / 8.0) : count * 2.0;
+        return model.RequestOverhead.count() + dataBytes * model.ByteTime;
+    }
+
+    double EstimateReadPlanTime(const std::vector<TReadPlanItem>& items,
+                                const std::vector<size_t>& requestStarts,
+                                const TReadCostModel& model)
+    {
+        double res = 0;
+        for (size_t i = 0; i < requestStarts.size(); ++i) {
+            const auto& first = items[requestStarts[i]];
+            const auto& last = items[(i + 1 < requestStarts.size()) ? requestStarts[i + 1] - 1 : items.size() - 1];
+            res += EstimateReadRequestTime(model, last.Address + last.Width - first.Address);
+        }
+        return res;
+    }
+
+    std::vector<size_t> PlanReadRequests(const std::vector<TReadPlanItem>& items, const TReadCostModel& model)
+    {
+        if (items.empty()) {
+            return {};
+        }
+
+        // Best[j] is the minimal bus time to read items [0, j)
+        // Starts[j] is the first item of the last request in that best partition
+        std::vector<double> best(items.size() + 1, std::numeric_limits<double>::max());
+        std::vector<size_t> starts(items.size() + 1, 0);
+        best[0] = 0;
+
+        for (size_t last = 0; last < items.size(); ++last) {
+            const auto end = items[last].Address + items[last].Width;
+            for (size_t first = last + 1; first-- > 0;) {
+                if (first != last) {
+                    const auto& next = items[first + 1];
+                    const auto holeEnd = items[first].Address + items[first].Width;
+                    if (next.Address - holeEnd > model.MaxHole) {
+                        break;
+                    }
+                    if (end - items[first].Address > model.MaxRegisters) {
+                        break;
+                    }
+                }
+                auto time = best[first] + EstimateReadRequestTime(model, end - items[first].Address);
+                if (time < best[last + 1]) {
+                    best[last + 1] = time;
+                    starts[last + 1] = first;
+                }
+            }
+        }
+
+        std::vector<size_t> res;
+        for (auto i = items.size(); i > 0; i = starts[i]) {
+            res.push_back(starts[i]);
+        }
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+
+    void TReadRangePlan::Update(TPort& port,
+                                const TModbusDevice& device,
+                                std::chrono::microseconds averageResponseTime,
+                                bool forceFrameTimeout)
+    {
+        if (!NeedUpdate(port, device, averageResponseTime, forceFrameTimeout)) {
+            return;
+        }
+
+        std::map<int, std::vector<TReadPlanItem>> itemsByType;
+        for (const auto& reg: device.GetRegisters()) {
+            if (IsPlannedRegister(*reg)) {
+                const auto& config = *reg->GetConfig();
+                itemsByType[config.Type].push_back(
+                    TReadPlanItem{GetUint32RegisterAddress(config.GetAddress()), config.Get16BitWidth()});
+            }
+        }
+
+        RequestStarts.clear();
+        for (auto& [type, items]: itemsByType) {
+            Normalize(items);
+            auto model = MakeReadCostModel(port, device, type, averageResponseTime, forceFrameTimeout);
+            auto& starts = RequestStarts[type];
+            for (auto i: PlanReadRequests(items, model)) {
+                starts.insert(items[i].Address);
+            }
+        }
+
+        PlannedResponseTime = averageResponseTime;
+        PlannedByteTime = port.GetSendTimeBytes(BYTE_TIME_MEASURE_BYTES);
+        PlannedMaxReadRegisters = device.GetMaxReadRegisters();
+        PlannedMaxRegHole = device.GetMaxReadHole(false);
+        PlannedMaxBitHole = device.GetMaxReadHole(true);
+        PlannedSupportsHoles = device.GetSupportsHoles();
+        PlannedForceFrameTimeout = forceFrameTimeout;
+        PlannedRegisterCount = GetPlannedRegisterCount(device);
+    }
+
+    bool TReadRangePlan::IsRequestStart(int registerType, uint32_t address) const
+    {
+        auto it = RequestStarts.find(registerType);
+        if (it == RequestStarts.end()) {
+            return false;
+        }
+        return it->second.count(address) != 0;
+    }
+
+    bool TReadRangePlan::NeedUpdate(TPort& port,
+                                    const TModbusDevice& device,
+                                    std::chrono::microseconds averageResponseTime,
+                                    bool forceFrameTimeout) const
+    {
+        if (PlannedSupportsHoles != device.GetSupportsHoles() || PlannedForceFrameTimeout != forceFrameTimeout ||
+            PlannedMaxReadRegisters != device.GetMaxReadRegisters() ||
+            PlannedMaxRegHole != device.GetMaxReadHole(false) || PlannedMaxBitHole != device.GetMaxReadHole(true) ||
+            PlannedByteTime != port.GetSendTimeBytes(BYTE_TIME_MEASURE_BYTES) ||
+            PlannedRegisterCount != GetPlannedRegisterCount(device))
+        {
+            return true;
+        }
+        auto delta = std::chrono::abs(averageResponseTime - PlannedResponseTime);
+        return delta > std::max(MIN_RESPONSE_TIME_CHANGE, PlannedResponseTime / RESPONSE_TIME_CHANGE_DIVIDER);
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "port/port.h"
+#include "serial_device.h"
+
+class TModbusDevice;
+
+namespace Modbus // modbus read requests planning
+{
+    //! Span of Modbus registers (16-bit words or bits) occupied by polled registers
+    struct TReadPlanItem
+    {
+        uint32_t Address;
+        uint32_t Width;
+    };
+
+    //! Bus time estimation parameters for read requests of one register type
+    struct TReadCostModel
+    {
+        //! Time spent on every request regardless of its size: headers, inter-frame gap, response latency, delays
+        std::chrono::microseconds RequestOverhead = std::chrono::microseconds::zero();
+
+        //! Time to transfer one byte, in microseconds
+        double ByteTime = 0;
+
+        //! Coils and discrete inputs are packed into bytes as a bitset
+        bool IsSingleBit = false;
+
+        //! Maximum count of Modbus registers in one request
+        size_t MaxRegisters = 1;
+
+        //! Maximum count of unused Modbus registers between two consecutive items in one request
+        size_t MaxHole = 0;
+    };
+
+    /**
+     * @brief Builds cost model for read requests of specified register type
+     *
+     * @param port port used to calculate byte time
+     * @param device polled device, it provides limits and delays
+     * @param registerType Modbus register type
+     * @param averageResponseTime measured device response latency
+     * @param forceFrameTimeout true, if every response is terminated by device frame timeout
+     */
+    TReadCostModel MakeReadCostModel(TPort& port,
+                                     const TModbusDevice& device,
+                                     int registerType,
+                                     std::chrono::microseconds averageResponseTime,
+                                     bool forceFrameTimeout);
+
+    //! Estimated bus time of one request reading count Modbus registers
+    double EstimateReadRequestTime(const TReadCostModel& model, size_t count);
+
+    /**
+     * @brief Estimated bus time of all requests for a given partition
+     *
+     * @param items sorted by address non-overlapping items
+     * @param requestStarts indexes of items starting a new request
+     */
+    double EstimateReadPlanTime(const std::vector<TReadPlanItem>& items,
+                                const std::vector<size_t>& requestStarts,
+                                const TReadCostModel& model);
+
+    /**
+     * @brief Splits items into read requests with minimal total bus time.
+     *        Longer requests read unused registers in holes, but save per-request overhead.
+     *        The function finds the best compromise using dynamic programming over sorted addresses.
+     *
+     * @param items sorted by address non-overlapping items
+     * @return indexes of items starting a new request, the first one is always 0
+     */
+    std::vector<size_t> PlanReadRequests(const std::vector<TReadPlanItem>& items, const TReadCostModel& model);
+
+    /**
+     * @brief Optimal read requests partition of all polled registers of a device.
+     *        TModbusRegisterRange doesn't extend a range across planned request starts.
+     */
+    class TReadRangePlan
+    {
+    public:
+        /**
+         * @brief Recalculates the plan if device registers or measured timings have changed significantly
+         */
+        void Update(TPort& port,
+                    const TModbusDevice& device,
+                    std::chrono::microseconds averageResponseTime,
+                    bool forceFrameTimeout);
+
+        //! The register at address must be the first one in a read request
+        bool IsRequestStart(int registerType, uint32_t address) const;
+
+    private:
+        std::map<int, std::set<uint32_t>> RequestStarts;
+
+        std::chrono::microseconds PlannedResponseTime = std::chrono::microseconds::zero();
+        std::chrono::microseconds PlannedByteTime = std::chrono::microseconds::zero();
+        int PlannedMaxReadRegisters = -1;
+        int PlannedMaxRegHole = -1;
+        int PlannedMaxBitHole = -1;
+        bool PlannedSupportsHoles = false;
+        bool PlannedForceFrameTimeout = false;
+        size_t PlannedRegisterCount = 0;
+
+        bool NeedUpdate(TPort& port,
+                        const TModbusDevice& device,
+                        std::chrono::microseconds averageResponseTime,
+                        bool forceFrameTimeout) const;
+    };
+}
@@ -0,0 +1,177 @@
+#include "modbus_read_tuner.h"
+
+#include <filesystem>
+#include <wblib/json_utils.h>
+
+#include "devices/modbus_device.h"
+#include "file_utils.h"
+#include "log.h"
+
+#define LOG(logger) logger.Log() << "[modbus] "
+
+namespace
+{
+    // The search stops if the current limit isn't reached during READ_CYCLES_WITHOUT_PROGRESS polling cycles
+    const size_t READ_CYCLES_WITHOUT_PROGRESS = 2;
+}
+
+namespace Modbus
+{
+    std::string ReadTuningStateToString(TReadTuningState state)
+    {
+        switch (state) {
+            case TReadTuningState::IN_PROGRESS:
+                return "in_progress";
+            case TReadTuningState::FINISHED:
+                return "finished";
+            default:
+                return "disabled";
+        }
+    }
+
+    Json::Value ReadTuningToJson(const TReadTuning& tuning)
+    {
+        Json::Value res(Json::objectValue);
+        res["state"] = ReadTuningStateToString(tuning.State);
+        if (tuning.State != TReadTuningState::DISABLED) {
+            res["max_read_registers"] = tuning.MaxReadRegisters;
+            res["supports_holes"] = tuning.SupportsHoles;
+        }
+        return res;
+    }
+
+    TReadBlockTuner::TReadBlockTuner(int minMaxReadRegisters, int maxMaxReadRegisters)
+        : Good(std::max(1, minMaxReadRegisters)),
+          Bad(std::max(Good, maxMaxReadRegisters) + 1)
+    {}
+
+    int TReadBlockTuner::GetMaxReadRegisters() const
+    {
+        return Good + (Bad - Good) / 2;
+    }
+
+    void TReadBlockTuner::OnReadSuccess(size_t count, bool hasHoles, size_t readsPerCycle)
+    {
+        if (hasHoles) {
+            SupportsHoles = true;
+            HolesFailures = 0;
+        }
+        if (static_cast<int>(count) > Good) {
+            Good = std::min(static_cast<int>(count), Bad - 1);
+            ReadsWithoutProgress = 0;
+            Failures = 0;
+            return;
+        }
+        if (Bad - Good > 1 && ++ReadsWithoutProgress > readsPerCycle * READ_CYCLES_WITHOUT_PROGRESS) {
+            // Polled registers can't form larger ranges, there is no point in further search
+            Bad = Good + 1;
+        }
+    }
+
+    void TReadBlockTuner::OnReadFailure(size_t count)
+    {
+        // Failures of ranges not larger than the known good size are not related to the size
+        if (static_cast<int>(count) <= Good || static_cast<int>(count) >= Bad) {
+            return;
+        }
+        FailedCount = (Failures == 0) ? count : std::max(FailedCount, static_cast<int>(count));
+        if (++Failures >= READ_TUNING_FAILURES_THRESHOLD) {
+            Bad = FailedCount;
+            Failures = 0;
+            ReadsWithoutProgress = 0;
+        }
+    }
+
+    void TReadBlockTuner::OnHolesNotSupported()
+    {
+        if (++HolesFailures >= READ_TUNING_FAILURES_THRESHOLD) {
+            SupportsHoles = false;
+        }
+    }
+
+    TReadTuning TReadBlockTuner::GetResult() const
+    {
+        TReadTuning res;
+        res.State = (Bad - Good > 1) ? TReadTuningState::IN_PROGRESS : TReadTuningState::FINISHED;
+        res.MaxReadRegisters = Good;
+        res.SupportsHoles = SupportsHoles;
+        return res;
+    }
+
+    void TReadBlockTuner::Restore(const TReadTuning& tuning)
+    {
+        Good = std::max(1, std::min(tuning.MaxReadRegisters, Bad - 1));
+        if (tuning.State == TReadTuningState::FINISHED) {
+            Bad = Good + 1;
+        }
+        SupportsHoles = tuning.SupportsHoles;
+        ReadsWithoutProgress = 0;
+        Failures = 0;
+        HolesFailures = 0;
+    }
+
+    TReadTuningStorage::TReadTuningStorage(const std::string& filePath): FilePath(filePath), Data(Json::objectValue)
+    {
+        if (!std::filesystem::exists(FilePath)) {
+            return;
+        }
+        try {
+            Data = WBMQTT::JSON::Parse(FilePath);
+            if (!Data.isObject()) {
+                Data = Json::Value(Json::objectValue);
+            }
+        } catch (const std::exception& e) {
+            LOG(Warn) << "Failed to load learned read parameters from " << FilePath << ": " << e.what();
+        }
+    }
+
+    void TReadTuningStorage::RegisterDevices(PHandlerConfig handlerConfig)
+    {
+        for (const auto& portConfig: handlerConfig->PortConfigs) {
+            for (const auto& device: portConfig->Devices) {
+                auto modbusDevice = std::dynamic_pointer_cast<TModbusDevice>(device->Device);
+                if (!modbusDevice || !modbusDevice->IsReadTuningEnabled()) {
+                    continue;
+                }
+                auto id = portConfig->Port->GetDescription(false) + ":" + modbusDevice->DeviceConfig()->SlaveId;
+                TReadTuning tuning;
+                if (Get(id, tuning)) {
+                    modbusDevice->RestoreReadTuning(tuning);
+                }
+                modbusDevice->SetReadTuningChangedCallback(
+                    [this, id](const TReadTuning& tuning) { Set(id, tuning); });
+            }
+        }
+    }
+
+    bool TReadTuningStorage::Get(const std::string& id, TReadTuning& tuning) const
+    {
+        std::unique_lock lock(Mutex);
+        const auto& item = Data[id];
+        if (!item.isObject() || !item["max_read_registers"].isInt()) {
+            return false;
+        }
+        tuning.State = (item["state"].asString() == ReadTuningStateToString(TReadTuningState::FINISHED))
+                           ? TReadTuningState::FINISHED
+                           : TReadTuningState::IN_PROGRESS;
+        tuning.MaxReadRegisters = item["max_read_registers"].asInt();
+        tuning.SupportsHoles = item.get("supports_holes", true).asBool();
+        return true;
+    }
+
+    void TReadTuningStorage::Set(const std::string& id, const TReadTuning& tuning)
+    {
+        std::unique_lock lock(Mutex);
+        Data[id] = ReadTuningToJson(tuning);
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "  ";
+        try {
+            // Write to a temporary file first to keep the previous version on power loss
+            auto tmpFilePath = FilePath + ".tmp";
+            WriteToFile(tmpFilePath, Json::writeString(builder, Data));
+            std::filesystem::rename(tmpFilePath, FilePath);
+        } catch (const std::exception& e) {
+            LOG(Warn) << "Failed to save learned read parameters to " << FilePath << ": " << e.what();
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+
+#include "serial_config.h"
+
+namespace Modbus // modbus read block size auto tuning
+{
+    enum class TReadTuningState
+    {
+        DISABLED,
+        IN_PROGRESS,
+        FINISHED
+    };
+
+    //! Learned read parameters of a device
+    struct TReadTuning
+    {
+        TReadTuningState State = TReadTuningState::DISABLED;
+
+        //! The largest count of Modbus registers successfully read by one request
+        int MaxReadRegisters = 1;
+
+        //! The device answers requests containing holes
+        bool SupportsHoles = true;
+
+        bool operator==(const TReadTuning& other) const = default;
+    };
+
+    //! Count of consecutive failures required to lower the request size limit or to disable holes
+    const size_t READ_TUNING_FAILURES_THRESHOLD = 3;
+
+    std::string ReadTuningStateToString(TReadTuningState state);
+    Json::Value ReadTuningToJson(const TReadTuning& tuning);
+
+    /**
+     * @brief Binary search of the largest read request size supported by a device.
+     *        The search is driven by results of ordinary polling requests.
+     *        A successful request raises the lower bound,
+     *        READ_TUNING_FAILURES_THRESHOLD consecutive failed ones lower the upper bound.
+     *        A single failure can be caused by noise on the bus, so it doesn't affect the search.
+     */
+    class TReadBlockTuner
+    {
+    public:
+        /**
+         * @param minMaxReadRegisters initial known good request size
+         * @param maxMaxReadRegisters the largest possible request size
+         */
+        TReadBlockTuner(int minMaxReadRegisters, int maxMaxReadRegisters);
+
+        //! Request size limit to use for building new register ranges
+        int GetMaxReadRegisters() const;
+
+        /**
+         * @brief Processes successfully read range
+         *
+         * @param count count of Modbus registers in the range
+         * @param hasHoles the range contains holes
+         * @param readsPerCycle count of reads in one polling cycle,
+         *                      the search stops if the limit isn't reached during two polling cycles
+         */
+        void OnReadSuccess(size_t count, bool hasHoles, size_t readsPerCycle);
+
+        /**
+         * @brief Processes failed read of a range: an error response or a timeout.
+         *        Errors of disconnected devices are not related to the request size and must not be passed.
+         *        Failures of ranges not larger than the known good size are ignored.
+         *
+         * @param count count of Modbus registers in the range
+         */
+        void OnReadFailure(size_t count);
+
+        //! The device has rejected a range with holes
+        void OnHolesNotSupported();
+
+        TReadTuning GetResult() const;
+        void Restore(const TReadTuning& tuning);
+
+    private:
+        int Good;
+        int Bad;
+        bool SupportsHoles = true;
+        size_t ReadsWithoutProgress = 0;
+
+        //! Consecutive failures of ranges larger than Good and the largest size of them
+        size_t Failures = 0;
+        int FailedCount = 0;
+
+        size_t HolesFailures = 0;
+    };
+
+    /**
+     * @brief Persistent storage of learned device read parameters.
+     *        Values are identified by port description and slave id.
+     */
+    class TReadTuningStorage
+    {
+    public:
+        TReadTuningStorage(const std::string& filePath);
+
+        /**
+         * Restores stored values into devices with enabled auto tuning and saves new values on tuning finish.
+         */
+        void RegisterDevices(PHandlerConfig handlerConfig);
+
+        bool Get(const std::string& id, TReadTuning& tuning) const;
+        void Set(const std::string& id, const TReadTuning& tuning);
+
+    private:
+        std::string FilePath;
+        mutable std::mutex Mutex;
+        Json::Value Data;
+    };
+}
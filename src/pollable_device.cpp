@@ -35,14 +35,21 @@ PRegisterRange TPollableDevice::ReadRegisterRange(TFeaturePort& port,
                                                   std::chrono::milliseconds pollLimit,
                                                   bool readAtLeastOneRegister,
                                                   const util::TSpentTimeMeter& sessionTime,
-                                                  TSerialClientDeviceAccessHandler& lastAccessedDevice)
+                                                  TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                                  std::chrono::milliseconds maxRangeTime)
 {
     auto currentTime = sessionTime.GetStartTime();
     auto registerRange = Device->CreateRegisterRange();
     while (Registers.HasReadyItems(currentTime)) {
-        const auto limit = (readAtLeastOneRegister && registerRange->RegisterList().empty())
-                               ? std::chrono::milliseconds::max()
-                               : pollLimit;
+        auto limit = pollLimit;
+        if (registerRange->RegisterList().empty()) {
+            if (readAtLeastOneRegister) {
+                limit = std::chrono::milliseconds::max();
+            }
+        } else {
+            // Registers which can be read in one request are not joined if the request becomes too long
+            limit = std::min(limit, maxRangeTime);
+        }
         const auto& item = Registers.GetTop();
         if (!registerRange->Add(port, item.Data, limit)) {
             break;
@@ -56,6 +63,10 @@ PRegisterRange TPollableDevice::ReadRegisterRange(TFeaturePort& port,
             Device->ReadRegisterRange(port, registerRange);
             readOk = true;
         }
+        if (!readOk) {
+            // Values of the device kept for change detection are outdated after the errors set below
+            Device->InvalidateReadCache();
+        }
 
         for (auto& reg: registerRange->RegisterList()) {
             reg->SetLastPollTime(currentTime);
@@ -74,6 +85,26 @@ PRegisterRange TPollableDevice::ReadRegisterRange(TFeaturePort& port,
     return registerRange;
 }
 
+bool TPollableDevice::PostponePoll(PRegister reg, std::chrono::steady_clock::time_point currentTime)
+{
+    if (!Registers.Contains(reg)) {
+        return false;
+    }
+    Registers.Remove(reg);
+    ScheduleNextPoll(reg, currentTime);
+    return true;
+}
+
+bool TPollableDevice::ScheduleImmediatePoll(PRegister reg, std::chrono::steady_clock::time_point currentTime)
+{
+    if (!Registers.Contains(reg)) {
+        return false;
+    }
+    Registers.Remove(reg);
+    Registers.AddEntry(reg, currentTime);
+    return true;
+}
+
 std::list<PRegister> TPollableDevice::MarkWaitingRegistersAsReadErrorAndReschedule(
     std::chrono::steady_clock::time_point currentTime)
 {
@@ -150,6 +181,16 @@ void TPollableDevice::ScheduleNextPoll(PRegister reg, std::chrono::steady_clock:
         }
         return;
     }
+    if (reg->IsPollingRelaxed()) {
+        // The value is delivered by events, so the register is polled rarely
+        // just to be sure that it is actual
+        auto period = Device->DeviceConfig()->EventsHeartbeatPeriod;
+        if (Priority == TPriority::High) {
+            period = std::max(period, *(reg->GetConfig()->ReadPeriod));
+        }
+        Registers.AddEntry(reg, currentTime + period);
+        return;
+    }
     if (Priority == TPriority::High) {
         Registers.AddEntry(reg, currentTime + *(reg->GetConfig()->ReadPeriod));
         return;
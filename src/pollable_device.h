@@ -26,7 +26,24 @@ public:
                                      std::chrono::milliseconds pollLimit,
                                      bool readAtLeastOneRegister,
                                      const util::TSpentTimeMeter& sessionTime,
-                                     TSerialClientDeviceAccessHandler& lastAccessedDevice);
+                                     TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                     std::chrono::milliseconds maxRangeTime = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Schedules next poll of the register as if it is read at currentTime.
+     *        It is used after successful write, because the register already has actual value.
+     *
+     * @return false if the register is not waiting for poll
+     */
+    bool PostponePoll(PRegister reg, std::chrono::steady_clock::time_point currentTime);
+
+    /**
+     * @brief Schedules poll of the register at currentTime.
+     *        It is used when relaxed polling of the register is stopped.
+     *
+     * @return false if the register is not waiting for poll
+     */
+    bool ScheduleImmediatePoll(PRegister reg, std::chrono::steady_clock::time_point currentTime);
 
     std::list<PRegister> MarkWaitingRegistersAsReadErrorAndReschedule(
         std::chrono::steady_clock::time_point currentTime);
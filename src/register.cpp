@@ -231,6 +231,16 @@ void TRegister::IncludeInPolling()
     ExcludedFromPolling = false;
 }
 
+bool TRegister::IsPollingRelaxed() const
+{
+    return PollingRelaxed;
+}
+
+void TRegister::SetPollingRelaxed(bool relaxed)
+{
+    PollingRelaxed = relaxed;
+}
+
 const PRegisterConfig TRegister::GetConfig() const
 {
     return Config;
@@ -668,51 +678,96 @@ template<> std::string ToScaledTextValue(const TRegisterConfig& reg, double val)
     return WBMQTT::StringFormat("%.15g", RoundValue(reg.Scale * val + reg.Offset, reg.RoundTo));
 }
 
-std::string ConvertFromRawValue(const TRegisterConfig& reg, TRegisterValue val)
+template<typename T> double ToScaledNumber(const TRegisterConfig& reg, T val)
+{
+    return RoundValue(reg.Scale * static_cast<double>(val) + reg.Offset, reg.RoundTo);
+}
+
+/**
+ * @brief Decodes numeric raw value according to register format and passes it to fn as a value of native type
+ *
+ * @return false if the register has non-numeric format, fn isn't called in the case
+ */
+template<typename TFn> bool VisitRawNumber(const TRegisterConfig& reg, const TRegisterValue& val, TFn&& fn)
 {
     switch (reg.Format) {
         case U8:
-            return ToScaledTextValue(reg, val.Get<uint8_t>());
+            fn(val.Get<uint8_t>());
+            return true;
         case S8:
-            return ToScaledTextValue(reg, val.Get<int8_t>());
+            fn(val.Get<int8_t>());
+            return true;
         case S16:
-            return ToScaledTextValue(reg, val.Get<int16_t>());
+            fn(val.Get<int16_t>());
+            return true;
         case S24: {
             uint32_t v = val.Get<uint64_t>() & 0xffffff;
             if (v & 0x800000)
                 v |= 0xff000000;
-            return ToScaledTextValue(reg, static_cast<int32_t>(v));
+            fn(static_cast<int32_t>(v));
+            return true;
         }
         case S32:
-            return ToScaledTextValue(reg, val.Get<int32_t>());
+            fn(val.Get<int32_t>());
+            return true;
         case S64:
-            return ToScaledTextValue(reg, val.Get<int64_t>());
+            fn(val.Get<int64_t>());
+            return true;
         case BCD8:
-            return ToScaledTextValue(reg, PackedBCD2Int(val.Get<uint64_t>(), WordSizes::W8_SZ));
+            fn(PackedBCD2Int(val.Get<uint64_t>(), WordSizes::W8_SZ));
+            return true;
         case BCD16:
-            return ToScaledTextValue(reg, PackedBCD2Int(val.Get<uint64_t>(), WordSizes::W16_SZ));
+            fn(PackedBCD2Int(val.Get<uint64_t>(), WordSizes::W16_SZ));
+            return true;
         case BCD24:
-            return ToScaledTextValue(reg, PackedBCD2Int(val.Get<uint64_t>(), WordSizes::W24_SZ));
+            fn(PackedBCD2Int(val.Get<uint64_t>(), WordSizes::W24_SZ));
+            return true;
         case BCD32:
-            return ToScaledTextValue(reg, PackedBCD2Int(val.Get<uint64_t>(), WordSizes::W32_SZ));
+            fn(PackedBCD2Int(val.Get<uint64_t>(), WordSizes::W32_SZ));
+            return true;
         case Float: {
             float v;
             auto rawValue = val.Get<uint64_t>();
             memcpy(&v, &rawValue, sizeof(v));
-            return ToScaledTextValue(reg, v);
+            fn(v);
+            return true;
         }
         case Double: {
             double v;
             auto rawValue = val.Get<uint64_t>();
             memcpy(&v, &rawValue, sizeof(v));
-            return ToScaledTextValue(reg, v);
+            fn(v);
+            return true;
         }
+        case Char8:
+        case String:
+        case String8:
+            return false;
+        default:
+            fn(val.Get<uint64_t>());
+            return true;
+    }
+}
+
+std::optional<double> ConvertFromRawValueToNumber(const TRegisterConfig& reg, TRegisterValue val)
+{
+    std::optional<double> res;
+    VisitRawNumber(reg, val, [&](auto v) { res = ToScaledNumber(reg, v); });
+    return res;
+}
+
+std::string ConvertFromRawValue(const TRegisterConfig& reg, TRegisterValue val)
+{
+    switch (reg.Format) {
         case Char8:
             return std::string(1, val.Get<uint8_t>());
         case String:
         case String8:
             return val.Get<std::string>();
-        default:
-            return ToScaledTextValue(reg, val.Get<uint64_t>());
+        default: {
+            std::string res;
+            VisitRawNumber(reg, val, [&](auto v) { res = ToScaledTextValue(reg, v); });
+            return res;
+        }
     }
 }
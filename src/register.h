@@ -386,6 +386,11 @@ struct TRegister
     void ExcludeFromPolling();
     void IncludeInPolling();
 
+    //! The register value is delivered by Fast Modbus events, so it is polled only with device's
+    //! events heartbeat period instead of its own read period
+    bool IsPollingRelaxed() const;
+    void SetPollingRelaxed(bool relaxed);
+
     const PRegisterConfig GetConfig() const;
 
 private:
@@ -400,6 +405,7 @@ private:
     TReadPeriodMissChecker ReadPeriodMissChecker;
     std::atomic<bool> Supported = true;
     bool ExcludedFromPolling = false;
+    bool PollingRelaxed = false;
     PRegisterConfig Config;
 };
 
@@ -574,3 +580,12 @@ TRegisterValue ConvertToRawValue(const TRegisterConfig& reg, const std::string&
  * @param val raw bytes
  */
 std::string ConvertFromRawValue(const TRegisterConfig& reg, TRegisterValue val);
+
+/**
+ * @brief Converts raw bytes to number according to register config
+ *        Performs scaling and rounding as ConvertFromRawValue does.
+ * @param reg register config
+ * @param val raw bytes
+ * @return empty value for string and character registers
+ */
+std::optional<double> ConvertFromRawValueToNumber(const TRegisterConfig& reg, TRegisterValue val);
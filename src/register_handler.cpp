@@ -44,15 +44,15 @@ void TRegisterHandler::HandleWriteErrorRetryWrite(const TRegisterValue& tempValu
     Reg->SetError(TRegister::TError::WriteError);
 }
 
-void TRegisterHandler::Flush(TPort& port)
+TRegisterValue TRegisterHandler::GetValueToSet()
 {
-    TRegisterValue tempValue; // must be volatile
-    try {
-        {
-            std::lock_guard<std::mutex> lock(SetValueMutex);
-            tempValue = ValueToSet;
-        }
-        Reg->Device()->WriteRegister(port, Reg, tempValue);
+    std::lock_guard<std::mutex> lock(SetValueMutex);
+    return ValueToSet;
+}
+
+void TRegisterHandler::HandleWriteResult(const TRegisterValue& tempValue, std::exception_ptr error)
+{
+    if (!error) {
         {
             std::lock_guard<std::mutex> lock(SetValueMutex);
             Dirty = (tempValue != ValueToSet);
@@ -60,17 +60,47 @@ void TRegisterHandler::Flush(TPort& port)
         }
         Reg->SetValue(tempValue, false);
         Reg->ClearError(TRegister::TError::WriteError);
+        return;
+    }
+    try {
+        std::rethrow_exception(error);
     } catch (const TSerialDeviceInternalErrorException& e) {
         HandleWriteErrorNoRetry(tempValue, e.what());
-        return;
     } catch (const TSerialDevicePermanentRegisterException& e) {
         HandleWriteErrorNoRetry(tempValue, e.what());
-        return;
     } catch (const TSerialDeviceException& e) {
         HandleWriteErrorRetryWrite(tempValue, e.what());
     }
 }
 
+void TRegisterHandler::Flush(TPort& port)
+{
+    TRegisterValue tempValue = GetValueToSet();
+    std::exception_ptr error;
+    try {
+        Reg->Device()->WriteRegister(port, Reg, tempValue);
+    } catch (const TSerialDeviceException& e) {
+        error = std::current_exception();
+    }
+    HandleWriteResult(tempValue, error);
+}
+
+void TRegisterHandler::Flush(TPort& port, const std::vector<PRegisterHandler>& handlers)
+{
+    if (handlers.empty()) {
+        return;
+    }
+    std::vector<TRegisterWriteRequest> requests;
+    requests.reserve(handlers.size());
+    for (const auto& handler: handlers) {
+        requests.push_back({handler->Reg, handler->GetValueToSet(), nullptr});
+    }
+    handlers.front()->Reg->Device()->WriteRegisters(port, requests);
+    for (size_t i = 0; i < handlers.size(); ++i) {
+        handlers[i]->HandleWriteResult(requests[i].Value, requests[i].Error);
+    }
+}
+
 bool TRegisterHandler::NeedRetryAfterWriteFail()
 {
     std::lock_guard<std::mutex> lock(SetValueMutex);
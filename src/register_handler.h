@@ -6,6 +6,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 #include <wblib/utils.h>
 
 using WBMQTT::StringFormat;
@@ -24,6 +25,13 @@ public:
      */
     void Flush(TPort& port);
 
+    /**
+     * @brief Write pending values of several registers of one device.
+     *        Adjacent registers can be written by one request if the device supports it.
+     *        NeedToFlush must be checked before call.
+     */
+    static void Flush(TPort& port, const std::vector<std::shared_ptr<TRegisterHandler>>& handlers);
+
     /**
      * @brief Returns false when MaxWriteFailTime has elapsed and the pending write is dropped.
      */
@@ -39,6 +47,8 @@ private:
     bool WriteFail;
     std::chrono::steady_clock::time_point WriteFirstTryTime;
 
+    TRegisterValue GetValueToSet();
+    void HandleWriteResult(const TRegisterValue& tempValue, std::exception_ptr error);
     void HandleWriteErrorNoRetry(const TRegisterValue& tempValue, const char* msg);
     void HandleWriteErrorRetryWrite(const TRegisterValue& tempValue, const char* msg);
 };
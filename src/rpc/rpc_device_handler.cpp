@@ -1,4 +1,5 @@
 #include "rpc_device_handler.h"
+#include "devices/modbus_device.h"
 #include "rpc_device_load_config_task.h"
 #include "rpc_device_load_task.h"
 #include "rpc_device_probe_task.h"
@@ -123,6 +124,7 @@ TRPCDeviceHandler::TRPCDeviceHandler(const std::string& configFileName,
                                      const std::string& requestDeviceSetSchemaFilePath,
                                      const std::string& requestDeviceProbeSchemaFilePath,
                                      const std::string& requestDeviceSetPollSchemaFilePath,
+                                     const std::string& requestDeviceGetReadTuningSchemaFilePath,
                                      const TSerialDeviceFactory& deviceFactory,
                                      PTemplateMap templates,
                                      TSerialClientTaskRunner& serialClientTaskRunner,
@@ -135,6 +137,8 @@ TRPCDeviceHandler::TRPCDeviceHandler(const std::string& configFileName,
       RequestDeviceSetSchema(LoadRPCRequestSchema(requestDeviceSetSchemaFilePath, "device/Set")),
       RequestDeviceProbeSchema(LoadRPCRequestSchema(requestDeviceProbeSchemaFilePath, "device/Probe")),
       RequestDeviceSetPollSchema(LoadRPCRequestSchema(requestDeviceSetPollSchemaFilePath, "device/SetPoll")),
+      RequestDeviceGetReadTuningSchema(
+          LoadRPCRequestSchema(requestDeviceGetReadTuningSchemaFilePath, "device/GetReadTuning")),
       Templates(templates),
       SerialClientTaskRunner(serialClientTaskRunner),
       ParametersCache(parametersCache)
@@ -169,6 +173,9 @@ TRPCDeviceHandler::TRPCDeviceHandler(const std::string& configFileName,
                                              std::placeholders::_3));
 
     rpcServer->RegisterMethod("device", "SetPoll", std::bind(&TRPCDeviceHandler::SetPoll, this, std::placeholders::_1));
+    rpcServer->RegisterMethod("device",
+                              "GetReadTuning",
+                              std::bind(&TRPCDeviceHandler::GetReadTuning, this, std::placeholders::_1));
 }
 
 void TRPCDeviceHandler::LoadConfig(const Json::Value& request,
@@ -265,6 +272,20 @@ Json::Value TRPCDeviceHandler::SetPoll(const Json::Value& request)
     }
     return Json::Value(Json::objectValue);
 }
+
+Json::Value TRPCDeviceHandler::GetReadTuning(const Json::Value& request)
+{
+    ValidateRPCRequest(request, RequestDeviceGetReadTuningSchema);
+    auto params = SerialClientTaskRunner.GetSerialClientParams(request);
+    if (!params.Device) {
+        throw TRPCException("Port or device not found", TRPCResultCode::RPC_WRONG_PARAM_VALUE);
+    }
+    auto modbusDevice = std::dynamic_pointer_cast<TModbusDevice>(params.Device);
+    if (!modbusDevice) {
+        return Modbus::ReadTuningToJson(Modbus::TReadTuning());
+    }
+    return Modbus::ReadTuningToJson(modbusDevice->GetReadTuning());
+}
 #endif
 
 void PrepareSession(TPort& port, PSerialDevice device, int maxRetries)
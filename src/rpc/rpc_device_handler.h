@@ -99,6 +99,7 @@ public:
                       const std::string& requestDeviceLSetSchemaFilePath,
                       const std::string& requestDeviceProbeSchemaFilePath,
                       const std::string& requestDeviceSetPollSchemaFilePath,
+                      const std::string& requestDeviceGetReadTuningSchemaFilePath,
                       const TSerialDeviceFactory& deviceFactory,
                       PTemplateMap templates,
                       TSerialClientTaskRunner& serialClientTaskRunner,
@@ -114,6 +115,7 @@ private:
     Json::Value RequestDeviceSetSchema;
     Json::Value RequestDeviceProbeSchema;
     Json::Value RequestDeviceSetPollSchema;
+    Json::Value RequestDeviceGetReadTuningSchema;
 
     PTemplateMap Templates;
     TSerialClientTaskRunner& SerialClientTaskRunner;
@@ -136,6 +138,8 @@ private:
                WBMQTT::TMqttRpcServer::TErrorCallback onError);
 
     Json::Value SetPoll(const Json::Value& request);
+
+    Json::Value GetReadTuning(const Json::Value& request);
 };
 
 struct TRPCRegister
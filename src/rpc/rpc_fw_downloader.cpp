@@ -1,7 +1,9 @@
 // Cf. fw_downloader.py - BinaryDownloader, get_released_fw(), get_released_bootloader()
 // Cf. firmware_update.py:185 parse_wbfw(), firmware_update.py:205 download_wbfw()
 // Cf. releases.py:13 parse_releases(), releases.py:30 parse_fw_version()
+#include <algorithm>
 #include <fstream>
+#include <future>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
@@ -20,6 +22,12 @@ const std::chrono::minutes TFwDownloader::RELEASE_CACHE_TTL{10};
 const std::chrono::minutes TFwDownloader::BOOTLOADER_CACHE_TTL{30};
 const std::chrono::hours TFwDownloader::WBFW_CACHE_TTL{2};
 
+void IHttpClient::GetBinaryStream(const std::string& url, const TFwDataCallback& onData)
+{
+    auto data = GetBinary(url);
+    onData(data.data(), data.size());
+}
+
 #ifndef __EMSCRIPTEN__
 
 // ============================================================
@@ -28,17 +36,37 @@ const std::chrono::hours TFwDownloader::WBFW_CACHE_TTL{2};
 
 namespace
 {
+    struct TCurlWriteContext
+    {
+        const TFwDataCallback& OnData;
+        std::exception_ptr Error;
+    };
+
+    // Exceptions must not pass through curl, so the error is saved and the transfer is aborted
     size_t CurlWriteCallback(void* contents, size_t size, size_t nmemb, void* userp)
     {
-        auto* buffer = static_cast<std::vector<uint8_t>*>(userp);
+        auto* context = static_cast<TCurlWriteContext*>(userp);
         auto totalSize = size * nmemb;
-        auto* bytes = static_cast<uint8_t*>(contents);
-        buffer->insert(buffer->end(), bytes, bytes + totalSize);
+        try {
+            context->OnData(static_cast<uint8_t*>(contents), totalSize);
+        } catch (...) {
+            context->Error = std::current_exception();
+            return 0;
+        }
         return totalSize;
     }
 }
 
 std::vector<uint8_t> TCurlHttpClient::GetBinary(const std::string& url)
+{
+    std::vector<uint8_t> buffer;
+    GetBinaryStream(url, [&buffer](const uint8_t* data, size_t size) {
+        buffer.insert(buffer.end(), data, data + size);
+    });
+    return buffer;
+}
+
+void TCurlHttpClient::GetBinaryStream(const std::string& url, const TFwDataCallback& onData)
 {
     struct CurlCleanup
     {
@@ -52,27 +80,28 @@ std::vector<uint8_t> TCurlHttpClient::GetBinary(const std::string& url)
         throw std::runtime_error("Failed to initialize curl");
     }
 
-    std::vector<uint8_t> buffer;
+    TCurlWriteContext context{onData, nullptr};
     curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
     curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, CurlWriteCallback);
-    curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &buffer);
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &context);
+    curl_easy_setopt(curl.get(), CURLOPT_FAILONERROR, 1L);
     curl_easy_setopt(curl.get(), CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(curl.get(), CURLOPT_TIMEOUT, 30L);
     curl_easy_setopt(curl.get(), CURLOPT_CONNECTTIMEOUT, 10L);
 
     CURLcode res = curl_easy_perform(curl.get());
-    if (res != CURLE_OK) {
-        throw std::runtime_error("Failed to download " + url + ": " + curl_easy_strerror(res));
+    if (context.Error) {
+        std::rethrow_exception(context.Error);
     }
-
     long httpCode = 0;
     curl_easy_getinfo(curl.get(), CURLINFO_RESPONSE_CODE, &httpCode);
+    if (res != CURLE_OK && res != CURLE_HTTP_RETURNED_ERROR) {
+        throw std::runtime_error("Failed to download " + url + ": " + curl_easy_strerror(res));
+    }
 
     if (httpCode != 200) {
         throw std::runtime_error("HTTP " + std::to_string(httpCode) + " downloading " + url);
     }
-
-    return buffer;
 }
 
 std::string TCurlHttpClient::GetText(const std::string& url)
@@ -93,25 +122,40 @@ std::string TCurlHttpClient::GetText(const std::string& url)
 //                     WBFW Parsing
 // ============================================================
 
-// Cf. firmware_update.py:185 parse_wbfw()
-TParsedWBFW ParseWBFW(const std::vector<uint8_t>& data)
+namespace
 {
     // Info block is 16 registers * 2 bytes = 32 bytes
-    const size_t INFO_BLOCK_SIZE = 32;
+    const size_t WBFW_INFO_BLOCK_SIZE = 32;
+}
 
-    if (data.size() % 2 != 0) {
-        throw std::runtime_error("Firmware file should be even-bytes long, got " + std::to_string(data.size()) + "b");
+void TWBFWParser::Add(const uint8_t* data, size_t size)
+{
+    Size += size;
+    auto infoSize = std::min(size, WBFW_INFO_BLOCK_SIZE - Firmware.Info.size());
+    Firmware.Info.insert(Firmware.Info.end(), data, data + infoSize);
+    Firmware.Data.insert(Firmware.Data.end(), data + infoSize, data + size);
+}
+
+// Cf. firmware_update.py:185 parse_wbfw()
+TParsedWBFW TWBFWParser::Finish()
+{
+    if (Size % 2 != 0) {
+        throw std::runtime_error("Firmware file should be even-bytes long, got " + std::to_string(Size) + "b");
     }
 
-    if (data.size() < INFO_BLOCK_SIZE) {
-        throw std::runtime_error("Firmware file too short: info block should be " + std::to_string(INFO_BLOCK_SIZE) +
-                                 " bytes, got " + std::to_string(data.size()));
+    if (Size < WBFW_INFO_BLOCK_SIZE) {
+        throw std::runtime_error("Firmware file too short: info block should be " +
+                                 std::to_string(WBFW_INFO_BLOCK_SIZE) + " bytes, got " + std::to_string(Size));
     }
 
-    TParsedWBFW result;
-    result.Info.assign(data.begin(), data.begin() + INFO_BLOCK_SIZE);
-    result.Data.assign(data.begin() + INFO_BLOCK_SIZE, data.end());
-    return result;
+    return std::move(Firmware);
+}
+
+TParsedWBFW ParseWBFW(const std::vector<uint8_t>& data)
+{
+    TWBFWParser parser;
+    parser.Add(data.data(), data.size());
+    return parser.Finish();
 }
 
 // ============================================================
@@ -262,8 +306,63 @@ std::string ReadReleaseSuite(const std::string& releasePath)
 //                     TFwDownloader
 // ============================================================
 
-TFwDownloader::TFwDownloader(PHttpClient httpClient): HttpClient(std::move(httpClient))
-{}
+TFwDownloader::TFwDownloader(PHttpClient httpClient, const std::string& cacheDir)
+    : HttpClient(std::move(httpClient))
+{
+    if (!cacheDir.empty()) {
+        FileCache = std::make_unique<TFwFileCache>(cacheDir);
+    }
+}
+
+// Release indexes are stored on disk to find cached firmwares without network access
+std::string TFwDownloader::GetIndexText(const std::string& url)
+{
+    try {
+        auto text = HttpClient->GetText(url);
+        if (FileCache) {
+            auto writer = FileCache->StartWrite(url);
+            writer->Write(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+            writer->Commit();
+        }
+        return text;
+    } catch (const std::exception& e) {
+        std::string text;
+        if (!FileCache || !FileCache->Read(url, [&text](const uint8_t* data, size_t size) {
+                text.append(reinterpret_cast<const char*>(data), size);
+            }))
+        {
+            throw;
+        }
+        LOG(Warn) << "Using cached " << url << ": " << e.what();
+        return text;
+    }
+}
+
+// Firmware URLs contain versions, so a cached firmware is used without network access
+TParsedWBFW TFwDownloader::LoadWBFW(const std::string& url)
+{
+    if (FileCache) {
+        TWBFWParser parser;
+        if (FileCache->Read(url, [&parser](const uint8_t* data, size_t size) { parser.Add(data, size); })) {
+            LOG(Debug) << "Using cached " << url;
+            return parser.Finish();
+        }
+    }
+
+    TWBFWParser parser;
+    auto writer = FileCache ? FileCache->StartWrite(url) : nullptr;
+    HttpClient->GetBinaryStream(url, [&parser, &writer](const uint8_t* data, size_t size) {
+        parser.Add(data, size);
+        if (writer) {
+            writer->Write(data, size);
+        }
+    });
+    auto firmware = parser.Finish();
+    if (writer) {
+        writer->Commit();
+    }
+    return firmware;
+}
 
 // Cf. fw_downloader.py _get_released_binary() + the @ttl_lru_cache wrappers.
 TReleasedBinary TFwDownloader::GetReleasedBinary(const std::string& indexUrl,
@@ -283,7 +382,7 @@ TReleasedBinary TFwDownloader::GetReleasedBinary(const std::string& indexUrl,
 
     if (releases.empty()) {
         LOG(Debug) << "Looking up released binary in " << indexUrl << " (suite: " << releaseSuite << ")";
-        auto text = HttpClient->GetText(indexUrl);
+        auto text = GetIndexText(indexUrl);
         releases = ParseReleaseVersionsYaml(text);
 
         std::lock_guard<std::mutex> lock(CacheMutex);
@@ -332,27 +431,50 @@ TReleasedBinary TFwDownloader::GetReleasedBootloader(const std::string& fwSignat
 }
 
 // Cf. firmware_update.py:205 download_wbfw()
+// Devices with the same signature updated in parallel on different ports share one download.
+// The image is kept while it is used, so a long fleet update doesn't download it again.
 TParsedWBFW TFwDownloader::DownloadAndParseWBFW(const std::string& url)
 {
-    auto now = std::chrono::steady_clock::now();
+    std::promise<TParsedWBFW> download;
+    std::shared_future<TParsedWBFW> pendingDownload;
     {
         std::lock_guard<std::mutex> lock(CacheMutex);
+        auto now = std::chrono::steady_clock::now();
         auto it = WBFWCache.find(url);
         if (it != WBFWCache.end() && now < it->second.ExpiresAt) {
+            it->second.ExpiresAt = now + WBFW_CACHE_TTL;
             return it->second.Firmware;
         }
+        auto downloadIt = WBFWDownloads.find(url);
+        if (downloadIt != WBFWDownloads.end()) {
+            pendingDownload = downloadIt->second;
+        } else {
+            WBFWDownloads[url] = download.get_future().share();
+        }
     }
 
-    auto data = HttpClient->GetBinary(url);
-    auto firmware = ParseWBFW(data);
-
-    {
-        std::lock_guard<std::mutex> lock(CacheMutex);
-        TWBFWCacheEntry wbfwEntry;
-        wbfwEntry.ExpiresAt = now + WBFW_CACHE_TTL;
-        wbfwEntry.Firmware = firmware;
-        WBFWCache[url] = wbfwEntry;
+    if (pendingDownload.valid()) {
+        return pendingDownload.get();
     }
 
-    return firmware;
+    try {
+        auto firmware = LoadWBFW(url);
+        {
+            std::lock_guard<std::mutex> lock(CacheMutex);
+            TWBFWCacheEntry wbfwEntry;
+            wbfwEntry.ExpiresAt = std::chrono::steady_clock::now() + WBFW_CACHE_TTL;
+            wbfwEntry.Firmware = firmware;
+            WBFWCache[url] = wbfwEntry;
+            WBFWDownloads.erase(url);
+        }
+        download.set_value(firmware);
+        return firmware;
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(CacheMutex);
+            WBFWDownloads.erase(url);
+        }
+        download.set_exception(std::current_exception());
+        throw;
+    }
 }
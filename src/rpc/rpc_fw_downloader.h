@@ -1,18 +1,24 @@
 #pragma once
 
 #include <chrono>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
+#include "rpc_fw_file_cache.h"
+
 class IHttpClient
 {
 public:
     virtual ~IHttpClient() = default;
     virtual std::string GetText(const std::string& url) = 0;
     virtual std::vector<uint8_t> GetBinary(const std::string& url) = 0;
+
+    //! Passes the response body to the callback by chunks as they are received
+    virtual void GetBinaryStream(const std::string& url, const TFwDataCallback& onData);
 };
 
 typedef std::shared_ptr<IHttpClient> PHttpClient;
@@ -23,6 +29,7 @@ class TCurlHttpClient: public IHttpClient
 public:
     std::vector<uint8_t> GetBinary(const std::string& url) override;
     std::string GetText(const std::string& url) override;
+    void GetBinaryStream(const std::string& url, const TFwDataCallback& onData) override;
 };
 #endif
 
@@ -38,6 +45,18 @@ struct TParsedWBFW
     std::vector<uint8_t> Data;
 };
 
+//! Parses WBFW file by chunks while it is downloaded
+class TWBFWParser
+{
+public:
+    void Add(const uint8_t* data, size_t size);
+    TParsedWBFW Finish();
+
+private:
+    TParsedWBFW Firmware;
+    size_t Size = 0;
+};
+
 TParsedWBFW ParseWBFW(const std::vector<uint8_t>& data);
 std::string ParseFwVersionFromUrl(const std::string& url);
 std::map<std::string, std::map<std::string, std::string>> ParseReleaseVersionsYaml(const std::string& text);
@@ -46,7 +65,10 @@ std::string ReadReleaseSuite(const std::string& releasePath = "/usr/lib/wb-relea
 class TFwDownloader
 {
 public:
-    TFwDownloader(PHttpClient httpClient);
+    /**
+     * @param cacheDir directory of on-disk cache of firmwares and release indexes, empty to disable the cache
+     */
+    TFwDownloader(PHttpClient httpClient, const std::string& cacheDir = std::string());
 
     TReleasedBinary GetReleasedFirmware(const std::string& fwSignature, const std::string& releaseSuite);
     TReleasedBinary GetReleasedBootloader(const std::string& fwSignature, const std::string& releaseSuite);
@@ -54,6 +76,7 @@ public:
 
 private:
     PHttpClient HttpClient;
+    std::unique_ptr<TFwFileCache> FileCache;
 
     struct TCacheEntry
     {
@@ -74,6 +97,7 @@ private:
     TReleaseCacheEntry ReleaseCache;
     TReleaseCacheEntry BootloaderReleaseCache;
     std::map<std::string, TWBFWCacheEntry> WBFWCache;
+    std::map<std::string, std::shared_future<TParsedWBFW>> WBFWDownloads;
 
     static const std::string FW_RELEASES_BASE_URL;
     static const std::chrono::minutes RELEASE_CACHE_TTL;
@@ -88,4 +112,7 @@ private:
                                       std::chrono::minutes ttl,
                                       const std::string& fwSignature,
                                       const std::string& releaseSuite);
+
+    std::string GetIndexText(const std::string& url);
+    TParsedWBFW LoadWBFW(const std::string& url);
 };
@@ -0,0 +1,154 @@
+#include "rpc_fw_file_cache.h"
+#include "log.h"
+
+#include <atomic>
+#include <unistd.h>
+#include <vector>
+
+#define LOG(logger) ::logger.Log() << "[fw-update] "
+
+namespace
+{
+    const size_t READ_CHUNK_SIZE = 4096;
+
+    std::filesystem::path GetContentPath(const std::filesystem::path& dir, const std::string& hash)
+    {
+        return dir / "data" / hash;
+    }
+
+    std::filesystem::path GetUrlPath(const std::filesystem::path& dir, const std::string& url)
+    {
+        return dir / "urls" / SHA256::HexDigest(reinterpret_cast<const uint8_t*>(url.data()), url.size());
+    }
+
+    // Writes the file at once, so readers see the old file or the new one
+    void WriteFileAtomically(const std::filesystem::path& tmpPath,
+                             const std::filesystem::path& path,
+                             const std::string& content)
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file << content;
+        file.close();
+        std::error_code ec;
+        if (!file) {
+            std::filesystem::remove(tmpPath, ec);
+            throw std::runtime_error("can't write " + tmpPath.string());
+        }
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmpPath, ec);
+            throw std::runtime_error("can't write " + path.string());
+        }
+    }
+
+    std::filesystem::path MakeTmpPath(const std::filesystem::path& dir)
+    {
+        static std::atomic<unsigned> counter = 0;
+        return dir / (".tmp." + std::to_string(getpid()) + "." + std::to_string(counter++));
+    }
+}
+
+TFwFileCache::TFwFileCache(const std::string& dir): Dir(dir)
+{}
+
+bool TFwFileCache::Read(const std::string& url, const TFwDataCallback& onData) const
+{
+    auto urlPath = GetUrlPath(Dir, url);
+    std::string hash;
+    {
+        std::ifstream urlFile(urlPath);
+        if (!urlFile || !std::getline(urlFile, hash) || hash.empty()) {
+            return false;
+        }
+    }
+
+    auto contentPath = GetContentPath(Dir, hash);
+    std::ifstream file(contentPath, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    SHA256::THasher hasher;
+    std::vector<uint8_t> buf(READ_CHUNK_SIZE);
+    while (file) {
+        file.read(reinterpret_cast<char*>(buf.data()), buf.size());
+        if (file.gcount() > 0) {
+            hasher.Update(buf.data(), file.gcount());
+            onData(buf.data(), file.gcount());
+        }
+    }
+    if (file.bad() || hasher.HexDigest() != hash) {
+        LOG(Warn) << "Cached " << url << " is corrupted, removing it";
+        std::error_code ec;
+        std::filesystem::remove(contentPath, ec);
+        std::filesystem::remove(urlPath, ec);
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<TFwFileCache::TWriter> TFwFileCache::StartWrite(const std::string& url) const
+{
+    return std::make_unique<TWriter>(Dir, url);
+}
+
+TFwFileCache::TWriter::TWriter(const std::filesystem::path& dir, const std::string& url): Dir(dir), Url(url)
+{
+    try {
+        std::filesystem::create_directories(Dir / "data");
+        std::filesystem::create_directories(Dir / "urls");
+        TmpPath = MakeTmpPath(Dir / "data");
+        File.open(TmpPath, std::ios::binary | std::ios::trunc);
+        if (!File) {
+            Fail("can't create " + TmpPath.string());
+        }
+    } catch (const std::exception& e) {
+        Fail(e.what());
+    }
+}
+
+TFwFileCache::TWriter::~TWriter()
+{
+    if (!TmpPath.empty()) {
+        File.close();
+        std::error_code ec;
+        std::filesystem::remove(TmpPath, ec);
+    }
+}
+
+void TFwFileCache::TWriter::Write(const uint8_t* data, size_t size)
+{
+    if (Failed) {
+        return;
+    }
+    Hasher.Update(data, size);
+    File.write(reinterpret_cast<const char*>(data), size);
+    if (!File) {
+        Fail("can't write " + TmpPath.string());
+    }
+}
+
+void TFwFileCache::TWriter::Commit()
+{
+    if (Failed) {
+        return;
+    }
+    try {
+        File.close();
+        if (!File) {
+            throw std::runtime_error("can't write " + TmpPath.string());
+        }
+        auto hash = Hasher.HexDigest();
+        // Equal contents of different URLs are stored once
+        std::filesystem::rename(TmpPath, GetContentPath(Dir, hash));
+        TmpPath.clear();
+        WriteFileAtomically(MakeTmpPath(Dir / "urls"), GetUrlPath(Dir, Url), hash);
+    } catch (const std::exception& e) {
+        Fail(e.what());
+    }
+}
+
+void TFwFileCache::TWriter::Fail(const std::string& error)
+{
+    LOG(Warn) << "Can't cache " << Url << ": " << error;
+    Failed = true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "sha256.h"
+
+using TFwDataCallback = std::function<void(const uint8_t* data, size_t size)>;
+
+/**
+ * @brief On-disk cache of downloaded firmware files and release indexes.
+ *        A content is stored in a file named by SHA-256 of the content,
+ *        a URL is linked to the content by a file named by SHA-256 of the URL.
+ *        Files are written to temporary files and renamed, so an interrupted write leaves no partial entries.
+ *        Errors of the cache are logged and don't break downloading.
+ */
+class TFwFileCache
+{
+public:
+    explicit TFwFileCache(const std::string& dir);
+
+    /**
+     * @brief Reads cached content of the URL by chunks.
+     *        A content not matching its hash is removed from the cache,
+     *        the data passed to the callback before the check must be dropped in the case.
+     *
+     * @return false if the URL is not cached or the content is corrupted
+     */
+    bool Read(const std::string& url, const TFwDataCallback& onData) const;
+
+    class TWriter
+    {
+    public:
+        TWriter(const std::filesystem::path& dir, const std::string& url);
+        ~TWriter();
+
+        void Write(const uint8_t* data, size_t size);
+
+        //! Stores the written content and links the URL to it
+        void Commit();
+
+    private:
+        void Fail(const std::string& error);
+
+        std::filesystem::path Dir;
+        std::string Url;
+        std::filesystem::path TmpPath;
+        std::ofstream File;
+        SHA256::THasher Hasher;
+        bool Failed = false;
+    };
+
+    //! Starts writing of the URL content, the content is stored after TWriter::Commit only
+    std::unique_ptr<TWriter> StartWrite(const std::string& url) const;
+
+private:
+    std::filesystem::path Dir;
+};
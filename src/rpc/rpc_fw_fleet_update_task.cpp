@@ -0,0 +1,103 @@
+#include "rpc_fw_fleet_update_task.h"
+#include "log.h"
+#include "rpc_fw_update_serial_client_task.h"
+
+#define LOG(logger) ::logger.Log() << "[fw-update] "
+
+TFwFleetUpdateJob::TFwFleetUpdateJob(size_t portsCount, PFwUpdateLock updateLock)
+    : PortsLeft(portsCount),
+      UpdateLock(std::move(updateLock))
+{}
+
+void TFwFleetUpdateJob::OnPortFinished()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (PortsLeft == 0 || --PortsLeft != 0) {
+        return;
+    }
+    LOG(Info) << "Fleet firmware update is finished";
+    std::lock_guard<std::mutex> updateLock(UpdateLock->Mutex);
+    UpdateLock->InProgress = false;
+}
+
+TFwFleetPortTask::TFwFleetPortTask(std::vector<TFwFleetDevice> devices,
+                                   const std::string& releaseSuite,
+                                   std::shared_ptr<TFwDownloader> downloader,
+                                   PFwUpdateState state,
+                                   PFwFleetUpdateJob job)
+    : Devices(std::move(devices)),
+      ReleaseSuite(releaseSuite),
+      Downloader(std::move(downloader)),
+      State(std::move(state)),
+      Job(std::move(job))
+{}
+
+TFwFleetPortTask::~TFwFleetPortTask()
+{
+    // The port is closed or reconfigured while updating
+    if (!Finished) {
+        Cancel("Firmware update is interrupted");
+    }
+}
+
+void TFwFleetPortTask::Cancel(const std::string& error)
+{
+    for (; NextDevice < Devices.size(); ++NextDevice) {
+        SetDeviceError(Devices[NextDevice], error);
+        State->FinishJobDevice(Devices[NextDevice].SlaveId, Devices[NextDevice].PortPath);
+    }
+    Finish();
+}
+
+TSerialClientSession TFwFleetPortTask::RunSession(PFeaturePort port,
+                                                 TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                                 const std::list<PSerialDevice>& polledDevices)
+{
+    for (; NextDevice < Devices.size(); ++NextDevice) {
+        const auto& device = Devices[NextDevice];
+        // The job holds the update lock, devices of the job don't lock each other
+        auto task = std::make_shared<TFwUpdateSerialClientTask>(
+            device.SlaveId,
+            device.Protocol,
+            device.SoftwareType,
+            device.PortPath,
+            ReleaseSuite,
+            device.PortSettings,
+            Downloader,
+            State,
+            std::make_shared<TFwUpdateLock>(),
+            nullptr,
+            [this, &device](int code, const std::string& error) { SetDeviceError(device, error); },
+            device.Slicing);
+        while (task->Run(port, lastAccessedDevice, polledDevices) == ISerialClientTask::TRunResult::SUSPENDED) {
+            co_await YieldBus(task->GetResumeTime());
+        }
+        State->FinishJobDevice(device.SlaveId, device.PortPath);
+    }
+    Finish();
+}
+
+// Errors before flashing are not in the state yet, so the device is added with the error
+void TFwFleetPortTask::SetDeviceError(const TFwFleetDevice& device, const std::string& error)
+{
+    LOG(Error) << "Firmware update of slave " << static_cast<int>(device.SlaveId) << " on " << device.PortPath
+               << " failed: " << error;
+    TDeviceUpdateInfo info;
+    info.PortPath = device.PortPath;
+    info.Protocol = device.Protocol;
+    info.SlaveId = device.SlaveId;
+    info.Type = device.SoftwareType;
+    Json::Value metadata;
+    metadata["exception"] = error;
+    info.Error = std::make_unique<TStateError>(
+        TStateError{"com.wb.serial_driver.generic_error", "Internal error. Check logs for more info", metadata});
+    State->Update(info);
+}
+
+void TFwFleetPortTask::Finish()
+{
+    if (!Finished) {
+        Finished = true;
+        Job->OnPortFinished();
+    }
+}
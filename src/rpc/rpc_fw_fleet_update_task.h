@@ -0,0 +1,68 @@
+#pragma once
+
+#include "port/serial_port_settings.h"
+#include "rpc_fw_downloader.h"
+#include "rpc_fw_update_state.h"
+#include "rpc_fw_update_task.h"
+
+struct TFwFleetDevice
+{
+    uint8_t SlaveId = 0;
+    std::string Protocol;
+    std::string SoftwareType;
+    std::string PortPath;
+    TSerialPortConnectionSettings PortSettings;
+    TFwFlashSlicing Slicing;
+};
+
+/**
+ * @brief Update of several devices on several ports.
+ *        Ports are updated in parallel by TFwFleetPortTask, one device of a port at a time.
+ *        The job holds the update lock till all ports are finished.
+ */
+class TFwFleetUpdateJob
+{
+public:
+    TFwFleetUpdateJob(size_t portsCount, PFwUpdateLock updateLock);
+
+    void OnPortFinished();
+
+private:
+    std::mutex Mutex;
+    size_t PortsLeft;
+    PFwUpdateLock UpdateLock;
+};
+
+using PFwFleetUpdateJob = std::shared_ptr<TFwFleetUpdateJob>;
+
+class TFwFleetPortTask: public TSerialClientSessionTask
+{
+public:
+    TFwFleetPortTask(std::vector<TFwFleetDevice> devices,
+                     const std::string& releaseSuite,
+                     std::shared_ptr<TFwDownloader> downloader,
+                     PFwUpdateState state,
+                     PFwFleetUpdateJob job);
+
+    ~TFwFleetPortTask();
+
+    //! Marks not updated devices as failed, e.g. if the task can't be started on the port
+    void Cancel(const std::string& error);
+
+protected:
+    TSerialClientSession RunSession(PFeaturePort port,
+                                    TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                    const std::list<PSerialDevice>& polledDevices) override;
+
+private:
+    void SetDeviceError(const TFwFleetDevice& device, const std::string& error);
+    void Finish();
+
+    std::vector<TFwFleetDevice> Devices;
+    std::string ReleaseSuite;
+    std::shared_ptr<TFwDownloader> Downloader;
+    PFwUpdateState State;
+    PFwFleetUpdateJob Job;
+    size_t NextDevice = 0;
+    bool Finished = false;
+};
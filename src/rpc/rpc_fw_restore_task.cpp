@@ -16,7 +16,8 @@ TFwRestoreTask::TFwRestoreTask(uint8_t slaveId,
                                PFwUpdateState state,
                                PFwUpdateLock updateLock,
                                WBMQTT::TMqttRpcServer::TResultCallback onResult,
-                               WBMQTT::TMqttRpcServer::TErrorCallback onError)
+                               WBMQTT::TMqttRpcServer::TErrorCallback onError,
+                               TFwFlashSlicing slicing)
     : SlaveId(slaveId),
       Protocol(protocol),
       PortPath(portPath),
@@ -26,27 +27,46 @@ TFwRestoreTask::TFwRestoreTask(uint8_t slaveId,
       State(std::move(state)),
       UpdateLock(std::move(updateLock)),
       OnResult(std::move(onResult)),
-      OnError(std::move(onError))
+      OnError(std::move(onError)),
+      Slicing(slicing)
 {}
 
+TFwRestoreTask::~TFwRestoreTask()
+{
+    // The port is closed or reconfigured while flashing
+    if (IsSessionSuspended()) {
+        LOG(Error) << "Firmware update of slave " << static_cast<int>(SlaveId) << " is interrupted";
+        Json::Value metadata;
+        metadata["exception"] = "Firmware update is interrupted";
+        State->SetError(SlaveId,
+                        PortPath,
+                        "firmware",
+                        "com.wb.serial_driver.generic_error",
+                        "Internal error. Check logs for more info",
+                        metadata);
+        std::lock_guard<std::mutex> lock(UpdateLock->Mutex);
+        UpdateLock->InProgress = false;
+    }
+}
+
 // Cf. firmware_update.py:871 FirmwareUpdater.restore_firmware() and firmware_update.py:1015 _restore_firmware()
-ISerialClientTask::TRunResult TFwRestoreTask::Run(PFeaturePort port,
-                                                  TSerialClientDeviceAccessHandler& lastAccessedDevice,
-                                                  const std::list<PSerialDevice>& polledDevices)
+TSerialClientSession TFwRestoreTask::RunSession(PFeaturePort port,
+                                               TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                               const std::list<PSerialDevice>& polledDevices)
 {
     try {
         if (!port->IsOpen()) {
             port->Open();
         }
         lastAccessedDevice.PrepareToAccess(*port, nullptr);
-        TSerialPortSettingsGuard settingsGuard(port, PortSettings);
-        port->SkipNoise();
 
         auto traits = MakeModbusTraits(Protocol);
 
         // Try to read device info. If device is not in bootloader mode, it will fail.
         TFwDeviceInfo info;
         try {
+            TSerialPortSettingsGuard settingsGuard(port, PortSettings);
+            port->SkipNoise();
             info = ReadFwDeviceInfo(*traits, *port, SlaveId);
         } catch (const std::exception&) {
             // Device not responding — return "Ok" silently (current behavior)
@@ -59,7 +79,7 @@ ISerialClientTask::TRunResult TFwRestoreTask::Run(PFeaturePort port,
                 result = "Ok";
                 OnResult(result);
             }
-            return ISerialClientTask::TRunResult::OK;
+            co_return;
         }
 
         // Device responded — proceed with firmware restore
@@ -87,12 +107,21 @@ ISerialClientTask::TRunResult TFwRestoreTask::Run(PFeaturePort port,
             auto firmware = Downloader->DownloadAndParseWBFW(released.Endpoint);
 
             TUpdateNotifier notifier(30);
-            FlashFirmware(*traits, *port, SlaveId, firmware, false, false, [&](int percent) {
-                if (notifier.ShouldNotify(percent)) {
-                    updateInfo.Progress = percent;
-                    State->Update(updateInfo);
-                }
-            });
+            co_await FlashFirmwareBySlots(*traits,
+                                          port,
+                                          lastAccessedDevice,
+                                          PortSettings,
+                                          SlaveId,
+                                          firmware,
+                                          false,
+                                          false,
+                                          [&](int percent) {
+                                              if (notifier.ShouldNotify(percent)) {
+                                                  updateInfo.Progress = percent;
+                                                  State->Update(updateInfo);
+                                              }
+                                          },
+                                          Slicing);
 
             State->Remove(SlaveId, PortPath, "firmware");
         } catch (const std::exception& e) {
@@ -124,5 +153,4 @@ ISerialClientTask::TRunResult TFwRestoreTask::Run(PFeaturePort port,
             OnError(WBMQTT::E_RPC_SERVER_ERROR, std::string("Error starting firmware restore: ") + e.what());
         }
     }
-    return ISerialClientTask::TRunResult::OK;
 }
@@ -11,7 +11,7 @@
 #include "rpc_fw_update_state.h"
 #include "rpc_fw_update_task.h"
 
-class TFwRestoreTask: public ISerialClientTask
+class TFwRestoreTask: public TSerialClientSessionTask
 {
 public:
     TFwRestoreTask(uint8_t slaveId,
@@ -23,11 +23,15 @@ public:
                    PFwUpdateState state,
                    PFwUpdateLock updateLock,
                    WBMQTT::TMqttRpcServer::TResultCallback onResult,
-                   WBMQTT::TMqttRpcServer::TErrorCallback onError);
+                   WBMQTT::TMqttRpcServer::TErrorCallback onError,
+                   TFwFlashSlicing slicing = TFwFlashSlicing());
 
-    ISerialClientTask::TRunResult Run(PFeaturePort port,
-                                      TSerialClientDeviceAccessHandler& lastAccessedDevice,
-                                      const std::list<PSerialDevice>& polledDevices) override;
+    ~TFwRestoreTask();
+
+protected:
+    TSerialClientSession RunSession(PFeaturePort port,
+                                    TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                    const std::list<PSerialDevice>& polledDevices) override;
 
 private:
     uint8_t SlaveId;
@@ -40,4 +44,5 @@ private:
     PFwUpdateLock UpdateLock;
     WBMQTT::TMqttRpcServer::TResultCallback OnResult;
     WBMQTT::TMqttRpcServer::TErrorCallback OnError;
+    TFwFlashSlicing Slicing;
 };
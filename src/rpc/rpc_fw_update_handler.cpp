@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #ifndef __EMSCRIPTEN__
+#include "rpc_fw_fleet_update_task.h"
 #include "rpc_fw_get_firmware_info_task.h"
 #include "rpc_fw_restore_task.h"
 #include "rpc_fw_update_handler.h"
@@ -61,6 +62,24 @@ bool ComponentFirmwareIsNewer(const std::string& currentVersion, const std::stri
     return !availableVersion.empty() && currentVersion != availableVersion;
 }
 
+// Polling of a device flashed in slots fails and interferes with the bootloader, so it is suspended
+void TRPCFwUpdateHandler::SetPollSuspension(TRequestParams& params)
+{
+    if (params.Slicing.BlocksPerSlot == 0) {
+        return;
+    }
+    auto clientParams = SerialClientTaskRunner.GetSerialClientParams(MakePortRequestJson(params));
+    if (!clientParams.SerialClient || !clientParams.Device) {
+        return;
+    }
+    params.Slicing.SuspendPoll = [client = clientParams.SerialClient, device = clientParams.Device]() {
+        client->SuspendPoll(device, std::chrono::steady_clock::now());
+    };
+    params.Slicing.ResumePoll = [client = clientParams.SerialClient, device = clientParams.Device]() {
+        client->ResumePoll(device);
+    };
+}
+
 // Cf. firmware_update.py:682 FirmwareUpdater.get_firmware_info() - response building part
 Json::Value BuildFirmwareInfoResponse(const TFwDeviceInfo& deviceInfo,
                                       TFwDownloader& downloader,
@@ -128,6 +147,7 @@ Json::Value BuildFirmwareInfoResponse(const TFwDeviceInfo& deviceInfo,
 TRPCFwUpdateHandler::TRPCFwUpdateHandler(ITaskRunner& serialClientTaskRunner,
                                          WBMQTT::PMqttRpcServer rpcServer,
                                          WBMQTT::PMqttClient mqtt,
+                                         const std::string& fwCacheDir,
                                          PHttpClient httpClient)
     : SerialClientTaskRunner(serialClientTaskRunner),
       Mqtt(mqtt)
@@ -146,7 +166,7 @@ TRPCFwUpdateHandler::TRPCFwUpdateHandler(ITaskRunner& serialClientTaskRunner,
     // Create frontend-based HTTP client here
 #endif
 
-    Downloader = std::make_shared<TFwDownloader>(httpClient);
+    Downloader = std::make_shared<TFwDownloader>(httpClient, fwCacheDir);
 
     State = std::make_shared<TFwUpdateState>(
         [this](const std::string& topic, const std::string& payload, bool retain) {
@@ -201,6 +221,13 @@ void TRPCFwUpdateHandler::RegisterRpcMethods(WBMQTT::PMqttRpcServer rpcServer)
                                              std::placeholders::_1,
                                              std::placeholders::_2,
                                              std::placeholders::_3));
+    rpcServer->RegisterAsyncMethod("fw-update",
+                                   "UpdateFleet",
+                                   std::bind(&TRPCFwUpdateHandler::UpdateFleet,
+                                             this,
+                                             std::placeholders::_1,
+                                             std::placeholders::_2,
+                                             std::placeholders::_3));
 }
 
 // Cf. serial_device.py:135 create_device_from_json()
@@ -224,6 +251,20 @@ TRPCFwUpdateHandler::TRequestParams TRPCFwUpdateHandler::ParseRequestParams(cons
     params.Protocol = request.get("protocol", "modbus").asString();
     params.PortSettings = ParseRPCSerialPortSettings(request["port"]);
 
+    // Flashing in slots interleaved with polling of other devices on the port
+    if (request.isMember("blocks_per_slot")) {
+        if (!request["blocks_per_slot"].isUInt()) {
+            throw std::runtime_error("blocks_per_slot must be a non-negative integer");
+        }
+        params.Slicing.BlocksPerSlot = request["blocks_per_slot"].asUInt();
+    }
+    if (request.isMember("bus_share")) {
+        if (!request["bus_share"].isInt() || request["bus_share"].asInt() < 1 || request["bus_share"].asInt() > 100) {
+            throw std::runtime_error("bus_share must be in range 1-100");
+        }
+        params.Slicing.BusShare = request["bus_share"].asInt();
+    }
+
     return params;
 }
 
@@ -278,6 +319,7 @@ void TRPCFwUpdateHandler::Update(const Json::Value& request,
         }
 
         auto params = ParseRequestParams(request);
+        SetPollSuspension(params);
         auto softwareType = request.get("type", "firmware").asString();
 
         auto task = std::make_shared<TFwUpdateSerialClientTask>(static_cast<uint8_t>(params.SlaveId),
@@ -290,7 +332,8 @@ void TRPCFwUpdateHandler::Update(const Json::Value& request,
                                                                 State,
                                                                 UpdateLock,
                                                                 std::move(onResult),
-                                                                std::move(onError));
+                                                                std::move(onError),
+                                                                params.Slicing);
         SerialClientTaskRunner.RunTask(MakePortRequestJson(params), task);
     } catch (const std::exception& e) {
         {
@@ -326,6 +369,7 @@ void TRPCFwUpdateHandler::Restore(const Json::Value& request,
         }
 
         auto params = ParseRequestParams(request);
+        SetPollSuspension(params);
 
         auto task = std::make_shared<TFwRestoreTask>(static_cast<uint8_t>(params.SlaveId),
                                                      params.Protocol,
@@ -336,7 +380,8 @@ void TRPCFwUpdateHandler::Restore(const Json::Value& request,
                                                      State,
                                                      UpdateLock,
                                                      std::move(onResult),
-                                                     std::move(onError));
+                                                     std::move(onError),
+                                                     params.Slicing);
         SerialClientTaskRunner.RunTask(MakePortRequestJson(params), task);
     } catch (const std::exception& e) {
         {
@@ -346,4 +391,72 @@ void TRPCFwUpdateHandler::Restore(const Json::Value& request,
         onError(WBMQTT::E_RPC_SERVER_ERROR, e.what());
     }
 }
+
+// Devices of different ports are updated in parallel, devices of a port one by one in order of the request
+void TRPCFwUpdateHandler::UpdateFleet(const Json::Value& request,
+                                      WBMQTT::TMqttRpcServer::TResultCallback onResult,
+                                      WBMQTT::TMqttRpcServer::TErrorCallback onError)
+{
+    try {
+        {
+            std::lock_guard<std::mutex> lock(UpdateLock->Mutex);
+            if (UpdateLock->InProgress) {
+                onError(WBMQTT::E_RPC_SERVER_ERROR, "Task is already executing.");
+                return;
+            }
+            UpdateLock->InProgress = true;
+        }
+
+        if (!request.isMember("devices") || !request["devices"].isArray() || request["devices"].empty()) {
+            throw std::runtime_error("devices is required and must be a non-empty array");
+        }
+
+        std::vector<std::pair<TRequestParams, std::vector<TFwFleetDevice>>> ports;
+        std::vector<TFwJobDevice> jobDevices;
+        for (const auto& deviceRequest: request["devices"]) {
+            auto params = ParseRequestParams(deviceRequest);
+            SetPollSuspension(params);
+            auto port = std::find_if(ports.begin(), ports.end(), [&params](const auto& p) {
+                return p.first.PortPath == params.PortPath;
+            });
+            if (port == ports.end()) {
+                port = ports.emplace(ports.end(), params, std::vector<TFwFleetDevice>());
+            }
+            port->second.push_back(TFwFleetDevice{static_cast<uint8_t>(params.SlaveId),
+                                                  params.Protocol,
+                                                  deviceRequest.get("type", "firmware").asString(),
+                                                  params.PortPath,
+                                                  params.PortSettings,
+                                                  params.Slicing});
+            jobDevices.push_back(TFwJobDevice{params.SlaveId, params.PortPath});
+        }
+
+        State->StartJob(jobDevices);
+        auto job = std::make_shared<TFwFleetUpdateJob>(ports.size(), UpdateLock);
+        std::vector<std::shared_ptr<TFwFleetPortTask>> tasks;
+        for (auto& port: ports) {
+            tasks.push_back(
+                std::make_shared<TFwFleetPortTask>(std::move(port.second), ReleaseSuite, Downloader, State, job));
+        }
+
+        // Progress and errors are reported via the state topic
+        Json::Value result;
+        result = "Ok";
+        onResult(result);
+
+        for (size_t i = 0; i < ports.size(); ++i) {
+            try {
+                SerialClientTaskRunner.RunTask(MakePortRequestJson(ports[i].first), tasks[i]);
+            } catch (const std::exception& e) {
+                tasks[i]->Cancel(e.what());
+            }
+        }
+    } catch (const std::exception& e) {
+        {
+            std::lock_guard<std::mutex> lock(UpdateLock->Mutex);
+            UpdateLock->InProgress = false;
+        }
+        onError(WBMQTT::E_RPC_SERVER_ERROR, e.what());
+    }
+}
 #endif
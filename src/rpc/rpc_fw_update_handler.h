@@ -18,6 +18,7 @@ public:
     TRPCFwUpdateHandler(ITaskRunner& serialClientTaskRunner,
                         WBMQTT::PMqttRpcServer rpcServer,
                         WBMQTT::PMqttClient mqtt,
+                        const std::string& fwCacheDir = std::string(),
                         PHttpClient httpClient = nullptr);
 
     struct TRequestParams
@@ -26,6 +27,7 @@ public:
         std::string PortPath;
         std::string Protocol;
         TSerialPortConnectionSettings PortSettings;
+        TFwFlashSlicing Slicing;
     };
 
     static TRequestParams ParseRequestParams(const Json::Value& request);
@@ -51,7 +53,12 @@ private:
                  WBMQTT::TMqttRpcServer::TResultCallback onResult,
                  WBMQTT::TMqttRpcServer::TErrorCallback onError);
 
+    void UpdateFleet(const Json::Value& request,
+                     WBMQTT::TMqttRpcServer::TResultCallback onResult,
+                     WBMQTT::TMqttRpcServer::TErrorCallback onError);
+
     static Json::Value MakePortRequestJson(const TRequestParams& params);
+    void SetPollSuspension(TRequestParams& params);
 
     ITaskRunner& SerialClientTaskRunner;
     WBMQTT::PMqttClient Mqtt;
@@ -17,7 +17,8 @@ TFwUpdateSerialClientTask::TFwUpdateSerialClientTask(uint8_t slaveId,
                                                      PFwUpdateState state,
                                                      PFwUpdateLock updateLock,
                                                      WBMQTT::TMqttRpcServer::TResultCallback onResult,
-                                                     WBMQTT::TMqttRpcServer::TErrorCallback onError)
+                                                     WBMQTT::TMqttRpcServer::TErrorCallback onError,
+                                                     TFwFlashSlicing slicing)
     : SlaveId(slaveId),
       Protocol(protocol),
       SoftwareType(softwareType),
@@ -28,23 +29,44 @@ TFwUpdateSerialClientTask::TFwUpdateSerialClientTask(uint8_t slaveId,
       State(std::move(state)),
       UpdateLock(std::move(updateLock)),
       OnResult(std::move(onResult)),
-      OnError(std::move(onError))
+      OnError(std::move(onError)),
+      Slicing(slicing)
 {}
 
-ISerialClientTask::TRunResult TFwUpdateSerialClientTask::Run(PFeaturePort port,
-                                                             TSerialClientDeviceAccessHandler& lastAccessedDevice,
-                                                             const std::list<PSerialDevice>& polledDevices)
+TFwUpdateSerialClientTask::~TFwUpdateSerialClientTask()
 {
-    try {
-        if (!port->IsOpen()) {
-            port->Open();
-        }
-        lastAccessedDevice.PrepareToAccess(*port, nullptr);
-        TSerialPortSettingsGuard settingsGuard(port, PortSettings);
-        port->SkipNoise();
+    // The port is closed or reconfigured while flashing
+    if (IsSessionSuspended()) {
+        LOG(Error) << "Firmware update of slave " << static_cast<int>(SlaveId) << " is interrupted";
+        Json::Value metadata;
+        metadata["exception"] = "Firmware update is interrupted";
+        State->SetError(SlaveId,
+                        PortPath,
+                        SoftwareType,
+                        "com.wb.serial_driver.generic_error",
+                        "Internal error. Check logs for more info",
+                        metadata);
+        std::lock_guard<std::mutex> lock(UpdateLock->Mutex);
+        UpdateLock->InProgress = false;
+    }
+}
 
+TSerialClientSession TFwUpdateSerialClientTask::RunSession(PFeaturePort port,
+                                                          TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                                          const std::list<PSerialDevice>& polledDevices)
+{
+    try {
         auto traits = MakeModbusTraits(Protocol);
-        auto info = ReadFwDeviceInfo(*traits, *port, SlaveId);
+        TFwDeviceInfo info;
+        {
+            if (!port->IsOpen()) {
+                port->Open();
+            }
+            lastAccessedDevice.PrepareToAccess(*port, nullptr);
+            TSerialPortSettingsGuard settingsGuard(port, PortSettings);
+            port->SkipNoise();
+            info = ReadFwDeviceInfo(*traits, *port, SlaveId);
+        }
 
         // Send RPC response early — flash proceeds asynchronously from client's perspective
         if (OnResult) {
@@ -55,11 +77,11 @@ ISerialClientTask::TRunResult TFwUpdateSerialClientTask::Run(PFeaturePort port,
 
         try {
             if (SoftwareType == "firmware") {
-                DoFirmwareUpdate(*port, *traits, info);
+                co_await DoFirmwareUpdate(port, lastAccessedDevice, *traits, info);
             } else if (SoftwareType == "bootloader") {
-                DoBootloaderUpdate(*port, *traits, info);
+                co_await DoBootloaderUpdate(port, lastAccessedDevice, *traits, info);
             } else if (SoftwareType == "component") {
-                DoComponentsUpdate(*port, *traits, info);
+                co_await DoComponentsUpdate(port, lastAccessedDevice, *traits, info);
             } else {
                 throw std::runtime_error("Unknown software type: " + SoftwareType);
             }
@@ -92,77 +114,85 @@ ISerialClientTask::TRunResult TFwUpdateSerialClientTask::Run(PFeaturePort port,
             OnError(WBMQTT::E_RPC_SERVER_ERROR, std::string("Error starting firmware update: ") + e.what());
         }
     }
-    return ISerialClientTask::TRunResult::OK;
 }
 
 // Cf. firmware_update.py:785 FirmwareUpdater.update_software() — firmware branch
-void TFwUpdateSerialClientTask::DoFirmwareUpdate(TPort& port, Modbus::IModbusTraits& traits, const TFwDeviceInfo& info)
+TSerialClientSession TFwUpdateSerialClientTask::DoFirmwareUpdate(PFeaturePort port,
+                                                                TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                                                Modbus::IModbusTraits& traits,
+                                                                const TFwDeviceInfo& info)
 {
     auto released = Downloader->GetReleasedFirmware(info.FwSignature, ReleaseSuite);
-    DoFlash(port,
-            traits,
-            "firmware",
-            info.FwVersion,
-            released.Version,
-            released.Endpoint,
-            true,
-            info.CanPreservePortSettings);
+    co_await DoFlash(port,
+                     lastAccessedDevice,
+                     traits,
+                     "firmware",
+                     info.FwVersion,
+                     released.Version,
+                     released.Endpoint,
+                     true,
+                     info.CanPreservePortSettings);
 
     // Also update components after firmware
-    DoComponentsUpdate(port, traits, info);
+    co_await DoComponentsUpdate(port, lastAccessedDevice, traits, info);
 }
 
 // Cf. firmware_update.py:939 _update_bootloader()
-void TFwUpdateSerialClientTask::DoBootloaderUpdate(TPort& port,
-                                                   Modbus::IModbusTraits& traits,
-                                                   const TFwDeviceInfo& info)
+TSerialClientSession TFwUpdateSerialClientTask::DoBootloaderUpdate(PFeaturePort port,
+                                                                  TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                                                  Modbus::IModbusTraits& traits,
+                                                                  const TFwDeviceInfo& info)
 {
     auto bootloader = Downloader->GetReleasedBootloader(info.FwSignature, ReleaseSuite);
-    DoFlash(port,
-            traits,
-            "bootloader",
-            info.BootloaderVersion,
-            bootloader.Version,
-            bootloader.Endpoint,
-            true,
-            info.CanPreservePortSettings);
+    co_await DoFlash(port,
+                     lastAccessedDevice,
+                     traits,
+                     "bootloader",
+                     info.BootloaderVersion,
+                     bootloader.Version,
+                     bootloader.Endpoint,
+                     true,
+                     info.CanPreservePortSettings);
 
     // Auto-restore firmware after bootloader update (device stays in bootloader mode).
     // Give the device time to settle after rebooting into the bootloader before starting the flash.
     // Cf. firmware_update.py:973
     LOG(Info) << "Auto-restoring firmware after bootloader update for slave " << static_cast<int>(SlaveId);
-    std::this_thread::sleep_for(std::chrono::seconds(2));
+    co_await WaitForFwDevice(std::chrono::seconds(2), Slicing);
 
     auto released = Downloader->GetReleasedFirmware(info.FwSignature, ReleaseSuite);
-    DoFlash(port,
-            traits,
-            "firmware",
-            "",
-            released.Version,
-            released.Endpoint,
-            false, // already in bootloader
-            false);
+    co_await DoFlash(port,
+                     lastAccessedDevice,
+                     traits,
+                     "firmware",
+                     "",
+                     released.Version,
+                     released.Endpoint,
+                     false, // already in bootloader
+                     false);
 }
 
 // Cf. firmware_update.py:538 update_components()
-void TFwUpdateSerialClientTask::DoComponentsUpdate(TPort& port,
-                                                   Modbus::IModbusTraits& traits,
-                                                   const TFwDeviceInfo& info)
+TSerialClientSession TFwUpdateSerialClientTask::DoComponentsUpdate(PFeaturePort port,
+                                                                  TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                                                  Modbus::IModbusTraits& traits,
+                                                                  const TFwDeviceInfo& info)
 {
     for (const auto& comp: info.Components) {
         try {
             auto released = Downloader->GetReleasedFirmware(comp.Signature, ReleaseSuite);
             if (ComponentFirmwareIsNewer(comp.FwVersion, released.Version)) {
-                DoFlash(port,
-                        traits,
-                        "component",
-                        comp.FwVersion,
-                        released.Version,
-                        released.Endpoint,
-                        false, // components don't reboot to bootloader
-                        false,
-                        comp.Number,
-                        comp.Model);
+                co_await DoFlash(port,
+                                 lastAccessedDevice,
+                                 traits,
+                                 "component",
+                                 comp.FwVersion,
+                                 released.Version,
+                                 released.Endpoint,
+                                 false, // components don't reboot to bootloader
+                                 false,
+                                 comp.Number,
+                                 comp.Model);
             }
         } catch (const std::exception& e) {
             LOG(Warn) << "Cannot update component " << comp.Number << ": " << e.what();
@@ -170,16 +200,17 @@ void TFwUpdateSerialClientTask::DoComponentsUpdate(TPort& port,
     }
 }
 
-void TFwUpdateSerialClientTask::DoFlash(TPort& port,
-                                        Modbus::IModbusTraits& traits,
-                                        const std::string& type,
-                                        const std::string& fromVersion,
-                                        const std::string& toVersion,
-                                        const std::string& fwUrl,
-                                        bool reboot,
-                                        bool canPreserve,
-                                        int componentNumber,
-                                        const std::string& componentModel)
+TSerialClientSession TFwUpdateSerialClientTask::DoFlash(PFeaturePort port,
+                                                       TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                                       Modbus::IModbusTraits& traits,
+                                                       std::string type,
+                                                       std::string fromVersion,
+                                                       std::string toVersion,
+                                                       std::string fwUrl,
+                                                       bool reboot,
+                                                       bool canPreserve,
+                                                       int componentNumber,
+                                                       std::string componentModel)
 {
     // Update state to show 0% progress
     TDeviceUpdateInfo updateInfo;
@@ -199,12 +230,21 @@ void TFwUpdateSerialClientTask::DoFlash(TPort& port,
 
     // Flash with throttled progress updates
     TUpdateNotifier notifier(30);
-    FlashFirmware(traits, port, SlaveId, firmware, reboot, canPreserve, [&](int percent) {
-        if (notifier.ShouldNotify(percent)) {
-            updateInfo.Progress = percent;
-            State->Update(updateInfo);
-        }
-    });
+    co_await FlashFirmwareBySlots(traits,
+                                  port,
+                                  lastAccessedDevice,
+                                  PortSettings,
+                                  SlaveId,
+                                  firmware,
+                                  reboot,
+                                  canPreserve,
+                                  [&](int percent) {
+                                      if (notifier.ShouldNotify(percent)) {
+                                          updateInfo.Progress = percent;
+                                          State->Update(updateInfo);
+                                      }
+                                  },
+                                  Slicing);
 
     // Success — remove from state
     State->Remove(SlaveId, PortPath, type);
@@ -7,7 +7,7 @@
 #include "rpc_fw_update_state.h"
 #include "rpc_fw_update_task.h"
 
-class TFwUpdateSerialClientTask: public ISerialClientTask
+class TFwUpdateSerialClientTask: public TSerialClientSessionTask
 {
 public:
     TFwUpdateSerialClientTask(uint8_t slaveId,
@@ -20,26 +20,40 @@ public:
                               PFwUpdateState state,
                               PFwUpdateLock updateLock,
                               WBMQTT::TMqttRpcServer::TResultCallback onResult,
-                              WBMQTT::TMqttRpcServer::TErrorCallback onError);
+                              WBMQTT::TMqttRpcServer::TErrorCallback onError,
+                              TFwFlashSlicing slicing = TFwFlashSlicing());
 
-    ISerialClientTask::TRunResult Run(PFeaturePort port,
-                                      TSerialClientDeviceAccessHandler& lastAccessedDevice,
-                                      const std::list<PSerialDevice>& polledDevices) override;
+    ~TFwUpdateSerialClientTask();
+
+protected:
+    TSerialClientSession RunSession(PFeaturePort port,
+                                    TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                    const std::list<PSerialDevice>& polledDevices) override;
 
 private:
-    void DoFirmwareUpdate(TPort& port, Modbus::IModbusTraits& traits, const TFwDeviceInfo& info);
-    void DoBootloaderUpdate(TPort& port, Modbus::IModbusTraits& traits, const TFwDeviceInfo& info);
-    void DoComponentsUpdate(TPort& port, Modbus::IModbusTraits& traits, const TFwDeviceInfo& info);
-    void DoFlash(TPort& port,
-                 Modbus::IModbusTraits& traits,
-                 const std::string& type,
-                 const std::string& fromVersion,
-                 const std::string& toVersion,
-                 const std::string& fwUrl,
-                 bool reboot,
-                 bool canPreserve,
-                 int componentNumber = -1,
-                 const std::string& componentModel = "");
+    TSerialClientSession DoFirmwareUpdate(PFeaturePort port,
+                                          TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                          Modbus::IModbusTraits& traits,
+                                          const TFwDeviceInfo& info);
+    TSerialClientSession DoBootloaderUpdate(PFeaturePort port,
+                                            TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                            Modbus::IModbusTraits& traits,
+                                            const TFwDeviceInfo& info);
+    TSerialClientSession DoComponentsUpdate(PFeaturePort port,
+                                            TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                            Modbus::IModbusTraits& traits,
+                                            const TFwDeviceInfo& info);
+    TSerialClientSession DoFlash(PFeaturePort port,
+                                 TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                 Modbus::IModbusTraits& traits,
+                                 std::string type,
+                                 std::string fromVersion,
+                                 std::string toVersion,
+                                 std::string fwUrl,
+                                 bool reboot,
+                                 bool canPreserve,
+                                 int componentNumber = -1,
+                                 std::string componentModel = "");
 
     uint8_t SlaveId;
     std::string Protocol;
@@ -52,4 +66,5 @@ private:
     PFwUpdateLock UpdateLock;
     WBMQTT::TMqttRpcServer::TResultCallback OnResult;
     WBMQTT::TMqttRpcServer::TErrorCallback OnError;
+    TFwFlashSlicing Slicing;
 };
@@ -61,6 +61,11 @@ void TFwUpdateState::Update(const TDeviceUpdateInfo& info)
             newInfo.ComponentModel = info.ComponentModel;
             Devices.push_back(std::move(newInfo));
         }
+        auto jobDevice = FindJobDevice(info.SlaveId, info.PortPath);
+        if (jobDevice && !jobDevice->Finished) {
+            jobDevice->Progress = info.Progress;
+            jobDevice->Failed = jobDevice->Failed || info.Error;
+        }
         json = ToJson();
     }
     Publish(json);
@@ -92,6 +97,10 @@ void TFwUpdateState::SetError(int slaveId,
     std::string json;
     {
         std::lock_guard<std::mutex> lock(Mutex);
+        auto jobDevice = FindJobDevice(slaveId, portPath);
+        if (jobDevice) {
+            jobDevice->Failed = true;
+        }
         for (auto& d: Devices) {
             if (d.SlaveId == slaveId && d.PortPath == portPath && d.Type == type) {
                 d.Error = std::make_unique<TStateError>(TStateError{errorId, errorMessage, metadata});
@@ -137,11 +146,53 @@ void TFwUpdateState::Reset()
     {
         std::lock_guard<std::mutex> lock(Mutex);
         Devices.clear();
+        Job.reset();
+        json = ToJson();
+    }
+    Publish(json);
+}
+
+void TFwUpdateState::StartJob(const std::vector<TFwJobDevice>& devices)
+{
+    std::string json;
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Job = std::make_unique<TJobState>();
+        Job->StartTime = std::chrono::steady_clock::now();
+        for (const auto& device: devices) {
+            Job->Devices.push_back(TJobDeviceState{device});
+        }
+        json = ToJson();
+    }
+    Publish(json);
+}
+
+void TFwUpdateState::FinishJobDevice(int slaveId, const std::string& portPath)
+{
+    std::string json;
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        auto jobDevice = FindJobDevice(slaveId, portPath);
+        if (!jobDevice || jobDevice->Finished) {
+            return;
+        }
+        jobDevice->Finished = true;
         json = ToJson();
     }
     Publish(json);
 }
 
+TFwUpdateState::TJobDeviceState* TFwUpdateState::FindJobDevice(int slaveId, const std::string& portPath)
+{
+    if (!Job) {
+        return nullptr;
+    }
+    auto it = std::find_if(Job->Devices.begin(), Job->Devices.end(), [&](const TJobDeviceState& d) {
+        return d.Device.SlaveId == slaveId && d.Device.PortPath == portPath;
+    });
+    return (it != Job->Devices.end()) ? &(*it) : nullptr;
+}
+
 void TFwUpdateState::Publish(const std::string& json)
 {
     if (PublishFn) {
@@ -196,12 +247,45 @@ std::string TFwUpdateState::ToJson() const
     }
 
     root["devices"] = devices;
+    if (Job) {
+        root["job"] = JobToJson();
+    }
 
     Json::StreamWriterBuilder builder;
     builder["indentation"] = "";
     return Json::writeString(builder, root);
 }
 
+// Progress is averaged over devices of the job, the estimate assumes the same rate for the rest of the job
+Json::Value TFwUpdateState::JobToJson() const
+{
+    Json::Value job;
+    int finished = 0;
+    int failed = 0;
+    double progressSum = 0;
+    for (const auto& d: Job->Devices) {
+        if (d.Finished) {
+            ++finished;
+            failed += d.Failed ? 1 : 0;
+        }
+        progressSum += d.Finished ? 100 : d.Progress;
+    }
+    double progress = Job->Devices.empty() ? 100 : progressSum / Job->Devices.size();
+    job["total"] = static_cast<int>(Job->Devices.size());
+    job["finished"] = finished;
+    job["failed"] = failed;
+    job["progress"] = static_cast<int>(progress);
+    if (finished == static_cast<int>(Job->Devices.size())) {
+        job["eta"] = 0;
+    } else if (progress > 0) {
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Job->StartTime).count();
+        job["eta"] = static_cast<int>(elapsed * (100 - progress) / progress);
+    } else {
+        job["eta"] = Json::nullValue;
+    }
+    return job;
+}
+
 // ============================================================
 //                     TUpdateNotifier
 // Cf. firmware_update.py:209 UpdateNotifier class
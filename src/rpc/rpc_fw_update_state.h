@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -31,6 +32,12 @@ struct TDeviceUpdateInfo
     bool Matches(const TDeviceUpdateInfo& other) const;
 };
 
+struct TFwJobDevice
+{
+    int SlaveId = 0;
+    std::string PortPath;
+};
+
 using TStatePublishFn = std::function<void(const std::string& topic, const std::string& payload, bool retain)>;
 
 class TFwUpdateState
@@ -50,12 +57,39 @@ public:
     void ClearError(int slaveId, const std::string& portPath, const std::string& type);
     void Reset();
 
+    /**
+     * @brief Starts tracking of a job updating several devices.
+     *        Aggregate progress and estimated time of the job are published in "job" object of the state.
+     *        Progress of a device is taken from Update calls, errors from Update and SetError calls.
+     */
+    void StartJob(const std::vector<TFwJobDevice>& devices);
+
+    //! Marks the device of the job as finished, successfully or not
+    void FinishJobDevice(int slaveId, const std::string& portPath);
+
 private:
+    struct TJobDeviceState
+    {
+        TFwJobDevice Device;
+        int Progress = 0;
+        bool Finished = false;
+        bool Failed = false;
+    };
+
+    struct TJobState
+    {
+        std::chrono::steady_clock::time_point StartTime;
+        std::vector<TJobDeviceState> Devices;
+    };
+
     void Publish(const std::string& json);
     std::string ToJson() const;
+    Json::Value JobToJson() const;
+    TJobDeviceState* FindJobDevice(int slaveId, const std::string& portPath);
 
     mutable std::mutex Mutex;
     std::vector<TDeviceUpdateInfo> Devices;
+    std::unique_ptr<TJobState> Job;
     TStatePublishFn PublishFn;
     std::string Topic;
 };
@@ -1,5 +1,6 @@
 #include "rpc_fw_update_task.h"
 #include "log.h"
+#include "port/port.h"
 #include "rpc_fw_update_helpers.h"
 #include "rpc_helpers.h"
 #include "serial_exc.h"
@@ -11,6 +12,7 @@ namespace
     const auto FW_RESPONSE_TIMEOUT = std::chrono::milliseconds(500);
     const auto FW_FRAME_TIMEOUT = std::chrono::milliseconds(20);
     const auto FW_REBOOT_TIMEOUT = std::chrono::milliseconds(1000);
+    const auto FW_BOOTLOADER_START_DELAY = std::chrono::milliseconds(500);
 
     const size_t FW_BLOCK_SIZE = FwRegisters::FW_DATA_BLOCK_COUNT * 2; // 68 registers * 2 bytes = 136 bytes
     const int MAX_WRITE_RETRIES = 3;
@@ -80,9 +82,6 @@ namespace
                 LOG(Debug) << "Device doesn't respond to reboot command, probably it has rebooted";
             }
         }
-
-        // Delay before going to bootloader
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 
     // Cf. firmware_update.py:382 flash_fw() - info block write part
@@ -134,37 +133,44 @@ namespace
         }
     }
 
-    void WriteData(Modbus::IModbusTraits& traits,
-                   TPort& port,
-                   uint8_t slaveId,
-                   const std::vector<uint8_t>& firmwareData,
-                   std::function<void(int)> onProgress)
+    // Keeps polling of the flashed device suspended while flashing in slots
+    class TFwPollSuspender
     {
-        if (firmwareData.empty()) {
-            if (onProgress) {
-                onProgress(100);
+    public:
+        explicit TFwPollSuspender(const TFwFlashSlicing& slicing): Slicing(slicing)
+        {}
+
+        ~TFwPollSuspender()
+        {
+            if (!Suspended || !Slicing.ResumePoll) {
+                return;
+            }
+            try {
+                Slicing.ResumePoll();
+            } catch (const std::exception& e) {
+                // Polling could be resumed by timeout or by a client
+                LOG(Debug) << "Cannot resume polling after flashing: " << e.what();
             }
-            return;
         }
 
-        size_t totalBlocks = (firmwareData.size() + FW_BLOCK_SIZE - 1) / FW_BLOCK_SIZE;
-        for (size_t i = 0; i < totalBlocks; ++i) {
-            size_t offset = i * FW_BLOCK_SIZE;
-            size_t blockLen = std::min(FW_BLOCK_SIZE, firmwareData.size() - offset);
-            std::vector<uint8_t> block(firmwareData.begin() + offset, firmwareData.begin() + offset + blockLen);
-
-            // Pad to even length if needed
-            if (block.size() % 2 != 0) {
-                block.push_back(0xFF);
+        void Suspend()
+        {
+            if (Slicing.BlocksPerSlot == 0 || !Slicing.SuspendPoll) {
+                return;
             }
-
-            WriteDataBlock(traits, port, slaveId, block);
-
-            if (onProgress) {
-                onProgress(static_cast<int>((i + 1) * 100 / totalBlocks));
+            try {
+                // Suspension expires after a while, so it is renewed before every slot
+                Slicing.SuspendPoll();
+                Suspended = true;
+            } catch (const std::exception& e) {
+                LOG(Warn) << "Cannot suspend polling while flashing: " << e.what();
             }
         }
-    }
+
+    private:
+        const TFwFlashSlicing& Slicing;
+        bool Suspended = false;
+    };
 }
 
 // ============================================================
@@ -322,13 +328,115 @@ void FlashFirmware(Modbus::IModbusTraits& traits,
                    bool rebootToBootloader,
                    bool canPreservePortSettings,
                    std::function<void(int)> onProgress)
+{
+    auto session = FlashFirmwareSession(traits,
+                                        port,
+                                        slaveId,
+                                        firmware,
+                                        rebootToBootloader,
+                                        canPreservePortSettings,
+                                        std::move(onProgress),
+                                        TFwFlashSlicing());
+    // Not sliced flashing doesn't yield the bus, so it is done in one run
+    session.Resume();
+}
+
+TSerialClientSession FlashFirmwareSession(Modbus::IModbusTraits& traits,
+                                          TPort& port,
+                                          uint8_t slaveId,
+                                          const TParsedWBFW& firmware,
+                                          bool rebootToBootloader,
+                                          bool canPreservePortSettings,
+                                          std::function<void(int)> onProgress,
+                                          TFwFlashSlicing slicing)
 {
     if (rebootToBootloader) {
         RebootToBootloader(traits, port, slaveId, canPreservePortSettings);
+        // Delay before going to bootloader
+        co_await WaitForFwDevice(FW_BOOTLOADER_START_DELAY, slicing);
     }
 
     WriteInfo(traits, port, slaveId, firmware.Info);
-    WriteData(traits, port, slaveId, firmware.Data, std::move(onProgress));
+
+    const auto& firmwareData = firmware.Data;
+    if (firmwareData.empty()) {
+        if (onProgress) {
+            onProgress(100);
+        }
+        co_return;
+    }
+
+    size_t totalBlocks = (firmwareData.size() + FW_BLOCK_SIZE - 1) / FW_BLOCK_SIZE;
+    auto slotStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < totalBlocks; ++i) {
+        size_t offset = i * FW_BLOCK_SIZE;
+        size_t blockLen = std::min(FW_BLOCK_SIZE, firmwareData.size() - offset);
+        std::vector<uint8_t> block(firmwareData.begin() + offset, firmwareData.begin() + offset + blockLen);
+
+        // Pad to even length if needed
+        if (block.size() % 2 != 0) {
+            block.push_back(0xFF);
+        }
+
+        WriteDataBlock(traits, port, slaveId, block);
+
+        if (onProgress) {
+            onProgress(static_cast<int>((i + 1) * 100 / totalBlocks));
+        }
+
+        if (slicing.BlocksPerSlot != 0 && (i + 1) % slicing.BlocksPerSlot == 0 && i + 1 < totalBlocks) {
+            auto now = std::chrono::steady_clock::now();
+            auto pause = (now - slotStart) * (100 - slicing.BusShare) / slicing.BusShare;
+            co_await YieldBus(now + pause);
+            slotStart = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+TSerialClientSession FlashFirmwareBySlots(Modbus::IModbusTraits& traits,
+                                          PFeaturePort port,
+                                          TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                          std::optional<TSerialPortConnectionSettings> portSettings,
+                                          uint8_t slaveId,
+                                          const TParsedWBFW& firmware,
+                                          bool rebootToBootloader,
+                                          bool canPreservePortSettings,
+                                          std::function<void(int)> onProgress,
+                                          TFwFlashSlicing slicing)
+{
+    auto flash = FlashFirmwareSession(traits,
+                                      *port,
+                                      slaveId,
+                                      firmware,
+                                      rebootToBootloader,
+                                      canPreservePortSettings,
+                                      std::move(onProgress),
+                                      slicing);
+    // The guard lives in the session, so polling is resumed on success, on error and if the task is dropped
+    TFwPollSuspender pollSuspender(slicing);
+    while (true) {
+        {
+            pollSuspender.Suspend();
+            lastAccessedDevice.PrepareToAccess(*port, nullptr);
+            std::optional<TSerialPortSettingsGuard> settingsGuard;
+            if (portSettings) {
+                settingsGuard.emplace(port, *portSettings);
+            }
+            if (flash.Resume()) {
+                break;
+            }
+        }
+        co_await YieldBus(flash.GetResumeTime());
+    }
+}
+
+TSerialClientSession WaitForFwDevice(std::chrono::milliseconds delay, const TFwFlashSlicing& slicing)
+{
+    if (slicing.BlocksPerSlot == 0) {
+        std::this_thread::sleep_for(delay);
+        co_return;
+    }
+    co_await YieldBus(std::chrono::steady_clock::now() + delay);
 }
 
 // ============================================================
@@ -385,7 +493,8 @@ TFwFlashTask::TFwFlashTask(uint8_t slaveId,
                            bool canPreservePortSettings,
                            TFwFlashProgressCallback onProgress,
                            TFwFlashCompleteCallback onComplete,
-                           TFwFlashErrorCallback onError)
+                           TFwFlashErrorCallback onError,
+                           TFwFlashSlicing slicing)
     : SlaveId(slaveId),
       Protocol(protocol),
       Firmware(std::move(firmware)),
@@ -393,12 +502,13 @@ TFwFlashTask::TFwFlashTask(uint8_t slaveId,
       CanPreservePortSettings(canPreservePortSettings),
       OnProgress(std::move(onProgress)),
       OnComplete(std::move(onComplete)),
-      OnError(std::move(onError))
+      OnError(std::move(onError)),
+      Slicing(slicing)
 {}
 
-ISerialClientTask::TRunResult TFwFlashTask::Run(PFeaturePort port,
-                                                TSerialClientDeviceAccessHandler& lastAccessedDevice,
-                                                const std::list<PSerialDevice>& polledDevices)
+TSerialClientSession TFwFlashTask::RunSession(PFeaturePort port,
+                                              TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                              const std::list<PSerialDevice>& polledDevices)
 {
     try {
         if (!port->IsOpen()) {
@@ -409,7 +519,16 @@ ISerialClientTask::TRunResult TFwFlashTask::Run(PFeaturePort port,
 
         auto traits = MakeModbusTraits(Protocol);
 
-        FlashFirmware(*traits, *port, SlaveId, Firmware, RebootToBootloader, CanPreservePortSettings, OnProgress);
+        co_await FlashFirmwareBySlots(*traits,
+                                      port,
+                                      lastAccessedDevice,
+                                      std::nullopt,
+                                      SlaveId,
+                                      Firmware,
+                                      RebootToBootloader,
+                                      CanPreservePortSettings,
+                                      OnProgress,
+                                      Slicing);
 
         if (OnComplete) {
             OnComplete();
@@ -419,5 +538,4 @@ ISerialClientTask::TRunResult TFwFlashTask::Run(PFeaturePort port,
             OnError(std::string("Firmware flash error: ") + e.what());
         }
     }
-    return ISerialClientTask::TRunResult::OK;
 }
@@ -2,11 +2,13 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "port/serial_port_settings.h"
 #include "rpc_fw_downloader.h"
-#include "serial_client.h"
+#include "serial_client_session.h"
 
 namespace Modbus
 {
@@ -73,6 +75,22 @@ struct TFwDeviceInfo
     std::vector<TComponentInfo> Components;
 };
 
+// Time-sliced flashing: data blocks are written by slots, other devices on the port are polled between slots
+struct TFwFlashSlicing
+{
+    //! Data blocks written in one slot, zero disables slicing
+    size_t BlocksPerSlot = 0;
+
+    //! Max share of bus time taken by flashing (1-100%), the rest is left for polling after every slot
+    int BusShare = 100;
+
+    //! Suspends polling of the flashed device, it is called before every slot. Empty if the device isn't polled
+    std::function<void()> SuspendPoll;
+
+    //! Resumes polling of the flashed device after flashing, successful or not
+    std::function<void()> ResumePoll;
+};
+
 // Free functions for serial operations — used by task classes and higher-level tasks
 TFwDeviceInfo ReadFwDeviceInfo(Modbus::IModbusTraits& traits, TPort& port, uint8_t slaveId);
 void FlashFirmware(Modbus::IModbusTraits& traits,
@@ -83,6 +101,34 @@ void FlashFirmware(Modbus::IModbusTraits& traits,
                    bool canPreservePortSettings,
                    std::function<void(int)> onProgress);
 
+// Same as FlashFirmware, but yields the bus after every slot and while the device reboots.
+// Arguments passed by reference must outlive the session
+TSerialClientSession FlashFirmwareSession(Modbus::IModbusTraits& traits,
+                                          TPort& port,
+                                          uint8_t slaveId,
+                                          const TParsedWBFW& firmware,
+                                          bool rebootToBootloader,
+                                          bool canPreservePortSettings,
+                                          std::function<void(int)> onProgress,
+                                          TFwFlashSlicing slicing);
+
+// Runs FlashFirmwareSession in a serial client task.
+// Device access is prepared and port settings are applied before every slot, settings are reset after it,
+// so polling between slots uses usual port settings. Polling of the flashed device is suspended meanwhile
+TSerialClientSession FlashFirmwareBySlots(Modbus::IModbusTraits& traits,
+                                          PFeaturePort port,
+                                          TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                          std::optional<TSerialPortConnectionSettings> portSettings,
+                                          uint8_t slaveId,
+                                          const TParsedWBFW& firmware,
+                                          bool rebootToBootloader,
+                                          bool canPreservePortSettings,
+                                          std::function<void(int)> onProgress,
+                                          TFwFlashSlicing slicing);
+
+// Waits for the device, the bus is given to polling meanwhile if flashing is sliced
+TSerialClientSession WaitForFwDevice(std::chrono::milliseconds delay, const TFwFlashSlicing& slicing);
+
 using TFwGetInfoCallback = std::function<void(const TFwDeviceInfo& info)>;
 using TFwGetInfoErrorCallback = std::function<void(const std::string& error)>;
 
@@ -109,7 +155,7 @@ using TFwFlashProgressCallback = std::function<void(int percent)>;
 using TFwFlashCompleteCallback = std::function<void()>;
 using TFwFlashErrorCallback = std::function<void(const std::string& error)>;
 
-class TFwFlashTask: public ISerialClientTask
+class TFwFlashTask: public TSerialClientSessionTask
 {
 public:
     TFwFlashTask(uint8_t slaveId,
@@ -119,11 +165,13 @@ public:
                  bool canPreservePortSettings,
                  TFwFlashProgressCallback onProgress,
                  TFwFlashCompleteCallback onComplete,
-                 TFwFlashErrorCallback onError);
+                 TFwFlashErrorCallback onError,
+                 TFwFlashSlicing slicing = TFwFlashSlicing());
 
-    ISerialClientTask::TRunResult Run(PFeaturePort port,
-                                      TSerialClientDeviceAccessHandler& lastAccessedDevice,
-                                      const std::list<PSerialDevice>& polledDevices) override;
+protected:
+    TSerialClientSession RunSession(PFeaturePort port,
+                                    TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                    const std::list<PSerialDevice>& polledDevices) override;
 
 private:
     uint8_t SlaveId;
@@ -134,4 +182,5 @@ private:
     TFwFlashProgressCallback OnProgress;
     TFwFlashCompleteCallback OnComplete;
     TFwFlashErrorCallback OnError;
+    TFwFlashSlicing Slicing;
 };
@@ -55,6 +55,7 @@ TSerialClientTaskExecutor::TSerialClientTaskExecutor(PFeaturePort port): Port(po
 {
     Thread = std::thread([this]() {
         TSerialClientDeviceAccessHandler lastAccessedDevice(nullptr);
+        const std::list<PSerialDevice> polledDevices;
         while (true) {
             std::unique_lock<std::mutex> lock(Mutex);
             TasksCv.wait(lock, [this]() { return !Tasks.empty() || !Running; });
@@ -70,7 +71,12 @@ TSerialClientTaskExecutor::TSerialClientTaskExecutor(PFeaturePort port): Port(po
             lock.unlock();
             for (auto& task: tasksToRun) {
                 try {
-                    task->Run(Port, lastAccessedDevice, std::list<PSerialDevice>());
+                    // There is no polling on the port, so a suspended task is resumed right away
+                    while (task->Run(Port, lastAccessedDevice, polledDevices) ==
+                           ISerialClientTask::TRunResult::SUSPENDED)
+                    {
+                        std::this_thread::sleep_until(task->GetResumeTime());
+                    }
                 } catch (const std::exception& e) {
                     LOG(Error) << "Error while running task: " << e.what();
                 }
@@ -165,6 +171,17 @@ TSerialClientParams TSerialClientTaskRunner::GetSerialClientParams(const Json::V
     return params;
 }
 
+std::vector<PSerialClient> TSerialClientTaskRunner::GetSerialClients()
+{
+    std::vector<PSerialClient> res;
+    if (SerialDriver) {
+        for (auto driver: SerialDriver->GetPortDrivers()) {
+            res.push_back(driver->GetSerialClient());
+        }
+    }
+    return res;
+}
+
 void TSerialClientTaskRunner::RunTask(const Json::Value& request, PSerialClientTask task)
 {
     auto params = GetSerialClientParams(request);
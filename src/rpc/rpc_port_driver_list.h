@@ -41,6 +41,12 @@ class ITaskRunner
 public:
     virtual ~ITaskRunner() = default;
     virtual void RunTask(const Json::Value& request, PSerialClientTask task) = 0;
+
+    //! Finds serial client and device of the request, they are empty if the port or the device isn't polled
+    virtual TSerialClientParams GetSerialClientParams(const Json::Value& request)
+    {
+        return TSerialClientParams();
+    }
 };
 
 class TSerialClientTaskRunner: public ITaskRunner
@@ -48,7 +54,8 @@ class TSerialClientTaskRunner: public ITaskRunner
 public:
     TSerialClientTaskRunner(PMQTTSerialDriver serialDriver);
 
-    TSerialClientParams GetSerialClientParams(const Json::Value& request);
+    TSerialClientParams GetSerialClientParams(const Json::Value& request) override;
+    std::vector<PSerialClient> GetSerialClients();
     void RunTask(const Json::Value& request, PSerialClientTask task) override;
 
 private:
@@ -29,6 +29,9 @@ TRPCPortHandler::TRPCPortHandler(const std::string& requestPortLoadSchemaFilePat
                                              std::placeholders::_2,
                                              std::placeholders::_3));
     rpcServer->RegisterMethod("ports", "Load", std::bind(&TRPCPortHandler::LoadPorts, this, std::placeholders::_1));
+    rpcServer->RegisterMethod("ports",
+                              "GetStats",
+                              std::bind(&TRPCPortHandler::GetPortsStats, this, std::placeholders::_1));
     rpcServer->RegisterAsyncMethod("port",
                                    "Setup",
                                    std::bind(&TRPCPortHandler::PortSetup,
@@ -108,3 +111,39 @@ Json::Value TRPCPortHandler::LoadPorts(const Json::Value& request)
 {
     return RPCConfig->GetPortConfigs();
 }
+
+Json::Value TRPCPortHandler::GetPortsStats(const Json::Value& request)
+{
+    Json::Value res(Json::arrayValue);
+    for (const auto& serialClient: SerialClientTaskRunner.GetSerialClients()) {
+        Json::Value item;
+        item["port"] = serialClient->GetPort()->GetDescription(false);
+        item["disconnected_devices_poll_time_ms"] = static_cast<Json::UInt64>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(serialClient->GetDisconnectedDevicesPollTime())
+                .count());
+        auto writeLatency = serialClient->GetWriteLatency();
+        item["write_count"] = static_cast<Json::UInt64>(writeLatency.Count);
+        item["superseded_write_count"] = static_cast<Json::UInt64>(writeLatency.Superseded);
+        item["write_latency_avg_ms"] = writeLatency.Average.count() / 1000.0;
+        item["write_latency_p99_ms"] = writeLatency.P99.count() / 1000.0;
+        item["write_latency_max_ms"] = writeLatency.Max.count() / 1000.0;
+        Json::Value devices(Json::arrayValue);
+        for (const auto& device: serialClient->GetDevices()) {
+            auto sessionStats = device->GetSessionSetupStats();
+            if (sessionStats.Count == 0) {
+                continue;
+            }
+            Json::Value deviceItem;
+            deviceItem["device"] = device->ToString();
+            deviceItem["session_count"] = static_cast<Json::UInt64>(sessionStats.Count);
+            deviceItem["session_setup_time_last_ms"] = sessionStats.Last.count() / 1000.0;
+            deviceItem["session_setup_time_avg_ms"] = sessionStats.Total.count() / 1000.0 / sessionStats.Count;
+            devices.append(deviceItem);
+        }
+        if (!devices.empty()) {
+            item["devices"] = devices;
+        }
+        res.append(item);
+    }
+    return res;
+}
@@ -31,6 +31,7 @@ private:
                   WBMQTT::TMqttRpcServer::TResultCallback onResult,
                   WBMQTT::TMqttRpcServer::TErrorCallback onError);
     Json::Value LoadPorts(const Json::Value& request);
+    Json::Value GetPortsStats(const Json::Value& request);
 };
 
 typedef std::shared_ptr<TRPCPortHandler> PRPCPortHandler;
@@ -1,4 +1,5 @@
 #include "serial_client.h"
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <unistd.h>
@@ -20,32 +21,37 @@ namespace
     const auto BALANCING_THRESHOLD = 500ms;
     // const auto MIN_READ_EVENTS_TIME = 25ms;
     const size_t MAX_EVENT_READ_ERRORS = 10;
+};
 
-    std::chrono::milliseconds GetReadEventsPeriod(const TPort& port)
-    {
-        auto sendByteTime = port.GetSendTimeBytes(1);
-        // >= 115200
-        if (sendByteTime < 100us) {
-            return 50ms;
-        }
-        // >= 38400
-        if (sendByteTime < 300us) {
-            return 100ms;
-        }
-        // < 38400
-        return 200ms;
+std::chrono::milliseconds GetReadEventsPeriod(const TPort& port)
+{
+    auto sendByteTime = port.GetSendTimeBytes(1);
+    // >= 115200
+    if (sendByteTime < 100us) {
+        return 50ms;
     }
-};
+    // >= 38400
+    if (sendByteTime < 300us) {
+        return 100ms;
+    }
+    // < 38400
+    return 200ms;
+}
 
 TSerialClient::TSerialClient(PFeaturePort port,
                              const TPortOpenCloseLogic::TSettings& openCloseSettings,
                              util::TGetNowFn nowFn,
-                             size_t lowPriorityRateLimit)
+                             size_t lowPriorityRateLimit,
+                             const TDisconnectedPollSettings& disconnectedPollSettings,
+                             std::chrono::milliseconds writeLatencyBudget)
     : Port(port),
       OpenCloseLogic(openCloseSettings, nowFn),
       ConnectLogger(PORT_OPEN_ERROR_NOTIFICATION_INTERVAL, "[serial client] "),
       NowFn(nowFn),
-      LowPriorityRateLimit(lowPriorityRateLimit)
+      LowPriorityRateLimit(lowPriorityRateLimit),
+      DisconnectedPollQuarantine(std::make_shared<TDisconnectedPollQuarantine>(disconnectedPollSettings)),
+      WriteLatencyStats(std::make_shared<TWriteLatencyStats>()),
+      WriteLatencyBudget(writeLatencyBudget)
 {}
 
 TSerialClient::~TSerialClient()
@@ -75,7 +81,8 @@ void TSerialClient::Activate()
         RegReader = std::make_unique<TSerialClientRegisterAndEventsReader>(Devices,
                                                                            GetReadEventsPeriod(*Port),
                                                                            NowFn,
-                                                                           LowPriorityRateLimit);
+                                                                           LowPriorityRateLimit,
+                                                                           DisconnectedPollQuarantine);
         LastAccessedDevice = std::make_unique<TSerialClientDeviceAccessHandler>(RegReader->GetEventsReader());
     }
 }
@@ -92,26 +99,64 @@ void TSerialClient::WaitForPollAndFlush(steady_clock::time_point currentTime, st
     }
 
     std::vector<PSerialClientTask> retryTasks;
-    {
-        std::unique_lock<std::mutex> lock(TasksMutex);
-
-        while (TasksCv.wait_until(lock, waitUntil, [this]() { return !Tasks.empty(); })) {
-            std::vector<PSerialClientTask> tasks;
-            Tasks.swap(tasks);
-            lock.unlock();
-            for (auto& task: tasks) {
-                if (task->Run(Port, *LastAccessedDevice, Devices) == ISerialClientTask::TRunResult::RETRY) {
+    // Every suspended task makes at least one step per cycle, so it is not starved by polling
+    auto suspendedTasks = TakeSuspendedTasks(currentTime);
+    while (true) {
+        // Suspended tasks use idle bus time, so new tasks are awaited only till the nearest resume time
+        auto tasks =
+            TaskQueue.WaitAndTake(suspendedTasks.empty() ? GetNextResumeTime(waitUntil) : steady_clock::time_point());
+        tasks.insert(tasks.end(), suspendedTasks.begin(), suspendedTasks.end());
+        suspendedTasks.clear();
+        // Writes to the same device are combined to use multi-register requests
+        for (auto& task: CombineWriteChannelTasks(tasks)) {
+            switch (task->Run(Port, *LastAccessedDevice, Devices)) {
+                case ISerialClientTask::TRunResult::RETRY:
                     retryTasks.push_back(task);
-                }
+                    break;
+                case ISerialClientTask::TRunResult::SUSPENDED:
+                    SuspendedTasks.push_back(task);
+                    break;
+                default:
+                    break;
             }
-            lock.lock();
+        }
+        auto now = NowFn();
+        if (now < waitUntil) {
+            suspendedTasks = TakeSuspendedTasks(now);
+        }
+        if (tasks.empty() && suspendedTasks.empty()) {
+            break;
         }
     }
     for (auto& task: retryTasks) {
-        AddTask(task);
+        // Writes queued during the run join the retried write
+        auto writeTask = std::dynamic_pointer_cast<TWriteChannelSerialClientTask>(task);
+        if (writeTask) {
+            TaskQueue.AddWrite(writeTask);
+        } else {
+            AddTask(task);
+        }
     }
 }
 
+std::vector<PSerialClientTask> TSerialClient::TakeSuspendedTasks(steady_clock::time_point now)
+{
+    auto it = std::stable_partition(SuspendedTasks.begin(), SuspendedTasks.end(), [now](const auto& task) {
+        return task->GetResumeTime() > now;
+    });
+    std::vector<PSerialClientTask> res(it, SuspendedTasks.end());
+    SuspendedTasks.erase(it, SuspendedTasks.end());
+    return res;
+}
+
+steady_clock::time_point TSerialClient::GetNextResumeTime(steady_clock::time_point waitUntil) const
+{
+    for (const auto& task: SuspendedTasks) {
+        waitUntil = std::min(waitUntil, task->GetResumeTime());
+    }
+    return waitUntil;
+}
+
 void TSerialClient::ProcessPolledRegister(PRegister reg)
 {
     if (reg->GetErrorState().test(TRegister::ReadError) || reg->GetErrorState().test(TRegister::WriteError)) {
@@ -125,6 +170,17 @@ void TSerialClient::ProcessPolledRegister(PRegister reg)
     }
 }
 
+void TSerialClient::ProcessWrittenRegister(PRegister reg)
+{
+    // The device has acknowledged the value, so there is no need to read it back soon
+    if (reg->Device()->DeviceConfig()->PostponePollAfterWrite) {
+        RegReader->PostponePoll(reg, NowFn());
+    }
+    if (RegisterReadCallback) {
+        RegisterReadCallback(reg);
+    }
+}
+
 void TSerialClient::Cycle()
 {
     Activate();
@@ -152,13 +208,27 @@ void TSerialClient::ClosedPortCycle()
     RegReader->ClosedPortCycle(waitUntil, [this](PRegister reg) { ProcessPolledRegister(reg); });
 }
 
-void TSerialClient::SetTextValue(PRegister reg, const std::string& value)
+void TSerialClient::SetTextValue(PRegister reg,
+                                 const std::string& value,
+                                 std::function<void(const std::string& error)> onComplete)
 {
     auto handler = GetHandler(reg);
     handler->SetTextValue(value);
-    auto serialClientTask =
-        std::make_shared<TWriteChannelSerialClientTask>(handler, RegisterReadCallback, RegisterErrorCallback);
-    AddTask(serialClientTask);
+    auto completionCallback = [stats = WriteLatencyStats, nowFn = NowFn, enqueueTime = NowFn(), onComplete](
+                                  const std::string& error) {
+        stats->AddLatency(duration_cast<microseconds>(nowFn() - enqueueTime));
+        if (onComplete) {
+            onComplete(error);
+        }
+    };
+    auto serialClientTask = std::make_shared<TWriteChannelSerialClientTask>(
+        handler,
+        [this](PRegister reg) { ProcessWrittenRegister(reg); },
+        RegisterErrorCallback,
+        completionCallback);
+    if (!TaskQueue.AddWrite(serialClientTask)) {
+        WriteLatencyStats->AddSuperseded();
+    }
 }
 
 void TSerialClient::SetReadCallback(const TSerialClient::TRegisterCallback& callback)
@@ -187,8 +257,14 @@ void TSerialClient::OpenPortCycle()
     waitUntil = std::min(waitUntil, currentTime + MAX_POLL_TIME);
     WaitForPollAndFlush(currentTime, waitUntil);
 
-    auto device =
-        RegReader->OpenPortCycle(*Port, [this](PRegister reg) { ProcessPolledRegister(reg); }, *LastAccessedDevice);
+    // Writes are executed only between poll requests,
+    // so a long request of a slow device delays writes queued during it
+    auto maxRangeTime = (WriteLatencyBudget == milliseconds::zero()) ? milliseconds::max() : WriteLatencyBudget;
+    auto device = RegReader->OpenPortCycle(
+        *Port,
+        [this](PRegister reg) { ProcessPolledRegister(reg); },
+        *LastAccessedDevice,
+        maxRangeTime);
 
     if (device) {
         OpenCloseLogic.CloseIfNeeded(Port, device->GetConnectionState() == TDeviceConnectionState::DISCONNECTED);
@@ -207,11 +283,7 @@ std::list<PSerialDevice> TSerialClient::GetDevices()
 
 void TSerialClient::AddTask(PSerialClientTask task)
 {
-    {
-        std::unique_lock<std::mutex> lock(TasksMutex);
-        Tasks.push_back(task);
-    }
-    TasksCv.notify_all();
+    TaskQueue.AddTask(task);
 }
 
 void TSerialClient::SuspendPoll(PSerialDevice device, std::chrono::steady_clock::time_point currentTime)
@@ -224,12 +296,23 @@ void TSerialClient::ResumePoll(PSerialDevice device)
     RegReader->ResumePoll(device);
 }
 
+std::chrono::microseconds TSerialClient::GetDisconnectedDevicesPollTime() const
+{
+    return DisconnectedPollQuarantine->GetDisconnectedDevicesPollTime();
+}
+
+TWriteLatencySummary TSerialClient::GetWriteLatency() const
+{
+    return WriteLatencyStats->GetSummary();
+}
+
 TSerialClientRegisterAndEventsReader::TSerialClientRegisterAndEventsReader(const std::list<PSerialDevice>& devices,
                                                                            std::chrono::milliseconds readEventsPeriod,
                                                                            util::TGetNowFn nowFn,
-                                                                           size_t lowPriorityRateLimit)
+                                                                           size_t lowPriorityRateLimit,
+                                                                           PDisconnectedPollQuarantine disconnectedPollQuarantine)
     : EventsReader(std::make_shared<TSerialClientEventsReader>(MAX_EVENT_READ_ERRORS)),
-      RegisterPoller(lowPriorityRateLimit),
+      RegisterPoller(lowPriorityRateLimit, disconnectedPollQuarantine),
       TimeBalancer(BALANCING_THRESHOLD),
       ReadEventsPeriod(readEventsPeriod),
       SpentTime(nowFn),
@@ -269,7 +352,8 @@ public:
 
 PSerialDevice TSerialClientRegisterAndEventsReader::OpenPortCycle(TFeaturePort& port,
                                                                   TRegisterCallback regCallback,
-                                                                  TSerialClientDeviceAccessHandler& lastAccessedDevice)
+                                                                  TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                                                  std::chrono::milliseconds maxRangeTime)
 {
     // Count idle time as high priority task time to faster reach time balancing threshold
     if (LastCycleWasTooSmallToPoll) {
@@ -291,6 +375,7 @@ PSerialDevice TSerialClientRegisterAndEventsReader::OpenPortCycle(TFeaturePort&
             TimeBalancer.AddEntry(TClientTaskType::EVENTS,
                                   SpentTime.GetStartTime() + ReadEventsPeriod,
                                   TPriority::High);
+            ScheduleRegistersWithRestoredPolling(NowFn());
         }
         SpentTime.Start();
 
@@ -306,12 +391,15 @@ PSerialDevice TSerialClientRegisterAndEventsReader::OpenPortCycle(TFeaturePort&
     const bool readAtLeastOneRegister =
         (handler.Policy == TItemAccumulationPolicy::Force) || !EventsReader->HasDevicesWithEnabledEvents();
 
+    ScheduleRegistersWithRestoredPolling(SpentTime.GetStartTime());
+
     auto res = RegisterPoller.OpenPortCycle(port,
                                             SpentTime,
                                             std::min(handler.PollLimit, MAX_POLL_TIME),
                                             readAtLeastOneRegister,
                                             lastAccessedDevice,
-                                            regCallback);
+                                            regCallback,
+                                            maxRangeTime);
 
     TimeBalancer.AddEntry(TClientTaskType::POLLING, res.Deadline, TPriority::Low);
     if (res.NotEnoughTime) {
@@ -350,3 +438,26 @@ void TSerialClientRegisterAndEventsReader::ResumePoll(PSerialDevice device)
 {
     RegisterPoller.ResumePoll(device);
 }
+
+void TSerialClientRegisterAndEventsReader::PostponePoll(PRegister reg,
+                                                        std::chrono::steady_clock::time_point currentTime)
+{
+    RegisterPoller.PostponePoll(reg, currentTime);
+}
+
+void TSerialClientRegisterAndEventsReader::ScheduleRegistersWithRestoredPolling(
+    std::chrono::steady_clock::time_point currentTime)
+{
+    auto regs = EventsReader->TakeRegistersWithRestoredPolling();
+    if (regs.empty()) {
+        return;
+    }
+    for (const auto& reg: regs) {
+        RegisterPoller.ScheduleImmediatePoll(reg, currentTime);
+    }
+    // Polling could be scheduled with events heartbeat period, move it to make the registers actual sooner
+    if (TimeBalancer.Contains(TClientTaskType::POLLING)) {
+        TimeBalancer.Remove(TClientTaskType::POLLING);
+        TimeBalancer.AddEntry(TClientTaskType::POLLING, currentTime, TPriority::Low);
+    }
+}
@@ -10,6 +10,8 @@
 #include "serial_client_device_access_handler.h"
 #include "serial_client_events_reader.h"
 #include "serial_client_register_poller.h"
+#include "serial_client_task_queue.h"
+#include "write_latency_stats.h"
 
 class TSerialDevice;
 typedef std::shared_ptr<TSerialDevice> PSerialDevice;
@@ -20,6 +22,9 @@ enum TClientTaskType
     EVENTS
 };
 
+//! Period of Fast Modbus events reading depending on port speed
+std::chrono::milliseconds GetReadEventsPeriod(const TPort& port);
+
 class TSerialClientRegisterAndEventsReader: public util::TNonCopyable
 {
 public:
@@ -28,12 +33,20 @@ public:
     TSerialClientRegisterAndEventsReader(const std::list<PSerialDevice>& devices,
                                          std::chrono::milliseconds readEventsPeriod,
                                          util::TGetNowFn nowFn,
-                                         size_t lowPriorityRateLimit = std::numeric_limits<size_t>::max());
+                                         size_t lowPriorityRateLimit = std::numeric_limits<size_t>::max(),
+                                         PDisconnectedPollQuarantine disconnectedPollQuarantine = nullptr);
 
     void ClosedPortCycle(std::chrono::steady_clock::time_point currentTime, TRegisterCallback regCallback);
+    /**
+     * @brief Reads Fast Modbus events or one register range
+     *
+     * @param maxRangeTime max estimated time of one read request,
+     *                     a register with longer read time is read by a separate request
+     */
     PSerialDevice OpenPortCycle(TFeaturePort& port,
                                 TRegisterCallback regCallback,
-                                TSerialClientDeviceAccessHandler& lastAccessedDevice);
+                                TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                std::chrono::milliseconds maxRangeTime = std::chrono::milliseconds::max());
 
     std::chrono::steady_clock::time_point GetDeadline(std::chrono::steady_clock::time_point currentTime) const;
 
@@ -41,6 +54,7 @@ public:
 
     void SuspendPoll(PSerialDevice device, std::chrono::steady_clock::time_point currentTime);
     void ResumePoll(PSerialDevice device);
+    void PostponePoll(PRegister reg, std::chrono::steady_clock::time_point currentTime);
 
 private:
     PSerialClientEventsReader EventsReader;
@@ -51,6 +65,8 @@ private:
     util::TSpentTimeMeter SpentTime;
     bool LastCycleWasTooSmallToPoll;
     util::TGetNowFn NowFn;
+
+    void ScheduleRegistersWithRestoredPolling(std::chrono::steady_clock::time_point currentTime);
 };
 
 class ISerialClientTask
@@ -59,7 +75,9 @@ public:
     enum class TRunResult
     {
         OK,
-        RETRY
+        RETRY,
+        //! The task has done a step and must be run again after polling
+        SUSPENDED
     };
 
     virtual ~ISerialClientTask() = default;
@@ -75,6 +93,12 @@ public:
     virtual ISerialClientTask::TRunResult Run(PFeaturePort port,
                                               TSerialClientDeviceAccessHandler& lastAccessedDevice,
                                               const std::list<PSerialDevice>& polledDevices) = 0;
+
+    //! The task returned SUSPENDED must not be run again before the time
+    virtual std::chrono::steady_clock::time_point GetResumeTime() const
+    {
+        return std::chrono::steady_clock::time_point();
+    }
 };
 
 typedef std::shared_ptr<ISerialClientTask> PSerialClientTask;
@@ -87,12 +111,21 @@ public:
     TSerialClient(PFeaturePort port,
                   const TPortOpenCloseLogic::TSettings& openCloseSettings,
                   util::TGetNowFn nowFn,
-                  size_t lowPriorityRateLimit = std::numeric_limits<size_t>::max());
+                  size_t lowPriorityRateLimit = std::numeric_limits<size_t>::max(),
+                  const TDisconnectedPollSettings& disconnectedPollSettings = TDisconnectedPollSettings(),
+                  std::chrono::milliseconds writeLatencyBudget = std::chrono::milliseconds::zero());
     ~TSerialClient();
 
     void AddDevice(PSerialDevice device);
     void Cycle();
-    void SetTextValue(PRegister reg, const std::string& value);
+    /**
+     * @brief Schedule register write
+     *
+     * @param onComplete is called from the port thread when the write is finished, error is empty on success
+     */
+    void SetTextValue(PRegister reg,
+                      const std::string& value,
+                      std::function<void(const std::string& error)> onComplete = nullptr);
     void SetReadCallback(const TRegisterCallback& callback);
     void SetErrorCallback(const TRegisterCallback& callback);
 
@@ -104,14 +137,23 @@ public:
     void SuspendPoll(PSerialDevice device, std::chrono::steady_clock::time_point currentTime);
     void ResumePoll(PSerialDevice device);
 
+    //! Total time spent on polling disconnected devices, the method is thread safe
+    std::chrono::microseconds GetDisconnectedDevicesPollTime() const;
+
+    //! Latency of channel writes from SetTextValue call to completion, the method is thread safe
+    TWriteLatencySummary GetWriteLatency() const;
+
 private:
     void Activate();
     void WaitForPollAndFlush(std::chrono::steady_clock::time_point now,
                              std::chrono::steady_clock::time_point waitUntil);
     PRegisterHandler GetHandler(PRegister) const;
+    std::vector<PSerialClientTask> TakeSuspendedTasks(std::chrono::steady_clock::time_point now);
+    std::chrono::steady_clock::time_point GetNextResumeTime(std::chrono::steady_clock::time_point waitUntil) const;
     void ClosedPortCycle();
     void OpenPortCycle();
     void ProcessPolledRegister(PRegister reg);
+    void ProcessWrittenRegister(PRegister reg);
 
     PFeaturePort Port;
     std::list<PRegister> RegList;
@@ -131,9 +173,14 @@ private:
 
     size_t LowPriorityRateLimit;
 
-    std::mutex TasksMutex;
-    std::condition_variable TasksCv;
-    std::vector<PSerialClientTask> Tasks;
+    PDisconnectedPollQuarantine DisconnectedPollQuarantine;
+
+    TSerialClientTaskQueue TaskQueue;
+    std::vector<PSerialClientTask> SuspendedTasks;
+    PWriteLatencyStats WriteLatencyStats;
+
+    //! Max time of one poll request, so queued writes are not delayed longer. Zero means no limit
+    std::chrono::milliseconds WriteLatencyBudget;
 };
 
 typedef std::shared_ptr<TSerialClient> PSerialClient;
@@ -152,6 +152,8 @@ class TModbusExtEventsVisitor: public ModbusExt::IEventsVisitor
                 reg->SetValue(TRegisterValue(value));
                 RegisterChangedCallback(reg);
             }
+            // The next read must update all registers, not only registers changed since the previous read
+            regArray->second.front()->Device()->InvalidateReadCache();
         } else {
             LOG(Warn) << "Unexpected event from: " << MakeRegisterDescriptionString(slaveId, eventType, eventId);
             RegsToDisable.emplace_back(TEventsReaderRegisterDesc{slaveId, eventId, eventType});
@@ -223,6 +225,10 @@ void TSerialClientEventsReader::ReadEventsFailed(const std::string& errorMessage
     ++ReadErrors;
     if (ReadErrors > MaxReadErrors) {
         SetReadErrors(registerCallback);
+        // Events could be lost, so the registers must be polled as usual until events are read again
+        for (const auto& reg: RegsWithRelaxedPolling) {
+            RestorePolling(reg);
+        }
         ReadErrors = 0;
         ClearErrorsOnSuccessfulRead = true;
     }
@@ -332,10 +338,20 @@ void TSerialClientEventsReader::OnEnabledEvent(uint8_t slaveId, uint8_t type, ui
                 if (reg->GetConfig()->SporadicMode == TRegisterConfig::TSporadicMode::ONLY_EVENTS) {
                     reg->ExcludeFromPolling();
                 }
+                if (reg->GetConfig()->SporadicMode == TRegisterConfig::TSporadicMode::EVENTS_AND_POLLING &&
+                    reg->Device()->DeviceConfig()->EventsHeartbeatPeriod != milliseconds::zero())
+                {
+                    RegsWithRelaxedPolling.insert(reg);
+                    if (!ClearErrorsOnSuccessfulRead) {
+                        RelaxPolling(reg);
+                    }
+                }
                 reg->SetAvailable(TRegisterAvailability::AVAILABLE);
                 DevicesWithEnabledEvents.emplace(slaveId);
             } else {
                 reg->IncludeInPolling();
+                RegsWithRelaxedPolling.erase(reg);
+                RestorePolling(reg);
             }
         }
     }
@@ -375,6 +391,15 @@ void TSerialClientEventsReader::OnDeviceConnectionStateChanged(PSerialDevice dev
         if (dev != nullptr) {
             DevicesWithEnabledEvents.erase(dev->SlaveId);
         }
+        // Events must be enabled again after reconnection, so poll registers as usual until that
+        for (auto it = RegsWithRelaxedPolling.begin(); it != RegsWithRelaxedPolling.end();) {
+            if ((*it)->Device() == device) {
+                RestorePolling(*it);
+                it = RegsWithRelaxedPolling.erase(it);
+            } else {
+                ++it;
+            }
+        }
     }
 }
 
@@ -399,6 +424,9 @@ void TSerialClientEventsReader::ClearReadErrors(TRegisterCallback callback)
         return;
     }
     ClearErrorsOnSuccessfulRead = false;
+    for (const auto& reg: RegsWithRelaxedPolling) {
+        RelaxPolling(reg);
+    }
     for (const auto& regArray: Regs) {
         for (const auto& reg: regArray.second) {
             if (reg->IsExcludedFromPolling() || reg->Device()->IsSporadicOnly()) {
@@ -416,6 +444,30 @@ bool TSerialClientEventsReader::HasDevicesWithEnabledEvents() const
     return !DevicesWithEnabledEvents.empty();
 }
 
+std::vector<PRegister> TSerialClientEventsReader::TakeRegistersWithRestoredPolling()
+{
+    std::vector<PRegister> res;
+    res.swap(RegsWithRestoredPolling);
+    return res;
+}
+
+void TSerialClientEventsReader::RelaxPolling(PRegister reg)
+{
+    if (!reg->IsPollingRelaxed()) {
+        LOG(Debug) << reg->ToString() << " is polled with events heartbeat period";
+        reg->SetPollingRelaxed(true);
+    }
+}
+
+void TSerialClientEventsReader::RestorePolling(PRegister reg)
+{
+    if (reg->IsPollingRelaxed()) {
+        LOG(Debug) << reg->ToString() << " is polled with its read period";
+        reg->SetPollingRelaxed(false);
+        RegsWithRestoredPolling.push_back(reg);
+    }
+}
+
 bool TEventsReaderRegisterDesc::operator==(const TEventsReaderRegisterDesc& other) const
 {
     return SlaveId == other.SlaveId && Addr == other.Addr && Type == other.Type;
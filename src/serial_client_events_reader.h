@@ -51,6 +51,13 @@ public:
 
     bool HasDevicesWithEnabledEvents() const;
 
+    /**
+     * @brief Returns registers which were polled with events heartbeat period,
+     *        but must be polled as usual from now, and clears the list.
+     *        The registers should be polled as soon as possible, because their events could be lost.
+     */
+    std::vector<PRegister> TakeRegistersWithRestoredPolling();
+
 private:
     uint8_t LastAccessedSlaveId;
     ModbusExt::TEventConfirmationState EventState;
@@ -61,10 +68,17 @@ private:
     TRegsMap Regs;
     std::unordered_set<uint8_t> DevicesWithEnabledEvents;
 
+    // Semi-sporadic registers with enabled events, they are polled with events heartbeat period
+    // while events are read successfully
+    std::unordered_set<PRegister> RegsWithRelaxedPolling;
+    std::vector<PRegister> RegsWithRestoredPolling;
+
     void OnEnabledEvent(uint8_t slaveId, uint8_t type, uint16_t addr, bool res);
     void ClearReadErrors(TRegisterCallback callback);
     void ReadEventsFailed(const std::string& errorMessage, TRegisterCallback registerCallback);
     void OnDeviceConnectionStateChanged(PSerialDevice device);
+    void RelaxPolling(PRegister reg);
+    void RestorePolling(PRegister reg);
 };
 
 typedef std::shared_ptr<TSerialClientEventsReader> PSerialClientEventsReader;
@@ -23,7 +23,9 @@ namespace
     {
         PRegisterRange RegisterRange;
         milliseconds MaxPollTime;
+        milliseconds MaxRangeTime;
         PPollableDevice Device;
+        bool WasDisconnected = false;
         bool ReadAtLeastOneRegister;
         const util::TSpentTimeMeter& SessionTime;
         TSerialClientDeviceAccessHandler& LastAccessedDevice;
@@ -34,8 +36,10 @@ namespace
                       const util::TSpentTimeMeter& sessionTime,
                       milliseconds maxPollTime,
                       bool readAtLeastOneRegister,
-                      TSerialClientDeviceAccessHandler& lastAccessedDevice)
+                      TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                      milliseconds maxRangeTime)
             : MaxPollTime(maxPollTime),
+              MaxRangeTime(maxRangeTime),
               ReadAtLeastOneRegister(readAtLeastOneRegister),
               SessionTime(sessionTime),
               LastAccessedDevice(lastAccessedDevice),
@@ -53,8 +57,14 @@ namespace
                 ReadAtLeastOneRegister = false;
             }
 
+            WasDisconnected = (device->GetDevice()->GetConnectionState() == TDeviceConnectionState::DISCONNECTED);
             RegisterRange =
-                device->ReadRegisterRange(Port, pollLimit, ReadAtLeastOneRegister, SessionTime, LastAccessedDevice);
+                device->ReadRegisterRange(Port,
+                                          pollLimit,
+                                          ReadAtLeastOneRegister,
+                                          SessionTime,
+                                          LastAccessedDevice,
+                                          MaxRangeTime);
             Device = device;
             return !RegisterRange->RegisterList().empty();
         }
@@ -68,6 +78,11 @@ namespace
         {
             return Device;
         }
+
+        bool DeviceWasDisconnected() const
+        {
+            return WasDisconnected;
+        }
     };
 
     class TClosedPortDeviceReader
@@ -108,11 +123,17 @@ namespace
     };
 };
 
-TSerialClientRegisterPoller::TSerialClientRegisterPoller(size_t lowPriorityRateLimit)
+TSerialClientRegisterPoller::TSerialClientRegisterPoller(size_t lowPriorityRateLimit,
+                                                         PDisconnectedPollQuarantine quarantine)
     : Scheduler(MAX_LOW_PRIORITY_LAG),
       ThrottlingStateLogger(),
-      LowPriorityRateLimiter(lowPriorityRateLimit)
-{}
+      LowPriorityRateLimiter(lowPriorityRateLimit),
+      Quarantine(quarantine)
+{
+    if (!Quarantine) {
+        Quarantine = std::make_shared<TDisconnectedPollQuarantine>(TDisconnectedPollSettings());
+    }
+}
 
 void TSerialClientRegisterPoller::SetDevices(const std::list<PSerialDevice>& devices,
                                              steady_clock::time_point currentTime)
@@ -140,7 +161,13 @@ void TSerialClientRegisterPoller::ScheduleNextPoll(PPollableDevice device, stead
     if (device->HasRegisters()) {
         auto delay = milliseconds(0);
         auto deadline = device->GetDeadline();
-        if (device->GetDevice()->GetConnectionState() == TDeviceConnectionState::DISCONNECTED) {
+        if (device->GetDevice()->GetConnectionState() == TDeviceConnectionState::DISCONNECTED &&
+            Quarantine->GetSettings().Backoff)
+        {
+            deadline = std::max(deadline, Quarantine->GetNextPollTime(device->GetDevice(), currentTime));
+            LOG(Debug) << "Device " << device->GetDevice()->ToString() << " poll delayed for "
+                       << duration_cast<milliseconds>(deadline - currentTime).count() << " ms";
+        } else if (device->GetDevice()->GetConnectionState() == TDeviceConnectionState::DISCONNECTED) {
             delay = device->GetDisconnectedPollDelay();
             if (delay.count()) {
                 deadline = currentTime + delay;
@@ -206,7 +233,8 @@ TPollResult TSerialClientRegisterPoller::OpenPortCycle(TFeaturePort& port,
                                                        std::chrono::milliseconds maxPollingTime,
                                                        bool readAtLeastOneRegister,
                                                        TSerialClientDeviceAccessHandler& lastAccessedDevice,
-                                                       TRegisterCallback callback)
+                                                       TRegisterCallback callback,
+                                                       std::chrono::milliseconds maxRangeTime)
 {
     RescheduleDisconnectedDevices();
     RescheduleDevicesWithSpendedPoll(spentTime.GetStartTime());
@@ -215,7 +243,7 @@ TPollResult TSerialClientRegisterPoller::OpenPortCycle(TFeaturePort& port,
 
     TPollResult res;
 
-    TDeviceReader reader(port, spentTime, maxPollingTime, readAtLeastOneRegister, lastAccessedDevice);
+    TDeviceReader reader(port, spentTime, maxPollingTime, readAtLeastOneRegister, lastAccessedDevice, maxRangeTime);
 
     bool lowPriorityRateLimitIsExceeded = LowPriorityRateLimiter.IsOverLimit(spentTime.GetStartTime());
 
@@ -262,11 +290,53 @@ TPollResult TSerialClientRegisterPoller::OpenPortCycle(TFeaturePort& port,
     }
     ScheduleNextPoll(reader.GetDevice(), spentTime.GetStartTime());
 
+    Quarantine->AddPollTime(reader.DeviceWasDisconnected(),
+                            spentTime.GetSpentTime(),
+                            spentTime.GetStartTime());
     Scheduler.UpdateSelectionTime(ceil<milliseconds>(spentTime.GetSpentTime()), reader.GetDevice()->GetPriority());
     res.Deadline = GetDeadline(lowPriorityRateLimitIsExceeded, spentTime);
     return res;
 }
 
+void TSerialClientRegisterPoller::PostponePoll(PRegister reg, std::chrono::steady_clock::time_point currentTime)
+{
+    std::unique_lock lock(Mutex);
+
+    auto range = Devices.equal_range(reg->Device());
+    for (auto it = range.first; it != range.second; ++it) {
+        auto device = it->second;
+        if (device->PostponePoll(reg, currentTime)) {
+            UpdateDeviceDeadline(device);
+        }
+    }
+}
+
+void TSerialClientRegisterPoller::ScheduleImmediatePoll(PRegister reg,
+                                                        std::chrono::steady_clock::time_point currentTime)
+{
+    std::unique_lock lock(Mutex);
+
+    auto range = Devices.equal_range(reg->Device());
+    for (auto it = range.first; it != range.second; ++it) {
+        auto device = it->second;
+        if (device->ScheduleImmediatePoll(reg, currentTime)) {
+            UpdateDeviceDeadline(device);
+        }
+    }
+}
+
+void TSerialClientRegisterPoller::UpdateDeviceDeadline(PPollableDevice device)
+{
+    if (!Scheduler.Contains(device)) {
+        return;
+    }
+    // Device deadline is the nearest deadline of its registers
+    Scheduler.Remove(device);
+    if (device->HasRegisters()) {
+        Scheduler.AddEntry(device, device->GetDeadline(), device->GetPriority());
+    }
+}
+
 void TSerialClientRegisterPoller::SuspendPoll(PSerialDevice device, std::chrono::steady_clock::time_point currentTime)
 {
     std::unique_lock lock(Mutex);
@@ -309,6 +379,9 @@ void TSerialClientRegisterPoller::ResumePoll(PSerialDevice device)
 
 void TSerialClientRegisterPoller::OnDeviceConnectionStateChanged(PSerialDevice device)
 {
+    if (device->GetConnectionState() == TDeviceConnectionState::CONNECTED) {
+        Quarantine->Release(device);
+    }
     if (device->GetConnectionState() == TDeviceConnectionState::DISCONNECTED &&
         DevicesWithSpendedPoll.find(device) == DevicesWithSpendedPoll.end())
     {
@@ -2,6 +2,7 @@
 
 #include <map>
 
+#include "disconnected_poll_quarantine.h"
 #include "poll_plan.h"
 #include "pollable_device.h"
 #include "port/port.h"
@@ -37,7 +38,8 @@ class TSerialClientRegisterPoller
 public:
     typedef std::function<void(PRegister reg)> TRegisterCallback;
 
-    TSerialClientRegisterPoller(size_t lowPriorityRateLimit = std::numeric_limits<size_t>::max());
+    TSerialClientRegisterPoller(size_t lowPriorityRateLimit = std::numeric_limits<size_t>::max(),
+                                PDisconnectedPollQuarantine quarantine = nullptr);
 
     void SetDevices(const std::list<PSerialDevice>& devices, std::chrono::steady_clock::time_point currentTime);
     void ClosedPortCycle(std::chrono::steady_clock::time_point currentTime, TRegisterCallback callback);
@@ -46,12 +48,20 @@ public:
                               std::chrono::milliseconds maxPollingTime,
                               bool readAtLeastOneRegister,
                               TSerialClientDeviceAccessHandler& lastAccessedDevice,
-                              TRegisterCallback callback);
+                              TRegisterCallback callback,
+                              std::chrono::milliseconds maxRangeTime = std::chrono::milliseconds::max());
 
     void SuspendPoll(PSerialDevice device, std::chrono::steady_clock::time_point currentTime);
     void ResumePoll(PSerialDevice device);
 
+    //! Delays next poll of the register by its read period starting from currentTime
+    void PostponePoll(PRegister reg, std::chrono::steady_clock::time_point currentTime);
+
+    //! Polls the register as soon as possible, it is used when relaxed polling of the register is stopped
+    void ScheduleImmediatePoll(PRegister reg, std::chrono::steady_clock::time_point currentTime);
+
 private:
+    void UpdateDeviceDeadline(PPollableDevice device);
     void ScheduleNextPoll(PPollableDevice device, std::chrono::steady_clock::time_point currentTime);
     std::chrono::steady_clock::time_point GetDeadline(bool lowPriorityRateLimitIsExceeded,
                                                       const util::TSpentTimeMeter& spentTime) const;
@@ -72,4 +82,6 @@ private:
     std::vector<PSerialDevice> DisconnectedDevicesWaitingForReschedule;
 
     std::unordered_map<PSerialDevice, std::chrono::steady_clock::time_point> DevicesWithSpendedPoll;
+
+    PDisconnectedPollQuarantine Quarantine;
 };
@@ -0,0 +1,113 @@
+#include "serial_client_session.h"
+
+#include <utility>
+
+TSerialClientSession TSerialClientSession::promise_type::get_return_object()
+{
+    auto handle = std::coroutine_handle<promise_type>::from_promise(*this);
+    Current = handle;
+    return TSerialClientSession(handle);
+}
+
+std::suspend_always TSerialClientSession::promise_type::initial_suspend() noexcept
+{
+    return {};
+}
+
+void TSerialClientSession::promise_type::return_void()
+{}
+
+void TSerialClientSession::promise_type::unhandled_exception()
+{
+    Exception = std::current_exception();
+}
+
+TSerialClientSession::TSerialClientSession(std::coroutine_handle<promise_type> handle): Handle(handle)
+{}
+
+TSerialClientSession::TSerialClientSession(TSerialClientSession&& other) noexcept
+    : Handle(std::exchange(other.Handle, nullptr))
+{}
+
+TSerialClientSession& TSerialClientSession::operator=(TSerialClientSession&& other) noexcept
+{
+    if (this != &other) {
+        if (Handle) {
+            Handle.destroy();
+        }
+        Handle = std::exchange(other.Handle, nullptr);
+    }
+    return *this;
+}
+
+TSerialClientSession::~TSerialClientSession()
+{
+    if (Handle) {
+        Handle.destroy();
+    }
+}
+
+bool TSerialClientSession::Resume()
+{
+    if (IsDone()) {
+        return true;
+    }
+    auto& promise = Handle.promise();
+    promise.ResumeTime = {};
+    promise.Current.resume();
+    if (promise.Exception) {
+        std::rethrow_exception(std::exchange(promise.Exception, nullptr));
+    }
+    return Handle.done();
+}
+
+bool TSerialClientSession::IsDone() const
+{
+    return !Handle || Handle.done();
+}
+
+std::chrono::steady_clock::time_point TSerialClientSession::GetResumeTime() const
+{
+    return Handle ? Handle.promise().ResumeTime : std::chrono::steady_clock::time_point();
+}
+
+TYieldBusAwaiter::TYieldBusAwaiter(std::chrono::steady_clock::time_point resumeTime): ResumeTime(resumeTime)
+{}
+
+bool TYieldBusAwaiter::await_ready() const noexcept
+{
+    return false;
+}
+
+void TYieldBusAwaiter::await_suspend(std::coroutine_handle<TSerialClientSession::promise_type> handle) noexcept
+{
+    handle.promise().Root->ResumeTime = ResumeTime;
+}
+
+void TYieldBusAwaiter::await_resume() const noexcept
+{}
+
+TYieldBusAwaiter YieldBus(std::chrono::steady_clock::time_point resumeTime)
+{
+    return TYieldBusAwaiter(resumeTime);
+}
+
+ISerialClientTask::TRunResult TSerialClientSessionTask::Run(PFeaturePort port,
+                                                            TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                                            const std::list<PSerialDevice>& polledDevices)
+{
+    if (!Session) {
+        Session = RunSession(port, lastAccessedDevice, polledDevices);
+    }
+    return Session->Resume() ? ISerialClientTask::TRunResult::OK : ISerialClientTask::TRunResult::SUSPENDED;
+}
+
+bool TSerialClientSessionTask::IsSessionSuspended() const
+{
+    return Session && !Session->IsDone();
+}
+
+std::chrono::steady_clock::time_point TSerialClientSessionTask::GetResumeTime() const
+{
+    return Session ? Session->GetResumeTime() : std::chrono::steady_clock::time_point();
+}
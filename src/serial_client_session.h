@@ -0,0 +1,177 @@
+#pragma once
+
+#include "serial_client.h"
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+
+/**
+ * @brief Coroutine of a long multi-step exchange on a port.
+ *        The coroutine suspends by co_await YieldBus() between transactions,
+ *        so the serial client polls registers and writes channels meanwhile.
+ *        A session can co_await other session, YieldBus in the nested session suspends the whole chain.
+ *        The coroutine is suspended at start and runs only from Resume or from the awaiting session.
+ *        Only serial client tasks can run sessions. Exchanges made while reading registers,
+ *        e.g. DLMS association or IEC handshake, still block the bus, as the poller can't suspend a range.
+ */
+class TSerialClientSession
+{
+public:
+    struct promise_type
+    {
+        std::exception_ptr Exception;
+
+        //! Session awaiting this one
+        std::coroutine_handle<promise_type> Parent;
+
+        //! Top level session of the chain
+        promise_type* Root = this;
+
+        //! Innermost session of the chain, is set in the top level session only
+        std::coroutine_handle<promise_type> Current;
+
+        //! The time to resume the chain after YieldBus, is set in the top level session only
+        std::chrono::steady_clock::time_point ResumeTime;
+
+        TSerialClientSession get_return_object();
+        std::suspend_always initial_suspend() noexcept;
+        auto final_suspend() noexcept;
+        void return_void();
+        void unhandled_exception();
+    };
+
+    TSerialClientSession(TSerialClientSession&& other) noexcept;
+    TSerialClientSession& operator=(TSerialClientSession&& other) noexcept;
+    ~TSerialClientSession();
+
+    TSerialClientSession(const TSerialClientSession&) = delete;
+    TSerialClientSession& operator=(const TSerialClientSession&) = delete;
+
+    /**
+     * @brief Runs the session till the next YieldBus or till the end.
+     *        An exception thrown by the session is rethrown.
+     *
+     * @return true if the session is finished
+     */
+    bool Resume();
+
+    bool IsDone() const;
+
+    //! The time requested by the last YieldBus, the session should not be resumed earlier
+    std::chrono::steady_clock::time_point GetResumeTime() const;
+
+    //! Awaiting runs the session as a part of the awaiting one
+    auto operator co_await() && noexcept;
+
+private:
+    std::coroutine_handle<promise_type> Handle;
+
+    explicit TSerialClientSession(std::coroutine_handle<promise_type> handle);
+};
+
+inline auto TSerialClientSession::promise_type::final_suspend() noexcept
+{
+    struct TFinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        // Continues the awaiting session if any
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+        {
+            auto& promise = handle.promise();
+            if (promise.Parent) {
+                promise.Root->Current = promise.Parent;
+                return promise.Parent;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept
+        {}
+    };
+    return TFinalAwaiter{};
+}
+
+inline auto TSerialClientSession::operator co_await() && noexcept
+{
+    struct TNestedAwaiter
+    {
+        std::coroutine_handle<promise_type> Handle;
+
+        bool await_ready() const noexcept
+        {
+            return !Handle || Handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> parent) noexcept
+        {
+            auto& promise = Handle.promise();
+            promise.Parent = parent;
+            promise.Root = parent.promise().Root;
+            promise.Root->Current = Handle;
+            return Handle;
+        }
+
+        void await_resume() const
+        {
+            if (Handle && Handle.promise().Exception) {
+                std::rethrow_exception(Handle.promise().Exception);
+            }
+        }
+    };
+    return TNestedAwaiter{Handle};
+}
+
+class TYieldBusAwaiter
+{
+public:
+    explicit TYieldBusAwaiter(std::chrono::steady_clock::time_point resumeTime);
+
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<TSerialClientSession::promise_type> handle) noexcept;
+    void await_resume() const noexcept;
+
+private:
+    std::chrono::steady_clock::time_point ResumeTime;
+};
+
+/**
+ * @brief Suspends the session and gives the bus to other tasks and polling
+ *
+ * @param resumeTime the session is not resumed before the time
+ */
+TYieldBusAwaiter YieldBus(std::chrono::steady_clock::time_point resumeTime = {});
+
+/**
+ * @brief Task running a session. The session is started on the first run and resumed on next runs.
+ *        Run returns SUSPENDED while the session is not finished.
+ *        The serial client passes the same lastAccessedDevice and polledDevices to every run,
+ *        so the session can keep references to them.
+ *        Other devices can be accessed while the session is suspended,
+ *        so the session must call lastAccessedDevice.PrepareToAccess after YieldBus.
+ */
+class TSerialClientSessionTask: public ISerialClientTask
+{
+public:
+    ISerialClientTask::TRunResult Run(PFeaturePort port,
+                                      TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                      const std::list<PSerialDevice>& polledDevices) override;
+
+    std::chrono::steady_clock::time_point GetResumeTime() const override;
+
+protected:
+    virtual TSerialClientSession RunSession(PFeaturePort port,
+                                            TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                            const std::list<PSerialDevice>& polledDevices) = 0;
+
+    //! Checks if the session is started and not finished, e.g. the task is destroyed in the middle of the session
+    bool IsSessionSuspended() const;
+
+private:
+    std::optional<TSerialClientSession> Session;
+};
@@ -0,0 +1,43 @@
+#include "serial_client_task_queue.h"
+#include "write_channel_serial_client_task.h"
+
+void TSerialClientTaskQueue::AddTask(PSerialClientTask task)
+{
+    {
+        std::unique_lock<std::mutex> lock(Mutex);
+        Tasks.push_back(task);
+    }
+    Cv.notify_all();
+}
+
+bool TSerialClientTaskQueue::AddWrite(PWriteChannelSerialClientTask task)
+{
+    {
+        std::unique_lock<std::mutex> lock(Mutex);
+        auto res = QueuedWrites.emplace(task->GetHandler(), task);
+        if (!res.second) {
+            res.first->second->Join(*task);
+            return false;
+        }
+        Tasks.push_back(task);
+    }
+    Cv.notify_all();
+    return true;
+}
+
+std::vector<PSerialClientTask> TSerialClientTaskQueue::WaitAndTake(std::chrono::steady_clock::time_point deadline)
+{
+    std::vector<PSerialClientTask> res;
+    std::unique_lock<std::mutex> lock(Mutex);
+    if (Cv.wait_until(lock, deadline, [this]() { return !Tasks.empty(); })) {
+        Tasks.swap(res);
+        QueuedWrites.clear();
+    }
+    return res;
+}
+
+size_t TSerialClientTaskQueue::Size() const
+{
+    std::unique_lock<std::mutex> lock(Mutex);
+    return Tasks.size();
+}
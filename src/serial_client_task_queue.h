@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class ISerialClientTask;
+typedef std::shared_ptr<ISerialClientTask> PSerialClientTask;
+
+class TRegisterHandler;
+typedef std::shared_ptr<TRegisterHandler> PRegisterHandler;
+
+class TWriteChannelSerialClientTask;
+typedef std::shared_ptr<TWriteChannelSerialClientTask> PWriteChannelSerialClientTask;
+
+/**
+ * @brief Tasks queue of a serial client.
+ *        Channel writes are deduplicated per register: if the register already has a queued write,
+ *        a new write doesn't add a task. The queued task writes the latest value set to the register
+ *        and completes all joined writes, so a burst of values is sent to the bus once.
+ */
+class TSerialClientTaskQueue
+{
+public:
+    void AddTask(PSerialClientTask task);
+
+    /**
+     * @brief Queues channel write. The register value must be set in the task handler before the call.
+     *
+     * @return false if the write has joined already queued write of the same register
+     */
+    bool AddWrite(PWriteChannelSerialClientTask task);
+
+    /**
+     * @brief Waits for tasks until the deadline and takes all queued tasks.
+     *        Taken writes are not joined by following writes anymore.
+     *
+     * @return empty vector if there are no tasks before the deadline
+     */
+    std::vector<PSerialClientTask> WaitAndTake(std::chrono::steady_clock::time_point deadline);
+
+    //! Number of queued tasks
+    size_t Size() const;
+
+private:
+    mutable std::mutex Mutex;
+    std::condition_variable Cv;
+    std::vector<PSerialClientTask> Tasks;
+    std::unordered_map<PRegisterHandler, PWriteChannelSerialClientTask> QueuedWrites;
+};
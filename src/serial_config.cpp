@@ -412,6 +412,13 @@ namespace
 
         Get(channel_data, "units", channel->Units);
 
+        Get(channel_data, "deadband", channel->Deadband);
+        Get(channel_data, "deadband_percent", channel->DeadbandPercent);
+        std::chrono::seconds maxUnchangedInterval;
+        if (Get(channel_data, "max_unchanged_interval", maxUnchangedInterval)) {
+            channel->MaxUnchangedInterval = maxUnchangedInterval;
+        }
+
         if (IsSerialNumberChannel(channel_data) && registers.size()) {
             deviceWithChannels.Device->SetSnRegister(registers[0]->GetConfig());
         }
@@ -626,6 +633,14 @@ namespace
         Get(port_data, "connection_timeout_ms", port_config->OpenCloseSettings.MaxFailTime);
         Get(port_data, "connection_max_fail_cycles", port_config->OpenCloseSettings.ConnectionMaxFailCycles);
 
+        Get(port_data, "disconnected_poll_backoff", port_config->DisconnectedPollSettings.Backoff);
+        Get(port_data, "disconnected_poll_max_delay_ms", port_config->DisconnectedPollSettings.MaxDelay);
+        if (port_data.isMember("disconnected_poll_max_bus_share")) {
+            port_config->DisconnectedPollSettings.MaxBusShare =
+                port_data["disconnected_poll_max_bus_share"].asDouble() / 100.0;
+        }
+        Get(port_data, "write_latency_budget_ms", port_config->WriteLatencyBudget);
+
         port_config->Port = portFactory(port_data, rpcConfig);
 
         std::chrono::milliseconds responseTimeout = RESPONSE_TIMEOUT_NOT_SET;
@@ -744,6 +759,9 @@ PHandlerConfig LoadConfig(const std::string& configFileName,
     }
     handlerConfig->PublishParameters.Set(maxUnchangedInterval.count());
 
+    Get(Root, "value_snapshot_file", handlerConfig->ValueSnapshotFile);
+    Get(Root, "local_api_socket", handlerConfig->LocalApiSocket);
+
     const Json::Value& array = Root["ports"];
     for (Json::Value::ArrayIndex index = 0; index < array.size(); ++index) {
         // old default prefix for compat
@@ -1072,6 +1090,8 @@ void LoadCommonDeviceParameters(TDeviceConfig& device_config, const Json::Value&
     Get(device_data, "access_level", device_config.AccessLevel);
     Get(device_data, "min_request_interval", device_config.MinRequestInterval);
     Get(device_data, "preserve_setup_order", device_config.PreserveSetupOrder);
+    Get(device_data, "postpone_poll_after_write", device_config.PostponePollAfterWrite);
+    Get(device_data, "events_heartbeat_period_ms", device_config.EventsHeartbeatPeriod);
 }
 
 PDeviceConfig LoadDeviceConfig(const Json::Value& dev,
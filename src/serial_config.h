@@ -12,6 +12,7 @@
 #include <wblib/json_utils.h>
 
 #include "confed_protocol_schemas_map.h"
+#include "disconnected_poll_quarantine.h"
 #include "port/feature_port.h"
 #include "rpc/rpc_config.h"
 #include "serial_device.h"
@@ -32,6 +33,8 @@ struct TPortConfig
     std::optional<std::chrono::milliseconds> ReadRateLimit;
     std::chrono::microseconds RequestDelay = std::chrono::microseconds::zero();
     TPortOpenCloseLogic::TSettings OpenCloseSettings;
+    TDisconnectedPollSettings DisconnectedPollSettings;
+    std::chrono::milliseconds WriteLatencyBudget = std::chrono::milliseconds::zero();
 
     void AddDevice(PSerialDeviceWithChannels device);
 };
@@ -45,6 +48,12 @@ struct THandlerConfig
     size_t LowPriorityRegistersRateLimit;
     std::vector<PPortConfig> PortConfigs;
 
+    //! Path of shared memory snapshot of channel values, empty if export is disabled
+    std::string ValueSnapshotFile;
+
+    //! Path of local API Unix socket, empty if local API is disabled
+    std::string LocalApiSocket;
+
     void AddPortConfig(PPortConfig portConfig);
 };
 
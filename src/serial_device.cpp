@@ -151,6 +151,29 @@ void TSerialDevice::WriteRegister(TPort& port, PRegister reg, uint64_t value)
     WriteRegister(port, reg, TRegisterValue{value});
 }
 
+void TSerialDevice::WriteRegisters(TPort& port, std::vector<TRegisterWriteRequest>& requests)
+{
+    WriteRegistersImpl(port, requests);
+    bool ok = false;
+    for (const auto& request: requests) {
+        if (!request.Error) {
+            ok = true;
+            break;
+        }
+        try {
+            std::rethrow_exception(request.Error);
+        } catch (const TSerialDevicePermanentRegisterException& e) {
+            // The device has responded
+            ok = true;
+            break;
+        } catch (const TSerialDeviceException& e) {
+        }
+    }
+    if (!requests.empty()) {
+        SetTransferResult(ok);
+    }
+}
+
 TRegisterValue TSerialDevice::ReadRegisterImpl(TPort& port, const TRegisterConfig& reg)
 {
     throw TSerialDeviceException("single register reading is not supported");
@@ -161,6 +184,17 @@ void TSerialDevice::WriteRegisterImpl(TPort& port, const TRegisterConfig& reg, c
     throw TSerialDeviceException(ToString() + ": register writing is not supported");
 }
 
+void TSerialDevice::WriteRegistersImpl(TPort& port, std::vector<TRegisterWriteRequest>& requests)
+{
+    for (auto& request: requests) {
+        try {
+            WriteRegisterImpl(port, *request.Register->GetConfig(), request.Value);
+        } catch (const TSerialDeviceException& e) {
+            request.Error = std::current_exception();
+        }
+    }
+}
+
 void TSerialDevice::ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError)
 {
     for (auto& reg: range->RegisterList()) {
@@ -244,6 +278,20 @@ void TSerialDevice::WriteSetupRegisters(TPort& port, const TDeviceSetupItems& se
     }
 }
 
+TSessionSetupStats TSerialDevice::GetSessionSetupStats() const
+{
+    std::unique_lock lock(SessionSetupStatsMutex);
+    return SessionSetupStats;
+}
+
+void TSerialDevice::AddSessionSetupTime(std::chrono::microseconds time)
+{
+    std::unique_lock lock(SessionSetupStatsMutex);
+    ++SessionSetupStats.Count;
+    SessionSetupStats.Last = time;
+    SessionSetupStats.Total += time;
+}
+
 PDeviceConfig TSerialDevice::DeviceConfig() const
 {
     return _DeviceConfig;
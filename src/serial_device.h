@@ -5,6 +5,7 @@
 #include <iostream>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <stdint.h>
 #include <string>
@@ -33,6 +34,15 @@ struct TDeviceChannelConfig
     std::string Units;
     std::vector<PRegister> Registers;
 
+    //! Numeric value is not published if it differs from last published one less than the deadband
+    double Deadband = 0;
+
+    //! Same as Deadband, but in percents of last published value
+    double DeadbandPercent = 0;
+
+    //! Overrides global max_unchanged_interval for the channel
+    std::optional<std::chrono::milliseconds> MaxUnchangedInterval;
+
     TDeviceChannelConfig(const std::string& type = "text",
                          const std::string& deviceId = "",
                          int order = 0,
@@ -80,6 +90,8 @@ const int DEFAULT_DEVICE_FAIL_CYCLES = 2;
 const std::chrono::milliseconds DefaultDeviceTimeout(3000);
 const std::chrono::seconds MaxUnchangedIntervalLowLimit(5);
 const std::chrono::seconds DefaultMaxUnchangedInterval(-1);
+//! Max unchanged interval of channels with deadband if it is not set in config
+const std::chrono::seconds DefaultDeadbandMaxUnchangedInterval(60);
 const std::chrono::seconds DefaultMaxWriteFailTime(600);
 
 struct TDeviceConfig
@@ -136,6 +148,14 @@ struct TDeviceConfig
     //! instead of being permanently excluded.
     bool ContinuePollingOnIllegalModbusException = false;
 
+    //! If true, a register successfully written to the device is not polled until its read period elapses,
+    //! the written value is published as read one
+    bool PostponePollAfterWrite = false;
+
+    //! If not zero, semi-sporadic registers with successfully enabled Fast Modbus events are polled with this period.
+    //! Usual polling is restored if events reading fails or the device is disconnected
+    std::chrono::milliseconds EventsHeartbeatPeriod = std::chrono::milliseconds::zero();
+
     explicit TDeviceConfig(const std::string& name = "",
                            const std::string& slave_id = "",
                            const std::string& protocol = "");
@@ -192,6 +212,26 @@ enum class TDevicePrepareMode
     WITHOUT_SETUP
 };
 
+//! A register value to be written by TSerialDevice::WriteRegisters
+struct TRegisterWriteRequest
+{
+    PRegister Register;
+    TRegisterValue Value;
+
+    //! Exception thrown while writing the register, empty on success
+    std::exception_ptr Error;
+};
+
+//! Statistics of communication session setups for protocols with sessions
+struct TSessionSetupStats
+{
+    //! Number of successfully opened sessions
+    uint64_t Count = 0;
+
+    std::chrono::microseconds Last = std::chrono::microseconds::zero();
+    std::chrono::microseconds Total = std::chrono::microseconds::zero();
+};
+
 class TSerialDevice: public std::enable_shared_from_this<TSerialDevice>
 {
 public:
@@ -223,6 +263,15 @@ public:
 
     void WriteRegister(TPort& port, PRegister reg, uint64_t value);
 
+    /**
+     * @brief Write several registers of the device. Errors are stored in requests, so a failed write
+     *        doesn't stop writing of other registers.
+     *        Requests are written in the given order.
+     *
+     * @throws exceptions not inherited from TSerialDeviceException
+     */
+    void WriteRegisters(TPort& port, std::vector<TRegisterWriteRequest>& requests);
+
     /**
      * Reads multiple registers.
      * Throws exceptions inherited from TSerialDeviceException.
@@ -283,11 +332,24 @@ public:
     virtual std::chrono::milliseconds GetFrameTimeout(TPort& port) const;
     virtual std::chrono::milliseconds GetResponseTimeout(TPort& port) const;
 
+    //! Can be called from any thread
+    TSessionSetupStats GetSessionSetupStats() const;
+
 protected:
     virtual void PrepareImpl(TPort& port);
     virtual TRegisterValue ReadRegisterImpl(TPort& port, const TRegisterConfig& reg);
     virtual void WriteRegisterImpl(TPort& port, const TRegisterConfig& reg, const TRegisterValue& value);
 
+    /**
+     * @brief Write several registers. Default implementation writes registers one by one,
+     *        devices supporting multi-register writes can combine adjacent registers into one request.
+     *        Exceptions inherited from TSerialDeviceException must be stored in TRegisterWriteRequest::Error.
+     */
+    virtual void WriteRegistersImpl(TPort& port, std::vector<TRegisterWriteRequest>& requests);
+
+    //! Must be called by devices with sessions after successful session setup
+    void AddSessionSetupTime(std::chrono::microseconds time);
+
 private:
     PDeviceConfig _DeviceConfig;
     PProtocol _Protocol;
@@ -308,6 +370,9 @@ private:
     std::unordered_map<std::string, PDeviceSetupItem> SetupItemsByAddress;
     TDeviceSetupItems SetupItems;
 
+    mutable std::mutex SessionSetupStatsMutex;
+    TSessionSetupStats SessionSetupStats;
+
     void SetConnectionState(TDeviceConnectionState state);
 };
 
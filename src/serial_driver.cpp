@@ -30,12 +30,76 @@ namespace
         }
         return res;
     }
+
+    class TLocalApiBackend: public ILocalApiBackend
+    {
+    public:
+        TLocalApiBackend(const std::vector<PSerialPortDriver>& portDrivers)
+        {
+            for (const auto& portDriver: portDrivers) {
+                for (const auto& channel: portDriver->GetChannels()) {
+                    Channels.emplace(channel->DeviceId + "/" + channel->MqttId, std::make_pair(portDriver, channel));
+                }
+            }
+        }
+
+        LocalApi::TReadResult Read(const std::string& channelId) override
+        {
+            LocalApi::TReadResult res;
+            auto it = Channels.find(channelId);
+            if (it == Channels.end()) {
+                res.Status = LocalApi::TStatus::NotFound;
+                return res;
+            }
+            auto state = it->second.second->GetState();
+            if (state.Value) {
+                res.Value = *state.Value;
+            } else {
+                res.Status = LocalApi::TStatus::NoValue;
+            }
+            res.Error = state.Error;
+            return res;
+        }
+
+        void Write(const std::string& channelId, const std::string& value, TWriteCallback callback) override
+        {
+            auto it = Channels.find(channelId);
+            if (it == Channels.end()) {
+                callback(LocalApi::TWriteResult{LocalApi::TStatus::NotFound, std::string()});
+                return;
+            }
+            it->second.first->WriteChannel(
+                it->second.second,
+                value,
+                [callback](TSerialPortDriver::TChannelWriteResult result, const std::string& error) {
+                    switch (result) {
+                        case TSerialPortDriver::TChannelWriteResult::Ok:
+                            callback(LocalApi::TWriteResult{LocalApi::TStatus::Ok, std::string()});
+                            break;
+                        case TSerialPortDriver::TChannelWriteResult::InvalidValue:
+                            callback(LocalApi::TWriteResult{LocalApi::TStatus::InvalidValue, error});
+                            break;
+                        case TSerialPortDriver::TChannelWriteResult::WriteError:
+                            callback(LocalApi::TWriteResult{LocalApi::TStatus::WriteError, error});
+                            break;
+                    }
+                });
+        }
+
+    private:
+        std::unordered_map<std::string, std::pair<PSerialPortDriver, PDeviceChannel>> Channels;
+    };
 }
 
 TMQTTSerialDriver::TMQTTSerialDriver(PDeviceDriver mqttDriver, PHandlerConfig config): Active(false)
 {
     try {
         size_t totalChannels = GetChannelsCount(config);
+        PValueSnapshotWriter valueSnapshot;
+        if (!config->ValueSnapshotFile.empty()) {
+            valueSnapshot = make_shared<TValueSnapshotWriter>(config->ValueSnapshotFile, totalChannels);
+            LOG(Info) << "channel values are exported to " << config->ValueSnapshotFile;
+        }
         for (const auto& portConfig: config->PortConfigs) {
             auto rateLimit = config->LowPriorityRegistersRateLimit;
             if (totalChannels != 0) {
@@ -45,10 +109,18 @@ TMQTTSerialDriver::TMQTTSerialDriver(PDeviceDriver mqttDriver, PHandlerConfig co
             if (rateLimit < 1) {
                 rateLimit = 1;
             }
-            PortDrivers.push_back(
-                make_shared<TSerialPortDriver>(mqttDriver, portConfig, config->PublishParameters, rateLimit));
+            PortDrivers.push_back(make_shared<TSerialPortDriver>(mqttDriver,
+                                                                 portConfig,
+                                                                 config->PublishParameters,
+                                                                 rateLimit,
+                                                                 valueSnapshot));
             PortDrivers.back()->SetUpDevices();
         }
+        if (!config->LocalApiSocket.empty()) {
+            LocalApiServer =
+                make_shared<TLocalApiServer>(config->LocalApiSocket, make_shared<TLocalApiBackend>(PortDrivers));
+            LOG(Info) << "local API is available at " << config->LocalApiSocket;
+        }
     } catch (const exception& e) {
         LOG(Error) << "unable to create port driver: '" << e.what() << "'. Cleaning.";
         ClearDevices();
@@ -94,6 +166,10 @@ void TMQTTSerialDriver::Start()
             }
         });
     }
+
+    if (LocalApiServer) {
+        LocalApiServer->Start();
+    }
 }
 
 void TMQTTSerialDriver::Stop()
@@ -107,6 +183,11 @@ void TMQTTSerialDriver::Stop()
         Active = false;
     }
 
+    // Channels must not be accessed by local API after ClearDevices
+    if (LocalApiServer) {
+        LocalApiServer->Stop();
+    }
+
     for (auto& loopThread: PortLoops) {
         if (loopThread.joinable()) {
             loopThread.join();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "local_api_server.h"
 #include "serial_port_driver.h"
 
 class TMQTTSerialDriver
@@ -16,6 +17,7 @@ public:
 
 private:
     std::vector<PSerialPortDriver> PortDrivers;
+    PLocalApiServer LocalApiServer;
     std::vector<std::thread> PortLoops;
     std::mutex ActiveMutex;
     bool Active;
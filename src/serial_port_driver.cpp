@@ -16,19 +16,98 @@ using namespace WBMQTT;
 
 #define LOG(logger) ::logger.Log() << "[serial port driver] "
 
+namespace
+{
+    std::string GetErrorText(const TRegister::TErrorState& errorState)
+    {
+        const std::unordered_map<TRegister::TError, std::string> errorNames = {
+            {TRegister::TError::ReadError, "r"},
+            {TRegister::TError::WriteError, "w"},
+            {TRegister::TError::PollIntervalMissError, "p"}};
+        std::string errorText;
+        for (size_t i = 0; i < TRegister::TError::MAX_ERRORS; ++i) {
+            if (errorState.test(i)) {
+                auto itName = errorNames.find(static_cast<TRegister::TError>(i));
+                if (itName != errorNames.end()) {
+                    errorText += itName->second;
+                }
+            }
+        }
+        return errorText;
+    }
+
+    uint32_t GetValueSnapshotFlags(const TRegister::TErrorState& errorState)
+    {
+        uint32_t flags = 0;
+        if (errorState.test(TRegister::TError::ReadError)) {
+            flags |= ValueSnapshot::ReadError;
+        }
+        if (errorState.test(TRegister::TError::WriteError)) {
+            flags |= ValueSnapshot::WriteError;
+        }
+        if (errorState.test(TRegister::TError::PollIntervalMissError)) {
+            flags |= ValueSnapshot::PollIntervalMissError;
+        }
+        return flags;
+    }
+
+    //! Collects results of writes of all channel's registers
+    class TChannelWriteCompletion
+    {
+    public:
+        TChannelWriteCompletion(size_t registersCount, TSerialPortDriver::TChannelWriteCallback callback)
+            : Remaining(registersCount),
+              Callback(callback)
+        {}
+
+        void Complete(TSerialPortDriver::TChannelWriteResult result,
+                      const std::string& error,
+                      size_t registersCount = 1)
+        {
+            TSerialPortDriver::TChannelWriteCallback callback;
+            {
+                std::unique_lock<std::mutex> lock(Mutex);
+                if (Result == TSerialPortDriver::TChannelWriteResult::Ok) {
+                    Result = result;
+                    Error = error;
+                }
+                Remaining -= std::min(registersCount, Remaining);
+                if (Remaining != 0) {
+                    return;
+                }
+                callback.swap(Callback);
+            }
+            if (callback) {
+                callback(Result, Error);
+            }
+        }
+
+    private:
+        std::mutex Mutex;
+        size_t Remaining;
+        TSerialPortDriver::TChannelWriteResult Result = TSerialPortDriver::TChannelWriteResult::Ok;
+        std::string Error;
+        TSerialPortDriver::TChannelWriteCallback Callback;
+    };
+}
+
 TSerialPortDriver::TSerialPortDriver(WBMQTT::PDeviceDriver mqttDriver,
                                      PPortConfig portConfig,
                                      const WBMQTT::TPublishParameters& publishPolicy,
-                                     size_t lowPriorityRateLimit)
+                                     size_t lowPriorityRateLimit,
+                                     PValueSnapshotWriter valueSnapshot)
     : MqttDriver(mqttDriver),
       Config(portConfig),
-      PublishPolicy(publishPolicy)
+      PublishPolicy(publishPolicy),
+      ValueSnapshot(valueSnapshot)
 {
     Description = Config->Port->GetDescription(false);
     SerialClient = PSerialClient(new TSerialClient(Config->Port,
                                                    Config->OpenCloseSettings,
                                                    std::chrono::steady_clock::now,
-                                                   lowPriorityRateLimit));
+                                                   lowPriorityRateLimit,
+                                                   Config->DisconnectedPollSettings,
+                                                   Config->WriteLatencyBudget));
 }
 
 const std::string& TSerialPortDriver::GetShortDescription() const
@@ -57,6 +136,14 @@ void TSerialPortDriver::SetUpDevices()
                 try {
                     auto channel = std::make_shared<TDeviceChannel>(device->Device, channelConfig);
                     channel->Control = mqttDevice->CreateControl(tx, From(channel)).GetValue();
+                    if (ValueSnapshot) {
+                        auto slot = ValueSnapshot->AllocateSlot(channel->DeviceId + "/" + channel->MqttId);
+                        if (slot) {
+                            channel->SetValueSnapshot(ValueSnapshot, *slot);
+                        } else {
+                            LOG(Warn) << "no value snapshot slot for " << channel->Describe();
+                        }
+                    }
                     for (const auto& reg: channel->Registers) {
                         RegisterToChannelMap.emplace(reg, channel);
                     }
@@ -105,7 +192,16 @@ void TSerialPortDriver::HandleControlOnValueEvent(const WBMQTT::TControlOnValueE
     portDriver->SetValueToChannel(channel, value);
 }
 
-void TSerialPortDriver::SetValueToChannel(const PDeviceChannel& channel, const string& value)
+void TSerialPortDriver::WriteChannel(const PDeviceChannel& channel,
+                                     const std::string& value,
+                                     TChannelWriteCallback onComplete)
+{
+    SetValueToChannel(channel, value, onComplete);
+}
+
+void TSerialPortDriver::SetValueToChannel(const PDeviceChannel& channel,
+                                          const string& value,
+                                          TChannelWriteCallback onComplete)
 {
     const auto& registers = channel->Registers;
 
@@ -113,9 +209,21 @@ void TSerialPortDriver::SetValueToChannel(const PDeviceChannel& channel, const s
 
     if (valueItems.size() != registers.size()) {
         LOG(Warn) << "invalid value for " << channel->Describe() << ": '" << value << "'";
+        if (onComplete) {
+            onComplete(TChannelWriteResult::InvalidValue, "number of values doesn't match number of registers");
+        }
         return;
     }
 
+    std::function<void(const std::string& error)> onRegisterWriteComplete;
+    std::shared_ptr<TChannelWriteCompletion> completion;
+    if (onComplete) {
+        completion = std::make_shared<TChannelWriteCompletion>(registers.size(), onComplete);
+        onRegisterWriteComplete = [completion](const std::string& error) {
+            completion->Complete(error.empty() ? TChannelWriteResult::Ok : TChannelWriteResult::WriteError, error);
+        };
+    }
+
     for (size_t i = 0; i < registers.size(); ++i) {
         PRegister reg = registers[i];
         LOG(Debug) << "setting device register: " << reg->ToString() << " <- " << valueItems[i];
@@ -127,10 +235,13 @@ void TSerialPortDriver::SetValueToChannel(const PDeviceChannel& channel, const s
             } else if (!channel->OffValue.empty() && valueItems[i] == "0") {
                 valueToSet = channel->OffValue;
             }
-            SerialClient->SetTextValue(reg, valueToSet);
+            SerialClient->SetTextValue(reg, valueToSet, onRegisterWriteComplete);
 
         } catch (std::exception& err) {
             LOG(Warn) << "invalid value for " << channel->Describe() << ": '" << value << "' : " << err.what();
+            if (completion) {
+                completion->Complete(TChannelWriteResult::InvalidValue, err.what(), registers.size() - i);
+            }
             return;
         }
     }
@@ -284,6 +395,18 @@ PSerialClient TSerialPortDriver::GetSerialClient()
     return SerialClient;
 }
 
+std::vector<PDeviceChannel> TSerialPortDriver::GetChannels() const
+{
+    std::vector<PDeviceChannel> res;
+    for (const auto& device: Devices) {
+        auto it = DeviceToChannelsMap.find(device);
+        if (it != DeviceToChannelsMap.end()) {
+            res.insert(res.end(), it->second.begin(), it->second.end());
+        }
+    }
+    return res;
+}
+
 TDeviceChannel::TDeviceChannel(PSerialDevice device, PDeviceChannelConfig config)
     : TDeviceChannelConfig(*config),
       Device(device),
@@ -315,7 +438,19 @@ void TDeviceChannel::UpdateValueAndError(WBMQTT::TDeviceDriver& deviceDriver,
         UpdateError(deviceDriver);
         return;
     }
-    auto error = GetErrorText();
+    auto errorState = GetErrorState();
+    auto error = GetErrorText(errorState);
+    if (ValueSnapshot) {
+        ValueSnapshot->Update(ValueSnapshotSlot,
+                              value,
+                              GetValueSnapshotFlags(errorState),
+                              std::chrono::steady_clock::now());
+    }
+    {
+        std::unique_lock<std::mutex> lock(StateMutex);
+        State.Value = value;
+        State.Error = error;
+    }
     bool errorIsChanged = (CachedErrorText != error);
     if (ShouldNotPublishPressCounter()) {
         if (errorIsChanged) {
@@ -325,10 +460,14 @@ void TDeviceChannel::UpdateValueAndError(WBMQTT::TDeviceDriver& deviceDriver,
         return;
     }
     PublishNextZeroPressCounter = true;
+    std::optional<double> numericValue;
+    if (Deadband > 0 || DeadbandPercent > 0) {
+        numericValue = GetNumericValue();
+    }
     switch (publishPolicy.Policy) {
         case TPublishParameters::PublishOnlyOnChange: {
-            if (CachedCurrentValue != value) {
-                PublishValueAndError(deviceDriver, value, error);
+            if (IsValueChanged(value, numericValue) || IsMaxUnchangedIntervalElapsed(publishPolicy)) {
+                PublishValueAndError(deviceDriver, value, numericValue, error);
             } else {
                 if (errorIsChanged) {
                     PublishError(deviceDriver, error);
@@ -337,51 +476,87 @@ void TDeviceChannel::UpdateValueAndError(WBMQTT::TDeviceDriver& deviceDriver,
             break;
         }
         case TPublishParameters::PublishAll: {
-            PublishValueAndError(deviceDriver, value, error);
+            PublishValueAndError(deviceDriver, value, numericValue, error);
             break;
         }
         case TPublishParameters::PublishSomeUnchanged: {
-            auto now = std::chrono::steady_clock::now();
-            if (errorIsChanged || (CachedCurrentValue != value) ||
-                (now - LastControlUpdate >= publishPolicy.PublishUnchangedInterval))
+            if (errorIsChanged || IsValueChanged(value, numericValue) || IsMaxUnchangedIntervalElapsed(publishPolicy))
             {
-                PublishValueAndError(deviceDriver, value, error);
+                PublishValueAndError(deviceDriver, value, numericValue, error);
             }
             break;
         }
     }
 }
 
+bool TDeviceChannel::IsValueChanged(const std::string& value, const std::optional<double>& numericValue) const
+{
+    if (CachedCurrentValue == value) {
+        return false;
+    }
+    if ((Deadband <= 0 && DeadbandPercent <= 0) || !numericValue || !CachedCurrentNumericValue) {
+        return true;
+    }
+    auto threshold = std::max(Deadband, std::abs(*CachedCurrentNumericValue) * DeadbandPercent / 100.0);
+    return std::abs(*numericValue - *CachedCurrentNumericValue) >= threshold;
+}
+
+bool TDeviceChannel::IsMaxUnchangedIntervalElapsed(const WBMQTT::TPublishParameters& publishPolicy) const
+{
+    std::chrono::milliseconds interval;
+    if (MaxUnchangedInterval) {
+        interval = *MaxUnchangedInterval;
+    } else if (publishPolicy.Policy == TPublishParameters::PublishSomeUnchanged) {
+        interval = publishPolicy.PublishUnchangedInterval;
+    } else if (Deadband > 0 || DeadbandPercent > 0) {
+        // Small changes are not published, so the value must be refreshed from time to time
+        interval = DefaultDeadbandMaxUnchangedInterval;
+    } else {
+        return false;
+    }
+    return std::chrono::steady_clock::now() - LastControlUpdate >= interval;
+}
+
 void TDeviceChannel::UpdateError(WBMQTT::TDeviceDriver& deviceDriver)
 {
-    PublishError(deviceDriver, GetErrorText());
+    auto errorState = GetErrorState();
+    if (ValueSnapshot) {
+        ValueSnapshot->UpdateFlags(ValueSnapshotSlot,
+                                   GetValueSnapshotFlags(errorState),
+                                   std::chrono::steady_clock::now());
+    }
+    auto error = GetErrorText(errorState);
+    {
+        std::unique_lock<std::mutex> lock(StateMutex);
+        State.Error = error;
+    }
+    PublishError(deviceDriver, error);
+}
+
+TDeviceChannelState TDeviceChannel::GetState() const
+{
+    std::unique_lock<std::mutex> lock(StateMutex);
+    return State;
+}
+
+void TDeviceChannel::SetValueSnapshot(PValueSnapshotWriter writer, size_t slot)
+{
+    ValueSnapshot = writer;
+    ValueSnapshotSlot = slot;
 }
 
-std::string TDeviceChannel::GetErrorText() const
+TRegister::TErrorState TDeviceChannel::GetErrorState() const
 {
     TRegister::TErrorState errorState;
     for (auto r: Registers) {
         errorState |= r->GetErrorState();
     }
-
-    const std::unordered_map<TRegister::TError, std::string> errorNames = {
-        {TRegister::TError::ReadError, "r"},
-        {TRegister::TError::WriteError, "w"},
-        {TRegister::TError::PollIntervalMissError, "p"}};
-    std::string errorText;
-    for (size_t i = 0; i < TRegister::TError::MAX_ERRORS; ++i) {
-        if (errorState.test(i)) {
-            auto itName = errorNames.find(static_cast<TRegister::TError>(i));
-            if (itName != errorNames.end()) {
-                errorText += itName->second;
-            }
-        }
-    }
-    return errorText;
+    return errorState;
 }
 
 void TDeviceChannel::PublishValueAndError(WBMQTT::TDeviceDriver& deviceDriver,
                                           const std::string& value,
+                                          const std::optional<double>& numericValue,
                                           const std::string& error)
 {
     if (::Debug.IsEnabled()) {
@@ -393,6 +568,7 @@ void TDeviceChannel::PublishValueAndError(WBMQTT::TDeviceDriver& deviceDriver,
         LOG(Debug) << ss.str();
     }
     CachedCurrentValue = value;
+    CachedCurrentNumericValue = numericValue;
     CachedErrorText = error;
     LastControlUpdate = std::chrono::steady_clock::now();
     {
@@ -438,6 +614,15 @@ std::string TDeviceChannel::GetTextValue() const
     return value;
 }
 
+std::optional<double> TDeviceChannel::GetNumericValue() const
+{
+    // Deadband is applied only to single register values without text mapping
+    if (Registers.size() != 1 || !OnValue.empty() || !OffValue.empty()) {
+        return std::nullopt;
+    }
+    return ConvertFromRawValueToNumber(*Registers.front()->GetConfig(), Registers.front()->GetValue());
+}
+
 bool TDeviceChannel::HasValuesOfAllRegisters() const
 {
     for (const auto& r: Registers) {
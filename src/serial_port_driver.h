@@ -2,13 +2,25 @@
 #include "register_handler.h"
 #include "serial_client.h"
 #include "serial_config.h"
+#include "value_snapshot.h"
 
 #include <wblib/declarations.h>
 
 #include <chrono>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
 
+struct TDeviceChannelState
+{
+    //! Last read value, nullopt if the value is not read yet
+    std::optional<std::string> Value;
+
+    //! Errors as published to MQTT
+    std::string Error;
+};
+
 struct TDeviceChannel: public TDeviceChannelConfig
 {
     TDeviceChannel(PSerialDevice device, PDeviceChannelConfig config);
@@ -22,13 +34,23 @@ struct TDeviceChannel: public TDeviceChannelConfig
 
     void DoNotPublishNextZeroPressCounter();
 
+    //! Export channel's value and errors to shared memory snapshot, the slot must be allocated by the caller
+    void SetValueSnapshot(PValueSnapshotWriter writer, size_t slot);
+
+    //! Last read value and errors, the method is thread safe
+    TDeviceChannelState GetState() const;
+
     PSerialDevice Device;
     WBMQTT::PControl Control;
 
 private:
     std::string GetTextValue() const;
-    std::string GetErrorText() const;
-    void PublishValueAndError(WBMQTT::TDeviceDriver& deviceDriver, const std::string& value, const std::string& error);
+    std::optional<double> GetNumericValue() const;
+    TRegister::TErrorState GetErrorState() const;
+    void PublishValueAndError(WBMQTT::TDeviceDriver& deviceDriver,
+                              const std::string& value,
+                              const std::optional<double>& numericValue,
+                              const std::string& error);
     void PublishError(WBMQTT::TDeviceDriver& deviceDriver, const std::string& error);
 
     /* Wiren Board devices reset press counters to 0 after reboot.
@@ -36,6 +58,11 @@ private:
     */
     bool ShouldNotPublishPressCounter() const;
 
+    //! Checks if the value differs from last published one more than the deadband
+    bool IsValueChanged(const std::string& value, const std::optional<double>& numericValue) const;
+
+    bool IsMaxUnchangedIntervalElapsed(const WBMQTT::TPublishParameters& publishPolicy) const;
+
     /* Current value of a channel, error flag and last update time.
        They are used to prevent unnecessary calls to libwbmqtt1.
        Although libwbmqtt1 implements publishing control with TPublishParams,
@@ -43,9 +70,16 @@ private:
        So we implement publish control logic in wb-mqtt-serial until libwbmqtt1 is fixed.
     */
     std::string CachedCurrentValue;
+    std::optional<double> CachedCurrentNumericValue;
     std::string CachedErrorText;
     std::chrono::steady_clock::time_point LastControlUpdate;
     bool PublishNextZeroPressCounter;
+
+    PValueSnapshotWriter ValueSnapshot;
+    size_t ValueSnapshotSlot = 0;
+
+    mutable std::mutex StateMutex;
+    TDeviceChannelState State;
 };
 
 typedef std::shared_ptr<TDeviceChannel> PDeviceChannel;
@@ -56,7 +90,8 @@ public:
     TSerialPortDriver(WBMQTT::PDeviceDriver mqttDriver,
                       PPortConfig port_config,
                       const WBMQTT::TPublishParameters& publishPolicy,
-                      size_t lowPriorityRateLimit);
+                      size_t lowPriorityRateLimit,
+                      PValueSnapshotWriter valueSnapshot = nullptr);
 
     void SetUpDevices();
     void Cycle(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
@@ -69,11 +104,33 @@ public:
 
     PSerialClient GetSerialClient();
 
+    //! Channels of all devices, the list is not changed after SetUpDevices
+    std::vector<PDeviceChannel> GetChannels() const;
+
+    enum class TChannelWriteResult
+    {
+        Ok,
+        InvalidValue,
+        WriteError
+    };
+
+    typedef std::function<void(TChannelWriteResult result, const std::string& error)> TChannelWriteCallback;
+
+    /**
+     * @brief Write channel bypassing MQTT
+     *
+     * @param onComplete is called when writes of all channel's registers are finished.
+     *                   It is called from the port thread or from the calling thread if the value is invalid
+     */
+    void WriteChannel(const PDeviceChannel& channel, const std::string& value, TChannelWriteCallback onComplete);
+
 private:
     WBMQTT::TLocalDeviceArgs From(const PSerialDevice& device);
     WBMQTT::TControlArgs From(const PDeviceChannel& channel);
 
-    void SetValueToChannel(const PDeviceChannel& channel, const std::string& value);
+    void SetValueToChannel(const PDeviceChannel& channel,
+                           const std::string& value,
+                           TChannelWriteCallback onComplete = nullptr);
     void UpdateError(PRegister reg);
     void OnDeviceConnectionStateChanged(PSerialDevice device);
 
@@ -83,6 +140,7 @@ private:
     std::vector<PSerialDevice> Devices;
     std::string Description;
     WBMQTT::TPublishParameters PublishPolicy;
+    PValueSnapshotWriter ValueSnapshot;
 
     std::unordered_map<PRegister, PDeviceChannel> RegisterToChannelMap;
     std::unordered_map<PSerialDevice, std::vector<PDeviceChannel>> DeviceToChannelsMap;
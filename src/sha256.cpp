@@ -0,0 +1,108 @@
+#include "sha256.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // clang-format off
+    const uint32_t K[] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+    // clang-format on
+
+    uint32_t Rotr(uint32_t x, int n)
+    {
+        return (x >> n) | (x << (32 - n));
+    }
+}
+
+SHA256::THasher::THasher()
+    : State({0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}),
+      BlockSize(0),
+      TotalSize(0)
+{}
+
+void SHA256::THasher::Transform(const uint8_t* block)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (block[i * 4] << 24) | (block[i * 4 + 1] << 16) | (block[i * 4 + 2] << 8) | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; ++i) {
+        auto s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        auto s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    auto s = State;
+    for (int i = 0; i < 64; ++i) {
+        auto s1 = Rotr(s[4], 6) ^ Rotr(s[4], 11) ^ Rotr(s[4], 25);
+        auto ch = (s[4] & s[5]) ^ (~s[4] & s[6]);
+        auto t1 = s[7] + s1 + ch + K[i] + w[i];
+        auto s0 = Rotr(s[0], 2) ^ Rotr(s[0], 13) ^ Rotr(s[0], 22);
+        auto maj = (s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]);
+        auto t2 = s0 + maj;
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = s[4];
+        s[4] = s[3] + t1;
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = s[0];
+        s[0] = t1 + t2;
+    }
+    for (size_t i = 0; i < State.size(); ++i) {
+        State[i] += s[i];
+    }
+}
+
+void SHA256::THasher::Update(const uint8_t* data, size_t size)
+{
+    TotalSize += size;
+    while (size) {
+        auto chunk = std::min(size, Block.size() - BlockSize);
+        memcpy(Block.data() + BlockSize, data, chunk);
+        BlockSize += chunk;
+        data += chunk;
+        size -= chunk;
+        if (BlockSize == Block.size()) {
+            Transform(Block.data());
+            BlockSize = 0;
+        }
+    }
+}
+
+std::string SHA256::THasher::HexDigest()
+{
+    uint64_t bitsCount = TotalSize * 8;
+    uint8_t padding[72] = {0x80};
+    size_t paddingSize = (BlockSize < 56) ? (56 - BlockSize) : (120 - BlockSize);
+    for (int i = 0; i < 8; ++i) {
+        padding[paddingSize + i] = static_cast<uint8_t>(bitsCount >> (56 - i * 8));
+    }
+    Update(padding, paddingSize + 8);
+
+    const char* hex = "0123456789abcdef";
+    std::string res;
+    for (auto v: State) {
+        for (int i = 28; i >= 0; i -= 4) {
+            res += hex[(v >> i) & 0x0F];
+        }
+    }
+    return res;
+}
+
+std::string SHA256::HexDigest(const uint8_t* data, size_t size)
+{
+    THasher hasher;
+    hasher.Update(data, size);
+    return hasher.HexDigest();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace SHA256
+{
+    //! Incremental SHA-256 calculation for data received by chunks
+    class THasher
+    {
+    public:
+        THasher();
+
+        void Update(const uint8_t* data, size_t size);
+
+        //! Finishes calculation, returns lowercase hex digest
+        std::string HexDigest();
+
+    private:
+        void Transform(const uint8_t* block);
+
+        std::array<uint32_t, 8> State;
+        std::array<uint8_t, 64> Block;
+        size_t BlockSize;
+        uint64_t TotalSize;
+    };
+
+    std::string HexDigest(const uint8_t* data, size_t size);
+}
@@ -0,0 +1,269 @@
+#include "value_snapshot.h"
+#include "serial_exc.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace ValueSnapshot;
+
+namespace
+{
+    size_t GetFileSize(size_t slotCount)
+    {
+        return sizeof(THeader) + slotCount * sizeof(TSlot);
+    }
+
+    THeader& GetHeader(void* data)
+    {
+        return *static_cast<THeader*>(data);
+    }
+
+    TSlot* GetSlots(void* data)
+    {
+        return reinterpret_cast<TSlot*>(static_cast<char*>(data) + sizeof(THeader));
+    }
+
+    int64_t ToTimestamp(std::chrono::steady_clock::time_point ts)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(ts.time_since_epoch()).count();
+    }
+}
+
+TValueSnapshotWriter::TValueSnapshotWriter(const std::string& path, size_t slotCount)
+    : Path(path),
+      SlotCount(slotCount),
+      Size(GetFileSize(slotCount))
+{
+    auto tmpPath = Path + ".tmp";
+    int fd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("can't create value snapshot file " + tmpPath + ": " + FormatErrno(errno));
+    }
+    if (ftruncate(fd, Size) != 0) {
+        auto err = errno;
+        close(fd);
+        unlink(tmpPath.c_str());
+        throw std::runtime_error("can't resize value snapshot file " + tmpPath + ": " + FormatErrno(err));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        auto err = errno;
+        close(fd);
+        unlink(tmpPath.c_str());
+        throw std::runtime_error("can't stat value snapshot file " + tmpPath + ": " + FormatErrno(err));
+    }
+    Device = st.st_dev;
+    Inode = st.st_ino;
+    Data = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    auto err = errno;
+    close(fd);
+    if (Data == MAP_FAILED) {
+        unlink(tmpPath.c_str());
+        throw std::runtime_error("can't map value snapshot file " + tmpPath + ": " + FormatErrno(err));
+    }
+
+    // The file is zero filled by ftruncate, so only the header must be set
+    auto& header = GetHeader(Data);
+    header.Version = VERSION;
+    header.SlotSize = sizeof(TSlot);
+    header.SlotCount = SlotCount;
+    header.UsedSlots.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    // Readers check magic last
+    header.Magic = MAGIC;
+
+    if (rename(tmpPath.c_str(), Path.c_str()) != 0) {
+        err = errno;
+        munmap(Data, Size);
+        unlink(tmpPath.c_str());
+        throw std::runtime_error("can't create value snapshot file " + Path + ": " + FormatErrno(err));
+    }
+}
+
+TValueSnapshotWriter::~TValueSnapshotWriter()
+{
+    munmap(Data, Size);
+    // Readers will know that values are not updated anymore.
+    // The file could be already replaced by another writer, it must be kept
+    struct stat st;
+    if (stat(Path.c_str(), &st) == 0 && st.st_dev == Device && st.st_ino == Inode) {
+        unlink(Path.c_str());
+    }
+}
+
+std::optional<size_t> TValueSnapshotWriter::AllocateSlot(const std::string& id)
+{
+    if (id.size() >= MAX_ID_SIZE) {
+        return std::nullopt;
+    }
+    std::unique_lock<std::mutex> lock(AllocateMutex);
+    auto& header = GetHeader(Data);
+    size_t index = header.UsedSlots.load(std::memory_order_relaxed);
+    if (index >= SlotCount) {
+        return std::nullopt;
+    }
+    auto& slot = GetSlots(Data)[index];
+    BeginWrite(slot);
+    memcpy(slot.Id, id.c_str(), id.size() + 1);
+    slot.Flags = ValueUndefined;
+    slot.ValueSize = 0;
+    EndWrite(slot);
+    header.UsedSlots.store(index + 1, std::memory_order_release);
+    return index;
+}
+
+void TValueSnapshotWriter::Update(size_t slotIndex,
+                                  const std::string& value,
+                                  uint32_t flags,
+                                  std::chrono::steady_clock::time_point ts)
+{
+    auto& slot = GetSlots(Data)[slotIndex];
+    auto size = value.size();
+    if (size > MAX_VALUE_SIZE) {
+        size = MAX_VALUE_SIZE;
+        flags |= ValueTruncated;
+    }
+    BeginWrite(slot);
+    memcpy(slot.Value, value.data(), size);
+    slot.ValueSize = size;
+    slot.Flags = flags;
+    slot.Timestamp = ToTimestamp(ts);
+    EndWrite(slot);
+}
+
+void TValueSnapshotWriter::UpdateFlags(size_t slotIndex, uint32_t flags, std::chrono::steady_clock::time_point ts)
+{
+    auto& slot = GetSlots(Data)[slotIndex];
+    BeginWrite(slot);
+    slot.Flags = (slot.Flags & (ValueUndefined | ValueTruncated)) | flags;
+    slot.Timestamp = ToTimestamp(ts);
+    EndWrite(slot);
+}
+
+const std::string& TValueSnapshotWriter::GetPath() const
+{
+    return Path;
+}
+
+void TValueSnapshotWriter::BeginWrite(TSlot& slot)
+{
+    // Every slot has the only writer, so relaxed load is enough
+    slot.Sequence.store(slot.Sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void TValueSnapshotWriter::EndWrite(TSlot& slot)
+{
+    slot.Sequence.store(slot.Sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+TValueSnapshotReader::TValueSnapshotReader(const std::string& path): Path(path)
+{
+    int fd = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("can't open value snapshot file " + Path + ": " + FormatErrno(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(THeader)) {
+        close(fd);
+        throw std::runtime_error("invalid value snapshot file " + Path);
+    }
+    Device = st.st_dev;
+    Inode = st.st_ino;
+    Size = st.st_size;
+    Data = mmap(nullptr, Size, PROT_READ, MAP_SHARED, fd, 0);
+    auto err = errno;
+    close(fd);
+    if (Data == MAP_FAILED) {
+        throw std::runtime_error("can't map value snapshot file " + Path + ": " + FormatErrno(err));
+    }
+
+    const auto& header = GetHeader(Data);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header.Magic != MAGIC || header.Version != VERSION || header.SlotSize != sizeof(TSlot) ||
+        GetFileSize(header.SlotCount) > Size)
+    {
+        munmap(Data, Size);
+        throw std::runtime_error("unsupported value snapshot file " + Path);
+    }
+    SlotCount = header.SlotCount;
+}
+
+TValueSnapshotReader::~TValueSnapshotReader()
+{
+    munmap(Data, Size);
+}
+
+size_t TValueSnapshotReader::GetSlotCount() const
+{
+    return std::min<size_t>(GetHeader(Data).UsedSlots.load(std::memory_order_acquire), SlotCount);
+}
+
+std::optional<size_t> TValueSnapshotReader::FindSlot(const std::string& id) const
+{
+    auto count = GetSlotCount();
+    for (size_t i = 0; i < count; ++i) {
+        const auto& slot = GetSlot(i);
+        if (strncmp(slot.Id, id.c_str(), MAX_ID_SIZE) == 0) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string TValueSnapshotReader::GetSlotId(size_t slot) const
+{
+    // Id is set before the slot is published by UsedSlots and is never changed
+    const auto& s = GetSlot(slot);
+    return std::string(s.Id, strnlen(s.Id, MAX_ID_SIZE));
+}
+
+TValue TValueSnapshotReader::Read(size_t slotIndex) const
+{
+    const auto& slot = GetSlot(slotIndex);
+    char value[MAX_VALUE_SIZE];
+    TValue res;
+    size_t size;
+    int64_t timestamp;
+    uint32_t seq;
+    do {
+        seq = slot.Sequence.load(std::memory_order_acquire);
+        while (seq & 1) {
+            // The writer could be preempted in the middle of update on single core systems
+            std::this_thread::yield();
+            seq = slot.Sequence.load(std::memory_order_acquire);
+        }
+        size = std::min<size_t>(slot.ValueSize, MAX_VALUE_SIZE);
+        memcpy(value, slot.Value, size);
+        res.Flags = slot.Flags;
+        timestamp = slot.Timestamp;
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (slot.Sequence.load(std::memory_order_relaxed) != seq);
+
+    res.Value.assign(value, size);
+    res.Timestamp = std::chrono::steady_clock::time_point(std::chrono::microseconds(timestamp));
+    return res;
+}
+
+bool TValueSnapshotReader::IsStale() const
+{
+    struct stat st;
+    if (stat(Path.c_str(), &st) != 0) {
+        return true;
+    }
+    return st.st_dev != Device || st.st_ino != Inode;
+}
+
+const TSlot& TValueSnapshotReader::GetSlot(size_t slot) const
+{
+    if (slot >= SlotCount) {
+        throw std::out_of_range("value snapshot slot index is out of range: " + std::to_string(slot));
+    }
+    return GetSlots(Data)[slot];
+}
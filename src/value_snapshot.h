@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <sys/types.h>
+
+/**
+ * @brief Shared memory snapshot of channel values.
+ *        The file is mapped into memory by wb-mqtt-serial and by local consumers.
+ *        It consists of a header followed by fixed size slots, one slot per channel.
+ *        Every slot is protected by a sequence counter (seqlock): the writer makes it odd before modification
+ *        and even after, so a reader retries while the counter is odd or has changed during copying.
+ *        The writer never waits for readers.
+ */
+namespace ValueSnapshot
+{
+    const uint32_t MAGIC = 0x53534257; // "WBSS"
+    const uint32_t VERSION = 1;
+
+    const size_t SLOT_SIZE = 256;
+    const size_t MAX_ID_SIZE = 96;
+    const size_t MAX_VALUE_SIZE = 136;
+
+    //! Bits of TSlot::Flags
+    enum TFlags : uint32_t
+    {
+        ReadError = 1 << 0,
+        WriteError = 1 << 1,
+        PollIntervalMissError = 1 << 2,
+
+        //! Channel has not got a value yet
+        ValueUndefined = 1 << 8,
+
+        //! The value is longer than MAX_VALUE_SIZE and is truncated
+        ValueTruncated = 1 << 9
+    };
+
+    struct alignas(64) THeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t SlotSize;
+        uint32_t SlotCount;
+
+        //! Number of slots assigned to channels, slots are allocated sequentially
+        std::atomic<uint32_t> UsedSlots;
+    };
+
+    struct alignas(64) TSlot
+    {
+        std::atomic<uint32_t> Sequence;
+        uint32_t Flags;
+
+        //! Last update time, microseconds of CLOCK_MONOTONIC (std::chrono::steady_clock)
+        int64_t Timestamp;
+
+        uint32_t ValueSize;
+
+        //! "device_id/control_id", zero terminated
+        char Id[MAX_ID_SIZE];
+
+        //! Channel value formatted as published to MQTT, not zero terminated
+        char Value[MAX_VALUE_SIZE];
+    };
+
+    static_assert(sizeof(THeader) == 64);
+    static_assert(sizeof(TSlot) == SLOT_SIZE);
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+    struct TValue
+    {
+        std::string Value;
+        uint32_t Flags = 0;
+        std::chrono::steady_clock::time_point Timestamp;
+    };
+}
+
+class TValueSnapshotWriter
+{
+public:
+    /**
+     * @brief Create snapshot file. The file is created with a temporary name and atomically renamed,
+     *        so readers of a previous instance can detect replacement with TValueSnapshotReader::IsStale.
+     */
+    TValueSnapshotWriter(const std::string& path, size_t slotCount);
+    ~TValueSnapshotWriter();
+
+    TValueSnapshotWriter(const TValueSnapshotWriter&) = delete;
+    TValueSnapshotWriter& operator=(const TValueSnapshotWriter&) = delete;
+
+    /**
+     * @brief Assign a slot to a channel
+     *
+     * @param id "device_id/control_id"
+     * @return slot index or nullopt if there are no free slots or id is too long
+     */
+    std::optional<size_t> AllocateSlot(const std::string& id);
+
+    void Update(size_t slot, const std::string& value, uint32_t flags, std::chrono::steady_clock::time_point ts);
+
+    //! Update flags keeping last value
+    void UpdateFlags(size_t slot, uint32_t flags, std::chrono::steady_clock::time_point ts);
+
+    const std::string& GetPath() const;
+
+private:
+    void BeginWrite(ValueSnapshot::TSlot& slot);
+    void EndWrite(ValueSnapshot::TSlot& slot);
+
+    std::string Path;
+    size_t SlotCount;
+    size_t Size;
+    void* Data;
+    dev_t Device;
+    ino_t Inode;
+    std::mutex AllocateMutex;
+};
+
+typedef std::shared_ptr<TValueSnapshotWriter> PValueSnapshotWriter;
+
+class TValueSnapshotReader
+{
+public:
+    explicit TValueSnapshotReader(const std::string& path);
+    ~TValueSnapshotReader();
+
+    TValueSnapshotReader(const TValueSnapshotReader&) = delete;
+    TValueSnapshotReader& operator=(const TValueSnapshotReader&) = delete;
+
+    //! Number of slots assigned to channels
+    size_t GetSlotCount() const;
+
+    std::optional<size_t> FindSlot(const std::string& id) const;
+    std::string GetSlotId(size_t slot) const;
+
+    //! Get consistent copy of slot's value, never blocks the writer
+    ValueSnapshot::TValue Read(size_t slot) const;
+
+    //! The file was removed or replaced by a new instance of the writer, reader must be recreated
+    bool IsStale() const;
+
+private:
+    const ValueSnapshot::TSlot& GetSlot(size_t slot) const;
+
+    std::string Path;
+    size_t SlotCount;
+    size_t Size;
+    void* Data;
+    dev_t Device;
+    ino_t Inode;
+};
@@ -1,25 +1,62 @@
 #include "write_channel_serial_client_task.h"
 #include "log.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 #define LOG(logger) logger.Log() << "[serial client] "
 
 TWriteChannelSerialClientTask::TWriteChannelSerialClientTask(PRegisterHandler handler,
                                                              TRegisterCallback readCallback,
-                                                             TRegisterCallback errorCallback)
+                                                             TRegisterCallback errorCallback,
+                                                             TCompletionCallback completionCallback)
     : Handler(handler),
       ReadCallback(readCallback),
       ErrorCallback(errorCallback)
-{}
+{
+    if (completionCallback) {
+        CompletionCallbacks.push_back(completionCallback);
+    }
+}
 
 ISerialClientTask::TRunResult TWriteChannelSerialClientTask::Run(PFeaturePort port,
                                                                  TSerialClientDeviceAccessHandler& lastAccessedDevice,
                                                                  const std::list<PSerialDevice>& polledDevices)
+{
+    auto res = CheckBeforeWrite(*port);
+    if (res) {
+        return *res;
+    }
+
+    if (lastAccessedDevice.PrepareToAccess(*port, Handler->Register()->Device())) {
+        Handler->Flush(*port);
+    } else {
+        Handler->Register()->SetError(TRegister::TError::WriteError);
+    }
+    return ProcessWriteResult();
+}
+
+PRegisterHandler TWriteChannelSerialClientTask::GetHandler() const
+{
+    return Handler;
+}
+
+void TWriteChannelSerialClientTask::Join(TWriteChannelSerialClientTask& other)
+{
+    for (auto& callback: other.CompletionCallbacks) {
+        CompletionCallbacks.push_back(std::move(callback));
+    }
+    other.CompletionCallbacks.clear();
+}
+
+std::optional<ISerialClientTask::TRunResult> TWriteChannelSerialClientTask::CheckBeforeWrite(TPort& port)
 {
     if (!Handler->NeedToFlush()) {
-        return ISerialClientTask::TRunResult::OK;
+        // The value is already written by previous task
+        return Complete(std::string());
     }
 
-    if (!port->IsOpen() || !Handler->Register()->IsSupported() ||
+    if (!port.IsOpen() || !Handler->Register()->IsSupported() ||
         Handler->Register()->Device()->GetConnectionState() == TDeviceConnectionState::DISCONNECTED)
     {
         Handler->Register()->SetError(TRegister::TError::WriteError);
@@ -28,7 +65,7 @@ ISerialClientTask::TRunResult TWriteChannelSerialClientTask::Run(PFeaturePort po
         }
         auto retry = true;
         std::string error;
-        if (!port->IsOpen()) {
+        if (!port.IsOpen()) {
             error = "port is not open";
         } else if (!Handler->Register()->IsSupported()) {
             retry = false;
@@ -41,14 +78,13 @@ ISerialClientTask::TRunResult TWriteChannelSerialClientTask::Run(PFeaturePort po
             return ISerialClientTask::TRunResult::RETRY;
         }
         LOG(Warn) << Handler->Register()->ToString() << " register write cancelled: " << error;
-        return ISerialClientTask::TRunResult::OK;
+        return Complete(error);
     }
+    return std::nullopt;
+}
 
-    if (lastAccessedDevice.PrepareToAccess(*port, Handler->Register()->Device())) {
-        Handler->Flush(*port);
-    } else {
-        Handler->Register()->SetError(TRegister::TError::WriteError);
-    }
+ISerialClientTask::TRunResult TWriteChannelSerialClientTask::ProcessWriteResult()
+{
     if (Handler->Register()->GetErrorState().test(TRegister::TError::WriteError)) {
         if (ErrorCallback) {
             ErrorCallback(Handler->Register());
@@ -58,5 +94,99 @@ ISerialClientTask::TRunResult TWriteChannelSerialClientTask::Run(PFeaturePort po
             ReadCallback(Handler->Register());
         }
     }
-    return Handler->NeedToFlush() ? ISerialClientTask::TRunResult::RETRY : ISerialClientTask::TRunResult::OK;
+    if (Handler->NeedToFlush()) {
+        return ISerialClientTask::TRunResult::RETRY;
+    }
+    return Complete(Handler->Register()->GetErrorState().test(TRegister::TError::WriteError) ? "write failed"
+                                                                                             : std::string());
+}
+
+ISerialClientTask::TRunResult TWriteChannelSerialClientTask::Complete(const std::string& error)
+{
+    for (const auto& callback: CompletionCallbacks) {
+        callback(error);
+    }
+    CompletionCallbacks.clear();
+    return ISerialClientTask::TRunResult::OK;
+}
+
+TWriteChannelsBatchSerialClientTask::TWriteChannelsBatchSerialClientTask(
+    std::vector<PWriteChannelSerialClientTask> tasks)
+    : Tasks(std::move(tasks))
+{}
+
+ISerialClientTask::TRunResult TWriteChannelsBatchSerialClientTask::Run(
+    PFeaturePort port,
+    TSerialClientDeviceAccessHandler& lastAccessedDevice,
+    const std::list<PSerialDevice>& polledDevices)
+{
+    std::vector<std::optional<ISerialClientTask::TRunResult>> results;
+    std::vector<PRegisterHandler> handlers;
+    results.reserve(Tasks.size());
+    for (const auto& task: Tasks) {
+        results.push_back(task->CheckBeforeWrite(*port));
+        // The same register can be set several times, its last value is written once
+        if (!results.back() && std::find(handlers.begin(), handlers.end(), task->GetHandler()) == handlers.end()) {
+            handlers.push_back(task->GetHandler());
+        }
+    }
+
+    if (!handlers.empty()) {
+        if (lastAccessedDevice.PrepareToAccess(*port, handlers.front()->Register()->Device())) {
+            TRegisterHandler::Flush(*port, handlers);
+        } else {
+            for (const auto& handler: handlers) {
+                handler->Register()->SetError(TRegister::TError::WriteError);
+            }
+        }
+    }
+
+    std::vector<PWriteChannelSerialClientTask> retryTasks;
+    for (size_t i = 0; i < Tasks.size(); ++i) {
+        auto res = results[i] ? *results[i] : Tasks[i]->ProcessWriteResult();
+        if (res == ISerialClientTask::TRunResult::RETRY) {
+            retryTasks.push_back(Tasks[i]);
+        }
+    }
+    Tasks.swap(retryTasks);
+    return Tasks.empty() ? ISerialClientTask::TRunResult::OK : ISerialClientTask::TRunResult::RETRY;
+}
+
+std::vector<PSerialClientTask> CombineWriteChannelTasks(const std::vector<PSerialClientTask>& tasks)
+{
+    std::vector<PSerialClientTask> res;
+    std::vector<std::vector<PWriteChannelSerialClientTask>> batches;
+    // Indexes of batches in res
+    std::vector<size_t> batchPositions;
+    std::unordered_map<PSerialDevice, size_t> deviceBatches;
+
+    for (const auto& task: tasks) {
+        auto writeTask = std::dynamic_pointer_cast<TWriteChannelSerialClientTask>(task);
+        if (!writeTask) {
+            deviceBatches.clear();
+            res.push_back(task);
+            continue;
+        }
+        auto device = writeTask->GetHandler()->Register()->Device();
+        if (!device || device->DeviceConfig()->MaxWriteRegisters <= 1) {
+            res.push_back(task);
+            continue;
+        }
+        auto it = deviceBatches.find(device);
+        if (it == deviceBatches.end()) {
+            deviceBatches.emplace(device, batches.size());
+            batchPositions.push_back(res.size());
+            batches.push_back({writeTask});
+            res.push_back(task);
+        } else {
+            batches[it->second].push_back(writeTask);
+        }
+    }
+
+    for (size_t i = 0; i < batches.size(); ++i) {
+        if (batches[i].size() > 1) {
+            res[batchPositions[i]] = std::make_shared<TWriteChannelsBatchSerialClientTask>(std::move(batches[i]));
+        }
+    }
+    return res;
 }
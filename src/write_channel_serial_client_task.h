@@ -3,15 +3,21 @@
 #include "register_handler.h"
 #include "serial_client.h"
 
+#include <optional>
+
 class TWriteChannelSerialClientTask: public ISerialClientTask
 {
 
 public:
     typedef std::function<void(PRegister reg)> TRegisterCallback;
 
+    //! Is called when the write is finished, error is empty on success
+    typedef std::function<void(const std::string& error)> TCompletionCallback;
+
     TWriteChannelSerialClientTask(PRegisterHandler handler,
                                   TRegisterCallback readCallback,
-                                  TRegisterCallback errorCallback);
+                                  TRegisterCallback errorCallback,
+                                  TCompletionCallback completionCallback = nullptr);
 
     ~TWriteChannelSerialClientTask() = default;
 
@@ -19,8 +25,57 @@ public:
                                       TSerialClientDeviceAccessHandler& lastAccessedDevice,
                                       const std::list<PSerialDevice>& polledDevices) override;
 
+    PRegisterHandler GetHandler() const;
+
+    /**
+     * @brief Takes completion callback of other write of the same register.
+     *        The other write is superseded by this one, so it is completed with the result of this write.
+     *        Must not be called while the task is running.
+     */
+    void Join(TWriteChannelSerialClientTask& other);
+
+    /**
+     * @brief Checks if the register must be written now.
+     *
+     * @return empty value if the register must be written, otherwise the result of the task
+     */
+    std::optional<ISerialClientTask::TRunResult> CheckBeforeWrite(TPort& port);
+
+    //! Notifies about write result. Must be called after writing of the register
+    ISerialClientTask::TRunResult ProcessWriteResult();
+
 private:
     PRegisterHandler Handler;
     TRegisterCallback ReadCallback;
     TRegisterCallback ErrorCallback;
+    std::vector<TCompletionCallback> CompletionCallbacks;
+
+    ISerialClientTask::TRunResult Complete(const std::string& error);
 };
+
+typedef std::shared_ptr<TWriteChannelSerialClientTask> PWriteChannelSerialClientTask;
+
+/**
+ * @brief Writes several channels of one device at once,
+ *        so adjacent registers can be written by one multi-register request.
+ *        Only tasks which must be retried are left in the batch after run.
+ */
+class TWriteChannelsBatchSerialClientTask: public ISerialClientTask
+{
+public:
+    TWriteChannelsBatchSerialClientTask(std::vector<PWriteChannelSerialClientTask> tasks);
+
+    ISerialClientTask::TRunResult Run(PFeaturePort port,
+                                      TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                      const std::list<PSerialDevice>& polledDevices) override;
+
+private:
+    std::vector<PWriteChannelSerialClientTask> Tasks;
+};
+
+/**
+ * @brief Combines channel write tasks for the same device into batches
+ *        if the device supports multi-register writes.
+ *        Other tasks are barriers: writes are not moved across them.
+ */
+std::vector<PSerialClientTask> CombineWriteChannelTasks(const std::vector<PSerialClientTask>& tasks);
@@ -0,0 +1,46 @@
+#include "write_latency_stats.h"
+
+#include <algorithm>
+#include <bit>
+
+using namespace std::chrono;
+
+void TWriteLatencyStats::AddLatency(microseconds latency)
+{
+    latency = std::max(latency, microseconds::zero());
+    auto bucket = std::min<size_t>(std::bit_width(static_cast<uint64_t>(latency.count())), BUCKETS_COUNT - 1);
+    std::unique_lock<std::mutex> lock(Mutex);
+    ++Buckets[bucket];
+    ++Count;
+    Total += latency;
+    Max = std::max(Max, latency);
+}
+
+void TWriteLatencyStats::AddSuperseded()
+{
+    std::unique_lock<std::mutex> lock(Mutex);
+    ++Superseded;
+}
+
+TWriteLatencySummary TWriteLatencyStats::GetSummary() const
+{
+    std::unique_lock<std::mutex> lock(Mutex);
+    TWriteLatencySummary res;
+    res.Count = Count;
+    res.Superseded = Superseded;
+    res.Max = Max;
+    if (Count == 0) {
+        return res;
+    }
+    res.Average = Total / Count;
+    auto threshold = Count - Count / 100;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < BUCKETS_COUNT; ++i) {
+        sum += Buckets[i];
+        if (sum >= threshold) {
+            res.P99 = std::min(microseconds((uint64_t(1) << i) - 1), Max);
+            break;
+        }
+    }
+    return res;
+}
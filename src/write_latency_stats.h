@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+struct TWriteLatencySummary
+{
+    //! Number of confirmed writes including superseded ones
+    uint64_t Count = 0;
+
+    //! Number of writes superseded by newer values of the same registers before being sent
+    uint64_t Superseded = 0;
+
+    std::chrono::microseconds Average = std::chrono::microseconds::zero();
+    std::chrono::microseconds Max = std::chrono::microseconds::zero();
+
+    //! Upper bound of 99th percentile, precision is a power of two
+    std::chrono::microseconds P99 = std::chrono::microseconds::zero();
+};
+
+/**
+ * @brief Latency of channel writes from enqueueing to confirmation.
+ *        Latencies are accumulated in a histogram with power of two buckets, so memory usage is constant.
+ *        The class is thread safe.
+ */
+class TWriteLatencyStats
+{
+public:
+    void AddLatency(std::chrono::microseconds latency);
+    void AddSuperseded();
+
+    TWriteLatencySummary GetSummary() const;
+
+private:
+    // Bucket i > 0 holds latencies in [2^(i-1), 2^i) us, the last one also holds all greater latencies
+    static const size_t BUCKETS_COUNT = 32;
+
+    mutable std::mutex Mutex;
+    std::array<uint64_t, BUCKETS_COUNT> Buckets{};
+    uint64_t Count = 0;
+    uint64_t Superseded = 0;
+    std::chrono::microseconds Total = std::chrono::microseconds::zero();
+    std::chrono::microseconds Max = std::chrono::microseconds::zero();
+};
+
+typedef std::shared_ptr<TWriteLatencyStats> PWriteLatencyStats;
@@ -0,0 +1,61 @@
+#include "bus_simulator.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    TSimulationConfig MakeConfig()
+    {
+        TSimulatedDeviceGroup relays;
+        relays.Name = "relay";
+        relays.Count = 5;
+        relays.Registers = 4;
+        relays.MaxReadRegisters = 4;
+        relays.ReadPeriod = 100ms;
+        relays.EventPeriod = 500ms;
+
+        TSimulatedDeviceGroup missing;
+        missing.Name = "missing";
+        missing.Count = 2;
+        missing.ReadPeriod = 100ms;
+        missing.Disconnected = true;
+
+        TSimulatedPortConfig port;
+        port.ConnectionSettings.BaudRate = 115200;
+        port.DisconnectedPollSettings.Backoff = true;
+        port.Groups = {relays, missing};
+
+        TSimulationConfig config;
+        config.Duration = 10s;
+        config.Ports = {port};
+        return config;
+    }
+}
+
+TEST(TBusSimulatorTest, Report)
+{
+    auto report = RunSimulation(MakeConfig());
+    ASSERT_EQ(report["ports"].size(), 1);
+    const auto& port = report["ports"][0];
+
+    EXPECT_GT(port["bus_utilization"].asDouble(), 0);
+    EXPECT_LT(port["bus_utilization"].asDouble(), 1);
+    EXPECT_GT(port["events"].asUInt(), 0);
+    EXPECT_GT(port["timeouts"].asUInt(), 0);
+
+    const auto& relays = port["devices"][0];
+    EXPECT_EQ(relays["read_errors"].asUInt(), 0);
+    EXPECT_GE(relays["avg_read_period_ms"].asDouble(), 100);
+    EXPECT_LT(relays["avg_read_period_ms"].asDouble(), 200);
+
+    const auto& missing = port["devices"][1];
+    EXPECT_EQ(missing["reads"].asUInt(), 0);
+    EXPECT_GT(missing["read_errors"].asUInt(), 0);
+}
+
+TEST(TBusSimulatorTest, Deterministic)
+{
+    auto config = MakeConfig();
+    EXPECT_EQ(RunSimulation(config), RunSimulation(config));
+}
@@ -0,0 +1,124 @@
+#include "disconnected_poll_quarantine.h"
+#include "fake_serial_device.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+class TDisconnectedPollQuarantineTest: public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TFakeSerialDevice::Register(DeviceFactory);
+    }
+
+    void TearDown() override
+    {
+        TFakeSerialDevice::ClearDevices();
+    }
+
+    PSerialDevice MakeDevice(const std::string& slaveId)
+    {
+        auto config = std::make_shared<TDeviceConfig>("fake" + slaveId, slaveId, "fake");
+        return std::make_shared<TFakeSerialDevice>(config, DeviceFactory.GetProtocol("fake"));
+    }
+
+    TSerialDeviceFactory DeviceFactory;
+};
+
+TEST_F(TDisconnectedPollQuarantineTest, ExponentialBackoff)
+{
+    TDisconnectedPollSettings settings;
+    settings.Backoff = true;
+    settings.InitialDelay = 1s;
+    settings.MaxDelay = 30s;
+    TDisconnectedPollQuarantine quarantine(settings);
+    auto device = MakeDevice("1");
+
+    steady_clock::time_point now;
+    milliseconds expectedDelay = 1s;
+    for (size_t i = 0; i < 10; ++i) {
+        auto delay = quarantine.GetNextPollTime(device, now) - now;
+        // Delay has random jitter up to 25%
+        EXPECT_GE(delay, expectedDelay * 3 / 4) << i;
+        EXPECT_LE(delay, std::min<steady_clock::duration>(expectedDelay * 5 / 4, settings.MaxDelay)) << i;
+        now += delay;
+        expectedDelay = std::min(expectedDelay * 2, settings.MaxDelay);
+    }
+
+    // Backoff starts from the beginning after reconnection
+    quarantine.Release(device);
+    auto delay = quarantine.GetNextPollTime(device, now) - now;
+    EXPECT_GE(delay, 750ms);
+    EXPECT_LE(delay, 1250ms);
+}
+
+TEST_F(TDisconnectedPollQuarantineTest, Jitter)
+{
+    // Devices disconnected simultaneously must be polled at different times
+    TDisconnectedPollSettings settings;
+    settings.Backoff = true;
+    TDisconnectedPollQuarantine quarantine(settings);
+
+    steady_clock::time_point now;
+    std::vector<steady_clock::time_point> pollTimes;
+    for (size_t i = 1; i < 10; ++i) {
+        pollTimes.push_back(quarantine.GetNextPollTime(MakeDevice(std::to_string(i)), now));
+    }
+    std::sort(pollTimes.begin(), pollTimes.end());
+    EXPECT_NE(pollTimes.front(), pollTimes.back());
+}
+
+TEST_F(TDisconnectedPollQuarantineTest, Spacing)
+{
+    // Polls of disconnected devices must not go one after another
+    TDisconnectedPollSettings settings;
+    settings.Backoff = true;
+    settings.MaxBusShare = 0.25;
+    TDisconnectedPollQuarantine quarantine(settings);
+
+    steady_clock::time_point now = steady_clock::time_point() + 1s;
+    quarantine.AddPollTime(true, 100ms, now);
+    std::vector<steady_clock::time_point> pollTimes;
+    for (size_t i = 1; i < 20; ++i) {
+        pollTimes.push_back(quarantine.GetNextPollTime(MakeDevice(std::to_string(i)), now));
+    }
+    std::sort(pollTimes.begin(), pollTimes.end());
+    for (size_t i = 1; i < pollTimes.size(); ++i) {
+        EXPECT_GE(pollTimes[i] - pollTimes[i - 1], 400ms) << i;
+    }
+}
+
+TEST_F(TDisconnectedPollQuarantineTest, BusShare)
+{
+    TDisconnectedPollSettings settings;
+    settings.Backoff = true;
+    settings.InitialDelay = 10ms;
+    settings.MaxBusShare = 0.1;
+    TDisconnectedPollQuarantine quarantine(settings);
+    auto device = MakeDevice("1");
+
+    // 100 ms of 200 ms are spent on disconnected device polling
+    steady_clock::time_point start = steady_clock::time_point() + 1s;
+    quarantine.AddPollTime(false, 100ms, start);
+    quarantine.AddPollTime(true, 100ms, start + 100ms);
+    auto now = start + 200ms;
+    EXPECT_DOUBLE_EQ(quarantine.GetDisconnectedDevicesPollShare(now), 0.5);
+
+    // The next poll must wait until the share goes under the limit
+    EXPECT_GE(quarantine.GetNextPollTime(device, now), start + 1s);
+}
+
+TEST_F(TDisconnectedPollQuarantineTest, PollTime)
+{
+    TDisconnectedPollQuarantine quarantine(TDisconnectedPollSettings{});
+    steady_clock::time_point now = steady_clock::time_point() + 1s;
+    quarantine.AddPollTime(true, 30ms, now);
+    quarantine.AddPollTime(false, 20ms, now + 30ms);
+    quarantine.AddPollTime(true, 40ms, now + 50ms);
+    EXPECT_EQ(quarantine.GetDisconnectedDevicesPollTime(), 70ms);
+}
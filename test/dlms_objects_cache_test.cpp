@@ -0,0 +1,85 @@
+#include "dlms_objects_cache.h"
+
+#include <filesystem>
+#include <gtest/gtest.h>
+
+namespace
+{
+    const std::string METER_ID = "/dev/ttyRS485-1:20:1";
+
+    DLMS::TObjectsCacheEntry MakeEntry()
+    {
+        DLMS::TObjectsCacheEntry entry;
+        entry.Identity.SerialNumber = "12345678";
+        entry.Identity.Firmware = "1.02";
+        entry.ScalerUnits["1.0.32.7.0.255"] = DLMS::TScalerUnit{-1, 35};
+        entry.ScalerUnits["1.0.31.7.0.255"] = DLMS::TScalerUnit{-3, 33};
+        return entry;
+    }
+
+    class TDlmsObjectsCacheTest: public testing::Test
+    {
+    protected:
+        std::filesystem::path FilePath;
+
+        void SetUp() override
+        {
+            FilePath = std::filesystem::temp_directory_path() / "wb-mqtt-serial-dlms-objects-cache-test.json";
+            std::filesystem::remove(FilePath);
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove(FilePath);
+        }
+    };
+}
+
+TEST_F(TDlmsObjectsCacheTest, Hit)
+{
+    auto entry = MakeEntry();
+    {
+        DLMS::TObjectsCacheStorage storage(FilePath);
+        storage.Set(METER_ID, entry);
+    }
+
+    DLMS::TObjectsCacheStorage storage(FilePath);
+    auto res = storage.Find(METER_ID, entry.Identity);
+    ASSERT_TRUE(res.has_value());
+    EXPECT_EQ(*res, entry);
+}
+
+TEST_F(TDlmsObjectsCacheTest, Miss)
+{
+    auto entry = MakeEntry();
+    DLMS::TObjectsCacheStorage storage(FilePath);
+    EXPECT_FALSE(storage.Find(METER_ID, entry.Identity).has_value());
+
+    storage.Set(METER_ID, entry);
+    EXPECT_FALSE(storage.Find("/dev/ttyRS485-1:20:2", entry.Identity).has_value());
+    EXPECT_FALSE(storage.Find("/dev/ttyRS485-2:20:1", entry.Identity).has_value());
+    EXPECT_TRUE(storage.Find(METER_ID, entry.Identity).has_value());
+}
+
+TEST_F(TDlmsObjectsCacheTest, Stale)
+{
+    auto entry = MakeEntry();
+    DLMS::TObjectsCacheStorage storage(FilePath);
+
+    // Firmware update
+    storage.Set(METER_ID, entry);
+    auto identity = entry.Identity;
+    identity.Firmware = "1.03";
+    EXPECT_FALSE(storage.Find(METER_ID, identity).has_value());
+    EXPECT_FALSE(storage.Find(METER_ID, entry.Identity).has_value());
+
+    // Meter replacement
+    storage.Set(METER_ID, entry);
+    identity = entry.Identity;
+    identity.SerialNumber = "87654321";
+    EXPECT_FALSE(storage.Find(METER_ID, identity).has_value());
+
+    // The stale entry is removed from the file too
+    DLMS::TObjectsCacheStorage reloadedStorage(FilePath);
+    EXPECT_FALSE(reloadedStorage.Find(METER_ID, entry.Identity).has_value());
+}
@@ -1,6 +1,8 @@
+#include "devices/dlms_device.h"
 #include "devices/uniel_device.h"
 #include "fake_serial_port.h"
 #include "uniel_expectations.h"
+#include <filesystem>
 #include <string>
 #include <wblib/testing/testlog.h>
 
@@ -73,3 +75,414 @@ TEST_F(TDlmsIntegrationTest, Poll)
     Note() << "LoopOnce()";
     SerialDriver->LoopOnce();
 }
+
+class TDlmsReadListExpectations: public virtual TExpectorProvider
+{
+protected:
+    // AARE declares multiple references support and max PDU size of 100 bytes
+    void EnqueueConnection()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x08, 0x02, 0x29, 0x41, 0x53, 0x9e, 0xb4, 0x7e},
+                           {0x7e, 0xa0, 0x21, 0x41, 0x02, 0x29, 0x73, 0x1b, 0x16, 0x81, 0x80, 0x14, 0x05, 0x02, 0x00,
+                            0x80, 0x06, 0x02, 0x00, 0x80, 0x07, 0x04, 0x00, 0x00, 0x00, 0x01, 0x08, 0x04, 0x00, 0x00,
+                            0x00, 0x01, 0xce, 0x6a, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x08, 0x02, 0x29, 0x41, 0x93, 0x92, 0x72, 0x7e},
+                           {0x7e, 0xa0, 0x21, 0x41, 0x02, 0x29, 0x73, 0x1b, 0x16, 0x81, 0x80, 0x14, 0x05, 0x02, 0x00,
+                            0x80, 0x06, 0x02, 0x00, 0x80, 0x07, 0x04, 0x00, 0x00, 0x00, 0x01, 0x08, 0x04, 0x00, 0x00,
+                            0x00, 0x01, 0xce, 0x6a, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x43, 0x02, 0x29, 0x41, 0x10, 0xcf, 0x42, 0xe6, 0xe6, 0x00, 0x60, 0x34, 0xa1,
+                            0x09, 0x06, 0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x01, 0x01, 0x8a, 0x02, 0x07, 0x80, 0x8b,
+                            0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x02, 0x01, 0xac, 0x08, 0x80, 0x06, 0x31, 0x31, 0x31,
+                            0x31, 0x31, 0x31, 0xbe, 0x10, 0x04, 0x0e, 0x01, 0x00, 0x00, 0x00, 0x06, 0x5f, 0x1f, 0x04,
+                            0x00, 0x00, 0x1e, 0x5d, 0xff, 0xff, 0xa0, 0xfd, 0x7e},
+                           {0x7e, 0xa0, 0x38, 0x41, 0x02, 0x29, 0x30, 0xa0, 0x83, 0xe6, 0xe7, 0x00, 0x61, 0x29, 0xa1,
+                            0x09, 0x06, 0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x01, 0x01, 0xa2, 0x03, 0x02, 0x01, 0x00,
+                            0xa3, 0x05, 0xa1, 0x03, 0x02, 0x01, 0x00, 0xbe, 0x10, 0x04, 0x0e, 0x08, 0x00, 0x06, 0x5f,
+                            0x1f, 0x04, 0x00, 0x00, 0x12, 0x1d, 0x00, 0x64, 0x00, 0x07, 0xd4, 0x83, 0x7e},
+                           __func__);
+    }
+
+    // AARE declares multiple references support and max PDU size of 40 bytes,
+    // so Gurux client puts only 2 attributes in one Get-Request-With-List
+    void EnqueueConnectionWithSmallPdu()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x08, 0x02, 0x29, 0x41, 0x53, 0x9e, 0xb4, 0x7e},
+                           {0x7e, 0xa0, 0x21, 0x41, 0x02, 0x29, 0x73, 0x1b, 0x16, 0x81, 0x80, 0x14, 0x05, 0x02, 0x00,
+                            0x80, 0x06, 0x02, 0x00, 0x80, 0x07, 0x04, 0x00, 0x00, 0x00, 0x01, 0x08, 0x04, 0x00, 0x00,
+                            0x00, 0x01, 0xce, 0x6a, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x08, 0x02, 0x29, 0x41, 0x93, 0x92, 0x72, 0x7e},
+                           {0x7e, 0xa0, 0x21, 0x41, 0x02, 0x29, 0x73, 0x1b, 0x16, 0x81, 0x80, 0x14, 0x05, 0x02, 0x00,
+                            0x80, 0x06, 0x02, 0x00, 0x80, 0x07, 0x04, 0x00, 0x00, 0x00, 0x01, 0x08, 0x04, 0x00, 0x00,
+                            0x00, 0x01, 0xce, 0x6a, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x43, 0x02, 0x29, 0x41, 0x10, 0xcf, 0x42, 0xe6, 0xe6, 0x00, 0x60, 0x34, 0xa1,
+                            0x09, 0x06, 0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x01, 0x01, 0x8a, 0x02, 0x07, 0x80, 0x8b,
+                            0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x02, 0x01, 0xac, 0x08, 0x80, 0x06, 0x31, 0x31, 0x31,
+                            0x31, 0x31, 0x31, 0xbe, 0x10, 0x04, 0x0e, 0x01, 0x00, 0x00, 0x00, 0x06, 0x5f, 0x1f, 0x04,
+                            0x00, 0x00, 0x1e, 0x5d, 0xff, 0xff, 0xa0, 0xfd, 0x7e},
+                           {0x7e, 0xa0, 0x38, 0x41, 0x02, 0x29, 0x30, 0xa0, 0x83, 0xe6, 0xe7, 0x00, 0x61, 0x29, 0xa1,
+                            0x09, 0x06, 0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x01, 0x01, 0xa2, 0x03, 0x02, 0x01, 0x00,
+                            0xa3, 0x05, 0xa1, 0x03, 0x02, 0x01, 0x00, 0xbe, 0x10, 0x04, 0x0e, 0x08, 0x00, 0x06, 0x5f,
+                            0x1f, 0x04, 0x00, 0x00, 0x12, 0x1d, 0x00, 0x28, 0x00, 0x07, 0x01, 0x20, 0x7e},
+                           __func__);
+    }
+
+    // Scalers and values of all registers in one request
+    void EnqueueReadListWithScalers()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x4d, 0x02, 0x29, 0x41, 0x32, 0x67, 0x21, 0xe6, 0xe6, 0x00, 0xc0, 0x03, 0xc1,
+                            0x06, 0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x03, 0x00, 0x00, 0x03, 0x00, 0x00,
+                            0x60, 0x09, 0x00, 0xff, 0x02, 0x00, 0x00, 0x03, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x03,
+                            0x00, 0x00, 0x03, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x02, 0x00, 0x00, 0x03, 0x01, 0x00,
+                            0x20, 0x07, 0x00, 0xff, 0x03, 0x00, 0x00, 0x03, 0x01, 0x00, 0x20, 0x07, 0x00, 0xff, 0x02,
+                            0x00, 0xe7, 0x48, 0x7e},
+                           {0x7e, 0xa0, 0x32, 0x41, 0x02, 0x29, 0x52, 0x1c, 0x8f, 0xe6, 0xe7, 0x00, 0xc4, 0x03, 0x81,
+                            0x06, 0x00, 0x02, 0x02, 0x0f, 0x00, 0x16, 0x09, 0x00, 0x10, 0x00, 0x1e, 0x00, 0x02, 0x02,
+                            0x0f, 0x00, 0x16, 0x21, 0x00, 0x12, 0x00, 0x05, 0x00, 0x02, 0x02, 0x0f, 0x01, 0x16, 0x23,
+                            0x00, 0x12, 0x00, 0x17, 0x1d, 0x7d, 0x7e},
+                           __func__);
+    }
+
+    // Scalers are already read, only values are requested
+    void EnqueueReadListValues()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x2f, 0x02, 0x29, 0x41, 0x54, 0x6c, 0x90, 0xe6, 0xe6, 0x00, 0xc0, 0x03, 0xc1,
+                            0x03, 0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x02, 0x00, 0x00, 0x03, 0x01, 0x00,
+                            0x1f, 0x07, 0x00, 0xff, 0x02, 0x00, 0x00, 0x03, 0x01, 0x00, 0x20, 0x07, 0x00, 0xff, 0x02,
+                            0x00, 0xa0, 0x7d, 0x7e},
+                           {0x7e, 0xa0, 0x1d, 0x41, 0x02, 0x29, 0x74, 0x45, 0xc1, 0xe6, 0xe7, 0x00, 0xc4, 0x03, 0x81,
+                            0x03, 0x00, 0x10, 0x00, 0x1f, 0x00, 0x12, 0x00, 0x06, 0x00, 0x12, 0x00, 0x16, 0x13, 0xee,
+                            0x7e},
+                           __func__);
+    }
+
+    void EnqueueSplitReadList()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x25, 0x02, 0x29, 0x41, 0x32, 0xf4, 0xda, 0xe6, 0xe6, 0x00, 0xc0, 0x03, 0xc1,
+                            0x02, 0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x03, 0x00, 0x00, 0x03, 0x00, 0x00,
+                            0x60, 0x09, 0x00, 0xff, 0x02, 0x00, 0xcd, 0x3a, 0x7e},
+                           {0x7e, 0xa0, 0x1c, 0x41, 0x02, 0x29, 0x52, 0x35, 0x8e, 0xe6, 0xe7, 0x00, 0xc4, 0x03, 0x81,
+                            0x02, 0x00, 0x02, 0x02, 0x0f, 0x00, 0x16, 0x09, 0x00, 0x10, 0x00, 0x1e, 0x3a, 0x85, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x25, 0x02, 0x29, 0x41, 0x54, 0xc4, 0xdc, 0xe6, 0xe6, 0x00, 0xc0, 0x03, 0xc1,
+                            0x02, 0x00, 0x03, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x03, 0x00, 0x00, 0x03, 0x01, 0x00,
+                            0x1f, 0x07, 0x00, 0xff, 0x02, 0x00, 0x36, 0xad, 0x7e},
+                           {0x7e, 0xa0, 0x1c, 0x41, 0x02, 0x29, 0x74, 0x01, 0xca, 0xe6, 0xe7, 0x00, 0xc4, 0x03, 0x81,
+                            0x02, 0x00, 0x02, 0x02, 0x0f, 0x00, 0x16, 0x21, 0x00, 0x12, 0x00, 0x05, 0x61, 0xa4, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x25, 0x02, 0x29, 0x41, 0x76, 0xd4, 0xde, 0xe6, 0xe6, 0x00, 0xc0, 0x03, 0xc1,
+                            0x02, 0x00, 0x03, 0x01, 0x00, 0x20, 0x07, 0x00, 0xff, 0x03, 0x00, 0x00, 0x03, 0x01, 0x00,
+                            0x20, 0x07, 0x00, 0xff, 0x02, 0x00, 0x61, 0x5f, 0x7e},
+                           {0x7e, 0xa0, 0x1c, 0x41, 0x02, 0x29, 0x96, 0x1d, 0x0e, 0xe6, 0xe7, 0x00, 0xc4, 0x03, 0x81,
+                            0x02, 0x00, 0x02, 0x02, 0x0f, 0x01, 0x16, 0x23, 0x00, 0x12, 0x00, 0x17, 0xaf, 0x1e, 0x7e},
+                           __func__);
+    }
+
+    // The meter answers with read-write-denied to Get-Request-With-List
+    void EnqueueRejectedReadList()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x4d, 0x02, 0x29, 0x41, 0x32, 0x67, 0x21, 0xe6, 0xe6, 0x00, 0xc0, 0x03, 0xc1,
+                            0x06, 0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x03, 0x00, 0x00, 0x03, 0x00, 0x00,
+                            0x60, 0x09, 0x00, 0xff, 0x02, 0x00, 0x00, 0x03, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x03,
+                            0x00, 0x00, 0x03, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x02, 0x00, 0x00, 0x03, 0x01, 0x00,
+                            0x20, 0x07, 0x00, 0xff, 0x03, 0x00, 0x00, 0x03, 0x01, 0x00, 0x20, 0x07, 0x00, 0xff, 0x02,
+                            0x00, 0xe7, 0x48, 0x7e},
+                           {0x7e, 0xa0, 0x12, 0x41, 0x02, 0x29, 0x52, 0x8d, 0xef, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x01, 0x03, 0x05, 0x84, 0x7e},
+                           __func__);
+    }
+
+    void EnqueueSingleReadsWithScalers()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x54, 0xe9, 0x62, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x03, 0x00, 0x8b, 0x78, 0x7e},
+                           {0x7e, 0xa0, 0x17, 0x41, 0x02, 0x29, 0x74, 0xed, 0x8d, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x02, 0x02, 0x0f, 0x00, 0x16, 0x09, 0xae, 0xd5, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x76, 0xf9, 0x60, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x02, 0x00, 0x53, 0x61, 0x7e},
+                           {0x7e, 0xa0, 0x14, 0x41, 0x02, 0x29, 0x96, 0x3d, 0x54, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x10, 0x00, 0x1e, 0x66, 0x3c, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x98, 0x89, 0x6e, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x03, 0x00, 0x04, 0x60, 0x7e},
+                           {0x7e, 0xa0, 0x17, 0x41, 0x02, 0x29, 0xb8, 0x8d, 0x81, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x02, 0x02, 0x0f, 0x00, 0x16, 0x21, 0xe4, 0x78, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0xba, 0x99, 0x6c, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x02, 0x00, 0xdc, 0x79, 0x7e},
+                           {0x7e, 0xa0, 0x14, 0x41, 0x02, 0x29, 0xda, 0x55, 0xdc, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x12, 0x00, 0x05, 0x8c, 0x27, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0xdc, 0xa9, 0x6a, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x01, 0x00, 0x20, 0x07, 0x00, 0xff, 0x03, 0x00, 0x5d, 0x9a, 0x7e},
+                           {0x7e, 0xa0, 0x17, 0x41, 0x02, 0x29, 0xfc, 0xad, 0x85, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x02, 0x02, 0x0f, 0x01, 0x16, 0x23, 0x2a, 0x01, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0xfe, 0xb9, 0x68, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x01, 0x00, 0x20, 0x07, 0x00, 0xff, 0x02, 0x00, 0x85, 0x83, 0x7e},
+                           {0x7e, 0xa0, 0x14, 0x41, 0x02, 0x29, 0x1e, 0x7d, 0x5c, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x12, 0x00, 0x17, 0x1f, 0x14, 0x7e},
+                           __func__);
+    }
+
+    void EnqueueSingleReadsValues()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x10, 0xc9, 0x66, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x02, 0x00, 0x53, 0x61, 0x7e},
+                           {0x7e, 0xa0, 0x14, 0x41, 0x02, 0x29, 0x30, 0x01, 0x94, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x10, 0x00, 0x1f, 0xef, 0x2d, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x32, 0xd9, 0x64, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x02, 0x00, 0xdc, 0x79, 0x7e},
+                           {0x7e, 0xa0, 0x14, 0x41, 0x02, 0x29, 0x52, 0x15, 0xd4, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x12, 0x00, 0x06, 0x17, 0x15, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x54, 0xe9, 0x62, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x01, 0x00, 0x20, 0x07, 0x00, 0xff, 0x02, 0x00, 0x85, 0x83, 0x7e},
+                           {0x7e, 0xa0, 0x14, 0x41, 0x02, 0x29, 0x74, 0x21, 0x90, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x12, 0x00, 0x16, 0x96, 0x05, 0x7e},
+                           __func__);
+    }
+};
+
+class TDlmsReadListIntegrationTest: public TSerialDeviceIntegrationTest, public TDlmsReadListExpectations
+{
+protected:
+    void TearDown() override;
+    const char* ConfigPath() const override
+    {
+        return "configs/config-dlms-read-list-test.json";
+    }
+};
+
+void TDlmsReadListIntegrationTest::TearDown()
+{
+    SerialPort->DumpWhatWasRead();
+    TSerialDeviceIntegrationTest::TearDown();
+}
+
+TEST_F(TDlmsReadListIntegrationTest, ReadList)
+{
+    ASSERT_TRUE(!!SerialPort);
+
+    EnqueueConnection();
+    EnqueueReadListWithScalers();
+
+    Note() << "LoopOnce()";
+    SerialDriver->LoopOnce();
+
+    EnqueueReadListValues();
+
+    Note() << "LoopOnce()";
+    SerialDriver->LoopOnce();
+}
+
+TEST_F(TDlmsReadListIntegrationTest, SplitByPduSize)
+{
+    ASSERT_TRUE(!!SerialPort);
+
+    EnqueueConnectionWithSmallPdu();
+    EnqueueSplitReadList();
+
+    Note() << "LoopOnce()";
+    SerialDriver->LoopOnce();
+}
+
+TEST_F(TDlmsReadListIntegrationTest, ReadListRejected)
+{
+    ASSERT_TRUE(!!SerialPort);
+
+    EnqueueConnection();
+    EnqueueRejectedReadList();
+    EnqueueSingleReadsWithScalers();
+
+    Note() << "LoopOnce()";
+    SerialDriver->LoopOnce();
+
+    // Get-Request-With-List is not sent again until reconnection
+    EnqueueSingleReadsValues();
+
+    Note() << "LoopOnce()";
+    SerialDriver->LoopOnce();
+}
+
+class TDlmsObjectsCacheExpectations: public virtual TExpectorProvider
+{
+protected:
+    // Connection and reading of serial number and firmware identifier
+    void EnqueueConnection()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x08, 0x02, 0x29, 0x41, 0x53, 0x9e, 0xb4, 0x7e},
+                           {0x7e, 0xa0, 0x21, 0x41, 0x02, 0x29, 0x73, 0x1b, 0x16, 0x81, 0x80, 0x14, 0x05, 0x02, 0x00,
+                            0x80, 0x06, 0x02, 0x00, 0x80, 0x07, 0x04, 0x00, 0x00, 0x00, 0x01, 0x08, 0x04, 0x00, 0x00,
+                            0x00, 0x01, 0xce, 0x6a, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x08, 0x02, 0x29, 0x41, 0x93, 0x92, 0x72, 0x7e},
+                           {0x7e, 0xa0, 0x21, 0x41, 0x02, 0x29, 0x73, 0x1b, 0x16, 0x81, 0x80, 0x14, 0x05, 0x02, 0x00,
+                            0x80, 0x06, 0x02, 0x00, 0x80, 0x07, 0x04, 0x00, 0x00, 0x00, 0x01, 0x08, 0x04, 0x00, 0x00,
+                            0x00, 0x01, 0xce, 0x6a, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x43, 0x02, 0x29, 0x41, 0x10, 0xcf, 0x42, 0xe6, 0xe6, 0x00, 0x60, 0x34, 0xa1,
+                            0x09, 0x06, 0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x01, 0x01, 0x8a, 0x02, 0x07, 0x80, 0x8b,
+                            0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x02, 0x01, 0xac, 0x08, 0x80, 0x06, 0x31, 0x31, 0x31,
+                            0x31, 0x31, 0x31, 0xbe, 0x10, 0x04, 0x0e, 0x01, 0x00, 0x00, 0x00, 0x06, 0x5f, 0x1f, 0x04,
+                            0x00, 0x00, 0x1e, 0x5d, 0xff, 0xff, 0xa0, 0xfd, 0x7e},
+                           {0x7e, 0xa0, 0x38, 0x41, 0x02, 0x29, 0x30, 0xa0, 0x83, 0xe6, 0xe7, 0x00, 0x61, 0x29, 0xa1,
+                            0x09, 0x06, 0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x01, 0x01, 0xa2, 0x03, 0x02, 0x01, 0x00,
+                            0xa3, 0x05, 0xa1, 0x03, 0x02, 0x01, 0x00, 0xbe, 0x10, 0x04, 0x0e, 0x08, 0x00, 0x06, 0x5f,
+                            0x1f, 0x04, 0x00, 0x00, 0x10, 0x1d, 0x00, 0x64, 0x00, 0x07, 0x82, 0x8b, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x32, 0xd9, 0x64, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x01, 0x00, 0x00, 0x60, 0x01, 0x00, 0xff, 0x02, 0x00, 0x89, 0xa0, 0x7e},
+                           {0x7e, 0xa0, 0x1b, 0x41, 0x02, 0x29, 0x52, 0xe9, 0xbe, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x0a, 0x08, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x8f, 0xfa, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x54, 0xe9, 0x62, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x01, 0x01, 0x00, 0x00, 0x02, 0x00, 0xff, 0x02, 0x00, 0x4b, 0xbb, 0x7e},
+                           {0x7e, 0xa0, 0x17, 0x41, 0x02, 0x29, 0x74, 0xed, 0x8d, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x0a, 0x04, 0x31, 0x2e, 0x30, 0x32, 0x4d, 0xc6, 0x7e},
+                           __func__);
+    }
+
+    // Scaler and unit are loaded from the cache
+    void EnqueueCachedRegisterRead()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x76, 0xf9, 0x60, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x02, 0x00, 0x53, 0x61, 0x7e},
+                           {0x7e, 0xa0, 0x14, 0x41, 0x02, 0x29, 0x96, 0x3d, 0x54, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x10, 0x00, 0x1e, 0x66, 0x3c, 0x7e},
+                           __func__);
+    }
+
+    void EnqueueRegisterRead()
+    {
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x76, 0xf9, 0x60, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x03, 0x00, 0x8b, 0x78, 0x7e},
+                           {0x7e, 0xa0, 0x17, 0x41, 0x02, 0x29, 0x96, 0xf1, 0x49, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x02, 0x02, 0x0f, 0x00, 0x16, 0x09, 0xae, 0xd5, 0x7e},
+                           __func__);
+        Expector()->Expect({0x7e, 0xa0, 0x1a, 0x02, 0x29, 0x41, 0x98, 0x89, 0x6e, 0xe6, 0xe6, 0x00, 0xc0, 0x01, 0xc1,
+                            0x00, 0x03, 0x00, 0x00, 0x60, 0x09, 0x00, 0xff, 0x02, 0x00, 0x53, 0x61, 0x7e},
+                           {0x7e, 0xa0, 0x14, 0x41, 0x02, 0x29, 0xb8, 0x41, 0x9c, 0xe6, 0xe7, 0x00, 0xc4, 0x01, 0x81,
+                            0x00, 0x10, 0x00, 0x1e, 0x66, 0x3c, 0x7e},
+                           __func__);
+    }
+};
+
+class TDlmsObjectsCacheIntegrationTest: public TDlmsIntegrationTest, public TDlmsObjectsCacheExpectations
+{
+protected:
+    const std::string TEMPERATURE_LOGICAL_NAME = "0.0.96.9.0.255";
+    const DLMS::TMeterIdentity METER_IDENTITY{"12345678", "1.02"};
+
+    std::filesystem::path CacheFilePath;
+    std::string MeterId;
+    std::unique_ptr<DLMS::TObjectsCacheStorage> ObjectsCache;
+
+    void SetUp() override
+    {
+        TDlmsIntegrationTest::SetUp();
+        CacheFilePath = std::filesystem::temp_directory_path() / "wb-mqtt-serial-dlms-objects-cache-test.json";
+        std::filesystem::remove(CacheFilePath);
+        MeterId = Config->PortConfigs[0]->Port->GetDescription(false) + ":20:1";
+    }
+
+    void TearDown() override
+    {
+        TDlmsIntegrationTest::TearDown();
+        std::filesystem::remove(CacheFilePath);
+    }
+
+    //! Simulates a driver started with objects cache stored by a previous run
+    void StartWithCachedObjects(const DLMS::TObjectsCacheEntry& entry)
+    {
+        DLMS::TObjectsCacheStorage(CacheFilePath).Set(MeterId, entry);
+        RegisterObjectsCache();
+    }
+
+    void RegisterObjectsCache()
+    {
+        ObjectsCache = std::make_unique<DLMS::TObjectsCacheStorage>(CacheFilePath);
+        DLMS::RegisterObjectsCache(*ObjectsCache, Config);
+    }
+};
+
+TEST_F(TDlmsObjectsCacheIntegrationTest, Miss)
+{
+    RegisterObjectsCache();
+
+    EnqueueConnection();
+    EnqueueRegisterRead();
+
+    Note() << "LoopOnce()";
+    SerialDriver->LoopOnce();
+
+    auto entry = DLMS::TObjectsCacheStorage(CacheFilePath).Find(MeterId, METER_IDENTITY);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->ScalerUnits, (std::map<std::string, DLMS::TScalerUnit>{{TEMPERATURE_LOGICAL_NAME, {0, 9}}}));
+}
+
+TEST_F(TDlmsObjectsCacheIntegrationTest, Hit)
+{
+    StartWithCachedObjects({METER_IDENTITY, {{TEMPERATURE_LOGICAL_NAME, {0, 9}}}});
+
+    EnqueueConnection();
+    EnqueueCachedRegisterRead();
+
+    Note() << "LoopOnce()";
+    SerialDriver->LoopOnce();
+}
+
+TEST_F(TDlmsObjectsCacheIntegrationTest, StaleEntry)
+{
+    // Scaler of the old firmware would give 300 instead of 30
+    StartWithCachedObjects({{METER_IDENTITY.SerialNumber, "1.01"}, {{TEMPERATURE_LOGICAL_NAME, {1, 9}}}});
+
+    EnqueueConnection();
+    EnqueueRegisterRead();
+
+    Note() << "LoopOnce()";
+    SerialDriver->LoopOnce();
+
+    auto entry = DLMS::TObjectsCacheStorage(CacheFilePath).Find(MeterId, METER_IDENTITY);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->ScalerUnits, (std::map<std::string, DLMS::TScalerUnit>{{TEMPERATURE_LOGICAL_NAME, {0, 9}}}));
+}
+
+class TDlmsRegisterRangeTest: public TSerialDeviceTest
+{};
+
+TEST_F(TDlmsRegisterRangeTest, PollLimit)
+{
+    TDlmsDeviceConfig config;
+    config.DeviceConfig = std::make_shared<TDeviceConfig>("dlms", "1", "dlms");
+    auto dev = std::make_shared<TDlmsDevice>(config, DeviceFactory.GetProtocol("dlms"));
+    std::vector<PRegister> regs;
+    for (uint32_t i = 0; i < 11; ++i) {
+        regs.push_back(dev->AddRegister(TRegisterConfig::Create(0, i, Double)));
+    }
+    auto fill = [&](std::chrono::milliseconds pollLimit) {
+        auto range = dev->CreateRegisterRange();
+        for (const auto& reg: regs) {
+            if (!range->Add(*SerialPort, reg, pollLimit)) {
+                break;
+            }
+        }
+        return range->RegisterList().size();
+    };
+
+    // At most 10 attributes are read by one Get-Request-With-List
+    EXPECT_EQ(fill(std::chrono::milliseconds::max()), 10);
+
+    // The first register is always added to be read at all
+    EXPECT_EQ(fill(std::chrono::milliseconds(1)), 1);
+
+    // At 9600 baud a request with a response for 10 attributes takes about 300 ms
+    auto count = fill(std::chrono::milliseconds(200));
+    EXPECT_GT(count, 1);
+    EXPECT_LT(count, 10);
+}
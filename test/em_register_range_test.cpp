@@ -0,0 +1,200 @@
+#include "crc16.h"
+#include "devices/mercury230_device.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <thread>
+
+using namespace std::chrono;
+
+namespace
+{
+    // Answers Mercury 230 requests and counts bytes on the bus
+    class TMercury230PortStub: public TPort
+    {
+    public:
+        size_t BytesOnBus = 0;
+        size_t SessionRequests = 0;
+        size_t ValueArrayRequests = 0;
+
+        void Open() override
+        {}
+        void Close() override
+        {}
+        bool IsOpen() const override
+        {
+            return true;
+        }
+        void CheckPortOpen() const override
+        {}
+        void WriteBytes(const uint8_t* buf, int count) override
+        {
+            BytesOnBus += count;
+            Response.assign(1, buf[0]);
+            switch (buf[1]) {
+                case 0x01: {
+                    ++SessionRequests;
+                    Response.push_back(0x00);
+                    break;
+                }
+                case 0x05: {
+                    ++ValueArrayRequests;
+                    Response.insert(Response.end(), 16, 0x01);
+                    break;
+                }
+                case 0x08: {
+                    Response.insert(Response.end(), 3, 0x02);
+                    break;
+                }
+            }
+            auto crc = CRC16::CalculateCRC16(Response.data(), Response.size());
+            Response.push_back(crc >> 8);
+            Response.push_back(crc & 0xFF);
+        }
+        uint8_t ReadByte(const microseconds& timeout) override
+        {
+            return 0;
+        }
+        TReadFrameResult ReadFrame(uint8_t* buf,
+                                   size_t count,
+                                   const microseconds& responseTimeout,
+                                   const microseconds& frameTimeout,
+                                   TFrameCompletePred frame_complete = 0) override
+        {
+            BytesOnBus += Response.size();
+            std::memcpy(buf, Response.data(), Response.size());
+            TReadFrameResult res;
+            res.Count = Response.size();
+            return res;
+        }
+        void SkipNoise() override
+        {}
+        void SleepSinceLastInteraction(const microseconds& us) override
+        {}
+        std::string GetDescription(bool verbose) const override
+        {
+            return std::string();
+        }
+        microseconds GetSendTimeBytes(double bytesNumber) const override
+        {
+            return microseconds(static_cast<int64_t>(bytesNumber * 1000));
+        }
+        microseconds GetSendTimeBits(size_t bitsNumber) const override
+        {
+            return microseconds(bitsNumber * 100);
+        }
+
+    private:
+        std::vector<uint8_t> Response;
+    };
+
+    class TEMRegisterRangeTest: public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            Device = std::make_shared<TMercury230Device>(std::make_shared<TDeviceConfig>("mercury230", "1", "mercury230"),
+                                                         &Protocol);
+            // Channels of templates mix value arrays and parameters
+            for (uint32_t phase = 0; phase < 3; ++phase) {
+                AddRegister(TMercury230Device::REG_VALUE_ARRAY, 0x00, U32, phase);
+                AddRegister(TMercury230Device::REG_PARAM, 0x1111 + phase, U24);
+                AddRegister(TMercury230Device::REG_VALUE_ARRAY, 0x01, U32, phase);
+            }
+        }
+
+        void AddRegister(int type, uint32_t address, RegisterFormat format, uint32_t dataOffset = 0)
+        {
+            Registers.push_back(Device->AddRegister(TRegisterConfig::Create(type,
+                                                                            address,
+                                                                            format,
+                                                                            1,
+                                                                            0,
+                                                                            0,
+                                                                            TRegisterConfig::TSporadicMode::DISABLED,
+                                                                            false,
+                                                                            "",
+                                                                            EWordOrder::BigEndian,
+                                                                            EByteOrder::BigEndian,
+                                                                            dataOffset)));
+        }
+
+        // Reads registers like a poller: next range is started when current one doesn't accept a register
+        size_t Poll(TPort& port, std::function<PRegisterRange()> createRange, milliseconds pollLimit)
+        {
+            size_t ranges = 0;
+            PRegisterRange range;
+            for (const auto& reg: Registers) {
+                if (range && range->Add(port, reg, pollLimit)) {
+                    continue;
+                }
+                if (range) {
+                    Device->ReadRegisterRange(port, range);
+                }
+                range = createRange();
+                EXPECT_TRUE(range->Add(port, reg, pollLimit));
+                ++ranges;
+            }
+            Device->ReadRegisterRange(port, range);
+            for (const auto& reg: Registers) {
+                EXPECT_EQ(reg->GetErrorState().count(), 0) << reg->ToString();
+            }
+            return ranges;
+        }
+
+        TUint32SlaveIdProtocol Protocol{"mercury230",
+                                        TRegisterTypes({{TMercury230Device::REG_VALUE_ARRAY, "array", "value", U32},
+                                                        {TMercury230Device::REG_PARAM, "param", "value", U24}})};
+        PMercury230Device Device;
+        std::vector<PRegister> Registers;
+    };
+}
+
+TEST_F(TEMRegisterRangeTest, ValueArraysAreReadOncePerCycle)
+{
+    TMercury230PortStub port;
+    EXPECT_EQ(Poll(port, [this]() { return Device->CreateRegisterRange(); }, milliseconds::max()), 1);
+    EXPECT_EQ(port.SessionRequests, 1);
+    EXPECT_EQ(port.ValueArrayRequests, 2);
+
+    EXPECT_EQ(Poll(port, [this]() { return Device->CreateRegisterRange(); }, milliseconds::max()), 1);
+    EXPECT_EQ(port.SessionRequests, 1);
+    EXPECT_EQ(port.ValueArrayRequests, 4);
+}
+
+TEST_F(TEMRegisterRangeTest, ValueArraysAreReadOncePerCycleInSeparateRanges)
+{
+    TMercury230PortStub port;
+    auto createRange = []() { return std::make_shared<TSameAddressRegisterRange>(); };
+    EXPECT_EQ(Poll(port, createRange, milliseconds::max()), Registers.size());
+    EXPECT_EQ(port.ValueArrayRequests, 2);
+
+    EXPECT_EQ(Poll(port, createRange, milliseconds::max()), Registers.size());
+    EXPECT_EQ(port.ValueArrayRequests, 4);
+}
+
+TEST_F(TEMRegisterRangeTest, OutdatedValueArraysAreReadAgain)
+{
+    TMercury230PortStub port;
+    auto read = [&](const PRegister& reg) {
+        auto range = std::make_shared<TSameAddressRegisterRange>();
+        EXPECT_TRUE(range->Add(port, reg, milliseconds::max()));
+        Device->ReadRegisterRange(port, range);
+    };
+    // Phases of array 0
+    read(Registers[0]);
+    read(Registers[3]);
+    EXPECT_EQ(port.ValueArrayRequests, 1);
+
+    std::this_thread::sleep_for(milliseconds(1100));
+    read(Registers[6]);
+    EXPECT_EQ(port.ValueArrayRequests, 2);
+}
+
+TEST_F(TEMRegisterRangeTest, PollLimit)
+{
+    TMercury230PortStub port;
+    // Each request takes 30 ms to send and 20 ms of frame timeout, registers with the same address are free
+    EXPECT_EQ(Poll(port, [this]() { return Device->CreateRegisterRange(); }, milliseconds(100)), 5);
+    EXPECT_EQ(port.ValueArrayRequests, 2);
+}
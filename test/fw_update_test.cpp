@@ -35,6 +35,11 @@ public:
         Errors[url] = error;
     }
 
+    void ClearError(const std::string& url)
+    {
+        Errors.erase(url);
+    }
+
     std::string GetText(const std::string& url) override
     {
         auto errIt = Errors.find(url);
@@ -130,6 +135,28 @@ TEST_F(WBFWParsingTest, LargeFile)
     ASSERT_EQ(result.Data.size(), 1360u);
 }
 
+TEST_F(WBFWParsingTest, ParseByChunks)
+{
+    std::vector<uint8_t> data(168);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i);
+    }
+
+    // Chunks don't match the info block boundary
+    TWBFWParser parser;
+    for (size_t i = 0; i < data.size(); i += 10) {
+        parser.Add(data.data() + i, std::min<size_t>(10, data.size() - i));
+    }
+    auto result = parser.Finish();
+    auto expected = ParseWBFW(data);
+    EXPECT_EQ(result.Info, expected.Info);
+    EXPECT_EQ(result.Data, expected.Data);
+
+    TWBFWParser shortParser;
+    shortParser.Add(data.data(), 30);
+    EXPECT_THROW(shortParser.Finish(), std::runtime_error);
+}
+
 // ============================================================
 //           2. Release YAML Parsing Tests
 // ============================================================
@@ -492,6 +519,53 @@ TEST_F(FwUpdateStateTest, RetainFlag)
     EXPECT_EQ(PublishLog.back().Topic, "/test/state");
 }
 
+TEST_F(FwUpdateStateTest, JobProgress)
+{
+    TFwUpdateState state(MakePublishFn(), "/test/state");
+    state.StartJob({{42, "/dev/ttyRS485-1"}, {43, "/dev/ttyRS485-2"}});
+
+    auto json = ParseLastPayload();
+    EXPECT_EQ(json["job"]["total"].asInt(), 2);
+    EXPECT_EQ(json["job"]["finished"].asInt(), 0);
+    EXPECT_EQ(json["job"]["progress"].asInt(), 0);
+    EXPECT_TRUE(json["job"]["eta"].isNull());
+
+    TDeviceUpdateInfo info;
+    info.PortPath = "/dev/ttyRS485-1";
+    info.Protocol = "modbus";
+    info.SlaveId = 42;
+    info.Progress = 50;
+    info.Type = "firmware";
+    state.Update(info);
+
+    json = ParseLastPayload();
+    EXPECT_EQ(json["job"]["progress"].asInt(), 25);
+    EXPECT_TRUE(json["job"]["eta"].isInt());
+
+    state.Remove(42, "/dev/ttyRS485-1", "firmware");
+    state.FinishJobDevice(42, "/dev/ttyRS485-1");
+    json = ParseLastPayload();
+    EXPECT_EQ(json["job"]["finished"].asInt(), 1);
+    EXPECT_EQ(json["job"]["progress"].asInt(), 50);
+
+    info.SlaveId = 43;
+    info.PortPath = "/dev/ttyRS485-2";
+    info.Progress = 10;
+    state.Update(info);
+    state.SetError(43, "/dev/ttyRS485-2", "firmware", "error_id", "error msg");
+    state.FinishJobDevice(43, "/dev/ttyRS485-2");
+
+    json = ParseLastPayload();
+    EXPECT_EQ(json["job"]["finished"].asInt(), 2);
+    EXPECT_EQ(json["job"]["failed"].asInt(), 1);
+    EXPECT_EQ(json["job"]["progress"].asInt(), 100);
+    EXPECT_EQ(json["job"]["eta"].asInt(), 0);
+
+    state.Reset();
+    json = ParseLastPayload();
+    EXPECT_FALSE(json.isMember("job"));
+}
+
 // ============================================================
 //           5. UpdateNotifier Tests
 // ============================================================
@@ -629,6 +703,21 @@ TEST_F(FwDownloaderTest, HTTPError)
     EXPECT_THROW(Downloader.DownloadAndParseWBFW("https://example.com/fail"), std::runtime_error);
 }
 
+TEST_F(FwDownloaderTest, DownloadWBFWOnce)
+{
+    std::string url = "https://example.com/fw.wbfw";
+    FakeHttp->SetError(url, "Connection refused");
+    EXPECT_THROW(Downloader.DownloadAndParseWBFW(url), std::runtime_error);
+
+    // Failed download is not reused
+    FakeHttp->ClearError(url);
+    FakeHttp->SetBinaryResponse(url, std::vector<uint8_t>(168, 0xDD));
+    Downloader.DownloadAndParseWBFW(url);
+    auto result = Downloader.DownloadAndParseWBFW(url);
+    EXPECT_EQ(result.Data.size(), 136u);
+    EXPECT_EQ(FakeHttp->GetRequestCount(url), 1);
+}
+
 TEST_F(FwDownloaderTest, CacheHit)
 {
     FakeHttp->SetTextResponse("https://fw-releases.wirenboard.com/fw/by-signature/release-versions.yaml",
@@ -649,6 +738,91 @@ TEST_F(FwDownloaderTest, CacheHit)
     EXPECT_EQ(firstCount, secondCount);
 }
 
+class FwDownloaderDiskCacheTest: public ::testing::Test
+{
+protected:
+    std::string CacheDir;
+    std::string IndexUrl = "https://fw-releases.wirenboard.com/fw/by-signature/release-versions.yaml";
+    std::string FwUrl = "https://fw-releases.wirenboard.com/fw/by-signature/wbled/bullseye/3.8.0.wbfw";
+
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/fw_cache_test_XXXXXX";
+        CacheDir = mkdtemp(tmpl);
+    }
+
+    void TearDown() override
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(CacheDir, ec);
+    }
+
+    std::shared_ptr<TFakeHttpClient> MakeOnlineHttpClient()
+    {
+        auto http = std::make_shared<TFakeHttpClient>();
+        http->SetTextResponse(IndexUrl, "releases:\n  wbled:\n    bullseye: fw/by-signature/wbled/bullseye/3.8.0.wbfw\n");
+        std::vector<uint8_t> wbfwData(168, 0xAA);
+        wbfwData[0] = 0x55;
+        http->SetBinaryResponse(FwUrl, wbfwData);
+        return http;
+    }
+};
+
+TEST_F(FwDownloaderDiskCacheTest, Offline)
+{
+    {
+        TFwDownloader downloader(MakeOnlineHttpClient(), CacheDir);
+        auto released = downloader.GetReleasedFirmware("wbled", "bullseye");
+        downloader.DownloadAndParseWBFW(released.Endpoint);
+    }
+
+    // After restart without network
+    auto offlineHttp = std::make_shared<TFakeHttpClient>();
+    offlineHttp->SetError(IndexUrl, "Could not resolve host");
+    offlineHttp->SetError(FwUrl, "Could not resolve host");
+    TFwDownloader downloader(offlineHttp, CacheDir);
+
+    auto released = downloader.GetReleasedFirmware("wbled", "bullseye");
+    EXPECT_EQ(released.Version, "3.8.0");
+    EXPECT_EQ(released.Endpoint, FwUrl);
+    auto firmware = downloader.DownloadAndParseWBFW(released.Endpoint);
+    ASSERT_EQ(firmware.Info.size(), 32u);
+    EXPECT_EQ(firmware.Info[0], 0x55);
+    EXPECT_EQ(firmware.Data, std::vector<uint8_t>(136, 0xAA));
+}
+
+TEST_F(FwDownloaderDiskCacheTest, NotCachedOffline)
+{
+    auto offlineHttp = std::make_shared<TFakeHttpClient>();
+    offlineHttp->SetError(FwUrl, "Could not resolve host");
+    TFwDownloader downloader(offlineHttp, CacheDir);
+
+    EXPECT_THROW(downloader.DownloadAndParseWBFW(FwUrl), std::runtime_error);
+}
+
+TEST_F(FwDownloaderDiskCacheTest, CorruptedFile)
+{
+    {
+        TFwDownloader downloader(MakeOnlineHttpClient(), CacheDir);
+        downloader.DownloadAndParseWBFW(FwUrl);
+    }
+    for (const auto& entry: std::filesystem::directory_iterator(CacheDir + "/data")) {
+        std::ofstream file(entry.path(), std::ios::binary | std::ios::app);
+        file << "garbage";
+    }
+
+    // Corrupted file is downloaded again
+    auto http = MakeOnlineHttpClient();
+    TFwDownloader downloader(http, CacheDir);
+    auto firmware = downloader.DownloadAndParseWBFW(FwUrl);
+    EXPECT_EQ(firmware.Data.size(), 136u);
+    EXPECT_EQ(http->GetRequestCount(FwUrl), 1);
+
+    // and cached again
+    TFwDownloader nextDownloader(std::make_shared<TFakeHttpClient>(), CacheDir);
+    EXPECT_EQ(nextDownloader.DownloadAndParseWBFW(FwUrl).Data.size(), 136u);
+}
+
 // ============================================================
 //           Shared Modbus test helpers
 // ============================================================
@@ -1329,6 +1503,113 @@ TEST_F(TFwTaskTest, FlashMultipleChunks)
     EXPECT_EQ(progressValues[2], 100); // 3/3
 }
 
+TEST_F(TFwTaskTest, FlashSliced)
+{
+    TParsedWBFW fw;
+    fw.Info.assign(32, 0x55);
+    fw.Data.assign(136 * 3, 0x66);
+
+    std::vector<int> infoData(fw.Info.begin(), fw.Info.end());
+    EnqueueWriteMultipleRegisters(FwRegisters::FW_INFO_BLOCK_ADDR, FwRegisters::FW_INFO_BLOCK_COUNT, infoData);
+    for (int i = 0; i < 3; ++i) {
+        std::vector<int> chunk(136, 0x66);
+        EnqueueWriteMultipleRegisters(FwRegisters::FW_DATA_BLOCK_ADDR, FwRegisters::FW_DATA_BLOCK_COUNT, chunk);
+    }
+
+    std::vector<int> progressValues;
+    bool completed = false;
+
+    TFwFlashSlicing slicing;
+    slicing.BlocksPerSlot = 1;
+    auto task = std::make_shared<TFwFlashTask>(
+        SLAVE_ID,
+        "modbus",
+        fw,
+        false,
+        false,
+        [&](int p) { progressValues.push_back(p); },
+        [&]() { completed = true; },
+        [&](const std::string&) {},
+        slicing);
+
+    // The bus is given to polling after every data block except the last one
+    EXPECT_EQ(task->Run(FeaturePort, *AccessHandler, EmptyDeviceList), ISerialClientTask::TRunResult::SUSPENDED);
+    EXPECT_EQ(progressValues.size(), 1u);
+    EXPECT_EQ(task->Run(FeaturePort, *AccessHandler, EmptyDeviceList), ISerialClientTask::TRunResult::SUSPENDED);
+    EXPECT_EQ(progressValues.size(), 2u);
+    EXPECT_FALSE(completed);
+    EXPECT_EQ(task->Run(FeaturePort, *AccessHandler, EmptyDeviceList), ISerialClientTask::TRunResult::OK);
+    EXPECT_TRUE(completed);
+    ASSERT_EQ(progressValues.size(), 3u);
+    EXPECT_EQ(progressValues[2], 100);
+}
+
+TEST_F(TFwTaskTest, FlashSlicedSuspendsPoll)
+{
+    TParsedWBFW fw;
+    fw.Info.assign(32, 0x55);
+    fw.Data.assign(136 * 2, 0x66);
+
+    std::vector<int> infoData(fw.Info.begin(), fw.Info.end());
+    EnqueueWriteMultipleRegisters(FwRegisters::FW_INFO_BLOCK_ADDR, FwRegisters::FW_INFO_BLOCK_COUNT, infoData);
+    for (int i = 0; i < 2; ++i) {
+        std::vector<int> chunk(136, 0x66);
+        EnqueueWriteMultipleRegisters(FwRegisters::FW_DATA_BLOCK_ADDR, FwRegisters::FW_DATA_BLOCK_COUNT, chunk);
+    }
+
+    std::vector<std::string> pollEvents;
+    TFwFlashSlicing slicing;
+    slicing.BlocksPerSlot = 1;
+    slicing.SuspendPoll = [&]() { pollEvents.push_back("suspend"); };
+    slicing.ResumePoll = [&]() { pollEvents.push_back("resume"); };
+    auto task = std::make_shared<TFwFlashTask>(
+        SLAVE_ID,
+        "modbus",
+        fw,
+        false,
+        false,
+        [&](int) {},
+        [&]() {},
+        [&](const std::string&) {},
+        slicing);
+
+    // Polling of the device is suspended before every slot and resumed after the last one
+    EXPECT_EQ(task->Run(FeaturePort, *AccessHandler, EmptyDeviceList), ISerialClientTask::TRunResult::SUSPENDED);
+    EXPECT_EQ(pollEvents, std::vector<std::string>({"suspend"}));
+    EXPECT_EQ(task->Run(FeaturePort, *AccessHandler, EmptyDeviceList), ISerialClientTask::TRunResult::OK);
+    EXPECT_EQ(pollEvents, std::vector<std::string>({"suspend", "suspend", "resume"}));
+}
+
+TEST_F(TFwTaskTest, FlashSlicedErrorResumesPoll)
+{
+    TParsedWBFW fw;
+    fw.Info.assign(32, 0x99);
+    fw.Data.assign(136, 0xAA);
+
+    SerialPort->SimulateDisconnect(TFakeSerialPort::SilentReadAndWriteFailure);
+
+    bool gotError = false;
+    std::vector<std::string> pollEvents;
+    TFwFlashSlicing slicing;
+    slicing.BlocksPerSlot = 1;
+    slicing.SuspendPoll = [&]() { pollEvents.push_back("suspend"); };
+    slicing.ResumePoll = [&]() { pollEvents.push_back("resume"); };
+    auto task = std::make_shared<TFwFlashTask>(
+        SLAVE_ID,
+        "modbus",
+        fw,
+        false,
+        false,
+        [&](int) {},
+        [&]() {},
+        [&](const std::string&) { gotError = true; },
+        slicing);
+
+    EXPECT_EQ(task->Run(FeaturePort, *AccessHandler, EmptyDeviceList), ISerialClientTask::TRunResult::OK);
+    EXPECT_TRUE(gotError);
+    EXPECT_EQ(pollEvents, std::vector<std::string>({"suspend", "resume"}));
+}
+
 TEST_F(TFwTaskTest, FlashPartialLastChunk)
 {
     // 136 + 50 bytes = not aligned to chunk size, last chunk gets padded
@@ -1584,6 +1865,29 @@ TEST_F(FwHandlerTest, ParseRequestParamsDefaultPortSettings)
     EXPECT_EQ(params.PortSettings.StopBits, 1);
 }
 
+TEST_F(FwHandlerTest, ParseRequestParamsSlicing)
+{
+    Json::Value request;
+    request["slave_id"] = 1;
+    request["port"]["path"] = "/dev/ttyRS485-1";
+
+    auto params = TRPCFwUpdateHandler::ParseRequestParams(request);
+    EXPECT_EQ(params.Slicing.BlocksPerSlot, 0u);
+    EXPECT_EQ(params.Slicing.BusShare, 100);
+
+    request["blocks_per_slot"] = 4;
+    request["bus_share"] = 30;
+    params = TRPCFwUpdateHandler::ParseRequestParams(request);
+    EXPECT_EQ(params.Slicing.BlocksPerSlot, 4u);
+    EXPECT_EQ(params.Slicing.BusShare, 30);
+
+    request["bus_share"] = 0;
+    EXPECT_THROW(TRPCFwUpdateHandler::ParseRequestParams(request), std::runtime_error);
+    request["bus_share"] = 30;
+    request["blocks_per_slot"] = -1;
+    EXPECT_THROW(TRPCFwUpdateHandler::ParseRequestParams(request), std::runtime_error);
+}
+
 // ---- MakePortRequestJson tests ----
 
 TEST_F(FwHandlerTest, MakePortRequestJson)
@@ -2305,6 +2609,20 @@ protected:
         Handler->Restore(request, MakeOnResult(), MakeOnError());
     }
 
+    void CallUpdateFleet(const Json::Value& request)
+    {
+        Handler->UpdateFleet(request, MakeOnResult(), MakeOnError());
+    }
+
+    Json::Value ParseLastState()
+    {
+        Json::CharReaderBuilder builder;
+        Json::Value state;
+        std::istringstream stream(PublishLog.back().Payload);
+        Json::parseFromStream(builder, stream, &state, nullptr);
+        return state;
+    }
+
     bool GetUpdateInProgress() const
     {
         return Handler->UpdateLock->InProgress;
@@ -2581,3 +2899,95 @@ TEST_F(FwHandlerIntegrationTest, RestoreBadRequest)
     ASSERT_TRUE(GotError);
     EXPECT_FALSE(GetUpdateInProgress());
 }
+
+// ---- UpdateFleet tests ----
+
+TEST_F(FwHandlerIntegrationTest, UpdateFleet)
+{
+    SetupReleasesYaml();
+    SetupBootloaderInfo();
+    SetupFirmwareDownload("wbled", "bullseye", "3.8.0");
+    for (int i = 0; i < 2; ++i) {
+        EnqueueBasicGetInfoResponses("wbled", "3.6.1", "1.5.0", "WB-LED");
+        EnqueueFlashExpectations(true, true);
+    }
+
+    Json::Value request;
+    request["devices"].append(MakeRequest(SLAVE_ID, "/dev/ttyRS485-1"));
+    request["devices"].append(MakeRequest(SLAVE_ID, "/dev/ttyRS485-2"));
+
+    CallUpdateFleet(request);
+
+    ASSERT_TRUE(GotResult);
+    ASSERT_FALSE(GotError);
+    EXPECT_EQ(LastResult.asString(), "Ok");
+    EXPECT_FALSE(GetUpdateInProgress());
+
+    // One task per port
+    ASSERT_EQ(TaskRunner->SubmittedTasks.size(), 2u);
+    EXPECT_EQ(TaskRunner->SubmittedTasks[0].Request["path"].asString(), "/dev/ttyRS485-1");
+    EXPECT_EQ(TaskRunner->SubmittedTasks[1].Request["path"].asString(), "/dev/ttyRS485-2");
+
+    // Devices with the same signature share the image
+    EXPECT_EQ(
+        FakeHttp->GetRequestCount("https://fw-releases.wirenboard.com/fw/by-signature/wbled/bullseye/3.8.0.wbfw"),
+        1);
+
+    auto state = ParseLastState();
+    EXPECT_EQ(state["devices"].size(), 0u);
+    EXPECT_EQ(state["job"]["total"].asInt(), 2);
+    EXPECT_EQ(state["job"]["finished"].asInt(), 2);
+    EXPECT_EQ(state["job"]["failed"].asInt(), 0);
+    EXPECT_EQ(state["job"]["progress"].asInt(), 100);
+}
+
+TEST_F(FwHandlerIntegrationTest, UpdateFleetDeviceNotResponding)
+{
+    SerialPort->SimulateDisconnect(TFakeSerialPort::SilentReadAndWriteFailure);
+
+    Json::Value request;
+    request["devices"].append(MakeRequest());
+
+    CallUpdateFleet(request);
+
+    // Errors of devices are reported via the state topic
+    ASSERT_TRUE(GotResult);
+    ASSERT_FALSE(GotError);
+    EXPECT_FALSE(GetUpdateInProgress());
+
+    auto state = ParseLastState();
+    ASSERT_EQ(state["devices"].size(), 1u);
+    EXPECT_FALSE(state["devices"][0]["error"].isNull());
+    EXPECT_EQ(state["job"]["finished"].asInt(), 1);
+    EXPECT_EQ(state["job"]["failed"].asInt(), 1);
+}
+
+TEST_F(FwHandlerIntegrationTest, UpdateFleetAlreadyInProgress)
+{
+    SetUpdateInProgress(true);
+
+    Json::Value request;
+    request["devices"].append(MakeRequest());
+
+    CallUpdateFleet(request);
+
+    ASSERT_FALSE(GotResult);
+    ASSERT_TRUE(GotError);
+    EXPECT_NE(LastErrorMsg.find("already executing"), std::string::npos);
+
+    SetUpdateInProgress(false);
+}
+
+TEST_F(FwHandlerIntegrationTest, UpdateFleetBadRequest)
+{
+    Json::Value request;
+    request["devices"] = Json::Value(Json::arrayValue);
+
+    CallUpdateFleet(request);
+
+    ASSERT_FALSE(GotResult);
+    ASSERT_TRUE(GotError);
+    EXPECT_NE(LastErrorMsg.find("devices"), std::string::npos);
+    EXPECT_FALSE(GetUpdateInProgress());
+    EXPECT_TRUE(TaskRunner->SubmittedTasks.empty());
+}
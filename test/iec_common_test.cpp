@@ -0,0 +1,53 @@
+#include "iec_common.h"
+#include "serial_exc.h"
+#include "gtest/gtest.h"
+
+namespace
+{
+    std::vector<uint8_t> MakeDataReadout(const std::string& data)
+    {
+        std::vector<uint8_t> res{IEC::STX};
+        res.insert(res.end(), data.begin(), data.end());
+        res.push_back(IEC::ETX);
+        res.push_back(IEC::CalcXorCRC(res.data() + 1, res.size() - 1));
+        return res;
+    }
+}
+
+TEST(TDataReadoutParserTest, Parse)
+{
+    auto msg = MakeDataReadout("1.8.0(019132.530*kWh)\r\n"
+                               "0.9.1(12:00:00)(01)\r\n"
+                               "F.F(00)32.7.0(230.1*V)\r\n"
+                               "(231.2*V)\r\n"
+                               "!\r\n");
+    // Noise before the message
+    msg.insert(msg.begin(), {'\r', '\n'});
+
+    IEC::TDataReadoutParser parser(IEC::CalcXorCRC);
+    for (size_t i = 1; i < msg.size(); ++i) {
+        ASSERT_FALSE(parser.Parse(msg.data(), i)) << i;
+    }
+    ASSERT_TRUE(parser.Parse(msg.data(), msg.size()));
+
+    auto& dataSets = parser.GetDataSets();
+    EXPECT_EQ(dataSets.size(), 4);
+    EXPECT_EQ(dataSets.at("1.8.0"), "(019132.530*kWh)");
+    EXPECT_EQ(dataSets.at("0.9.1"), "(12:00:00)(01)");
+    EXPECT_EQ(dataSets.at("F.F"), "(00)");
+    EXPECT_EQ(dataSets.at("32.7.0"), "(230.1*V)(231.2*V)");
+}
+
+TEST(TDataReadoutParserTest, Errors)
+{
+    auto msg = MakeDataReadout("1.8.0(019132.530*kWh)\r\n!\r\n");
+
+    IEC::TDataReadoutParser incompleteParser(IEC::CalcXorCRC);
+    EXPECT_FALSE(incompleteParser.Parse(msg.data(), msg.size() - 1));
+    EXPECT_THROW(incompleteParser.GetDataSets(), TSerialDeviceTransientErrorException);
+
+    msg.back() ^= 1;
+    IEC::TDataReadoutParser parser(IEC::CalcXorCRC);
+    EXPECT_TRUE(parser.Parse(msg.data(), msg.size()));
+    EXPECT_THROW(parser.GetDataSets(), TSerialDeviceTransientErrorException);
+}
@@ -0,0 +1,117 @@
+#include "devices/iec_mode_c_device.h"
+#include "fake_serial_port.h"
+#include <string>
+
+namespace
+{
+    class TIecModeCExpectations: public virtual TExpectorProvider
+    {
+    public:
+        void EnqueueStartSession(const std::string& identification)
+        {
+            Expector()->Expect(ExpectVectorFromString("/?141628345!\r\n"),
+                               ExpectVectorFromString(identification + "\r\n"),
+                               __func__);
+        }
+
+        void EnqueueGoToProgMode(char baudRateCode, bool response = true)
+        {
+            std::string request = "\x06"
+                                  "0";
+            request += baudRateCode;
+            request += "1\r\n";
+            Expector()->Expect(ExpectVectorFromString(request),
+                               response ? ExpectVectorFromString("\x01P0\x02(141628345)\x03\x5a")
+                                        : std::vector<int>(),
+                               __func__);
+        }
+
+        void EnqueueEndSession()
+        {
+            Expector()->Expect(ExpectVectorFromString("\x01"
+                                                      "B0\x03\x71"),
+                               {},
+                               __func__);
+        }
+    };
+
+    class TIecModeCTest: public TSerialDeviceTest, public TIecModeCExpectations
+    {
+    protected:
+        void SetUp() override
+        {
+            TSerialDeviceTest::SetUp();
+
+            auto config = std::make_shared<TDeviceConfig>("iec", "141628345", "iec_mode_c");
+            config->FrameTimeout = std::chrono::milliseconds(0);
+            Dev = std::make_shared<TIecModeCDevice>(config, DeviceFactory.GetProtocol("iec_mode_c"));
+
+            SerialPort->Open();
+        }
+
+        void Session(const std::string& identification, char baudRateCode)
+        {
+            EnqueueStartSession(identification);
+            EnqueueGoToProgMode(baudRateCode);
+            EnqueueEndSession();
+            Dev->Prepare(*SerialPort, TDevicePrepareMode::WITHOUT_SETUP);
+            Dev->EndSession(*SerialPort);
+        }
+
+        void FailedSession(const std::string& identification, char baudRateCode)
+        {
+            EnqueueStartSession(identification);
+            EnqueueGoToProgMode(baudRateCode, false);
+            EnqueueEndSession();
+            EXPECT_THROW(Dev->Prepare(*SerialPort, TDevicePrepareMode::WITHOUT_SETUP),
+                         TSerialDeviceTransientErrorException);
+        }
+
+        std::shared_ptr<TIecModeCDevice> Dev;
+    };
+}
+
+TEST_F(TIecModeCTest, BaudRateNegotiation)
+{
+    // The meter supports 19200
+    Session("/EKT6CE102M", '6');
+    // The meter supports only 4800
+    Session("/EKT4CE102M", '4');
+}
+
+TEST_F(TIecModeCTest, FallbackBaudRate)
+{
+    // The baud rate code is missing in identification message, 9600 must be used instead of desired 19200
+    Session("/EKTZCE102M", '5');
+    Session("/EKT", '5');
+}
+
+TEST_F(TIecModeCTest, BaudRateDowngrade)
+{
+    // Single timeouts don't affect the baud rate
+    FailedSession("/EKT6CE102M", '6');
+    Session("/EKT6CE102M", '6');
+    FailedSession("/EKT6CE102M", '6');
+    FailedSession("/EKT6CE102M", '6');
+    Session("/EKT6CE102M", '6');
+
+    // Timeouts in a row lower the baud rate
+    for (size_t i = 0; i < IEC::BAUD_RATE_FAILURES_THRESHOLD; ++i) {
+        FailedSession("/EKT6CE102M", '6');
+    }
+    for (size_t i = 0; i < IEC::BAUD_RATE_RAISE_SESSIONS; ++i) {
+        Session("/EKT6CE102M", '5');
+    }
+
+    // The higher baud rate is tried again after some successful sessions, it still fails
+    for (size_t i = 0; i < IEC::BAUD_RATE_FAILURES_THRESHOLD; ++i) {
+        FailedSession("/EKT6CE102M", '6');
+    }
+
+    // Next try is made after twice more sessions and succeeds
+    for (size_t i = 0; i < 2 * IEC::BAUD_RATE_RAISE_SESSIONS; ++i) {
+        Session("/EKT6CE102M", '5');
+    }
+    Session("/EKT6CE102M", '6');
+    Session("/EKT6CE102M", '6');
+}
@@ -0,0 +1,208 @@
+#include "gtest/gtest.h"
+#include "local_api_client.h"
+#include "local_api_server.h"
+
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace LocalApi;
+
+namespace
+{
+    class TFakeBackend: public ILocalApiBackend
+    {
+    public:
+        TReadResult Read(const std::string& channel) override
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            auto it = Values.find(channel);
+            if (it == Values.end()) {
+                return TReadResult{TStatus::NotFound, "", ""};
+            }
+            return TReadResult{TStatus::Ok, it->second, ""};
+        }
+
+        void Write(const std::string& channel, const std::string& value, TWriteCallback callback) override
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            if (!Values.count(channel)) {
+                lock.unlock();
+                callback(TWriteResult{TStatus::NotFound, ""});
+                return;
+            }
+            // Complete writes asynchronously as port thread does
+            PendingWrites.emplace_back(channel, value, callback);
+            if (PendingWrites.size() == CompleteAfter) {
+                auto writes = std::move(PendingWrites);
+                PendingWrites.clear();
+                Threads.emplace_back([this, writes]() {
+                    for (const auto& write: writes) {
+                        {
+                            std::unique_lock<std::mutex> lock(Mutex);
+                            Values[std::get<0>(write)] = std::get<1>(write);
+                        }
+                        if (std::get<1>(write) == "bad") {
+                            std::get<2>(write)(TWriteResult{TStatus::WriteError, "write failed"});
+                        } else {
+                            std::get<2>(write)(TWriteResult{TStatus::Ok, ""});
+                        }
+                    }
+                });
+            }
+        }
+
+        ~TFakeBackend()
+        {
+            for (auto& thread: Threads) {
+                thread.join();
+            }
+        }
+
+        std::mutex Mutex;
+        std::map<std::string, std::string> Values;
+        std::vector<std::tuple<std::string, std::string, TWriteCallback>> PendingWrites;
+        std::vector<std::thread> Threads;
+        size_t CompleteAfter = 1;
+    };
+}
+
+class TLocalApiTest: public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        SocketPath =
+            (std::filesystem::temp_directory_path() / ("wb-mqtt-serial-local-api-test-" + std::to_string(getpid())))
+                .string();
+        Backend = std::make_shared<TFakeBackend>();
+        Backend->Values = {{"dev/temperature", "23.5"}, {"dev/K1", "0"}, {"dev/K2", "1"}};
+        Server = std::make_shared<TLocalApiServer>(SocketPath, Backend);
+        Server->Start();
+    }
+
+    void TearDown() override
+    {
+        Server.reset();
+        EXPECT_FALSE(std::filesystem::exists(SocketPath));
+    }
+
+    std::string SocketPath;
+    std::shared_ptr<TFakeBackend> Backend;
+    PLocalApiServer Server;
+};
+
+TEST_F(TLocalApiTest, Protocol)
+{
+    auto data = EncodeWriteRequest(7, {{"dev/K1", "1"}, {"dev/K2", ""}});
+    std::string buffer = data.substr(0, 5);
+    EXPECT_FALSE(DecodeMessage(buffer));
+    buffer = data + EncodeReadRequest(8, {"dev/K1"});
+    auto message = DecodeMessage(buffer);
+    ASSERT_TRUE(message);
+    EXPECT_EQ(message->Type, TMessageType::WriteRequest);
+    EXPECT_EQ(message->RequestId, 7);
+    auto values = DecodeWriteRequest(message->Payload);
+    ASSERT_EQ(values.size(), 2);
+    EXPECT_EQ(values[0].first, "dev/K1");
+    EXPECT_EQ(values[1].second, "");
+
+    message = DecodeMessage(buffer);
+    ASSERT_TRUE(message);
+    EXPECT_EQ(message->Type, TMessageType::ReadRequest);
+    EXPECT_EQ(DecodeReadRequest(message->Payload), std::vector<std::string>{"dev/K1"});
+    EXPECT_TRUE(buffer.empty());
+
+    EXPECT_THROW(DecodeReadRequest(std::string("\x02\x00\x01\x00x", 5)), TProtocolError);
+    std::string tooBig("\xFF\xFF\xFF\x00", 4);
+    EXPECT_THROW(DecodeMessage(tooBig), TProtocolError);
+}
+
+TEST_F(TLocalApiTest, Read)
+{
+    TLocalApiClient client(SocketPath);
+    auto results = client.Read({"dev/temperature", "dev/unknown", "dev/K2"});
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0].Status, TStatus::Ok);
+    EXPECT_EQ(results[0].Value, "23.5");
+    EXPECT_EQ(results[1].Status, TStatus::NotFound);
+    EXPECT_EQ(results[2].Value, "1");
+}
+
+TEST_F(TLocalApiTest, Write)
+{
+    Backend->CompleteAfter = 2;
+    TLocalApiClient client(SocketPath);
+    auto results = client.Write({{"dev/K1", "1"}, {"dev/unknown", "1"}, {"dev/K2", "bad"}});
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0].Status, TStatus::Ok);
+    EXPECT_EQ(results[1].Status, TStatus::NotFound);
+    EXPECT_EQ(results[2].Status, TStatus::WriteError);
+    EXPECT_EQ(results[2].Error, "write failed");
+
+    auto values = client.Read({"dev/K1"});
+    EXPECT_EQ(values[0].Value, "1");
+
+    EXPECT_TRUE(client.Write({}).empty());
+}
+
+TEST_F(TLocalApiTest, MalformedRequest)
+{
+    TLocalApiClient client(SocketPath);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, SocketPath.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+    // Unknown message type
+    auto request = EncodeReadRequest(1, {"dev/K1"});
+    request[4] = 0x10;
+    ASSERT_EQ(send(fd, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    char buf[256];
+    auto size = recv(fd, buf, sizeof(buf), 0);
+    ASSERT_GT(size, 0);
+    std::string response(buf, size);
+    auto message = DecodeMessage(response);
+    ASSERT_TRUE(message);
+    EXPECT_EQ(message->Type, TMessageType::ErrorResponse);
+    EXPECT_EQ(message->RequestId, 1);
+
+    // Too big message closes the connection
+    std::string tooBig("\xFF\xFF\xFF\x00", 4);
+    ASSERT_EQ(send(fd, tooBig.data(), tooBig.size(), 0), 4);
+    EXPECT_EQ(recv(fd, buf, sizeof(buf), 0), 0);
+    close(fd);
+
+    // Other connections are served
+    EXPECT_EQ(client.Read({"dev/K1"})[0].Value, "0");
+}
+
+TEST_F(TLocalApiTest, ClientDoesntReadResponses)
+{
+    Backend->Values["dev/big"] = std::string(1000, 'x');
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, SocketPath.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+    // Every response is about 60 KB, the client sends requests and doesn't read responses.
+    // The server closes the connection when unsent responses exceed the buffer limit
+    // and the socket buffer of the server is full
+    auto request = EncodeReadRequest(1, std::vector<std::string>(60, "dev/big"));
+    bool closed = false;
+    for (size_t i = 0; i < 2000 && !closed; ++i) {
+        closed = (send(fd, request.data(), request.size(), MSG_NOSIGNAL) < 0);
+    }
+    EXPECT_TRUE(closed);
+    close(fd);
+
+    // Other connections are served
+    TLocalApiClient client(SocketPath);
+    EXPECT_EQ(client.Read({"dev/K1"})[0].Value, "0");
+}
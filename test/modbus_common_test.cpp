@@ -0,0 +1,168 @@
+#include "bin_utils.h"
+#include "modbus_common.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Straightforward per-register conversion, TReadResponseWords must give the same results
+    TRegisterValue GetReferenceRegisterValue(const std::vector<uint8_t>& data, const TRegisterConfig& reg, uint32_t index)
+    {
+        auto width = reg.Get16BitWidth();
+        auto start = data.data() + index * 2;
+        std::vector<uint16_t> words(width);
+        for (uint32_t i = 0; i < width; i++) {
+            if (reg.ByteOrder == EByteOrder::LittleEndian) {
+                words[i] = *(start + 1) << 8 | *start;
+            } else {
+                words[i] = *start << 8 | *(start + 1);
+            }
+            start += 2;
+        }
+        if (reg.WordOrder == EWordOrder::LittleEndian) {
+            std::reverse(words.begin(), words.end());
+        }
+        if (reg.IsString()) {
+            std::string str;
+            size_t offset = reg.Format == RegisterFormat::String8 ? 1 : 0;
+            size_t shift = offset;
+            auto it = words.begin();
+            while (it != words.end()) {
+                auto ch = static_cast<char>(*it >> shift * 8);
+                if (ch == '\0' || ch == '\xFF') {
+                    break;
+                }
+                str.push_back(ch);
+                if (shift > 0) {
+                    --shift;
+                    continue;
+                }
+                shift = offset;
+                ++it;
+            }
+            return TRegisterValue{str};
+        }
+        uint64_t value = 0;
+        for (auto word: words) {
+            value <<= 16;
+            value |= word;
+        }
+        value >>= reg.GetDataOffset();
+        value &= BinUtils::GetLSBMask(reg.GetDataWidth());
+        return TRegisterValue{value};
+    }
+
+    std::vector<uint8_t> MakeData()
+    {
+        std::vector<uint8_t> data(Modbus::MAX_READ_REGISTERS * 2);
+        uint32_t seed = 12345;
+        for (auto& byte: data) {
+            seed = seed * 1103515245 + 12345;
+            byte = static_cast<uint8_t>(seed >> 16);
+        }
+        return data;
+    }
+}
+
+TEST(TReadResponseWordsTest, SameAsPerRegisterConversion)
+{
+    auto data = MakeData();
+    // Printable characters for string registers
+    for (size_t i = 0; i < 20; ++i) {
+        data[i] = 'a' + i;
+    }
+
+    std::vector<PRegisterConfig> configs;
+    for (auto format: {U8, S8, U16, S16, S24, U24, U32, S32, S64, U64, BCD8, BCD16, BCD24, BCD32, Float, Double}) {
+        for (auto wordOrder: {EWordOrder::BigEndian, EWordOrder::LittleEndian}) {
+            for (auto byteOrder: {EByteOrder::BigEndian, EByteOrder::LittleEndian}) {
+                for (auto type: {Modbus::REG_HOLDING, Modbus::REG_INPUT}) {
+                    configs.push_back(
+                        TRegisterConfig::Create(type, 0, format, 1, 0, 0, {}, false, "", wordOrder, byteOrder));
+                }
+            }
+        }
+    }
+    // Bit fields
+    for (auto byteOrder: {EByteOrder::BigEndian, EByteOrder::LittleEndian}) {
+        configs.push_back(
+            TRegisterConfig::Create(Modbus::REG_HOLDING, 0, U16, 1, 0, 0, {}, false, "", {}, byteOrder, 3, 5));
+        configs.push_back(
+            TRegisterConfig::Create(Modbus::REG_INPUT, 0, U32, 1, 0, 0, {}, false, "", {}, byteOrder, 12, 9));
+    }
+    for (auto format: {String, String8}) {
+        for (auto wordOrder: {EWordOrder::BigEndian, EWordOrder::LittleEndian}) {
+            configs.push_back(TRegisterConfig::Create(Modbus::REG_HOLDING,
+                                                      0,
+                                                      format,
+                                                      1,
+                                                      0,
+                                                      0,
+                                                      {},
+                                                      false,
+                                                      "",
+                                                      wordOrder,
+                                                      EByteOrder::BigEndian,
+                                                      0,
+                                                      8 * 8));
+        }
+    }
+
+    Modbus::TReadResponseWords words(data);
+    for (const auto& config: configs) {
+        auto width = config->Get16BitWidth();
+        for (uint32_t index = 0; index + width <= Modbus::MAX_READ_REGISTERS; index += 7) {
+            Modbus::TRegisterCache cache;
+            auto value = words.GetRegisterValue(*config, index, cache);
+            EXPECT_EQ(value, GetReferenceRegisterValue(data, *config, index)) << config->ToString() << " " << index;
+            if (config->Type == Modbus::REG_HOLDING) {
+                EXPECT_EQ(cache.size(), width);
+            } else {
+                EXPECT_TRUE(cache.empty());
+            }
+        }
+    }
+}
+
+TEST(TReadResponseWordsTest, Cache)
+{
+    std::vector<uint8_t> data{0x01, 0x02, 0x03, 0x04};
+    Modbus::TReadResponseWords words(data);
+    Modbus::TRegisterCache cache;
+    auto reg = TRegisterConfig::Create(Modbus::REG_HOLDING, 10, U32, 1, 0, 0, {}, false, "", EWordOrder::LittleEndian);
+    EXPECT_EQ(words.GetRegisterValue(*reg, 0, cache), 0x03040102);
+    EXPECT_EQ(cache, Modbus::TRegisterCache({{10, 0x0102}, {11, 0x0304}}));
+
+    reg = TRegisterConfig::Create(Modbus::REG_HOLDING,
+                                  20,
+                                  U16,
+                                  1,
+                                  0,
+                                  0,
+                                  {},
+                                  false,
+                                  "",
+                                  EWordOrder::BigEndian,
+                                  EByteOrder::LittleEndian);
+    EXPECT_EQ(words.GetRegisterValue(*reg, 1, cache), 0x0403);
+    EXPECT_EQ(cache[20], 0x0403);
+
+    EXPECT_THROW(words.GetRegisterValue(*reg, 2, cache), Modbus::TMalformedResponseError);
+}
+
+TEST(TUnpackBitsTest, Unpack)
+{
+    std::vector<uint8_t> data(11);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 37 + 5);
+    }
+    auto words = Modbus::UnpackBits(data);
+    ASSERT_EQ(words.size(), 2);
+    for (size_t i = 0; i < data.size() * 8; ++i) {
+        EXPECT_EQ((words[i / 64] >> (i % 64)) & 1, (data[i / 8] >> (i % 8)) & 1u) << i;
+    }
+    EXPECT_EQ(words[1] >> 24, 0);
+
+    EXPECT_TRUE(Modbus::UnpackBits({}).empty());
+}
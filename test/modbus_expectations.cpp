@@ -3734,3 +3734,34 @@ void TModbusExpectations::EnqueueInputReadResponse(uint8_t addrLow, const std::v
                        WrapPDU(resp),
                        __func__);
 }
+
+void TModbusExpectations::EnqueueHoldingReadTimeout(uint8_t addrLow, uint8_t count)
+{
+    Expector()->Expect(WrapPDU({
+                           0x03,    // function code
+                           0x00,    // starting address Hi
+                           addrLow, // starting address Lo
+                           0x00,    // quantity Hi
+                           count,   // quantity Lo
+                       }),
+                       std::vector<int>(),
+                       __func__);
+}
+
+void TModbusExpectations::EnqueueCoilsReadResponse(uint8_t addrLow, uint8_t count, const std::vector<int>& status)
+{
+    std::vector<int> response{
+        0x01,                           // function code
+        static_cast<int>(status.size()) // byte count
+    };
+    response.insert(response.end(), status.begin(), status.end());
+    Expector()->Expect(WrapPDU({
+                           0x01,    // function code
+                           0x00,    // starting address Hi
+                           addrLow, // starting address Lo
+                           0x00,    // quantity Hi
+                           count,   // quantity Lo
+                       }),
+                       WrapPDU(response),
+                       __func__);
+}
@@ -116,4 +116,6 @@ public:
 
     /*--------------------------------------*/
     void EnqueueInputReadResponse(uint8_t addrLow, const std::vector<int>& data);
+    void EnqueueHoldingReadTimeout(uint8_t addrLow, uint8_t count);
+    void EnqueueCoilsReadResponse(uint8_t addrLow, uint8_t count, const std::vector<int>& status);
 };
@@ -0,0 +1,126 @@
+#include "modbus_read_planner.h"
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <wblib/json_utils.h>
+#include <wblib/testing/testlog.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    Modbus::TReadCostModel MakeModel(size_t maxRegisters, size_t maxHole)
+    {
+        Modbus::TReadCostModel model;
+        model.RequestOverhead = 1000us;
+        model.ByteTime = 100;
+        model.MaxRegisters = maxRegisters;
+        model.MaxHole = maxHole;
+        return model;
+    }
+
+    // Reproduces TModbusRegisterRange::Add merging rules without cost checks
+    std::vector<size_t> PlanGreedy(const std::vector<Modbus::TReadPlanItem>& items, const Modbus::TReadCostModel& model)
+    {
+        std::vector<size_t> res;
+        uint32_t start = 0;
+        uint32_t end = 0;
+        for (size_t i = 0; i < items.size(); ++i) {
+            auto itemEnd = items[i].Address + items[i].Width;
+            if (res.empty() || items[i].Address > end + model.MaxHole || itemEnd - start > model.MaxRegisters) {
+                res.push_back(i);
+                start = items[i].Address;
+            }
+            end = itemEnd;
+        }
+        return res;
+    }
+
+    uint32_t GetWidth(const std::string& format)
+    {
+        if (format == "s32" || format == "u32" || format == "float") {
+            return 2;
+        }
+        if (format == "s64" || format == "u64" || format == "double") {
+            return 4;
+        }
+        return 1;
+    }
+}
+
+TEST(TModbusReadPlannerTest, Empty)
+{
+    EXPECT_TRUE(Modbus::PlanReadRequests({}, MakeModel(10, 10)).empty());
+}
+
+TEST(TModbusReadPlannerTest, Contiguous)
+{
+    std::vector<Modbus::TReadPlanItem> items{{0, 1}, {1, 2}, {3, 1}};
+    EXPECT_EQ(Modbus::PlanReadRequests(items, MakeModel(10, 0)), std::vector<size_t>({0}));
+    EXPECT_EQ(Modbus::PlanReadRequests(items, MakeModel(2, 0)), std::vector<size_t>({0, 1, 2}));
+}
+
+TEST(TModbusReadPlannerTest, Holes)
+{
+    // Reading 2 unused registers is cheaper than a new request
+    std::vector<Modbus::TReadPlanItem> items{{0, 1}, {3, 1}};
+    EXPECT_EQ(Modbus::PlanReadRequests(items, MakeModel(20, 20)), std::vector<size_t>({0}));
+
+    // Reading 10 unused registers is more expensive than a new request
+    items = {{0, 1}, {11, 1}};
+    EXPECT_EQ(Modbus::PlanReadRequests(items, MakeModel(20, 20)), std::vector<size_t>({0, 1}));
+
+    // Max hole is exceeded
+    items = {{0, 1}, {3, 1}};
+    EXPECT_EQ(Modbus::PlanReadRequests(items, MakeModel(20, 1)), std::vector<size_t>({0, 1}));
+}
+
+TEST(TModbusReadPlannerTest, BetterThanGreedy)
+{
+    // Greedy: [0..4] + [5..7], optimal: [0] + [3..7]
+    std::vector<Modbus::TReadPlanItem> items{{0, 1}, {3, 2}, {5, 3}};
+    auto model = MakeModel(5, 10);
+    auto greedy = PlanGreedy(items, model);
+    EXPECT_EQ(greedy, std::vector<size_t>({0, 2}));
+    auto optimal = Modbus::PlanReadRequests(items, model);
+    EXPECT_EQ(optimal, std::vector<size_t>({0, 1}));
+    EXPECT_LT(Modbus::EstimateReadPlanTime(items, optimal, model), Modbus::EstimateReadPlanTime(items, greedy, model));
+}
+
+TEST(TModbusReadPlannerTest, SingleBit)
+{
+    auto model = MakeModel(2000, 100);
+    model.IsSingleBit = true;
+    EXPECT_EQ(Modbus::EstimateReadRequestTime(model, 1), 1100);
+    EXPECT_EQ(Modbus::EstimateReadRequestTime(model, 8), 1100);
+    EXPECT_EQ(Modbus::EstimateReadRequestTime(model, 9), 1200);
+
+    // 80 unused coils take 10 bytes, it is cheaper than a new request
+    std::vector<Modbus::TReadPlanItem> items{{0, 1}, {81, 1}};
+    EXPECT_EQ(Modbus::PlanReadRequests(items, model), std::vector<size_t>({0}));
+}
+
+TEST(TModbusReadPlannerTest, Template)
+{
+    // WB-MAP3E input registers, 9600 baud, 1ms response time
+    Json::Value templateJson = WBMQTT::JSON::Parse(
+        WBMQTT::Testing::TLoggedFixture::GetDataFilePath("../templates/config-map3e.json"));
+    std::vector<Modbus::TReadPlanItem> items;
+    for (const auto& channel: templateJson["device"]["channels"]) {
+        auto address = std::stoul(channel["address"].asString(), nullptr, 0);
+        items.push_back({static_cast<uint32_t>(address), GetWidth(channel.get("format", "u16").asString())});
+    }
+    std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) { return a.Address < b.Address; });
+
+    Modbus::TReadCostModel model;
+    model.ByteTime = 11 * 1000000.0 / 9600;
+    model.RequestOverhead = std::chrono::microseconds(static_cast<int>(16.5 * model.ByteTime)) + 1ms;
+    model.MaxRegisters = templateJson["device"]["max_read_registers"].asUInt();
+    model.MaxHole = 10;
+
+    auto greedy = PlanGreedy(items, model);
+    auto optimal = Modbus::PlanReadRequests(items, model);
+    auto greedyTime = Modbus::EstimateReadPlanTime(items, greedy, model);
+    auto optimalTime = Modbus::EstimateReadPlanTime(items, optimal, model);
+    EXPECT_LE(optimalTime, greedyTime);
+}
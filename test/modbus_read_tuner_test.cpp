@@ -0,0 +1,146 @@
+#include "modbus_common.h"
+#include "modbus_read_tuner.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+
+TEST(TModbusReadTunerTest, BinarySearch)
+{
+    // Device can read up to 37 registers at once
+    const int deviceLimit = 37;
+    Modbus::TReadBlockTuner tuner(1, Modbus::MAX_READ_REGISTERS);
+    size_t requests = 0;
+    while (tuner.GetResult().State == Modbus::TReadTuningState::IN_PROGRESS) {
+        auto count = tuner.GetMaxReadRegisters();
+        if (count <= deviceLimit) {
+            tuner.OnReadSuccess(count, false, 10);
+        } else {
+            tuner.OnReadFailure(count);
+        }
+        ++requests;
+        ASSERT_LT(requests, 10 * Modbus::READ_TUNING_FAILURES_THRESHOLD);
+    }
+    EXPECT_EQ(tuner.GetResult().MaxReadRegisters, deviceLimit);
+    EXPECT_EQ(tuner.GetMaxReadRegisters(), deviceLimit);
+}
+
+TEST(TModbusReadTunerTest, SmallRangeFailure)
+{
+    Modbus::TReadBlockTuner tuner(10, Modbus::MAX_READ_REGISTERS);
+    auto limit = tuner.GetMaxReadRegisters();
+
+    // Failed request is not larger than known good one, so it is not related to the size
+    tuner.OnReadFailure(5);
+    EXPECT_EQ(tuner.GetMaxReadRegisters(), limit);
+    EXPECT_EQ(tuner.GetResult().State, Modbus::TReadTuningState::IN_PROGRESS);
+    EXPECT_EQ(tuner.GetResult().MaxReadRegisters, 10);
+}
+
+TEST(TModbusReadTunerTest, SporadicFailures)
+{
+    Modbus::TReadBlockTuner tuner(10, Modbus::MAX_READ_REGISTERS);
+    auto limit = tuner.GetMaxReadRegisters();
+
+    // Occasional failures of large ranges caused by noise on the bus
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 1; j < Modbus::READ_TUNING_FAILURES_THRESHOLD; ++j) {
+            tuner.OnReadFailure(limit);
+        }
+        EXPECT_EQ(tuner.GetMaxReadRegisters(), limit);
+        tuner.OnReadSuccess(limit, false, 10);
+        EXPECT_EQ(tuner.GetResult().State, Modbus::TReadTuningState::IN_PROGRESS);
+        EXPECT_EQ(tuner.GetResult().MaxReadRegisters, limit);
+        EXPECT_GT(tuner.GetMaxReadRegisters(), limit);
+        limit = tuner.GetMaxReadRegisters();
+    }
+}
+
+TEST(TModbusReadTunerTest, RepeatedFailures)
+{
+    Modbus::TReadBlockTuner tuner(10, Modbus::MAX_READ_REGISTERS);
+    auto limit = tuner.GetMaxReadRegisters();
+
+    for (size_t i = 1; i < Modbus::READ_TUNING_FAILURES_THRESHOLD; ++i) {
+        tuner.OnReadFailure(limit);
+        // Small ranges are read successfully between failures
+        tuner.OnReadSuccess(5, false, 10);
+        EXPECT_EQ(tuner.GetMaxReadRegisters(), limit);
+    }
+    tuner.OnReadFailure(limit);
+    EXPECT_LT(tuner.GetMaxReadRegisters(), limit);
+    EXPECT_GE(tuner.GetMaxReadRegisters(), 10);
+}
+
+TEST(TModbusReadTunerTest, NoLargerRanges)
+{
+    // Polled registers form ranges up to 20 registers
+    Modbus::TReadBlockTuner tuner(1, Modbus::MAX_READ_REGISTERS);
+    for (size_t i = 0; i < 100 && tuner.GetResult().State == Modbus::TReadTuningState::IN_PROGRESS; ++i) {
+        tuner.OnReadSuccess(std::min(20, tuner.GetMaxReadRegisters()), false, 5);
+    }
+    EXPECT_EQ(tuner.GetResult().State, Modbus::TReadTuningState::FINISHED);
+    EXPECT_EQ(tuner.GetResult().MaxReadRegisters, 20);
+    EXPECT_EQ(tuner.GetMaxReadRegisters(), 20);
+}
+
+TEST(TModbusReadTunerTest, Holes)
+{
+    Modbus::TReadBlockTuner tuner(1, Modbus::MAX_READ_REGISTERS);
+    EXPECT_TRUE(tuner.GetResult().SupportsHoles);
+    for (size_t i = 1; i < Modbus::READ_TUNING_FAILURES_THRESHOLD; ++i) {
+        tuner.OnHolesNotSupported();
+    }
+    EXPECT_TRUE(tuner.GetResult().SupportsHoles);
+
+    // Successful read of a range with holes resets failures
+    tuner.OnReadSuccess(5, true, 10);
+    tuner.OnHolesNotSupported();
+    EXPECT_TRUE(tuner.GetResult().SupportsHoles);
+
+    for (size_t i = 1; i < Modbus::READ_TUNING_FAILURES_THRESHOLD; ++i) {
+        tuner.OnHolesNotSupported();
+    }
+    EXPECT_FALSE(tuner.GetResult().SupportsHoles);
+}
+
+TEST(TModbusReadTunerTest, Restore)
+{
+    Modbus::TReadBlockTuner tuner(1, Modbus::MAX_READ_REGISTERS);
+    Modbus::TReadTuning tuning;
+    tuning.State = Modbus::TReadTuningState::FINISHED;
+    tuning.MaxReadRegisters = 42;
+    tuning.SupportsHoles = false;
+    tuner.Restore(tuning);
+    EXPECT_EQ(tuner.GetResult(), tuning);
+    EXPECT_EQ(tuner.GetMaxReadRegisters(), 42);
+
+    // Learned value can't exceed protocol limit
+    tuning.MaxReadRegisters = 1000;
+    tuner.Restore(tuning);
+    EXPECT_EQ(tuner.GetMaxReadRegisters(), 42);
+}
+
+TEST(TModbusReadTunerTest, Storage)
+{
+    auto filePath = std::filesystem::temp_directory_path() / "wb-mqtt-serial-read-tuning-test.json";
+    std::filesystem::remove(filePath);
+
+    Modbus::TReadTuning tuning;
+    tuning.State = Modbus::TReadTuningState::FINISHED;
+    tuning.MaxReadRegisters = 60;
+    tuning.SupportsHoles = false;
+    {
+        Modbus::TReadTuningStorage storage(filePath);
+        Modbus::TReadTuning res;
+        EXPECT_FALSE(storage.Get("/dev/ttyRS485-1:1", res));
+        storage.Set("/dev/ttyRS485-1:1", tuning);
+    }
+
+    Modbus::TReadTuningStorage storage(filePath);
+    Modbus::TReadTuning res;
+    EXPECT_TRUE(storage.Get("/dev/ttyRS485-1:1", res));
+    EXPECT_EQ(res, tuning);
+    EXPECT_FALSE(storage.Get("/dev/ttyRS485-1:2", res));
+
+    std::filesystem::remove(filePath);
+}
@@ -534,6 +534,152 @@ TEST_F(TModbusTest, SkipNoiseAtPacketEnd)
     EXPECT_NO_THROW(dev->ReadRegisterRange(*SerialPort, range));
 }
 
+TEST_F(TModbusTest, OptimizedReadRangesBitFields)
+{
+    auto deviceConfig = GetDeviceConfig();
+    deviceConfig.OptimizeReadRanges = true;
+    auto dev = std::make_shared<TModbusDevice>(std::make_unique<Modbus::TModbusRTUTraits>(),
+                                               deviceConfig,
+                                               DeviceFactory.GetProtocol("modbus"));
+    auto holding = dev->AddRegister(TRegisterConfig::Create(Modbus::REG_HOLDING, 70, U16));
+    std::vector<PRegister> bitFields;
+    for (uint32_t bit = 0; bit < 3; ++bit) {
+        TRegisterDesc desc;
+        desc.Address = std::make_shared<TUint32RegisterAddress>(200);
+        desc.DataOffset = bit;
+        desc.DataWidth = 1;
+        auto reg = dev->AddRegister(TRegisterConfig::Create(Modbus::REG_HOLDING, desc, U16));
+        // Registers with unknown availability are read one by one regardless of the plan
+        reg->SetAvailable(TRegisterAvailability::AVAILABLE);
+        bitFields.push_back(reg);
+    }
+
+    // The first read builds read ranges plan, the register 200 is too far and starts a new request
+    EnqueueHoldingReadU16Response();
+    auto range = dev->CreateRegisterRange();
+    range->Add(*SerialPort, holding, std::chrono::milliseconds::max());
+    dev->ReadRegisterRange(*SerialPort, range);
+    ASSERT_TRUE(dev->IsReadRequestStart(Modbus::REG_HOLDING, 200));
+
+    // All bit fields of the register must be read by one request
+    range = dev->CreateRegisterRange();
+    for (const auto& reg: bitFields) {
+        EXPECT_TRUE(range->Add(*SerialPort, reg, std::chrono::milliseconds::max()));
+    }
+    EXPECT_EQ(range->RegisterList().size(), 3);
+}
+
+TEST_F(TModbusTest, ReadTuningKeepsConfig)
+{
+    auto deviceConfig = GetDeviceConfig();
+    deviceConfig.AutoMaxReadRegisters = true;
+    auto dev = std::make_shared<TModbusDevice>(std::make_unique<Modbus::TModbusRTUTraits>(),
+                                               deviceConfig,
+                                               DeviceFactory.GetProtocol("modbus"));
+    // The search starts from the middle between configured and the largest possible sizes
+    EXPECT_EQ(dev->GetMaxReadRegisters(), 10 + (Modbus::MAX_READ_REGISTERS + 1 - 10) / 2);
+    // Holes are explicitly disabled in config
+    EXPECT_EQ(dev->GetMaxReadHole(false), 0);
+    EXPECT_EQ(dev->GetMaxReadHole(true), 0);
+    EXPECT_EQ(dev->DeviceConfig()->MaxReadRegisters, 10);
+
+    // Holes aren't set in config, they are checked with default limits
+    deviceConfig = GetDeviceConfig();
+    deviceConfig.AutoMaxReadRegisters = true;
+    deviceConfig.AutoMaxReadHoles = true;
+    dev = std::make_shared<TModbusDevice>(std::make_unique<Modbus::TModbusRTUTraits>(),
+                                          deviceConfig,
+                                          DeviceFactory.GetProtocol("modbus"));
+    EXPECT_EQ(dev->GetMaxReadHole(false), Modbus::MAX_HOLE_CONTINUOUS_16_BIT_REGISTERS);
+    EXPECT_EQ(dev->GetMaxReadHole(true), Modbus::MAX_HOLE_CONTINUOUS_1_BIT_REGISTERS);
+    EXPECT_EQ(dev->DeviceConfig()->MaxRegHole, 0);
+    EXPECT_EQ(dev->DeviceConfig()->MaxBitHole, 0);
+    EXPECT_EQ(dev->DeviceConfig()->MaxReadRegisters, 10);
+}
+
+TEST_F(TModbusTest, ReadTuningTimeouts)
+{
+    auto deviceConfig = GetDeviceConfig();
+    deviceConfig.AutoMaxReadRegisters = true;
+    deviceConfig.CommonConfig->FrameTimeout = 0ms;
+    deviceConfig.CommonConfig->ResponseTimeout = 1ms;
+    auto dev = std::make_shared<TModbusDevice>(std::make_unique<Modbus::TModbusRTUTraits>(),
+                                               deviceConfig,
+                                               DeviceFactory.GetProtocol("modbus"));
+    auto holding = dev->AddRegister(TRegisterConfig::Create(Modbus::REG_HOLDING, 70, U16));
+    std::vector<PRegister> block;
+    for (uint32_t addr = 0; addr < 20; ++addr) {
+        auto reg = dev->AddRegister(TRegisterConfig::Create(Modbus::REG_HOLDING, addr, U16));
+        reg->SetAvailable(TRegisterAvailability::AVAILABLE);
+        block.push_back(reg);
+    }
+
+    EnqueueHoldingReadU16Response();
+    auto range = dev->CreateRegisterRange();
+    range->Add(*SerialPort, holding, std::chrono::milliseconds::max());
+    dev->ReadRegisterRange(*SerialPort, range);
+    auto limit = dev->GetMaxReadRegisters();
+
+    // The device silently drops requests larger than the known good size
+    for (size_t i = 0; i < Modbus::READ_TUNING_FAILURES_THRESHOLD; ++i) {
+        EnqueueHoldingReadTimeout(0, block.size());
+        range = dev->CreateRegisterRange();
+        for (const auto& reg: block) {
+            range->Add(*SerialPort, reg, std::chrono::milliseconds::max());
+        }
+        dev->ReadRegisterRange(*SerialPort, range);
+    }
+    EXPECT_LT(dev->GetMaxReadRegisters(), limit);
+    EXPECT_EQ(dev->GetMaxReadRegisters(), 10 + (20 - 10) / 2);
+    EXPECT_EQ(dev->DeviceConfig()->MaxReadRegisters, 10);
+}
+
+TEST_F(TModbusTest, SingleBitChangeDetection)
+{
+    auto deviceConfig = GetDeviceConfig();
+    deviceConfig.CommonConfig->MaxReadRegisters = Modbus::MAX_READ_REGISTERS;
+    auto dev = std::make_shared<TModbusDevice>(std::make_unique<Modbus::TModbusRTUTraits>(),
+                                               deviceConfig,
+                                               DeviceFactory.GetProtocol("modbus"));
+    auto coil0 = dev->AddRegister(TRegisterConfig::Create(Modbus::REG_COIL, 0, U8));
+    std::vector<PRegister> coils;
+    for (uint32_t i = 0; i < 70; ++i) {
+        coils.push_back(dev->AddRegister(TRegisterConfig::Create(Modbus::REG_COIL, 100 + i, U8)));
+    }
+    auto read = [&](const std::vector<int>& status) {
+        EnqueueCoilsReadResponse(100, 70, status);
+        auto range = dev->CreateRegisterRange();
+        for (const auto& reg: coils) {
+            range->Add(*SerialPort, reg, std::chrono::milliseconds::max());
+        }
+        dev->ReadRegisterRange(*SerialPort, range);
+    };
+
+    read({0x02, 0, 0, 0, 0, 0, 0, 0, 0});
+    EXPECT_EQ(coils[1]->GetValue(), 1);
+    EXPECT_EQ(coils[66]->GetValue(), 0);
+
+    // Registers of unchanged bits are not visited, so the error set by the test stays
+    coils[5]->SetError(TRegister::TError::ReadError);
+    read({0x02, 0, 0, 0, 0, 0, 0, 0, 0x04});
+    EXPECT_EQ(coils[66]->GetValue(), 1);
+    EXPECT_TRUE(coils[5]->GetErrorState().test(TRegister::TError::ReadError));
+
+    // A write invalidates previous reads, all registers are updated
+    EnqueueCoilWriteResponse();
+    dev->WriteRegister(*SerialPort, coil0, 1);
+    read({0x02, 0, 0, 0, 0, 0, 0, 0, 0x04});
+    EXPECT_FALSE(coils[5]->GetErrorState().test(TRegister::TError::ReadError));
+
+    // Errors of a failed read are cleared by the next successful one
+    read({});
+    EXPECT_TRUE(coils[5]->GetErrorState().test(TRegister::TError::ReadError));
+    read({0x02, 0, 0, 0, 0, 0, 0, 0, 0x04});
+    for (const auto& reg: coils) {
+        EXPECT_FALSE(reg->GetErrorState().test(TRegister::TError::ReadError));
+    }
+}
+
 class TModbusIntegrationTest: public TSerialDeviceIntegrationTest, public TModbusExpectations
 {
 protected:
@@ -1232,6 +1378,53 @@ TEST_F(TModbusPublishTest, DuplicateValues)
     }
 }
 
+class TModbusDeadbandPublishTest: public TSerialDeviceIntegrationTest
+{
+protected:
+    void SetUp() override
+    {
+        TSerialDeviceIntegrationTest::SetUp();
+        SetMode(E_Normal);
+    }
+    const char* ConfigPath() const override
+    {
+        return "configs/config-modbus-deadband-test.json";
+    }
+};
+
+// Check which values are published and which are suppressed for channels with
+// "deadband" (5), "deadband_percent" (10%) and "max_unchanged_interval" (1 s, with deadband 100).
+// Every step sets values of Absolute, Interval and Percent channels.
+TEST_F(TModbusDeadbandPublishTest, SuppressSmallChanges)
+{
+    auto driver = SerialDriver->GetPortDrivers().front();
+    auto& deviceRegs = driver->GetSerialClient()->GetDevices().front()->GetRegisters();
+    std::vector<PRegister> regs(deviceRegs.begin(), deviceRegs.end());
+    ASSERT_EQ(regs.size(), 3);
+
+    auto readValues = [&](const std::vector<uint64_t>& values) {
+        for (size_t i = 0; i < regs.size(); ++i) {
+            regs[i]->SetValue(TRegisterValue{values[i]});
+            driver->OnValueRead(regs[i]);
+        }
+    };
+
+    Note() << "first values are published";
+    readValues({100, 10, 200});
+
+    Note() << "changes within deadband are suppressed";
+    readValues({103, 20, 219});
+
+    Note() << "changes reaching deadband are published";
+    readValues({105, 30, 220});
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+    // Deadband is compared with the last published value, not with the last read one
+    Note() << "max_unchanged_interval elapsed";
+    readValues({101, 40, 240});
+}
+
 class TModbusPushbuttonPublishTest: public TSerialDeviceIntegrationTest
 {
 protected:
@@ -0,0 +1,199 @@
+#include "crc16.h"
+#include "modbus_common.h"
+#include "serial_exc.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstring>
+#include <list>
+
+using namespace std::chrono;
+
+namespace
+{
+    class TPortMock: public TPort
+    {
+    public:
+        std::vector<std::vector<uint8_t>> Requests;
+        std::list<std::vector<uint8_t>> Responses;
+
+        void Open() override
+        {}
+        void Close() override
+        {}
+        bool IsOpen() const override
+        {
+            return true;
+        }
+        void CheckPortOpen() const override
+        {}
+
+        void WriteBytes(const uint8_t* buf, int count) override
+        {
+            Requests.emplace_back(buf, buf + count);
+        }
+
+        uint8_t ReadByte(const std::chrono::microseconds& timeout) override
+        {
+            return 0;
+        }
+
+        TReadFrameResult ReadFrame(uint8_t* buf,
+                                   size_t count,
+                                   const std::chrono::microseconds& responseTimeout,
+                                   const std::chrono::microseconds& frameTimeout,
+                                   TFrameCompletePred frame_complete = 0) override
+        {
+            if (Responses.empty()) {
+                throw TResponseTimeoutException();
+            }
+            TReadFrameResult res;
+            res.Count = Responses.front().size();
+            memcpy(buf, Responses.front().data(), Responses.front().size());
+            Responses.pop_front();
+            return res;
+        }
+
+        void SkipNoise() override
+        {}
+
+        void SleepSinceLastInteraction(const std::chrono::microseconds& us) override
+        {}
+
+        std::string GetDescription(bool verbose) const override
+        {
+            return std::string();
+        }
+
+        std::chrono::microseconds GetSendTimeBytes(double bytesNumber) const override
+        {
+            return GetSendTimeBits(std::ceil(11 * bytesNumber));
+        }
+
+        std::chrono::microseconds GetSendTimeBits(size_t bitsNumber) const override
+        {
+            return std::chrono::microseconds(static_cast<int64_t>(std::ceil((1000000.0 * bitsNumber) / 115200.0)));
+        }
+
+        // Adds RTU frame with slave id 1 and CRC
+        void AddResponse(std::vector<uint8_t> pdu)
+        {
+            pdu.insert(pdu.begin(), 1);
+            auto crc = CRC16::CalculateCRC16(pdu.data(), pdu.size());
+            pdu.push_back(crc >> 8);
+            pdu.push_back(crc & 0xFF);
+            Responses.push_back(pdu);
+        }
+
+        // Returns PDU of the request
+        std::vector<uint8_t> GetRequestPdu(size_t index) const
+        {
+            return std::vector<uint8_t>(Requests[index].begin() + 1, Requests[index].end() - 2);
+        }
+    };
+
+    TRegisterWriteRequest MakeRequest(int type, uint32_t address, uint64_t value, RegisterFormat format = U16)
+    {
+        auto config = TRegisterConfig::Create(type, address, format);
+        return TRegisterWriteRequest{std::make_shared<TRegister>(nullptr, config), TRegisterValue{value}, nullptr};
+    }
+}
+
+class TModbusWriteRegistersTest: public testing::Test
+{
+protected:
+    void WriteRegisters(std::vector<TRegisterWriteRequest>& requests, size_t maxRegisters)
+    {
+        Modbus::WriteRegisters(Traits, Port, 1, requests, maxRegisters, Cache, 0us, 100ms, 10ms);
+    }
+
+    TPortMock Port;
+    Modbus::TModbusRTUTraits Traits;
+    Modbus::TRegisterCache Cache;
+};
+
+TEST_F(TModbusWriteRegistersTest, HoldingRegisters)
+{
+    std::vector<TRegisterWriteRequest> requests{MakeRequest(Modbus::REG_HOLDING, 10, 0x0102),
+                                                MakeRequest(Modbus::REG_HOLDING, 11, 0x03040506, U32),
+                                                MakeRequest(Modbus::REG_HOLDING, 13, 0x0708),
+                                                MakeRequest(Modbus::REG_HOLDING, 20, 0x090A)};
+    Port.AddResponse({0x10, 0x00, 0x0A, 0x00, 0x04});
+    Port.AddResponse({0x06, 0x00, 0x14, 0x09, 0x0A});
+    WriteRegisters(requests, Modbus::MAX_WRITE_REGISTERS);
+
+    ASSERT_EQ(Port.Requests.size(), 2);
+    EXPECT_EQ(Port.GetRequestPdu(0),
+              std::vector<uint8_t>(
+                  {0x10, 0x00, 0x0A, 0x00, 0x04, 0x08, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08}));
+    EXPECT_EQ(Port.GetRequestPdu(1), std::vector<uint8_t>({0x06, 0x00, 0x14, 0x09, 0x0A}));
+    for (const auto& request: requests) {
+        EXPECT_FALSE(request.Error);
+    }
+}
+
+TEST_F(TModbusWriteRegistersTest, Coils)
+{
+    std::vector<TRegisterWriteRequest> requests;
+    for (uint32_t i = 0; i < 10; ++i) {
+        requests.push_back(MakeRequest(Modbus::REG_COIL, i, i % 3 == 0));
+    }
+    Port.AddResponse({0x0F, 0x00, 0x00, 0x00, 0x0A});
+    WriteRegisters(requests, Modbus::MAX_WRITE_REGISTERS);
+
+    ASSERT_EQ(Port.Requests.size(), 1);
+    EXPECT_EQ(Port.GetRequestPdu(0), std::vector<uint8_t>({0x0F, 0x00, 0x00, 0x00, 0x0A, 0x02, 0x49, 0x02}));
+}
+
+TEST_F(TModbusWriteRegistersTest, MaxRegisters)
+{
+    std::vector<TRegisterWriteRequest> requests{MakeRequest(Modbus::REG_HOLDING, 1, 1),
+                                                MakeRequest(Modbus::REG_HOLDING, 2, 2),
+                                                MakeRequest(Modbus::REG_HOLDING, 3, 3)};
+    Port.AddResponse({0x10, 0x00, 0x01, 0x00, 0x02});
+    Port.AddResponse({0x06, 0x00, 0x03, 0x00, 0x03});
+    WriteRegisters(requests, 2);
+    ASSERT_EQ(Port.Requests.size(), 2);
+    EXPECT_EQ(Port.GetRequestPdu(0)[0], 0x10);
+    EXPECT_EQ(Port.GetRequestPdu(1)[0], 0x06);
+
+    // Combining is disabled
+    Port.Requests.clear();
+    Port.AddResponse({0x06, 0x00, 0x01, 0x00, 0x01});
+    Port.AddResponse({0x06, 0x00, 0x02, 0x00, 0x02});
+    Port.AddResponse({0x06, 0x00, 0x03, 0x00, 0x03});
+    WriteRegisters(requests, 1);
+    EXPECT_EQ(Port.Requests.size(), 3);
+}
+
+TEST_F(TModbusWriteRegistersTest, MaxCoils)
+{
+    std::vector<TRegisterWriteRequest> requests;
+    for (uint32_t i = 0; i < 5; ++i) {
+        requests.push_back(MakeRequest(Modbus::REG_COIL, i, 1));
+    }
+    Port.AddResponse({0x0F, 0x00, 0x00, 0x00, 0x03});
+    Port.AddResponse({0x0F, 0x00, 0x03, 0x00, 0x02});
+    WriteRegisters(requests, 3);
+
+    ASSERT_EQ(Port.Requests.size(), 2);
+    EXPECT_EQ(Port.GetRequestPdu(0), std::vector<uint8_t>({0x0F, 0x00, 0x00, 0x00, 0x03, 0x01, 0x07}));
+    EXPECT_EQ(Port.GetRequestPdu(1), std::vector<uint8_t>({0x0F, 0x00, 0x03, 0x00, 0x02, 0x01, 0x03}));
+}
+
+TEST_F(TModbusWriteRegistersTest, Errors)
+{
+    std::vector<TRegisterWriteRequest> requests{MakeRequest(Modbus::REG_HOLDING, 1, 1),
+                                                MakeRequest(Modbus::REG_HOLDING, 2, 2),
+                                                MakeRequest(Modbus::REG_COIL, 3, 1)};
+    // ILLEGAL_DATA_ADDRESS for the combined request
+    Port.AddResponse({0x90, 0x02});
+    Port.AddResponse({0x05, 0x00, 0x03, 0xFF, 0x00});
+    WriteRegisters(requests, Modbus::MAX_WRITE_REGISTERS);
+
+    ASSERT_EQ(Port.Requests.size(), 2);
+    EXPECT_TRUE(requests[0].Error);
+    EXPECT_EQ(requests[0].Error, requests[1].Error);
+    EXPECT_THROW(std::rethrow_exception(requests[1].Error), TSerialDevicePermanentRegisterException);
+    EXPECT_FALSE(requests[2].Error);
+}
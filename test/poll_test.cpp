@@ -988,3 +988,51 @@ TEST_F(TPollTest, SuspendAndResumeWithEvents)
         Cycle(serialClient, lastAccessedDevice);
     }
 }
+
+TEST_F(TPollTest, SemiSporadicRegisterWithEventsHeartbeat)
+{
+    // One register with events and polling, events heartbeat period is set
+    // 1. Events must be enabled
+    // 2. The register is read once by normal request
+    // 3. Events read requests are sent every 50ms, the register is not polled
+    // 4. Events reading fails, the register is polled as usual
+    // 5. Events are read successfully again, the register is polled once and then only events are read
+
+    Port->SetBaudRate(115200);
+    auto config = MakeDeviceConfig("device1", "1");
+    config.CommonConfig->RequestDelay = 10ms;
+    config.CommonConfig->EventsHeartbeatPeriod = 10s;
+    auto device = MakeDevice(config);
+    AddRegister(*device, 1, 0ms, TRegisterConfig::TSporadicMode::EVENTS_AND_POLLING);
+
+    TSerialClientRegisterAndEventsReader serialClient({device}, 50ms, [this]() { return TimeMock.GetTime(); });
+    TSerialClientDeviceAccessHandler lastAccessedDevice(serialClient.GetEventsReader());
+
+    EnqueueEnableEvents(1, 1, 10ms);
+    EnqueueReadHolding(1, 1, 1, 10ms);
+    Cycle(serialClient, lastAccessedDevice);
+
+    for (size_t i = 0; i < 3; ++i) {
+        EnqueueReadEvents(4ms);
+        Cycle(serialClient, lastAccessedDevice);
+    }
+
+    for (size_t i = 0; i < 3; ++i) {
+        EnqueueReadEvents(30ms, 0, true, MAX_EVENT_RESPONSE_SIZE);
+        EnqueueReadEvents(30ms, 0, true, MAX_EVENT_RESPONSE_SIZE);
+        EnqueueReadEvents(30ms, 0, true, MAX_EVENT_RESPONSE_SIZE);
+        EnqueueReadEvents(25ms, 0, true, 0x40);
+        Cycle(serialClient, lastAccessedDevice);
+    }
+
+    // Events could be lost, so the register is polled as soon as possible
+    EnqueueReadEvents(4ms);
+    Cycle(serialClient, lastAccessedDevice);
+    EnqueueReadHolding(1, 1, 1, 10ms);
+    Cycle(serialClient, lastAccessedDevice);
+
+    for (size_t i = 0; i < 3; ++i) {
+        EnqueueReadEvents(4ms);
+        Cycle(serialClient, lastAccessedDevice);
+    }
+}
@@ -0,0 +1,208 @@
+#include "pollable_device.h"
+#include "port/feature_port.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono;
+
+namespace
+{
+    class TTestDevice: public TSerialDevice, public TUInt32SlaveId
+    {
+    public:
+        TTestDevice(PDeviceConfig config, PProtocol protocol)
+            : TSerialDevice(config, protocol),
+              TUInt32SlaveId(config->SlaveId)
+        {}
+    };
+
+    const auto REGISTER_READ_TIME = 10ms;
+
+    class TPortStub: public TPort
+    {
+    public:
+        void Open() override
+        {}
+        void Close() override
+        {}
+        bool IsOpen() const override
+        {
+            return true;
+        }
+        void CheckPortOpen() const override
+        {}
+        void WriteBytes(const uint8_t* buf, int count) override
+        {}
+        uint8_t ReadByte(const std::chrono::microseconds& timeout) override
+        {
+            return 0;
+        }
+        TReadFrameResult ReadFrame(uint8_t* buf,
+                                   size_t count,
+                                   const std::chrono::microseconds& responseTimeout,
+                                   const std::chrono::microseconds& frameTimeout,
+                                   TFrameCompletePred frame_complete = 0) override
+        {
+            throw TResponseTimeoutException();
+        }
+        void SkipNoise() override
+        {}
+        void SleepSinceLastInteraction(const std::chrono::microseconds& us) override
+        {}
+        std::string GetDescription(bool verbose) const override
+        {
+            return std::string();
+        }
+        std::chrono::microseconds GetSendTimeBytes(double bytesNumber) const override
+        {
+            return std::chrono::microseconds::zero();
+        }
+        std::chrono::microseconds GetSendTimeBits(size_t bitsNumber) const override
+        {
+            return std::chrono::microseconds::zero();
+        }
+    };
+
+    //! Every register adds REGISTER_READ_TIME to the estimated request time
+    class TTimedRegisterRange: public TRegisterRange
+    {
+    public:
+        bool Add(TPort& port, PRegister reg, std::chrono::milliseconds pollLimit) override
+        {
+            if (!RegisterList().empty() && REGISTER_READ_TIME * (RegisterList().size() + 1) > pollLimit) {
+                return false;
+            }
+            RegisterList().push_back(reg);
+            return true;
+        }
+    };
+
+    class TRangeTestDevice: public TSerialDevice, public TUInt32SlaveId
+    {
+    public:
+        TRangeTestDevice(PDeviceConfig config, PProtocol protocol)
+            : TSerialDevice(config, protocol),
+              TUInt32SlaveId(config->SlaveId)
+        {}
+
+        PRegisterRange CreateRegisterRange() const override
+        {
+            return std::make_shared<TTimedRegisterRange>();
+        }
+
+        void ReadRegisterRange(TPort& port, PRegisterRange range, bool breakOnError) override
+        {}
+    };
+
+    PRegister AddRegister(PSerialDevice device, uint32_t address, std::optional<milliseconds> readPeriod)
+    {
+        auto config = TRegisterConfig::Create(0, address);
+        config->ReadPeriod = readPeriod;
+        return device->AddRegister(config);
+    }
+}
+
+TEST(TPollableDeviceTest, PostponePoll)
+{
+    TUint32SlaveIdProtocol protocol("test", TRegisterTypes({{0, "test", "value", U16}}));
+    auto device = std::make_shared<TTestDevice>(std::make_shared<TDeviceConfig>("test", "1", "test"), &protocol);
+    auto reg1 = AddRegister(device, 1, 100ms);
+    auto reg2 = AddRegister(device, 2, 200ms);
+    auto lowPriorityReg = AddRegister(device, 3, std::nullopt);
+
+    steady_clock::time_point start;
+    TPollableDevice pollableDevice(device, start, TPriority::High);
+    EXPECT_EQ(pollableDevice.GetDeadline(), start);
+
+    EXPECT_TRUE(pollableDevice.PostponePoll(reg1, start + 10ms));
+    EXPECT_EQ(pollableDevice.GetDeadline(), start);
+    EXPECT_TRUE(pollableDevice.PostponePoll(reg2, start + 20ms));
+    EXPECT_EQ(pollableDevice.GetDeadline(), start + 110ms);
+
+    // The register is polled by other pollable device
+    EXPECT_FALSE(pollableDevice.PostponePoll(lowPriorityReg, start + 20ms));
+
+    // Next write postpones the poll again
+    EXPECT_TRUE(pollableDevice.PostponePoll(reg1, start + 50ms));
+    EXPECT_EQ(pollableDevice.GetDeadline(), start + 150ms);
+}
+
+TEST(TPollableDeviceTest, RelaxedPolling)
+{
+    TUint32SlaveIdProtocol protocol("test", TRegisterTypes({{0, "test", "value", U16}}));
+    auto config = std::make_shared<TDeviceConfig>("test", "1", "test");
+    config->EventsHeartbeatPeriod = 10s;
+    auto device = std::make_shared<TTestDevice>(config, &protocol);
+    auto reg = AddRegister(device, 1, 100ms);
+    auto lowPriorityReg = AddRegister(device, 2, std::nullopt);
+
+    steady_clock::time_point start;
+    TPollableDevice pollableDevice(device, start, TPriority::High);
+    TPollableDevice lowPriorityPollableDevice(device, start, TPriority::Low);
+
+    reg->SetPollingRelaxed(true);
+    lowPriorityReg->SetPollingRelaxed(true);
+    EXPECT_TRUE(pollableDevice.PostponePoll(reg, start));
+    EXPECT_EQ(pollableDevice.GetDeadline(), start + 10s);
+    EXPECT_TRUE(lowPriorityPollableDevice.PostponePoll(lowPriorityReg, start));
+    EXPECT_EQ(lowPriorityPollableDevice.GetDeadline(), start + 10s);
+
+    // Usual polling is restored
+    reg->SetPollingRelaxed(false);
+    EXPECT_TRUE(pollableDevice.ScheduleImmediatePoll(reg, start + 1s));
+    EXPECT_EQ(pollableDevice.GetDeadline(), start + 1s);
+    EXPECT_TRUE(pollableDevice.PostponePoll(reg, start + 1s));
+    EXPECT_EQ(pollableDevice.GetDeadline(), start + 1100ms);
+
+    EXPECT_FALSE(pollableDevice.ScheduleImmediatePoll(lowPriorityReg, start + 1s));
+}
+
+class TPollableDeviceRangeTest: public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Protocol = std::make_unique<TUint32SlaveIdProtocol>("test", TRegisterTypes({{0, "test", "value", U16}}));
+        Device = std::make_shared<TRangeTestDevice>(std::make_shared<TDeviceConfig>("test", "1", "test"),
+                                                    Protocol.get());
+        for (uint32_t i = 0; i < 5; ++i) {
+            AddRegister(Device, i, 100ms);
+        }
+        Port = std::make_shared<TFeaturePort>(std::make_shared<TPortStub>(), false);
+    }
+
+    size_t ReadRangeSize(milliseconds pollLimit, milliseconds maxRangeTime)
+    {
+        TPollableDevice pollableDevice(Device, steady_clock::time_point(), TPriority::High);
+        util::TSpentTimeMeter sessionTime([]() { return steady_clock::time_point(); });
+        sessionTime.Start();
+        TSerialClientDeviceAccessHandler accessHandler(nullptr);
+        auto range =
+            pollableDevice.ReadRegisterRange(*Port, pollLimit, false, sessionTime, accessHandler, maxRangeTime);
+        return range->RegisterList().size();
+    }
+
+    std::unique_ptr<TUint32SlaveIdProtocol> Protocol;
+    std::shared_ptr<TRangeTestDevice> Device;
+    std::shared_ptr<TFeaturePort> Port;
+};
+
+TEST_F(TPollableDeviceRangeTest, RangeTimeLimit)
+{
+    // All registers fit into the poll limit and into the range time limit
+    EXPECT_EQ(ReadRangeSize(1s, milliseconds::max()), 5);
+    EXPECT_EQ(ReadRangeSize(1s, 50ms), 5);
+
+    // The range is split, because its estimated time exceeds the range time limit
+    EXPECT_EQ(ReadRangeSize(1s, 49ms), 4);
+    EXPECT_EQ(ReadRangeSize(1s, 25ms), 2);
+
+    // The lowest limit is used
+    EXPECT_EQ(ReadRangeSize(30ms, 40ms), 3);
+    EXPECT_EQ(ReadRangeSize(40ms, 30ms), 3);
+}
+
+TEST_F(TPollableDeviceRangeTest, FirstRegisterIgnoresRangeTimeLimit)
+{
+    // At least one register is read even if its read takes more time than the limit
+    EXPECT_EQ(ReadRangeSize(1s, 5ms), 1);
+}
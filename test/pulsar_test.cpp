@@ -41,3 +41,47 @@ TEST_F(TPulsarDeviceTest, PulsarHeatMeterFloatQuery)
 
     SerialPort->Close();
 }
+
+TEST_F(TPulsarDeviceTest, PulsarHeatMeterRangeQuery)
+{
+    // Both channels are read by one request with mask 0x0C
+    // temperatures == 24.71257 and 19.5
+
+    SerialPort->Expect({0x00, 0x10, 0x70, 0x80, 0x01, 0x0e, 0x0c,
+                        0x00, 0x00, 0x00, 0x00, 0x00, 0x7d, 0xef},
+                       {0x00, 0x10, 0x70, 0x80, 0x01, 0x12, 0x5a, 0xb3, 0xc5,
+                        0x41, 0x00, 0x00, 0x9c, 0x41, 0x00, 0x00, 0x63, 0x4f});
+
+    auto range = Dev->CreateRegisterRange();
+    ASSERT_TRUE(range->Add(*SerialPort, Heat_TempOut, std::chrono::milliseconds::max()));
+    ASSERT_TRUE(range->Add(*SerialPort, Heat_TempIn, std::chrono::milliseconds::max()));
+    Dev->ReadRegisterRange(*SerialPort, range);
+
+    EXPECT_EQ(TRegisterValue{0x41C5B35A}, Heat_TempIn->GetValue());
+    EXPECT_EQ(TRegisterValue{0x419C0000}, Heat_TempOut->GetValue());
+
+    SerialPort->Close();
+}
+
+TEST_F(TPulsarDeviceTest, PulsarHeatMeterRangeFallback)
+{
+    // The meter returns only the first channel for a request with mask 0x0C, channels are read one by one
+    // temperature == 24.71257, the second channel doesn't respond
+
+    SerialPort->Expect({0x00, 0x10, 0x70, 0x80, 0x01, 0x0e, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7d, 0xef},
+                       {0x00, 0x10, 0x70, 0x80, 0x01, 0x0e, 0x5a, 0xb3, 0xc5, 0x41, 0x00, 0x00, 0x18, 0xdb});
+    SerialPort->Expect({0x00, 0x10, 0x70, 0x80, 0x01, 0x0e, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x7d, 0x37},
+                       {0x00, 0x10, 0x70, 0x80, 0x01, 0x0e, 0x5a, 0xb3, 0xc5, 0x41, 0x01, 0x00, 0x19, 0x4b});
+    SerialPort->Expect({0x00, 0x10, 0x70, 0x80, 0x01, 0x0e, 0x08, 0x00, 0x00, 0x00, 0x02, 0x00, 0x7d, 0x0b}, {});
+
+    auto range = Dev->CreateRegisterRange();
+    ASSERT_TRUE(range->Add(*SerialPort, Heat_TempIn, std::chrono::milliseconds::max()));
+    ASSERT_TRUE(range->Add(*SerialPort, Heat_TempOut, std::chrono::milliseconds::max()));
+    Dev->ReadRegisterRange(*SerialPort, range);
+
+    EXPECT_EQ(TRegisterValue{0x41C5B35A}, Heat_TempIn->GetValue());
+    EXPECT_EQ(Heat_TempIn->GetErrorState().count(), 0);
+    EXPECT_TRUE(Heat_TempOut->GetErrorState().test(TRegister::TError::ReadError));
+
+    SerialPort->Close();
+}
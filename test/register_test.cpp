@@ -0,0 +1,47 @@
+#include "register.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+TEST(TRegisterTest, ConvertFromRawValueToNumber)
+{
+    auto config = TRegisterConfig::Create(0, 1, S16, 0.1, 2, 0.5);
+    auto value = ConvertFromRawValueToNumber(*config, TRegisterValue{static_cast<uint16_t>(-234)});
+    ASSERT_TRUE(value);
+    EXPECT_DOUBLE_EQ(*value, -21.5);
+    EXPECT_EQ(ConvertFromRawValue(*config, TRegisterValue{static_cast<uint16_t>(-234)}), "-21.5");
+
+    float f = 12.25;
+    uint32_t rawFloat;
+    memcpy(&rawFloat, &f, sizeof(rawFloat));
+    value = ConvertFromRawValueToNumber(*TRegisterConfig::Create(0, 1, Float), TRegisterValue{rawFloat});
+    ASSERT_TRUE(value);
+    EXPECT_DOUBLE_EQ(*value, 12.25);
+
+    EXPECT_FALSE(ConvertFromRawValueToNumber(*TRegisterConfig::Create(0, 1, String), TRegisterValue{"abc"}));
+}
+
+TEST(TRegisterTest, ConvertFromRawValueToNumberMatchesText)
+{
+    struct TCase
+    {
+        RegisterFormat Format;
+        uint64_t Raw;
+    };
+    std::vector<TCase> cases = {{U8, 0xFE},
+                                {S8, 0xFE},
+                                {U16, 0xFFFE},
+                                {S16, 0xFFFE},
+                                {S24, 0xFFFFFE},
+                                {U32, 0xFFFFFFFE},
+                                {S32, 0xFFFFFFFE},
+                                {S64, 0xFFFFFFFFFFFFFFFE},
+                                {BCD16, 0x1234}};
+    for (const auto& c: cases) {
+        auto config = TRegisterConfig::Create(0, 1, c.Format);
+        auto value = ConvertFromRawValueToNumber(*config, TRegisterValue{c.Raw});
+        ASSERT_TRUE(value) << RegisterFormatName(c.Format);
+        EXPECT_DOUBLE_EQ(*value, std::stod(ConvertFromRawValue(*config, TRegisterValue{c.Raw})))
+            << RegisterFormatName(c.Format);
+    }
+}
@@ -0,0 +1,230 @@
+#include "serial_client_session.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono;
+
+namespace
+{
+    const auto POLL_PERIOD = 100ms;
+    const auto POLL_TIME = 5ms;
+    const auto SESSION_STEP_TIME = 40ms;
+    const size_t SESSION_STEPS = 20;
+
+    class TPortStub: public TPort
+    {
+    public:
+        void Open() override
+        {}
+        void Close() override
+        {}
+        bool IsOpen() const override
+        {
+            return true;
+        }
+        void CheckPortOpen() const override
+        {}
+        void WriteBytes(const uint8_t* buf, int count) override
+        {}
+        uint8_t ReadByte(const std::chrono::microseconds& timeout) override
+        {
+            return 0;
+        }
+        TReadFrameResult ReadFrame(uint8_t* buf,
+                                   size_t count,
+                                   const std::chrono::microseconds& responseTimeout,
+                                   const std::chrono::microseconds& frameTimeout,
+                                   TFrameCompletePred frame_complete = 0) override
+        {
+            throw TResponseTimeoutException();
+        }
+        void SkipNoise() override
+        {}
+        void SleepSinceLastInteraction(const std::chrono::microseconds& us) override
+        {}
+        std::string GetDescription(bool verbose) const override
+        {
+            return std::string();
+        }
+        std::chrono::microseconds GetSendTimeBytes(double bytesNumber) const override
+        {
+            return std::chrono::microseconds::zero();
+        }
+        std::chrono::microseconds GetSendTimeBits(size_t bitsNumber) const override
+        {
+            return std::chrono::microseconds::zero();
+        }
+    };
+
+    // Time is advanced by bus exchanges only
+    class TTestClock
+    {
+    public:
+        steady_clock::time_point Now;
+
+        void Advance(milliseconds time)
+        {
+            Now += time;
+        }
+    };
+
+    class TTestDevice: public TSerialDevice, public TUInt32SlaveId
+    {
+    public:
+        TTestDevice(PDeviceConfig config, PProtocol protocol, TTestClock& clock)
+            : TSerialDevice(config, protocol),
+              TUInt32SlaveId(config->SlaveId),
+              Clock(clock)
+        {}
+
+        std::vector<steady_clock::time_point> PollTimes;
+
+    protected:
+        TRegisterValue ReadRegisterImpl(TPort& port, const TRegisterConfig& reg) override
+        {
+            Clock.Advance(POLL_TIME);
+            PollTimes.push_back(Clock.Now);
+            return TRegisterValue{PollTimes.size()};
+        }
+
+    private:
+        TTestClock& Clock;
+    };
+
+    // Stands for a long task exchange like firmware flashing
+    class TLongSessionTask: public TSerialClientSessionTask
+    {
+    public:
+        TLongSessionTask(TTestClock& clock, bool yieldBus): Clock(clock), YieldBetweenSteps(yieldBus)
+        {}
+
+        size_t Steps = 0;
+
+    protected:
+        TSerialClientSession RunSession(PFeaturePort port,
+                                        TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                        const std::list<PSerialDevice>& polledDevices) override
+        {
+            for (size_t i = 0; i < SESSION_STEPS; ++i) {
+                lastAccessedDevice.PrepareToAccess(*port, nullptr);
+                Clock.Advance(SESSION_STEP_TIME);
+                ++Steps;
+                if (YieldBetweenSteps) {
+                    co_await YieldBus();
+                }
+            }
+        }
+
+    private:
+        TTestClock& Clock;
+        bool YieldBetweenSteps;
+    };
+
+    class TSerialClientSessionTest: public testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            Protocol = std::make_unique<TUint32SlaveIdProtocol>("test", TRegisterTypes({{0, "test", "value", U16}}));
+            Device = std::make_shared<TTestDevice>(std::make_shared<TDeviceConfig>("test", "1", "test"),
+                                                   Protocol.get(),
+                                                   Clock);
+            auto config = TRegisterConfig::Create(0, 1);
+            config->ReadPeriod = POLL_PERIOD;
+            Device->AddRegister(config);
+
+            SerialClient = std::make_shared<TSerialClient>(
+                std::make_shared<TFeaturePort>(std::make_shared<TPortStub>(), false),
+                TPortOpenCloseLogic::TSettings(),
+                [this]() { return Clock.Now; });
+            SerialClient->AddDevice(Device);
+        }
+
+        milliseconds RunSessionAndGetMaxPollInterval(std::shared_ptr<TLongSessionTask> task)
+        {
+            // Initial poll
+            SerialClient->Cycle();
+            SerialClient->AddTask(task);
+            for (size_t i = 0; i < SESSION_STEPS * 3 && task->Steps < SESSION_STEPS; ++i) {
+                SerialClient->Cycle();
+            }
+            EXPECT_EQ(task->Steps, SESSION_STEPS);
+
+            milliseconds maxInterval = milliseconds::zero();
+            for (size_t i = 1; i < Device->PollTimes.size(); ++i) {
+                maxInterval = std::max(maxInterval,
+                                       duration_cast<milliseconds>(Device->PollTimes[i] - Device->PollTimes[i - 1]));
+            }
+            return maxInterval;
+        }
+
+        TTestClock Clock;
+        std::unique_ptr<TUint32SlaveIdProtocol> Protocol;
+        std::shared_ptr<TTestDevice> Device;
+        PSerialClient SerialClient;
+    };
+}
+
+TEST_F(TSerialClientSessionTest, PollDuringSession)
+{
+    auto task = std::make_shared<TLongSessionTask>(Clock, true);
+    auto maxInterval = RunSessionAndGetMaxPollInterval(task);
+
+    // Polling is delayed by one session step at most
+    EXPECT_LE(maxInterval, POLL_PERIOD + SESSION_STEP_TIME + POLL_TIME);
+}
+
+TEST_F(TSerialClientSessionTest, BlockingSession)
+{
+    auto task = std::make_shared<TLongSessionTask>(Clock, false);
+    auto maxInterval = RunSessionAndGetMaxPollInterval(task);
+
+    EXPECT_GE(maxInterval, SESSION_STEPS * SESSION_STEP_TIME);
+}
+
+TEST(TSerialClientSessionExceptionTest, Rethrow)
+{
+    auto session = []() -> TSerialClientSession {
+        co_await YieldBus();
+        throw std::runtime_error("session error");
+    }();
+    EXPECT_FALSE(session.IsDone());
+    EXPECT_FALSE(session.Resume());
+    EXPECT_THROW(session.Resume(), std::runtime_error);
+    EXPECT_TRUE(session.IsDone());
+    EXPECT_TRUE(session.Resume());
+}
+
+TEST(TSerialClientSessionNestedTest, ResumeChain)
+{
+    std::vector<int> steps;
+    auto resumeTime = steady_clock::time_point() + 10s;
+    auto nested = [&]() -> TSerialClientSession {
+        steps.push_back(1);
+        co_await YieldBus(resumeTime);
+        steps.push_back(2);
+        throw std::runtime_error("nested error");
+    };
+    auto top = [&]() -> TSerialClientSession {
+        try {
+            co_await nested();
+        } catch (const std::runtime_error&) {
+            steps.push_back(3);
+        }
+        co_await YieldBus();
+        steps.push_back(4);
+    };
+    auto session = top();
+
+    // YieldBus in the nested session suspends the top level one
+    EXPECT_FALSE(session.Resume());
+    EXPECT_EQ(steps, std::vector<int>({1}));
+    EXPECT_EQ(session.GetResumeTime(), resumeTime);
+
+    // The exception of the nested session is caught by the awaiting one
+    EXPECT_FALSE(session.Resume());
+    EXPECT_EQ(steps, std::vector<int>({1, 2, 3}));
+    EXPECT_EQ(session.GetResumeTime(), steady_clock::time_point());
+
+    EXPECT_TRUE(session.Resume());
+    EXPECT_EQ(steps, std::vector<int>({1, 2, 3, 4}));
+}
@@ -0,0 +1,144 @@
+#include "serial_client_task_queue.h"
+#include "write_channel_serial_client_task.h"
+#include "write_latency_stats.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+using namespace std::chrono;
+
+namespace
+{
+    class TDummyTask: public ISerialClientTask
+    {
+    public:
+        ISerialClientTask::TRunResult Run(PFeaturePort port,
+                                          TSerialClientDeviceAccessHandler& lastAccessedDevice,
+                                          const std::list<PSerialDevice>& polledDevices) override
+        {
+            return ISerialClientTask::TRunResult::OK;
+        }
+    };
+
+    class TPortStub: public TPort
+    {
+    public:
+        void Open() override
+        {}
+        void Close() override
+        {}
+        bool IsOpen() const override
+        {
+            return true;
+        }
+        void CheckPortOpen() const override
+        {}
+        void WriteBytes(const uint8_t* buf, int count) override
+        {}
+        uint8_t ReadByte(const std::chrono::microseconds& timeout) override
+        {
+            return 0;
+        }
+        TReadFrameResult ReadFrame(uint8_t* buf,
+                                   size_t count,
+                                   const std::chrono::microseconds& responseTimeout,
+                                   const std::chrono::microseconds& frameTimeout,
+                                   TFrameCompletePred frame_complete = 0) override
+        {
+            throw TResponseTimeoutException();
+        }
+        void SkipNoise() override
+        {}
+        void SleepSinceLastInteraction(const std::chrono::microseconds& us) override
+        {}
+        std::string GetDescription(bool verbose) const override
+        {
+            return std::string();
+        }
+        std::chrono::microseconds GetSendTimeBytes(double bytesNumber) const override
+        {
+            return std::chrono::microseconds::zero();
+        }
+        std::chrono::microseconds GetSendTimeBits(size_t bitsNumber) const override
+        {
+            return std::chrono::microseconds::zero();
+        }
+    };
+
+    PRegisterHandler MakeHandler(uint32_t address)
+    {
+        auto config = TRegisterConfig::Create(0, address);
+        return std::make_shared<TRegisterHandler>(std::make_shared<TRegister>(nullptr, config));
+    }
+}
+
+TEST(TSerialClientTaskQueueTest, WriteDeduplication)
+{
+    TSerialClientTaskQueue queue;
+    auto handler1 = MakeHandler(1);
+    auto handler2 = MakeHandler(2);
+    std::vector<std::string> completed;
+    auto makeWrite = [&](PRegisterHandler handler, const std::string& name) {
+        return std::make_shared<TWriteChannelSerialClientTask>(
+            handler,
+            nullptr,
+            nullptr,
+            [&completed, name](const std::string& error) { completed.push_back(name); });
+    };
+
+    EXPECT_TRUE(queue.AddWrite(makeWrite(handler1, "a")));
+    EXPECT_TRUE(queue.AddWrite(makeWrite(handler2, "b")));
+    queue.AddTask(std::make_shared<TDummyTask>());
+    EXPECT_FALSE(queue.AddWrite(makeWrite(handler1, "c")));
+    EXPECT_FALSE(queue.AddWrite(makeWrite(handler1, "d")));
+    EXPECT_EQ(queue.Size(), 3);
+
+    auto tasks = queue.WaitAndTake(steady_clock::now());
+    ASSERT_EQ(tasks.size(), 3);
+    EXPECT_EQ(queue.Size(), 0);
+
+    // Taken writes are not joined
+    EXPECT_TRUE(queue.AddWrite(makeWrite(handler1, "e")));
+
+    // Registers have no pending values, so writes are completed without bus access
+    TPortStub port;
+    auto write = std::dynamic_pointer_cast<TWriteChannelSerialClientTask>(tasks[0]);
+    ASSERT_TRUE(write);
+    EXPECT_EQ(write->CheckBeforeWrite(port), ISerialClientTask::TRunResult::OK);
+    EXPECT_EQ(completed, std::vector<std::string>({"a", "c", "d"}));
+}
+
+TEST(TSerialClientTaskQueueTest, WaitAndTake)
+{
+    TSerialClientTaskQueue queue;
+    EXPECT_TRUE(queue.WaitAndTake(steady_clock::now() + 1ms).empty());
+
+    std::thread producer([&queue]() {
+        std::this_thread::sleep_for(10ms);
+        queue.AddTask(std::make_shared<TDummyTask>());
+    });
+    EXPECT_EQ(queue.WaitAndTake(steady_clock::now() + 10s).size(), 1);
+    producer.join();
+}
+
+TEST(TWriteLatencyStatsTest, Summary)
+{
+    TWriteLatencyStats stats;
+    auto summary = stats.GetSummary();
+    EXPECT_EQ(summary.Count, 0);
+    EXPECT_EQ(summary.P99, microseconds::zero());
+
+    for (size_t i = 0; i < 99; ++i) {
+        stats.AddLatency(1000us);
+    }
+    stats.AddLatency(100000us);
+    stats.AddSuperseded();
+
+    summary = stats.GetSummary();
+    EXPECT_EQ(summary.Count, 100);
+    EXPECT_EQ(summary.Superseded, 1);
+    EXPECT_EQ(summary.Max, 100000us);
+    EXPECT_EQ(summary.Average, 1990us);
+    // 1000 us is in [512, 1024) bucket
+    EXPECT_EQ(summary.P99, 1023us);
+}
@@ -0,0 +1,35 @@
+#include "sha256.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string HexDigest(const std::string& str)
+    {
+        return SHA256::HexDigest(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    }
+}
+
+// Test vectors are from FIPS 180-2, appendix B
+TEST(Sha256Test, HexDigest)
+{
+    EXPECT_EQ(HexDigest(""), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    EXPECT_EQ(HexDigest("abc"), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    // 56 bytes, padding doesn't fit into the first block
+    EXPECT_EQ(HexDigest("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+}
+
+TEST(Sha256Test, Incremental)
+{
+    // One million of 'a' fed by chunks not aligned to block size
+    std::vector<uint8_t> chunk(1000, 'a');
+    SHA256::THasher hasher;
+    for (size_t i = 0; i < 1000; ++i) {
+        hasher.Update(chunk.data(), 1 + i % 2);
+        hasher.Update(chunk.data(), chunk.size() - 1 - i % 2);
+    }
+    EXPECT_EQ(hasher.HexDigest(), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
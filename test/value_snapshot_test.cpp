@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include "value_snapshot.h"
+
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+class TValueSnapshotTest: public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Path = (std::filesystem::temp_directory_path() /
+                ("wb-mqtt-serial-value-snapshot-test-" + std::to_string(getpid())))
+                   .string();
+    }
+
+    std::string Path;
+};
+
+TEST_F(TValueSnapshotTest, ReadWrite)
+{
+    TValueSnapshotWriter writer(Path, 2);
+    auto slot1 = writer.AllocateSlot("device1/temperature");
+    auto slot2 = writer.AllocateSlot("device1/humidity");
+    ASSERT_TRUE(slot1);
+    ASSERT_TRUE(slot2);
+    EXPECT_FALSE(writer.AllocateSlot("device1/extra"));
+    EXPECT_FALSE(writer.AllocateSlot(std::string(ValueSnapshot::MAX_VALUE_SIZE, 'x')));
+
+    TValueSnapshotReader reader(Path);
+    EXPECT_EQ(reader.GetSlotCount(), 2);
+    EXPECT_EQ(reader.FindSlot("device1/humidity"), slot2);
+    EXPECT_EQ(reader.GetSlotId(*slot1), "device1/temperature");
+    EXPECT_FALSE(reader.FindSlot("device1/pressure"));
+
+    auto value = reader.Read(*slot1);
+    EXPECT_EQ(value.Flags, ValueSnapshot::ValueUndefined);
+    EXPECT_TRUE(value.Value.empty());
+
+    steady_clock::time_point ts(123456us);
+    writer.Update(*slot1, "23.5", 0, ts);
+    value = reader.Read(*slot1);
+    EXPECT_EQ(value.Value, "23.5");
+    EXPECT_EQ(value.Flags, 0);
+    EXPECT_EQ(value.Timestamp, ts);
+
+    writer.UpdateFlags(*slot1, ValueSnapshot::ReadError, ts + 1s);
+    value = reader.Read(*slot1);
+    EXPECT_EQ(value.Value, "23.5");
+    EXPECT_EQ(value.Flags, ValueSnapshot::ReadError);
+    EXPECT_EQ(value.Timestamp, ts + 1s);
+
+    writer.Update(*slot2, std::string(ValueSnapshot::MAX_VALUE_SIZE + 10, '1'), 0, ts);
+    value = reader.Read(*slot2);
+    EXPECT_EQ(value.Value.size(), ValueSnapshot::MAX_VALUE_SIZE);
+    EXPECT_EQ(value.Flags, ValueSnapshot::ValueTruncated);
+
+    EXPECT_THROW(reader.Read(2), std::out_of_range);
+}
+
+TEST_F(TValueSnapshotTest, Stale)
+{
+    auto writer = std::make_unique<TValueSnapshotWriter>(Path, 1);
+    TValueSnapshotReader reader(Path);
+    EXPECT_FALSE(reader.IsStale());
+
+    // Restart of the driver creates a new file
+    writer = std::make_unique<TValueSnapshotWriter>(Path, 1);
+    EXPECT_TRUE(reader.IsStale());
+    TValueSnapshotReader newReader(Path);
+    EXPECT_FALSE(newReader.IsStale());
+
+    writer.reset();
+    EXPECT_TRUE(newReader.IsStale());
+    EXPECT_THROW(TValueSnapshotReader{Path}, std::runtime_error);
+}
+
+TEST_F(TValueSnapshotTest, ConcurrentAccess)
+{
+    TValueSnapshotWriter writer(Path, 1);
+    auto slot = *writer.AllocateSlot("device/control");
+    TValueSnapshotReader reader(Path);
+
+    // Value and timestamp are changed together, reader must never see mixed data
+    std::atomic_bool stop = false;
+    std::thread writerThread([&]() {
+        for (size_t i = 1; !stop; ++i) {
+            auto size = 1 + i % ValueSnapshot::MAX_VALUE_SIZE;
+            writer.Update(slot, std::string(size, '0' + i % 10), i % 2, steady_clock::time_point(microseconds(size)));
+        }
+    });
+
+    size_t reads = 0;
+    for (; reads < 100000; ++reads) {
+        auto value = reader.Read(slot);
+        if (value.Flags & ValueSnapshot::ValueUndefined) {
+            continue;
+        }
+        ASSERT_EQ(value.Timestamp.time_since_epoch(), microseconds(value.Value.size()));
+        ASSERT_EQ(value.Value, std::string(value.Value.size(), value.Value.front()));
+        ASSERT_EQ(value.Flags, static_cast<uint32_t>((value.Value.front() - '0') % 2));
+    }
+    stop = true;
+    writerThread.join();
+}